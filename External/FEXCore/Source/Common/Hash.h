@@ -0,0 +1,131 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+namespace FEXCore::Hash {
+/**
+ * @brief Incremental 64bit hash using the XXH64 algorithm
+ *
+ * Input is consumed in 32 byte stripes of four independent lanes, which keeps the host's pipelines full
+ * Output is the same as the reference XXH64 for the same input and seed
+ */
+class XXHash64 final {
+public:
+  explicit XXHash64(uint64_t Seed = 0)
+    : Lanes {Seed + PRIME1 + PRIME2, Seed + PRIME2, Seed, Seed - PRIME1}
+    , Seed {Seed} {
+  }
+
+  void Update(void const *Data, size_t Size) {
+    auto Input = reinterpret_cast<uint8_t const*>(Data);
+    TotalSize += Size;
+
+    if (BufferSize + Size < STRIPE_SIZE) {
+      memcpy(Buffer + BufferSize, Input, Size);
+      BufferSize += Size;
+      return;
+    }
+
+    if (BufferSize) {
+      size_t Fill = STRIPE_SIZE - BufferSize;
+      memcpy(Buffer + BufferSize, Input, Fill);
+      ConsumeStripe(Buffer);
+      Input += Fill;
+      Size -= Fill;
+      BufferSize = 0;
+    }
+
+    for (; Size >= STRIPE_SIZE; Input += STRIPE_SIZE, Size -= STRIPE_SIZE) {
+      ConsumeStripe(Input);
+    }
+
+    memcpy(Buffer, Input, Size);
+    BufferSize = Size;
+  }
+
+  uint64_t Final() const {
+    uint64_t Hash;
+    if (TotalSize >= STRIPE_SIZE) {
+      Hash = RotateLeft(Lanes[0], 1) + RotateLeft(Lanes[1], 7) + RotateLeft(Lanes[2], 12) + RotateLeft(Lanes[3], 18);
+      for (auto Lane : Lanes) {
+        Hash = (Hash ^ Round(0, Lane)) * PRIME1 + PRIME4;
+      }
+    }
+    else {
+      Hash = Seed + PRIME5;
+    }
+
+    Hash += TotalSize;
+
+    uint8_t const *Input = Buffer;
+    size_t Size = BufferSize;
+    for (; Size >= 8; Input += 8, Size -= 8) {
+      Hash ^= Round(0, Read<uint64_t>(Input));
+      Hash = RotateLeft(Hash, 27) * PRIME1 + PRIME4;
+    }
+
+    if (Size >= 4) {
+      Hash ^= Read<uint32_t>(Input) * PRIME1;
+      Hash = RotateLeft(Hash, 23) * PRIME2 + PRIME3;
+      Input += 4;
+      Size -= 4;
+    }
+
+    for (; Size; ++Input, --Size) {
+      Hash ^= *Input * PRIME5;
+      Hash = RotateLeft(Hash, 11) * PRIME1;
+    }
+
+    Hash ^= Hash >> 33;
+    Hash *= PRIME2;
+    Hash ^= Hash >> 29;
+    Hash *= PRIME3;
+    Hash ^= Hash >> 32;
+    return Hash;
+  }
+
+  static uint64_t Hash(void const *Data, size_t Size, uint64_t Seed = 0) {
+    XXHash64 State {Seed};
+    State.Update(Data, Size);
+    return State.Final();
+  }
+
+private:
+  constexpr static uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+  constexpr static uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+  constexpr static uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+  constexpr static uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+  constexpr static uint64_t PRIME5 = 0x27D4EB2F165667C5ULL;
+  constexpr static size_t STRIPE_SIZE = 32;
+
+  static uint64_t RotateLeft(uint64_t Value, int Shift) {
+    return (Value << Shift) | (Value >> (64 - Shift));
+  }
+
+  static uint64_t Round(uint64_t Lane, uint64_t Input) {
+    Lane += Input * PRIME2;
+    return RotateLeft(Lane, 31) * PRIME1;
+  }
+
+  template<typename T>
+  static uint64_t Read(uint8_t const *Input) {
+    T Value;
+    memcpy(&Value, Input, sizeof(T));
+    return Value;
+  }
+
+  void ConsumeStripe(uint8_t const *Input) {
+    Lanes[0] = Round(Lanes[0], Read<uint64_t>(Input));
+    Lanes[1] = Round(Lanes[1], Read<uint64_t>(Input + 8));
+    Lanes[2] = Round(Lanes[2], Read<uint64_t>(Input + 16));
+    Lanes[3] = Round(Lanes[3], Read<uint64_t>(Input + 24));
+  }
+
+  uint64_t Lanes[4];
+  uint64_t Seed;
+  uint64_t TotalSize {};
+  uint8_t Buffer[STRIPE_SIZE];
+  size_t BufferSize {};
+};
+}
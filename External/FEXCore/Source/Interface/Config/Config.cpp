@@ -27,6 +27,33 @@ namespace FEXCore::Config {
     case FEXCore::Config::CONFIG_UNIFIED_MEMORY:
       CTX->Config.UnifiedMemory = Config != 0;
     break;
+    case FEXCore::Config::CONFIG_TIERUP_THRESHOLD:
+      CTX->Config.TierUpThreshold = Config;
+    break;
+    case FEXCore::Config::CONFIG_TRANSLATION_CACHE:
+      CTX->Config.TranslationCache = Config != 0;
+    break;
+    case FEXCore::Config::CONFIG_LAZY_FLAGS:
+      CTX->Config.LazyFlags = Config != 0;
+    break;
+    case FEXCore::Config::CONFIG_STATIC_REGISTERS:
+      CTX->Config.StaticRegisters = Config != 0;
+    break;
+    case FEXCore::Config::CONFIG_REGISTER_ALLOCATOR:
+      CTX->Config.RegisterAllocator = static_cast<FEXCore::Config::ConfigRegisterAllocator>(Config);
+    break;
+    case FEXCore::Config::CONFIG_BASELINE_REGISTER_ALLOCATOR:
+      CTX->Config.BaselineRegisterAllocator = static_cast<FEXCore::Config::ConfigRegisterAllocator>(Config);
+    break;
+    case FEXCore::Config::CONFIG_COMPILE_STATS:
+      CTX->Config.CompileStats = Config != 0;
+    break;
+    case FEXCore::Config::CONFIG_VDSO:
+      CTX->Config.VDSO = Config != 0;
+    break;
+    case FEXCore::Config::CONFIG_HUGE_PAGES:
+      CTX->Config.HugePages = Config != 0;
+    break;
     default: LogMan::Msg::A("Unknown configuration option");
     }
   }
@@ -36,6 +63,15 @@ namespace FEXCore::Config {
     case CONFIG_ROOTFSPATH:
       CTX->Config.RootFSPath = Config;
       break;
+    case CONFIG_SYSCALL_TRACE:
+      // Takes effect immediately, can be flipped while the guest is running
+      if (Config.empty()) {
+        CTX->SyscallHandler->Tracer.Stop();
+      }
+      else {
+        CTX->SyscallHandler->Tracer.Start(Config);
+      }
+      break;
     default: LogMan::Msg::A("Unknown configuration option");
     }
   }
@@ -62,6 +98,36 @@ namespace FEXCore::Config {
     case FEXCore::Config::CONFIG_UNIFIED_MEMORY:
       return CTX->Config.UnifiedMemory;
     break;
+    case FEXCore::Config::CONFIG_TIERUP_THRESHOLD:
+      return CTX->Config.TierUpThreshold;
+    break;
+    case FEXCore::Config::CONFIG_TRANSLATION_CACHE:
+      return CTX->Config.TranslationCache;
+    break;
+    case FEXCore::Config::CONFIG_LAZY_FLAGS:
+      return CTX->Config.LazyFlags;
+    break;
+    case FEXCore::Config::CONFIG_STATIC_REGISTERS:
+      return CTX->Config.StaticRegisters;
+    break;
+    case FEXCore::Config::CONFIG_REGISTER_ALLOCATOR:
+      return CTX->Config.RegisterAllocator;
+    break;
+    case FEXCore::Config::CONFIG_BASELINE_REGISTER_ALLOCATOR:
+      return CTX->Config.BaselineRegisterAllocator;
+    break;
+    case FEXCore::Config::CONFIG_COMPILE_STATS:
+      return CTX->Config.CompileStats;
+    break;
+    case FEXCore::Config::CONFIG_VDSO:
+      return CTX->Config.VDSO;
+    break;
+    case FEXCore::Config::CONFIG_HUGE_PAGES:
+      return CTX->Config.HugePages;
+    break;
+    case FEXCore::Config::CONFIG_SYSCALL_TRACE:
+      return CTX->SyscallHandler->Tracer.IsEnabled();
+    break;
     default: LogMan::Msg::A("Unknown configuration option");
     }
 
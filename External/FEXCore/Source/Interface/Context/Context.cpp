@@ -33,8 +33,6 @@ namespace FEXCore::Context {
 
   void SetApplicationFile(FEXCore::Context::Context *CTX, std::string const &File) {
     CTX->SyscallHandler->SetFilename(File);
-    // XXX: This isn't good for debugging
-    // CTX->LoadEntryList();
   }
 
   bool InitCore(FEXCore::Context::Context *CTX, FEXCore::CodeLoader *Loader) {
@@ -123,6 +121,10 @@ namespace Debug {
     return CTX->GetRuntimeStatsForThread(Thread);
   }
 
+  FEXCore::Core::CompileStats *GetCompileStatsForThread(FEXCore::Context::Context *CTX, uint64_t Thread) {
+    return CTX->GetCompileStatsForThread(Thread);
+  }
+
   FEXCore::Core::CPUState GetCPUState(FEXCore::Context::Context *CTX) {
     return CTX->GetCPUState();
   }
@@ -139,6 +141,10 @@ namespace Debug {
     return CTX->FindHostCodeForRIP(RIP, Code);
   }
 
+  void GetCachedRIPs(FEXCore::Context::Context *CTX, std::vector<uint64_t> *RIPs) {
+    CTX->GetCachedRIPs(RIPs);
+  }
+
   // XXX:
   // bool FindIRForRIP(FEXCore::Context::Context *CTX, uint64_t RIP, FEXCore::IR::IntrusiveIRList **ir) {
   //   return CTX->FindIRForRIP(RIP, ir);
@@ -11,12 +11,22 @@
 #include <FEXCore/Utils/Event.h>
 #include <stdint.h>
 
+#include <condition_variable>
+#include <deque>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
 
 namespace FEXCore {
 class SyscallHandler;
 class BlockSamplingData;
+class CodePageTracker;
+class TranslationCache;
 class GdbServer;
 
 namespace CPU {
@@ -24,13 +34,6 @@ namespace CPU {
 }
 }
 
-namespace FEXCore::IR {
-  class RegisterAllocationPass;
-namespace Validation {
-  class IRValidation;
-}
-}
-
 namespace FEXCore::Context {
   enum CoreRunningMode {
     MODE_RUN,
@@ -40,7 +43,6 @@ namespace FEXCore::Context {
   struct Context {
     friend class FEXCore::SyscallHandler;
     friend class FEXCore::CPU::JITCore;
-    friend class FEXCore::IR::Validation::IRValidation;
 
     struct {
       bool Multiblock {false};
@@ -50,6 +52,24 @@ namespace FEXCore::Context {
       FEXCore::Config::ConfigCore Core {FEXCore::Config::CONFIG_INTERPRETER};
       bool GdbServer {false};
       bool UnifiedMemory {true};
+      // Number of executions before a baseline block is recompiled with full optimizations, 0 disables tiering
+      uint64_t TierUpThreshold {0};
+      // Keep the IR of blocks on disk between runs of the same application
+      bool TranslationCache {false};
+      // Only store the flags of ALU ops once something needs them
+      bool LazyFlags {false};
+      // Keep the most used guest GPRs of a block in host registers instead of the context
+      // They're filled on block entry and written back on every exit, nothing stays pinned between blocks
+      bool StaticRegisters {false};
+      // Allocators for fully optimized code and for the baseline tier
+      FEXCore::Config::ConfigRegisterAllocator RegisterAllocator {FEXCore::Config::CONFIG_RA_GRAPH};
+      FEXCore::Config::ConfigRegisterAllocator BaselineRegisterAllocator {FEXCore::Config::CONFIG_RA_LINEAR_SCAN};
+      // Time every compilation stage and IR pass, dumped when the Context goes away
+      bool CompileStats {false};
+      // Map a vDSO in to the guest and hand it over through AT_SYSINFO_EHDR
+      bool VDSO {false};
+      // Back code buffers, block cache tables and large guest mappings with huge pages where the host has them
+      bool HugePages {false};
       std::string RootFSPath;
 
       // LLVM JIT options
@@ -73,8 +93,114 @@ namespace FEXCore::Context {
     Event PauseWait;
     bool Running{};
     CoreRunningMode RunningMode {CoreRunningMode::MODE_RUN};
-    FEXCore::Frontend::Decoder FrontendDecoder;
-    FEXCore::IR::PassManager PassManager;
+
+    /**
+     * @name Shared code cache
+     *
+     * Blocks are compiled once and then executed by every thread whose CPUBackend can share code
+     * Lookups through the BlockCache are lock free, anything that modifies the cache holds CodeCacheMutex
+     * @{ */
+    std::shared_ptr<FEXCore::BlockCache> BlockCache;
+    std::shared_mutex CodeCacheMutex;
+    // Backing memory of the IR copies, has to outlive IRLists and RetiredIR
+    FEXCore::IR::IRArena IRStorage;
+    std::map<uint64_t, std::unique_ptr<FEXCore::IR::IRListView<true>>> IRLists;
+    std::map<uint64_t, FEXCore::Core::DebugData> DebugData;
+    // Caches of threads whose backend can't share code, they still need to see blocks being invalidated
+    std::vector<std::shared_ptr<FEXCore::BlockCache>> PrivateBlockCaches;
+    /**  @} */
+
+    /**
+     * @name Guest code invalidation
+     *
+     * Every guest page a block was decoded from is tracked, and write protected while it has code on it
+     * The guest writing to, unmapping or reprotecting one of those pages throws out exactly the blocks decoded from it
+     * CodePages is guarded by CodeCacheMutex, mapping changes without code on them only hold it shared
+     * @{ */
+    std::unique_ptr<FEXCore::CodePageTracker> CodePages;
+
+    /**
+     * @brief Throws out every block decoded from guest code in [Start, Start + Length)
+     *
+     * Caller must hold CodeCacheMutex exclusively
+     */
+    void InvalidateGuestCodeRange(uint64_t Start, uint64_t Length);
+    /**  @} */
+
+    /**
+     * @name Translation cache
+     *
+     * Optimized IR from earlier runs of the application, loaded at startup and saved back on exit
+     * Blocks found in it skip the frontend and every pass but register allocation
+     * Guarded by CodeCacheMutex, except for lookups
+     * @{ */
+    std::unique_ptr<FEXCore::TranslationCache> Translations;
+    /**  @} */
+
+    /**
+     * @name Concurrent compilation
+     *
+     * Threads compile in parallel, each with its own frontend and pass pipeline
+     * A RIP that is being compiled for the shared cache is in CompileInFlight, other threads wanting it wait for it to be published
+     * @{ */
+    std::mutex CompileInFlightMutex;
+    std::condition_variable CompileInFlightCV;
+    std::set<uint64_t> CompileInFlight;
+    /**  @} */
+
+    /**
+     * @name Tiered compilation
+     *
+     * Guest threads compile a fast baseline tier whose blocks count their runs
+     * Blocks that reach Config.TierUpThreshold queue themselves to be recompiled with the full pass set on a background thread
+     * The new code atomically replaces the baseline block in the shared BlockCache
+     * @{ */
+    struct {
+      // Compilation state of the background compiler, never executes guest code
+      std::unique_ptr<FEXCore::Core::InternalThreadState> Thread;
+      std::thread Worker;
+      std::mutex QueueMutex;
+      std::condition_variable QueueCV;
+      std::deque<uint64_t> Queue;
+      std::set<uint64_t> Queued;
+      bool ShouldStop {false};
+    } TierUp;
+    /**  @} */
+
+    /**
+     * @name Block execution counts
+     *
+     * Blocks count their own runs in DebugData::RunCount, linked blocks never go back through the dispatcher
+     * Only baseline tier blocks count, the profile the next run precompiles from reuses their counts
+     * @{ */
+    bool CountBlockExecutions {false};
+
+    // Baseline tier blocks check their RunCount against Config.TierUpThreshold
+    bool IsBaselineTier(FEXCore::Core::InternalThreadState const *Thread) const {
+      return TierUp.Thread && Thread != TierUp.Thread.get();
+    }
+
+    // Called by a baseline tier block whose RunCount reached Config.TierUpThreshold
+    void QueueTierUp(uint64_t GuestRIP);
+    /**  @} */
+
+    /**
+     * @name Background precompilation
+     *
+     * Blocks the application ran last time are compiled by a pool of workers while the guest is already running, hottest first
+     * Guest threads compile whatever isn't ready yet themselves, or wait on the worker that is already compiling it
+     * @{ */
+    struct {
+      // Compilation state of each worker, never executes guest code
+      std::vector<std::unique_ptr<FEXCore::Core::InternalThreadState>> Threads;
+      std::vector<std::thread> Workers;
+      // [Begin, End) of guest memory the code loader mapped, nothing else is known to be mapped before the guest runs
+      std::vector<std::pair<uint64_t, uint64_t>> Regions;
+      std::vector<uint64_t> Queue;
+      std::atomic<size_t> Next {};
+      std::atomic_bool ShouldStop {false};
+    } Precompile;
+    /**  @} */
 
     FEXCore::CPUIDEmu CPUID;
     std::unique_ptr<FEXCore::SyscallHandler> SyscallHandler;
@@ -107,14 +233,14 @@ namespace FEXCore::Context {
     void CompileRIP(FEXCore::Core::InternalThreadState *Thread, uint64_t RIP);
     uint64_t GetThreadCount() const;
     FEXCore::Core::RuntimeStats *GetRuntimeStatsForThread(uint64_t Thread);
+    FEXCore::Core::CompileStats *GetCompileStatsForThread(uint64_t Thread);
     FEXCore::Core::CPUState GetCPUState();
     void GetMemoryRegions(std::vector<FEXCore::Memory::MemRegion> *Regions);
     bool GetDebugDataForRIP(uint64_t RIP, FEXCore::Core::DebugData *Data);
     bool FindHostCodeForRIP(uint64_t RIP, uint8_t **Code);
+    void GetCachedRIPs(std::vector<uint64_t> *RIPs);
 
-    // XXX:
-    // bool FindIRForRIP(uint64_t RIP, FEXCore::IR::IntrusiveIRList **ir);
-    // void SetIRForRIP(uint64_t RIP, FEXCore::IR::IntrusiveIRList *const ir);
+    bool FindIRForRIP(uint64_t RIP, FEXCore::IR::IRListView<true> **IR, FEXCore::Core::DebugData **Data);
     FEXCore::Core::ThreadState *GetThreadState();
     void LoadEntryList();
 
@@ -130,9 +256,7 @@ namespace FEXCore::Context {
     void RunThread(FEXCore::Core::InternalThreadState *Thread);
 
   protected:
-    IR::RegisterAllocationPass *GetRegisterAllocatorPass();
-    bool HasRegisterAllocationPass() const { return RAPass != nullptr; }
-    void ClearCodeCache(FEXCore::Core::InternalThreadState *Thread, uint64_t GuestRIP);
+    void ClearCodeCache(FEXCore::Core::InternalThreadState *Thread);
 
   private:
     void WaitForIdle();
@@ -142,19 +266,49 @@ namespace FEXCore::Context {
     void ExecutionThread(FEXCore::Core::InternalThreadState *Thread);
     void NotifyPause();
     void HandleExit(FEXCore::Core::InternalThreadState *Thread);
+    void DumpCompileStats();
+
+    uintptr_t CompileBlockInternal(FEXCore::Core::InternalThreadState *Thread, uint64_t GuestRIP, bool Reoptimize = false);
+    void InitializeCompileState(FEXCore::Core::InternalThreadState *Thread, bool Optimize);
+    uintptr_t AddBlockMapping(FEXCore::Core::InternalThreadState *Thread, uint64_t Address, void *Ptr, FEXCore::IR::IRListView<true> const *IR = nullptr);
+    FEXCore::CPU::CPUBackend *CreateCPUBackend(FEXCore::Core::InternalThreadState *Thread);
+    bool HasSharedBlockCache(FEXCore::Core::InternalThreadState *Thread) const { return Thread->BlockCache == BlockCache; }
+
+    // Code buffers and IR that other threads might still be executing from
+    // Freed once every thread's dispatcher has moved past the epoch they were retired in
+    void ReclaimRetiredBackends();
+    std::atomic<uint64_t> CodeCacheEpoch {};
+    std::vector<std::pair<uint64_t, std::unique_ptr<FEXCore::CPU::CPUBackend>>> RetiredBackends;
+    std::vector<std::pair<uint64_t, std::unique_ptr<FEXCore::IR::IRListView<true>>>> RetiredIR;
+
+    // Moving the epoch resets every thread's return stack, so only code getting thrown out does that
+    // IR replaced by compiling waits for the next move instead, forcing one once enough of it piled up
+    void RetireIR(std::unique_ptr<FEXCore::IR::IRListView<true>> IR);
+    uint64_t IRRetiredSinceEpoch{};
+
+    void StartTierUpCompiler();
+    void StopTierUpCompiler();
+    void TierUpCompilerThread();
+
+    void StartPrecompile();
+    void StopPrecompile();
+    void PrecompileThread(FEXCore::Core::InternalThreadState *Thread);
 
-    uintptr_t AddBlockMapping(FEXCore::Core::InternalThreadState *Thread, uint64_t Address, void *Ptr);
+    void InvalidateBlocks(std::set<uint64_t> const &Blocks);
+    void InvalidateWrittenCodePages();
 
     FEXCore::CodeLoader *LocalLoader{};
 
     // Entry Cache
     bool GetFilenameHash(std::string const &Filename, std::string &Hash);
-    void AddThreadRIPsToEntryList(FEXCore::Core::InternalThreadState *Thread);
+    // Device, inode, modification seconds, modification nanoseconds and size -> hash
+    std::map<std::tuple<uint64_t, uint64_t, uint64_t, uint64_t, uint64_t>, std::string> FilenameHashes;
+    void AddCachedRIPsToEntryList();
     void SaveEntryList();
-    std::set<uint64_t> EntryList;
+    // Entry RIP -> how often it ran, decayed across runs
+    std::map<uint64_t, uint64_t> EntryList;
     std::vector<uint64_t> InitLocations;
     uint64_t StartingRIP;
-    IR::RegisterAllocationPass *RAPass {};
     std::mutex ExitMutex;
     std::unique_ptr<GdbServer> DebugServer;
 
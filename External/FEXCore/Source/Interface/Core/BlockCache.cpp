@@ -1,34 +1,38 @@
 #include "Interface/Context/Context.h"
 #include "Interface/Core/Core.h"
 #include "Interface/Core/BlockCache.h"
+#include "Interface/Memory/HugePages.h"
 #include <sys/mman.h>
 
 namespace FEXCore {
 BlockCache::BlockCache(FEXCore::Context::Context *CTX)
   : ctx {CTX} {
 
-  // Block cache ends up looking like this
-  // PageMemoryMap[VirtualMemoryRegion >> 12]
-  //       |
-  //       v
-  // PageMemory[Memory & (VIRTUAL_PAGE_SIZE - 1)]
-  //       |
-  //       v
-  // Pointer to Code
-  //
   // Allocate a region of memory that we can use to back our block pointers
   // We need one pointer per page of virtual memory
   // At 64GB of virtual memory this will allocate 128MB of virtual memory space
   PagePointer = reinterpret_cast<uintptr_t>(mmap(nullptr, ctx->Config.VirtualMemSize / 4096 * 8, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
 
-  // Allocate our memory backing our pages
-  // We need 32KB per guest page (One pointer per byte)
-  // XXX: We can drop down to 16KB if we store 4byte offsets from the code base
-  // We currently limit to 128MB of real memory for caching for the total cache size.
-  // Can end up being inefficient if we compile a small number of blocks per page
-  PageMemory = reinterpret_cast<uintptr_t>(mmap(nullptr, CODE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+  // Allocate our memory backing the per page tables
+  // Only what gets touched is backed, a page with a few blocks on it costs a couple of cache lines
+  PageMemory = reinterpret_cast<uintptr_t>(mmap(nullptr, CODE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0));
   LogMan::Throw::A(PageMemory != -1ULL, "Failed to allocate page memory");
 
+  if (ctx->Config.HugePages) {
+    // Both tables are sparse, hugetlb would reserve all of it up front
+    FEXCore::Memory::AdviseHugePages(reinterpret_cast<void*>(PagePointer), ctx->Config.VirtualMemSize / 4096 * 8);
+    FEXCore::Memory::AdviseHugePages(reinterpret_cast<void*>(PageMemory), CODE_SIZE);
+  }
+
+  static_assert(CLASS_SHARE[0] + CLASS_SHARE[1] + CLASS_SHARE[2] + CLASS_SHARE[3] == 16, "Size classes need to cover the pool");
+  uintptr_t ClassBase = PageMemory;
+  for (size_t i = 0; i < NUM_CLASSES; ++i) {
+    size_t ClassSize = CODE_SIZE / 16 * CLASS_SHARE[i];
+    Classes[i].Base = ClassBase;
+    Classes[i].Count = ClassSize / ClassStride(i);
+    ClassBase += ClassSize;
+  }
+
   MemoryBase = ctx->MemoryMapper.GetBaseOffset<uintptr_t>(0);
   VirtualMemSize = ctx->Config.VirtualMemSize;
 }
@@ -46,12 +50,309 @@ void BlockCache::HintUsedRange(uint64_t Address, uint64_t Size) {
   madvise(reinterpret_cast<void*>(PagePointer + Address), Size, MADV_WILLNEED);
 }
 
+void BlockCache::BeginWrite(PageBlocks *Page) {
+  // Readers that overlap with the write see the version change and miss
+  Page->Version.store(NextVersion, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+void BlockCache::EndWrite(PageBlocks *Page) {
+  uint32_t Version = NextVersion + 1;
+  NextVersion += 2;
+  // Zero is what a table that was never written looks like
+  Page->Version.store(Version ? Version : 2, std::memory_order_release);
+}
+
+BlockCache::PageBlocks *BlockCache::AllocatePage(size_t Class, uint64_t PageIndex, uint64_t GuestPage) {
+  auto &SC = Classes[Class];
+  PageBlocks *Page {};
+  if (SC.Free.empty() && SC.Allocated < SC.Count) {
+    Page = reinterpret_cast<PageBlocks*>(SC.Base + SC.Allocated * ClassStride(Class));
+    ++SC.Allocated;
+  }
+  else {
+    if (SC.Free.empty() && !EvictPage(Class, PageIndex)) {
+      return nullptr;
+    }
+    Page = SC.Free.back();
+    SC.Free.pop_back();
+  }
+
+  // Left in the written state, the caller fills it in before ending the write
+  BeginWrite(Page);
+  Page->Mask.store(CLASS_ENTRIES[Class] - 1, std::memory_order_relaxed);
+  Page->GuestPage.store(GuestPage, std::memory_order_relaxed);
+  // New tables get a full trip around the clock before they can be evicted
+  Page->Referenced.store(1, std::memory_order_relaxed);
+  Page->Class = Class;
+  Page->Used = 0;
+  Page->Live = 0;
+
+  auto Entries = Page->Entries();
+  for (size_t i = 0; i < CLASS_ENTRIES[Class]; ++i) {
+    Entries[i].store(0, std::memory_order_relaxed);
+  }
+
+  Page->ClockIndex = SC.Pages.size();
+  SC.Pages.emplace_back(PageIndex);
+  return Page;
+}
+
+void BlockCache::FreePage(PageBlocks *Page) {
+  // Stays odd while it is free, so lookups still holding on to it miss
+  Page->Version.store(NextVersion, std::memory_order_release);
+  NextVersion += 2;
+
+  auto &SC = Classes[Page->Class];
+  uint32_t ClockIndex = Page->ClockIndex;
+  uint64_t MovedPageIndex = SC.Pages.back();
+  SC.Pages[ClockIndex] = MovedPageIndex;
+  SC.Pages.pop_back();
+  if (ClockIndex < SC.Pages.size()) {
+    auto Pointers = reinterpret_cast<std::atomic<PageBlocks*>*>(PagePointer);
+    Pointers[MovedPageIndex].load(std::memory_order_relaxed)->ClockIndex = ClockIndex;
+  }
+
+  SC.Free.emplace_back(Page);
+}
+
+bool BlockCache::EvictPage(size_t Class, uint64_t KeepPageIndex) {
+  auto &SC = Classes[Class];
+  auto Pointers = reinterpret_cast<std::atomic<PageBlocks*>*>(PagePointer);
+
+  // Second trip around the clock finds the pages the first one cleared
+  for (size_t Step = 0; Step < SC.Pages.size() * 2; ++Step) {
+    if (SC.ClockHand >= SC.Pages.size()) {
+      SC.ClockHand = 0;
+    }
+
+    uint64_t PageIndex = SC.Pages[SC.ClockHand];
+    auto Page = Pointers[PageIndex].load(std::memory_order_relaxed);
+    if (PageIndex == KeepPageIndex || Page->Referenced.exchange(0, std::memory_order_relaxed)) {
+      ++SC.ClockHand;
+      continue;
+    }
+
+    // Only the lookups go away. The code stays valid and anything linked to it keeps working
+    // The JIT doesn't keep IR around, so a block that runs through the dispatcher again gets decoded and compiled again
+    Pointers[PageIndex].store(nullptr, std::memory_order_release);
+    FreePage(Page);
+    return true;
+  }
+
+  return false;
+}
+
+BlockCache::PageBlocks *BlockCache::GrowPage(uint64_t PageIndex, PageBlocks *Page) {
+  // Erased blocks get dropped on the way, so this can end up in the same class
+  size_t Class = 0;
+  while (Class + 1 < NUM_CLASSES && (Page->Live + 1) * 2 > CLASS_ENTRIES[Class]) {
+    ++Class;
+  }
+
+  auto NewPage = AllocatePage(Class, PageIndex, Page->GuestPage.load(std::memory_order_relaxed));
+  if (!NewPage) {
+    return nullptr;
+  }
+
+  auto Entries = Page->Entries();
+  auto NewEntries = NewPage->Entries();
+  uint32_t Mask = Page->Mask.load(std::memory_order_relaxed);
+  uint32_t NewMask = NewPage->Mask.load(std::memory_order_relaxed);
+  for (uint32_t i = 0; i <= Mask; ++i) {
+    uint64_t Entry = Entries[i].load(std::memory_order_relaxed);
+    if (!(Entry >> ENTRY_KEY_BITS)) {
+      continue;
+    }
+
+    uint32_t Index = HashOffset((Entry & ENTRY_KEY_MASK) - 1, NewMask);
+    while (NewEntries[Index].load(std::memory_order_relaxed)) {
+      Index = (Index + 1) & NewMask;
+    }
+    NewEntries[Index].store(Entry, std::memory_order_relaxed);
+    ++NewPage->Used;
+    ++NewPage->Live;
+  }
+
+  NewPage->Referenced.store(Page->Referenced.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  EndWrite(NewPage);
+
+  auto Pointers = reinterpret_cast<std::atomic<PageBlocks*>*>(PagePointer);
+  Pointers[PageIndex].store(NewPage, std::memory_order_release);
+  FreePage(Page);
+  return NewPage;
+}
+
+uintptr_t BlockCache::AddBlockMapping(uint64_t Address, void *Ptr) {
+  uint64_t FullPage = Address & ~PAGE_MASK;
+  uint64_t PageOffset = Address & PAGE_MASK;
+  uint64_t PageIndex = (Address & (VirtualMemSize - 1)) >> PAGE_SHIFT;
+
+  uintptr_t CastPtr = reinterpret_cast<uintptr_t>(Ptr);
+  LogMan::Throw::A((CastPtr >> (64 - ENTRY_KEY_BITS)) == 0, "Host code pointer doesn't fit in a block cache entry");
+  uint64_t Key = PageOffset + 1;
+  uint64_t NewEntry = (CastPtr << ENTRY_KEY_BITS) | Key;
+
+  auto Pointers = reinterpret_cast<std::atomic<PageBlocks*>*>(PagePointer);
+  PageBlocks *Page = Pointers[PageIndex].load(std::memory_order_relaxed);
+  if (Page && Page->GuestPage.load(std::memory_order_relaxed) != FullPage) {
+    // A different guest page with the same page pointer, the newer one wins
+    Pointers[PageIndex].store(nullptr, std::memory_order_release);
+    FreePage(Page);
+    Page = nullptr;
+  }
+
+  if (!Page) {
+    Page = AllocatePage(0, PageIndex, FullPage);
+    if (!Page) {
+      // Couldn't allocate, return so the frontend can recover from this
+      return 0;
+    }
+    EndWrite(Page);
+    Pointers[PageIndex].store(Page, std::memory_order_release);
+  }
+
+  // Look for the block, remembering the first slot it could go in
+  auto Entries = Page->Entries();
+  uint32_t Mask = Page->Mask.load(std::memory_order_relaxed);
+  std::atomic<uint64_t> *Slot {};
+  bool SlotIsEmpty {};
+  for (uint32_t Index = HashOffset(PageOffset, Mask), Probes = 0; Probes <= Mask; Index = (Index + 1) & Mask, ++Probes) {
+    uint64_t Entry = Entries[Index].load(std::memory_order_relaxed);
+    if (Entry == 0) {
+      if (!Slot) {
+        Slot = &Entries[Index];
+        SlotIsEmpty = true;
+      }
+      break;
+    }
+
+    if ((Entry & ENTRY_KEY_MASK) == Key) {
+      Entries[Index].store(NewEntry, std::memory_order_release);
+      if (Entry >> ENTRY_KEY_BITS) {
+        // Same block being recompiled, swapped in one store so lookups never miss
+        // Linked blocks pick up the new code the next time they go through their link stub
+        UnlinkBlocks(Address);
+      }
+      else {
+        ++Page->Live;
+      }
+      return CastPtr;
+    }
+
+    if (!Slot && !(Entry >> ENTRY_KEY_BITS)) {
+      // Erased block, can be reused by anything
+      Slot = &Entries[Index];
+    }
+  }
+
+  if (!Slot || (SlotIsEmpty && (Page->Used + 1) * 2 > Mask + 1)) {
+    // Keep probes short
+    if (!GrowPage(PageIndex, Page)) {
+      return 0;
+    }
+    return AddBlockMapping(Address, Ptr);
+  }
+
+  Slot->store(NewEntry, std::memory_order_release);
+  if (SlotIsEmpty) {
+    ++Page->Used;
+  }
+  ++Page->Live;
+  return CastPtr;
+}
+
+void BlockCache::Erase(uint64_t Address) {
+  // Blocks that jump straight to this one have to go back through the dispatcher
+  UnlinkBlocks(Address);
+
+  uint64_t PageOffset = Address & PAGE_MASK;
+  uint64_t PageIndex = (Address & (VirtualMemSize - 1)) >> PAGE_SHIFT;
+
+  auto Pointers = reinterpret_cast<std::atomic<PageBlocks*>*>(PagePointer);
+  PageBlocks *Page = Pointers[PageIndex].load(std::memory_order_relaxed);
+  if (!Page || Page->GuestPage.load(std::memory_order_relaxed) != (Address & ~PAGE_MASK)) {
+    // Page for this code didn't even exist, nothing to do
+    return;
+  }
+
+  auto Entries = Page->Entries();
+  uint32_t Mask = Page->Mask.load(std::memory_order_relaxed);
+  uint64_t Key = PageOffset + 1;
+  for (uint32_t Index = HashOffset(PageOffset, Mask), Probes = 0; Probes <= Mask; Index = (Index + 1) & Mask, ++Probes) {
+    uint64_t Entry = Entries[Index].load(std::memory_order_relaxed);
+    if (Entry == 0) {
+      return;
+    }
+
+    if ((Entry & ENTRY_KEY_MASK) == Key) {
+      if (Entry >> ENTRY_KEY_BITS) {
+        // Keeps the key so probes for other blocks still go past it
+        Entries[Index].store(Key, std::memory_order_release);
+        --Page->Live;
+      }
+      return;
+    }
+  }
+}
+
+void BlockCache::EvictCodeRange(uintptr_t Begin, uintptr_t End) {
+  // Links patched in to the range go away with the code, unlinking them later would write to freed memory
+  for (auto Link = BlockLinks.begin(); Link != BlockLinks.end();) {
+    if (Link->first.second >= Begin && Link->first.second < End) {
+      Link = BlockLinks.erase(Link);
+    }
+    else {
+      ++Link;
+    }
+  }
+
+  // Code in the range is still running on other threads, it must not add new links
+  ++Generation;
+
+  auto Pointers = reinterpret_cast<std::atomic<PageBlocks*>*>(PagePointer);
+  for (auto &SC : Classes) {
+    for (uint64_t PageIndex : SC.Pages) {
+      auto Page = Pointers[PageIndex].load(std::memory_order_relaxed);
+      uint64_t GuestPage = Page->GuestPage.load(std::memory_order_relaxed);
+      auto Entries = Page->Entries();
+      uint32_t Mask = Page->Mask.load(std::memory_order_relaxed);
+      for (uint32_t i = 0; i <= Mask; ++i) {
+        uint64_t Entry = Entries[i].load(std::memory_order_relaxed);
+        uintptr_t HostCode = Entry >> ENTRY_KEY_BITS;
+        if (HostCode < Begin || HostCode >= End) {
+          continue;
+        }
+
+        // Blocks in other code buffers that jump straight to this one have to go back through the dispatcher
+        UnlinkBlocks(GuestPage + (Entry & ENTRY_KEY_MASK) - 1);
+
+        // Keeps the key so probes for other blocks still go past it
+        Entries[i].store(Entry & ENTRY_KEY_MASK, std::memory_order_release);
+        --Page->Live;
+      }
+    }
+  }
+}
+
 void BlockCache::ClearCache() {
+  // Nothing may jump straight in to code that is about to be thrown away
+  for (auto &Link : BlockLinks) {
+    Link.second();
+  }
+  BlockLinks.clear();
+  ++Generation;
+
   // Clear out the page memory
+  // Tables read back as zero, which lookups treat as never written
   madvise(reinterpret_cast<void*>(PagePointer), ctx->Config.VirtualMemSize / 4096 * 8, MADV_DONTNEED);
   madvise(reinterpret_cast<void*>(PageMemory), CODE_SIZE, MADV_DONTNEED);
-  AllocateOffset = 0;
+  for (auto &SC : Classes) {
+    SC.Allocated = 0;
+    SC.Free.clear();
+    SC.Pages.clear();
+    SC.ClockHand = 0;
+  }
 }
 
 }
-
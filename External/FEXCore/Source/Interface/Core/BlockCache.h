@@ -2,15 +2,18 @@
 #include "Interface/Context/Context.h"
 #include "LogManager.h"
 
+#include <array>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <utility>
+#include <vector>
+
 namespace FEXCore {
+// Lookups through the block cache don't take any locks so the cache can be shared between threads.
+// Anything that modifies the cache must be serialized by the owner.
 class BlockCache {
 public:
-
-  struct BlockCacheEntry { 
-    uintptr_t HostCode;
-    uintptr_t GuestCode;
-  };
-
   BlockCache(FEXCore::Context::Context *CTX);
   ~BlockCache();
 
@@ -21,105 +24,189 @@ public:
     return FindCodePointerForAddress(Address);
   }
 
-  void Erase(uint64_t Address) {
-    Address = Address & (VirtualMemSize -1);
+  void Erase(uint64_t Address);
 
-    uint64_t PageOffset = Address & (0x0FFF);
-    Address >>= 12;
+  /**
+   * @brief Maps the guest Address to the host code at Ptr
+   *
+   * Replaces an existing mapping for the address. Least recently used pages of blocks get evicted to make room
+   * Returns 0 if there was no room at all, the owner needs to clear the cache then
+   */
+  uintptr_t AddBlockMapping(uint64_t Address, void *Ptr);
 
-    uintptr_t *Pointers = reinterpret_cast<uintptr_t*>(PagePointer);
-    uint64_t LocalPagePointer = Pointers[Address];
-    if (!LocalPagePointer) {
-      // Page for this code didn't even exist, nothing to do
-      return;
-    }
+  void ClearCache();
 
-    // Page exists, just set the offset to zero
-    auto BlockPointers = reinterpret_cast<BlockCacheEntry*>(LocalPagePointer);
-    BlockPointers[PageOffset].GuestCode = 0;
-    BlockPointers[PageOffset].HostCode = 0;
+  /**
+   * @brief Evicts every block whose host code is in [Begin, End), for when the code buffer holding it gets retired
+   *
+   * Blocks compiled in to other code buffers stay mapped
+   */
+  void EvictCodeRange(uintptr_t Begin, uintptr_t End);
+
+  /**
+   * @brief Records a direct jump from one block's code to the block at GuestDestination
+   *
+   * HostLink identifies what was patched, linking the same thing again replaces the old record
+   * Unlink is called to restore the jump to its slow path when the destination goes away
+   * Links are only recorded while the Generation they were compiled under is still current
+   */
+  void AddBlockLink(uint64_t GuestDestination, uintptr_t HostLink, std::function<void()> Unlink) {
+    BlockLinks.insert_or_assign(BlockLinkTag{GuestDestination, HostLink}, std::move(Unlink));
   }
 
-  uintptr_t AddBlockMapping(uint64_t Address, void *Ptr) { 
-    auto FullAddress = Address;
-    Address = Address & (VirtualMemSize -1);
-
-    uint64_t PageOffset = Address & (0x0FFF);
-    Address >>= 12;
-    uintptr_t *Pointers = reinterpret_cast<uintptr_t*>(PagePointer);
-    uint64_t LocalPagePointer = Pointers[Address];
-    if (!LocalPagePointer) {
-      // We don't have a page pointer for this address
-      // Allocate one now if we can
-      uintptr_t NewPageBacking = AllocateBackingForPage();
-      if (!NewPageBacking) {
-        // Couldn't allocate, return so the frontend can recover from this
-        return 0;
-      }
-      Pointers[Address] = NewPageBacking;
-      LocalPagePointer = NewPageBacking;
-    }
-
-    // Add the new pointer to the page block
-    auto BlockPointers = reinterpret_cast<BlockCacheEntry*>(LocalPagePointer);
-    uintptr_t CastPtr = reinterpret_cast<uintptr_t>(Ptr);
-
-    // This silently replaces existing mappings
-    BlockPointers[PageOffset].GuestCode = FullAddress;
-    BlockPointers[PageOffset].HostCode = CastPtr;
-
-    return CastPtr;
+  /**
+   * @brief Forgets a link without calling its unlink function, for when the patched location got reused
+   */
+  void RemoveBlockLink(uint64_t GuestDestination, uintptr_t HostLink) {
+    BlockLinks.erase(BlockLinkTag{GuestDestination, HostLink});
   }
 
-  void ClearCache();
+  /**
+   * @brief Bumped every time the cache is cleared or a code buffer's blocks are evicted
+   *
+   * Code compiled under an older generation might be in a retired code buffer, so it must not link itself to anything
+   */
+  uint64_t GetGeneration() const { return Generation.load(); }
 
   void HintUsedRange(uint64_t Address, uint64_t Size);
 
   uintptr_t GetPagePointer() { return PagePointer; }
 
 private:
-  uintptr_t AllocateBackingForPage() {
-    uintptr_t NewBase = AllocateOffset;
-    uintptr_t NewEnd = AllocateOffset + SIZE_PER_PAGE;
+  // Block cache ends up looking like this
+  // PagePointer[VirtualMemoryRegion >> 12]
+  //       |
+  //       v
+  // PageBlocks: small open addressed table of the blocks on that guest page
+  //       |
+  //       v
+  // Page offset and host code packed in to one 64bit entry
+  //
+  // Tables start small and move to a larger size class as the page fills up
+  // Every size class has a fixed region of the pool, so a table's header is always at the same place even after it was reused
+  // Readers validate what they read against the table's version, like a seqlock
+  struct PageBlocks {
+    // Odd while the table is free or being rewritten
+    std::atomic<uint32_t> Version;
+    std::atomic<uint32_t> Mask;
+    std::atomic<uint64_t> GuestPage;
+    // Set by lookups, cleared by the eviction clock
+    std::atomic<uint8_t> Referenced;
+    uint8_t Class;
+    // Owner only
+    uint32_t Used;
+    uint32_t Live;
+    uint32_t ClockIndex;
+
+    std::atomic<uint64_t> *Entries() { return reinterpret_cast<std::atomic<uint64_t>*>(this + 1); }
+  };
+  static_assert(sizeof(PageBlocks) == 32, "Entries are expected to start half way through a cache line");
 
-    if (NewEnd >= CODE_SIZE) {
-      // We ran out of block backing space. Need to clear the block cache and tell the JIT cores to clear their caches as well
-      // Tell whatever is calling this that it needs to do it.
-      return 0;
-    }
+  constexpr static uint64_t PAGE_SHIFT = 12;
+  constexpr static uint64_t PAGE_MASK = (1ULL << PAGE_SHIFT) - 1;
+
+  // Low bits of an entry are the page offset + 1, the rest is the host code
+  // A zero entry ends a probe. An entry with no host code is an erased block and the probe continues past it
+  constexpr static uint64_t ENTRY_KEY_BITS = 16;
+  constexpr static uint64_t ENTRY_KEY_MASK = (1ULL << ENTRY_KEY_BITS) - 1;
 
-    AllocateOffset = NewEnd;
-    return PageMemory + NewBase;
+  constexpr static size_t CODE_SIZE = 128 * 1024 * 1024;
+  constexpr static size_t NUM_CLASSES = 4;
+  // Largest class fits every offset of a page with the table half full
+  constexpr static std::array<uint32_t, NUM_CLASSES> CLASS_ENTRIES = {16, 128, 1024, 8192};
+  // Share of CODE_SIZE in 1/16ths, most pages only have a handful of blocks
+  constexpr static std::array<size_t, NUM_CLASSES> CLASS_SHARE = {2, 4, 5, 5};
+
+  static constexpr size_t ClassStride(size_t Class) {
+    return (sizeof(PageBlocks) + CLASS_ENTRIES[Class] * sizeof(uint64_t) + 63) & ~size_t(63);
   }
 
+  static uint32_t HashOffset(uint64_t PageOffset, uint32_t Mask) {
+    return static_cast<uint32_t>((PageOffset * 0x9E3779B1ULL) >> 16) & Mask;
+  }
+
+  struct SizeClass {
+    uintptr_t Base;
+    size_t Count;
+    size_t Allocated;
+    std::vector<PageBlocks*> Free;
+    // Page indices of the tables in this class, in clock order
+    std::vector<uint64_t> Pages;
+    size_t ClockHand;
+  };
+
+  void UnlinkBlocks(uint64_t GuestDestination) {
+    auto Begin = BlockLinks.lower_bound(BlockLinkTag{GuestDestination, 0});
+    auto End = Begin;
+    for (; End != BlockLinks.end() && End->first.first == GuestDestination; ++End) {
+      End->second();
+    }
+    BlockLinks.erase(Begin, End);
+  }
+
+  PageBlocks *AllocatePage(size_t Class, uint64_t PageIndex, uint64_t GuestPage);
+  // Only takes the table off its class's clock, the caller has to clear the page pointer
+  void FreePage(PageBlocks *Page);
+  bool EvictPage(size_t Class, uint64_t KeepPageIndex);
+  PageBlocks *GrowPage(uint64_t PageIndex, PageBlocks *Page);
+  void BeginWrite(PageBlocks *Page);
+  void EndWrite(PageBlocks *Page);
+
   uintptr_t FindCodePointerForAddress(uint64_t Address) {
-    auto FullAddress = Address;
-    Address = Address & (VirtualMemSize -1);
-
-    uint64_t PageOffset = Address & (0x0FFF);
-    Address >>= 12;
-    uintptr_t *Pointers = reinterpret_cast<uintptr_t*>(PagePointer);
-    uint64_t LocalPagePointer = Pointers[Address];
-    if (!LocalPagePointer) {
+    uint64_t FullPage = Address & ~PAGE_MASK;
+    uint64_t PageOffset = Address & PAGE_MASK;
+    uint64_t PageIndex = (Address & (VirtualMemSize - 1)) >> PAGE_SHIFT;
+
+    auto Pointers = reinterpret_cast<std::atomic<PageBlocks*>*>(PagePointer);
+    PageBlocks *Page = Pointers[PageIndex].load(std::memory_order_acquire);
+    if (!Page) {
       // We don't have a page pointer for this address
       return 0;
     }
 
-    // Find there pointer for the address in the blocks
-    auto BlockPointers = reinterpret_cast<BlockCacheEntry*>(LocalPagePointer);
+    uint32_t Version = Page->Version.load(std::memory_order_acquire);
+    if ((Version & 1) || Version == 0 ||
+        Page->GuestPage.load(std::memory_order_relaxed) != FullPage) {
+      return 0;
+    }
 
-    if (BlockPointers[PageOffset].GuestCode == FullAddress)
-      return BlockPointers[PageOffset].HostCode;
-    else
+    auto Entries = Page->Entries();
+    uint32_t Mask = Page->Mask.load(std::memory_order_relaxed);
+    uint64_t Key = PageOffset + 1;
+    uintptr_t HostCode {};
+    for (uint32_t Index = HashOffset(PageOffset, Mask), Probes = 0; Probes <= Mask; Index = (Index + 1) & Mask, ++Probes) {
+      uint64_t Entry = Entries[Index].load(std::memory_order_acquire);
+      if (Entry == 0) {
+        break;
+      }
+      if ((Entry & ENTRY_KEY_MASK) == Key) {
+        HostCode = Entry >> ENTRY_KEY_BITS;
+        break;
+      }
+    }
+
+    // The table was rewritten or reused underneath us, treat it as a miss
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (Page->Version.load(std::memory_order_relaxed) != Version) {
       return 0;
+    }
+
+    if (HostCode && !Page->Referenced.load(std::memory_order_relaxed)) {
+      Page->Referenced.store(1, std::memory_order_relaxed);
+    }
+    return HostCode;
   }
 
   uintptr_t PagePointer;
   uintptr_t PageMemory;
-
-  constexpr static size_t CODE_SIZE = 128 * 1024 * 1024;
-  constexpr static size_t SIZE_PER_PAGE = 4096 * sizeof(BlockCacheEntry);
-  size_t AllocateOffset {};
+  std::array<SizeClass, NUM_CLASSES> Classes{};
+  // Never reset so a table that got reused can't end up with the version a reader saw before
+  uint32_t NextVersion {1};
+
+  // Guest destination and the host location that was patched
+  using BlockLinkTag = std::pair<uint64_t, uintptr_t>;
+  std::map<BlockLinkTag, std::function<void()>> BlockLinks;
+  std::atomic<uint64_t> Generation {};
 
   FEXCore::Context::Context *ctx;
   uintptr_t MemoryBase{};
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+// Host implementations of the MemCpy/MemSet/MemCmp IR ops, shared by the backends that don't emit them inline
+// Pointers are host pointers to the first element, Backward walks down from there like x86 with DF set
+namespace FEXCore::CPU {
+
+// REP MOVS semantics, one element at a time
+// Only a destination that overlaps the part of the source that hasn't been read yet needs the element loop, everything else is a memmove
+inline void BulkCopy(uint8_t *Dest, uint8_t const *Src, uint64_t Count, uint8_t Size, bool Backward) {
+  if (Count == 0) {
+    return;
+  }
+
+  uint64_t Bytes = Count * Size;
+  if (!Backward) {
+    if (Dest <= Src || Dest >= Src + Bytes) {
+      memmove(Dest, Src, Bytes);
+      return;
+    }
+
+    for (uint64_t i = 0; i < Count; ++i) {
+      memmove(Dest + i * Size, Src + i * Size, Size);
+    }
+  }
+  else {
+    uint8_t *DestStart = Dest - (Bytes - Size);
+    uint8_t const *SrcStart = Src - (Bytes - Size);
+    if (Dest >= Src || Dest + Size <= SrcStart) {
+      memmove(DestStart, SrcStart, Bytes);
+      return;
+    }
+
+    for (uint64_t i = 0; i < Count; ++i) {
+      memmove(Dest - i * Size, Src - i * Size, Size);
+    }
+  }
+}
+
+inline void BulkFill(uint8_t *Dest, uint64_t Value, uint64_t Count, uint8_t Size, bool Backward) {
+  if (Count == 0) {
+    return;
+  }
+
+  // Every element is the same, so only where the fill starts depends on the direction
+  if (Backward) {
+    Dest -= (Count - 1) * Size;
+  }
+
+  if (Size == 1) {
+    memset(Dest, Value, Count);
+    return;
+  }
+
+  for (uint64_t i = 0; i < Count; ++i) {
+    memcpy(Dest + i * Size, &Value, Size);
+  }
+}
+
+// Returns how many elements were compared, the last one is the one that ended the repeat
+inline uint64_t BulkCompare(uint8_t const *Src1, uint8_t const *Src2, uint64_t Count, uint8_t Size, bool Backward, bool WhileEqual) {
+  int64_t Step = Backward ? -static_cast<int64_t>(Size) : Size;
+  for (uint64_t i = 0; i < Count; ++i) {
+    bool Equal = memcmp(Src1 + i * Step, Src2 + i * Step, Size) == 0;
+    if (Equal != WhileEqual) {
+      return i + 1;
+    }
+  }
+  return Count;
+}
+}
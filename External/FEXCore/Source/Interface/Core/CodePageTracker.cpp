@@ -0,0 +1,329 @@
+#include "Interface/Core/CodePageTracker.h"
+#include "LogManager.h"
+
+#include <algorithm>
+#include <signal.h>
+#include <sys/mman.h>
+
+namespace FEXCore {
+namespace {
+  // There is only one set of signal handlers per process
+  CodePageTracker *ActiveTracker{};
+  struct sigaction OldSigAction_SEGV{};
+
+  void SigAction_SEGV(int sig, siginfo_t *info, void *RawContext) {
+    if (info->si_code == SEGV_ACCERR &&
+        ActiveTracker &&
+        ActiveTracker->HandleWriteFault(reinterpret_cast<uint64_t>(info->si_addr))) {
+      // The page is writable now, returning retries the write
+      return;
+    }
+
+    // Not ours, hand it to whoever was installed before us
+    if (OldSigAction_SEGV.sa_flags & SA_SIGINFO) {
+      OldSigAction_SEGV.sa_sigaction(sig, info, RawContext);
+    }
+    else if (OldSigAction_SEGV.sa_handler == SIG_DFL || OldSigAction_SEGV.sa_handler == SIG_IGN) {
+      // Returning executes the access again which faults with the default behaviour
+      sigaction(SIGSEGV, &OldSigAction_SEGV, nullptr);
+    }
+    else {
+      OldSigAction_SEGV.sa_handler(sig);
+    }
+  }
+}
+
+CodePageTracker::CodePageTracker(bool ProtectPages)
+  : ProtectPages {ProtectPages} {
+  if (!ProtectPages) {
+    return;
+  }
+
+  if (ActiveTracker) {
+    LogMan::Msg::I("Guest code pages are already being tracked. Self modifying code won't be caught");
+    this->ProtectPages = false;
+    return;
+  }
+
+  // Only touched parts of this get backed
+  void *Directory = mmap(nullptr, STATE_DIRECTORY_SIZE * sizeof(uintptr_t), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (Directory == MAP_FAILED) {
+    LogMan::Msg::E("Couldn't allocate code page states. Self modifying code won't be caught");
+    this->ProtectPages = false;
+    return;
+  }
+  StateDirectory = reinterpret_cast<std::atomic<std::atomic<uint8_t>*>*>(Directory);
+
+  ActiveTracker = this;
+
+  struct sigaction sa{};
+  sa.sa_sigaction = &SigAction_SEGV;
+  sa.sa_flags = SA_SIGINFO;
+  sigemptyset(&sa.sa_mask);
+  sigaction(SIGSEGV, &sa, &OldSigAction_SEGV);
+}
+
+CodePageTracker::~CodePageTracker() {
+  if (!ProtectPages) {
+    return;
+  }
+
+  // Leave guest memory the way the guest asked for it
+  for (auto &Page : PageBlocks) {
+    UnprotectPage(Page.first);
+  }
+
+  sigaction(SIGSEGV, &OldSigAction_SEGV, nullptr);
+  ActiveTracker = nullptr;
+
+  for (size_t i = 0; i < STATE_DIRECTORY_SIZE; ++i) {
+    if (auto Table = StateDirectory[i].load(std::memory_order_relaxed)) {
+      munmap(Table, STATE_TABLE_SIZE);
+    }
+  }
+  munmap(StateDirectory, STATE_DIRECTORY_SIZE * sizeof(uintptr_t));
+}
+
+std::atomic<uint8_t> *CodePageTracker::GetPageState(uint64_t Page, bool Allocate) {
+  uint64_t PageIndex = Page >> PAGE_SHIFT;
+  uint64_t DirectoryIndex = PageIndex >> STATE_TABLE_BITS;
+  if (!StateDirectory || DirectoryIndex >= STATE_DIRECTORY_SIZE) {
+    return nullptr;
+  }
+
+  auto Table = StateDirectory[DirectoryIndex].load(std::memory_order_acquire);
+  if (!Table) {
+    if (!Allocate) {
+      return nullptr;
+    }
+
+    void *NewTable = mmap(nullptr, STATE_TABLE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (NewTable == MAP_FAILED) {
+      return nullptr;
+    }
+    Table = reinterpret_cast<std::atomic<uint8_t>*>(NewTable);
+    StateDirectory[DirectoryIndex].store(Table, std::memory_order_release);
+  }
+
+  return &Table[PageIndex & (STATE_TABLE_SIZE - 1)];
+}
+
+void CodePageTracker::ProtectPage(uint64_t Page) {
+  if (!ProtectPages) {
+    return;
+  }
+
+  int Prot = GetGuestProtection(Page);
+  if (!(Prot & PROT_WRITE)) {
+    // The guest can't write to it in the first place
+    return;
+  }
+
+  auto State = GetPageState(Page, true);
+  if (!State) {
+    return;
+  }
+
+  uint8_t Value = State->load();
+  if ((Value & STATE_MASK) == STATE_UNPROTECTING) {
+    // A write is being let through right now, the page gets caught the next time code is compiled from it
+    return;
+  }
+
+  // Published before the protection change so a fault can never see a page we protected without knowing about it
+  State->store(STATE_PROTECTED | (Prot & STATE_PROT_MASK));
+  if (::mprotect(reinterpret_cast<void*>(Page), PAGE_SIZE, Prot & ~PROT_WRITE) != 0) {
+    State->store(STATE_NONE);
+  }
+}
+
+void CodePageTracker::UnprotectPage(uint64_t Page) {
+  if (!ProtectPages) {
+    return;
+  }
+
+  auto State = GetPageState(Page, false);
+  if (!State) {
+    return;
+  }
+
+  uint8_t Value = State->load();
+  while (true) {
+    switch (Value & STATE_MASK) {
+      case STATE_PROTECTED:
+        // Writes racing with us spin on the fault handler until the page is writable again
+        if (State->compare_exchange_weak(Value, (Value & STATE_PROT_MASK) | STATE_UNPROTECTING)) {
+          ::mprotect(reinterpret_cast<void*>(Page), PAGE_SIZE, Value & STATE_PROT_MASK);
+          State->store(STATE_NONE);
+          return;
+        }
+        break;
+      case STATE_UNPROTECTING:
+        // Fault handler is restoring it, it is only a syscall away from being dirty
+        Value = State->load();
+        break;
+      case STATE_DIRTY:
+        State->store(STATE_NONE);
+        return;
+      default:
+        return;
+    }
+  }
+}
+
+bool CodePageTracker::HandleWriteFault(uint64_t Address) {
+  // Runs in a signal handler. No allocations and no locks
+  uint64_t Page = Address & ~PAGE_MASK;
+  auto State = GetPageState(Page, false);
+  if (!State) {
+    return false;
+  }
+
+  uint8_t Value = State->load();
+  while (true) {
+    switch (Value & STATE_MASK) {
+      case STATE_PROTECTED:
+        if (State->compare_exchange_weak(Value, (Value & STATE_PROT_MASK) | STATE_UNPROTECTING)) {
+          ::mprotect(reinterpret_cast<void*>(Page), PAGE_SIZE, Value & STATE_PROT_MASK);
+          State->store((Value & STATE_PROT_MASK) | STATE_DIRTY);
+          WrittenPagesPending.store(true);
+          return true;
+        }
+        break;
+      case STATE_UNPROTECTING:
+      case STATE_DIRTY:
+        // Someone else got here first, the write just needs to be retried
+        return true;
+      default:
+        return false;
+    }
+  }
+}
+
+void CodePageTracker::AddBlock(uint64_t GuestRIP, std::vector<std::pair<uint64_t, uint64_t>> const &Ranges) {
+  auto &Pages = BlockPages[GuestRIP];
+  for (auto const &Range : Ranges) {
+    if (Range.first == Range.second) {
+      continue;
+    }
+
+    for (uint64_t Page = Range.first & ~PAGE_MASK; Page < Range.second; Page += PAGE_SIZE) {
+      if (std::find(Pages.begin(), Pages.end(), Page) != Pages.end()) {
+        continue;
+      }
+      Pages.emplace_back(Page);
+
+      auto &Blocks = PageBlocks[Page];
+      Blocks.emplace(GuestRIP);
+      if (Blocks.size() == 1) {
+        ProtectPage(Page);
+      }
+    }
+  }
+}
+
+void CodePageTracker::RemoveBlock(uint64_t GuestRIP, std::set<uint64_t> *RemovedBlocks) {
+  auto Block = BlockPages.find(GuestRIP);
+  if (Block == BlockPages.end()) {
+    return;
+  }
+
+  for (auto Page : Block->second) {
+    auto Blocks = PageBlocks.find(Page);
+    Blocks->second.erase(GuestRIP);
+    if (Blocks->second.empty()) {
+      PageBlocks.erase(Blocks);
+      UnprotectPage(Page);
+    }
+  }
+
+  BlockPages.erase(Block);
+  RemovedBlocks->emplace(GuestRIP);
+}
+
+void CodePageTracker::RemoveRange(uint64_t Start, uint64_t Length, std::set<uint64_t> *RemovedBlocks) {
+  uint64_t End = Start + Length;
+  std::vector<uint64_t> Blocks;
+  for (auto Page = PageBlocks.lower_bound(Start & ~PAGE_MASK); Page != PageBlocks.end() && Page->first < End; ++Page) {
+    Blocks.insert(Blocks.end(), Page->second.begin(), Page->second.end());
+  }
+
+  for (auto GuestRIP : Blocks) {
+    RemoveBlock(GuestRIP, RemovedBlocks);
+  }
+}
+
+bool CodePageTracker::HasCode(uint64_t Start, uint64_t Length) const {
+  uint64_t End = Start + Length;
+  auto Page = PageBlocks.lower_bound(Start & ~PAGE_MASK);
+  return Page != PageBlocks.end() && Page->first < End;
+}
+
+bool CodePageTracker::IsWriteProtected(uint64_t Start, uint64_t Length) {
+  uint64_t End = Start + Length;
+  for (auto Page = PageBlocks.lower_bound(Start & ~PAGE_MASK); Page != PageBlocks.end() && Page->first < End; ++Page) {
+    auto State = GetPageState(Page->first, false);
+    if (State && (State->load() & STATE_MASK) == STATE_PROTECTED) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void CodePageTracker::RemoveWrittenPages(std::set<uint64_t> *RemovedBlocks) {
+  // Cleared first, anything written while we look gets picked up next time
+  WrittenPagesPending.store(false);
+
+  std::vector<uint64_t> WrittenPages;
+  for (auto const &Page : PageBlocks) {
+    auto State = GetPageState(Page.first, false);
+    if (State && (State->load() & STATE_MASK) == STATE_DIRTY) {
+      WrittenPages.emplace_back(Page.first);
+    }
+  }
+
+  for (auto Page : WrittenPages) {
+    RemoveRange(Page, PAGE_SIZE, RemovedBlocks);
+  }
+}
+
+void CodePageTracker::SetGuestProtection(uint64_t Start, uint64_t Length, int Prot) {
+  uint64_t End = (Start + Length + PAGE_MASK) & ~PAGE_MASK;
+  Start &= ~PAGE_MASK;
+
+  std::lock_guard<std::mutex> lk(GuestProtectionMutex);
+  // Split whatever straddles the edges of the range, then everything inside is replaced
+  auto SplitAt = [this](uint64_t Address) {
+    auto Region = GuestProtection.upper_bound(Address);
+    if (Region == GuestProtection.begin()) {
+      return;
+    }
+    --Region;
+    if (Region->first < Address && Address < Region->second.first) {
+      GuestProtection.emplace(Address, Region->second);
+      Region->second.first = Address;
+    }
+  };
+  SplitAt(Start);
+  SplitAt(End);
+
+  GuestProtection.erase(GuestProtection.lower_bound(Start), GuestProtection.lower_bound(End));
+  if (Prot != -1) {
+    GuestProtection.emplace(Start, std::make_pair(End, Prot));
+  }
+}
+
+int CodePageTracker::GetGuestProtection(uint64_t Address) const {
+  std::lock_guard<std::mutex> lk(GuestProtectionMutex);
+  auto Region = GuestProtection.upper_bound(Address);
+  if (Region != GuestProtection.begin()) {
+    --Region;
+    if (Address < Region->second.first) {
+      return Region->second.second;
+    }
+  }
+
+  return PROT_READ | PROT_WRITE;
+}
+}
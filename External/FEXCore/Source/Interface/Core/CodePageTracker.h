@@ -0,0 +1,113 @@
+#pragma once
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <set>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+namespace FEXCore {
+// Keeps track of which guest pages compiled blocks were decoded from
+// Pages with code on them are write protected so the guest writing to them can be caught and the code thrown out
+// Everything except HandleWriteFault and the guest protection records must be serialized by the owner
+// Guest protection records have their own lock, mapping changes without code on them don't need to hold off everything else
+class CodePageTracker {
+public:
+  /**
+   * @param ProtectPages Write protect pages with code on them, needs guest addresses to be host addresses
+   */
+  explicit CodePageTracker(bool ProtectPages);
+  ~CodePageTracker();
+
+  /**
+   * @brief Records that the block at GuestRIP was decoded from the guest code in the [Begin, End) ranges
+   */
+  void AddBlock(uint64_t GuestRIP, std::vector<std::pair<uint64_t, uint64_t>> const &Ranges);
+
+  /**
+   * @brief Stops tracking every block with code in [Start, Start + Length)
+   *
+   * The entry RIPs of those blocks get added to RemovedBlocks
+   */
+  void RemoveRange(uint64_t Start, uint64_t Length, std::set<uint64_t> *RemovedBlocks);
+
+  /**
+   * @brief Stops tracking every block on a page the guest wrote to since the last call
+   */
+  void RemoveWrittenPages(std::set<uint64_t> *RemovedBlocks);
+
+  /**
+   * @brief Set from the fault handler when a page with code on it got written to
+   *
+   * JIT code checks this directly before chaining to another block
+   */
+  std::atomic_bool const *GetWrittenPagesPending() const { return &WrittenPagesPending; }
+  bool HasWrittenPages() const { return WrittenPagesPending.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Records the guest's protection for [Start, Start + Length), -1 when the guest unmapped it
+   *
+   * Memory without a record is what we mapped for the guest ourselves, which is always read/write
+   */
+  void SetGuestProtection(uint64_t Start, uint64_t Length, int Prot);
+  int GetGuestProtection(uint64_t Address) const;
+
+  /**
+   * @brief Returns true if any block was decoded from a page in [Start, Start + Length)
+   *
+   * Only needs the owner to hold off changes, not other lookups
+   */
+  bool HasCode(uint64_t Start, uint64_t Length) const;
+
+  /**
+   * @brief Returns true if any page in [Start, Start + Length) is write protected by us
+   */
+  bool IsWriteProtected(uint64_t Start, uint64_t Length);
+
+  /**
+   * @brief Called from the SIGSEGV handler
+   *
+   * Returns true if the fault was a write to a page we protected. The page is writable again and the write can be retried
+   */
+  bool HandleWriteFault(uint64_t Address);
+
+private:
+  constexpr static uint64_t PAGE_SHIFT = 12;
+  constexpr static uint64_t PAGE_SIZE = 1ULL << PAGE_SHIFT;
+  constexpr static uint64_t PAGE_MASK = PAGE_SIZE - 1;
+
+  // Page states are looked up from the fault handler, so they live in a lock free two level table
+  constexpr static uint64_t ADDRESS_BITS = 47;
+  constexpr static uint64_t STATE_TABLE_BITS = 15;
+  constexpr static uint64_t STATE_DIRECTORY_SIZE = 1ULL << (ADDRESS_BITS - PAGE_SHIFT - STATE_TABLE_BITS);
+  constexpr static uint64_t STATE_TABLE_SIZE = 1ULL << STATE_TABLE_BITS;
+
+  // Low bits hold the guest's protection so the fault handler can restore it without looking anything up
+  constexpr static uint8_t STATE_PROT_MASK    = 0b0000'0111;
+  constexpr static uint8_t STATE_MASK         = 0b0011'0000;
+  constexpr static uint8_t STATE_NONE         = 0b0000'0000;
+  constexpr static uint8_t STATE_PROTECTED    = 0b0001'0000;
+  // Someone is in the middle of making the page writable again, writes just retry
+  constexpr static uint8_t STATE_UNPROTECTING = 0b0010'0000;
+  // Written to and writable, the blocks on it haven't been thrown out yet
+  constexpr static uint8_t STATE_DIRTY        = 0b0011'0000;
+
+  std::atomic<uint8_t> *GetPageState(uint64_t Page, bool Allocate);
+  void ProtectPage(uint64_t Page);
+  void UnprotectPage(uint64_t Page);
+  void RemoveBlock(uint64_t GuestRIP, std::set<uint64_t> *RemovedBlocks);
+
+  bool ProtectPages;
+  std::atomic<std::atomic<uint8_t>*> *StateDirectory{};
+  std::atomic_bool WrittenPagesPending {false};
+
+  // Page -> entry RIPs of the blocks with code on it
+  std::map<uint64_t, std::set<uint64_t>> PageBlocks;
+  // Entry RIP -> pages its code is on
+  std::map<uint64_t, std::vector<uint64_t>> BlockPages;
+  // Start -> End, protection of guest mappings
+  mutable std::mutex GuestProtectionMutex;
+  std::map<uint64_t, std::pair<uint64_t, int>> GuestProtection;
+};
+}
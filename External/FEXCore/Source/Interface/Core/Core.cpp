@@ -1,15 +1,19 @@
+#include "Common/Hash.h"
 #include "Common/MathUtils.h"
 #include "Common/Paths.h"
 
 #include "Interface/Context/Context.h"
 #include "Interface/Core/BlockCache.h"
 #include "Interface/Core/BlockSamplingData.h"
+#include "Interface/Core/CodePageTracker.h"
 #include "Interface/Core/Core.h"
 #include "Interface/Core/DebugData.h"
 #include "Interface/Core/OpcodeDispatcher.h"
+#include "Interface/Core/TranslationCache.h"
 #include "Interface/Core/Interpreter/InterpreterCore.h"
 #include "Interface/Core/JIT/JITCore.h"
 #include "Interface/Core/LLVMJIT/LLVMCore.h"
+#include "Interface/HLE/VDSO.h"
 #include "Interface/IR/Passes/RegisterAllocationPass.h"
 #include "Interface/IR/Passes.h"
 
@@ -19,7 +23,14 @@
 #include <FEXCore/Core/CPUBackend.h>
 #include <FEXCore/Core/X86Enums.h>
 
+#include <algorithm>
+#include <chrono>
+#include <elf.h>
+#include <fcntl.h>
 #include <fstream>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include "Interface/Core/GdbServer.h"
@@ -29,6 +40,8 @@ constexpr uint64_t STACK_OFFSET = 0xc000'0000;
 constexpr uint64_t FS_OFFSET = 0xb000'0000;
 constexpr uint64_t FS_SIZE = 0x1000'0000;
 
+constexpr uint64_t VDSO_OFFSET = 0xa000'0000;
+
 namespace FEXCore::CPU {
   bool CreateCPUCore(FEXCore::Context::Context *CTX) {
     // This should be used for generating things that are shared between threads
@@ -124,39 +137,204 @@ namespace DefaultFallbackCore {
 }
 
 namespace FEXCore::Context {
+  namespace {
+    // Anything keyed on the application hash can change what it stores between builds
+    // So every build gets its own hashes and starts over with a fresh cache
+    uint64_t GetFilenameHashSalt() {
+      static uint64_t Salt = [] {
+        FEXCore::Hash::XXHash64 State;
+        State.Update(FEXCORE_BUILD_VERSION, strlen(FEXCORE_BUILD_VERSION));
+        return State.Final();
+      }();
+      return Salt;
+    }
+
+    // Limits how large the file of known hashes can grow, it starts over once full
+    constexpr size_t MAX_FILE_HASH_RECORDS = 4096;
+
+    struct FileHashRecord {
+      uint64_t Device;
+      uint64_t Inode;
+      uint64_t MTimeSec;
+      uint64_t MTimeNSec;
+      uint64_t Size;
+      uint64_t Salt;
+      uint64_t Hash;
+    };
+
+    bool HashFileContents(int FD, uint64_t Size, uint64_t *Hash) {
+      FEXCore::Hash::XXHash64 State {GetFilenameHashSalt()};
+      if (Size == 0) {
+        *Hash = State.Final();
+        return true;
+      }
+
+      void *Mapping = mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, FD, 0);
+      if (Mapping == MAP_FAILED) {
+        return false;
+      }
+      madvise(Mapping, Size, MADV_SEQUENTIAL);
+
+      auto Base = reinterpret_cast<uint8_t const*>(Mapping);
+      auto Header = reinterpret_cast<Elf64_Ehdr const*>(Base);
+      bool IsELF = Size >= sizeof(Elf64_Ehdr) &&
+        memcmp(Header->e_ident, ELFMAG, SELFMAG) == 0 &&
+        Header->e_ident[EI_CLASS] == ELFCLASS64 &&
+        Header->e_phentsize == sizeof(Elf64_Phdr) &&
+        Header->e_phoff <= Size &&
+        Header->e_phnum <= (Size - Header->e_phoff) / sizeof(Elf64_Phdr);
+
+      if (IsELF) {
+        // Only what gets loaded in to memory matters, debug info and symbols can change freely
+        State.Update(Header, sizeof(Elf64_Ehdr));
+        auto ProgramHeaders = reinterpret_cast<Elf64_Phdr const*>(Base + Header->e_phoff);
+        for (size_t i = 0; i < Header->e_phnum; ++i) {
+          auto const &Segment = ProgramHeaders[i];
+          State.Update(&Segment, sizeof(Segment));
+          if (Segment.p_type == PT_LOAD && Segment.p_offset <= Size) {
+            State.Update(Base + Segment.p_offset, std::min<uint64_t>(Segment.p_filesz, Size - Segment.p_offset));
+          }
+        }
+      }
+      else {
+        State.Update(Base, Size);
+      }
+
+      munmap(Mapping, Size);
+      *Hash = State.Final();
+      return true;
+    }
+
+    bool FindFileHashRecord(std::string const &Path, FileHashRecord *Record) {
+      int FD = open(Path.c_str(), O_RDONLY | O_CLOEXEC);
+      if (FD == -1) {
+        return false;
+      }
+
+      // Writers resize the file under an exclusive lock
+      flock(FD, LOCK_SH);
+
+      // Only whole records, a partial one at the end is never matched
+      bool Found = false;
+      FileHashRecord Known;
+      while (read(FD, &Known, sizeof(Known)) == sizeof(Known)) {
+        if (Known.Device == Record->Device &&
+            Known.Inode == Record->Inode &&
+            Known.MTimeSec == Record->MTimeSec &&
+            Known.MTimeNSec == Record->MTimeNSec &&
+            Known.Size == Record->Size &&
+            Known.Salt == Record->Salt) {
+          Record->Hash = Known.Hash;
+          Found = true;
+          break;
+        }
+      }
+
+      close(FD);
+      return Found;
+    }
+
+    void AddFileHashRecord(std::string const &Path, FileHashRecord const &Record) {
+      int FD = open(Path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+      if (FD == -1) {
+        return;
+      }
+
+      // Other instances append at the same time, checking the size and appending can't be split up
+      struct stat Stat{};
+      if (flock(FD, LOCK_EX) == 0 && fstat(FD, &Stat) == 0) {
+        off_t Size = Stat.st_size;
+        if (Size >= static_cast<off_t>(MAX_FILE_HASH_RECORDS * sizeof(FileHashRecord))) {
+          Size = 0;
+        }
+        else {
+          // Torn record from an instance that died while appending, everything after it would be misaligned
+          Size -= Size % sizeof(FileHashRecord);
+        }
+
+        if (Size != Stat.st_size && ftruncate(FD, Size) != 0) {
+          close(FD);
+          return;
+        }
+
+        if (write(FD, &Record, sizeof(Record)) != static_cast<ssize_t>(sizeof(Record))) {
+          // Don't leave part of a record behind
+          if (ftruncate(FD, Size) != 0) {
+            LogMan::Msg::D("Couldn't remove partial file hash record from '%s'", Path.c_str());
+          }
+        }
+      }
+
+      close(FD);
+    }
+  }
+
   Context::Context()
-    : FrontendDecoder {this}
-    , SyscallHandler {FEXCore::CreateHandler(OperatingMode::MODE_64BIT, this)} {
+    : SyscallHandler {FEXCore::CreateHandler(OperatingMode::MODE_64BIT, this)} {
     FallbackCPUFactory = FEXCore::Core::DefaultFallbackCore::CPUCreationFactory;
-    PassManager.AddDefaultPasses();
-    PassManager.AddDefaultValidationPasses();
 #ifdef BLOCKSTATS
     BlockData = std::make_unique<FEXCore::BlockSamplingData>();
 #endif
   }
 
   bool Context::GetFilenameHash(std::string const &Filename, std::string &Hash) {
-    // Calculate a hash for the input file
-    std::ifstream Input (Filename.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
-    if (Input.is_open()) {
-      std::streampos Size;
-      Size = Input.tellg();
-      Input.seekg(0, std::ios::beg);
-      std::string Data;
-      Data.resize(Size);
-      Input.read(&Data.at(0), Size);
-      Input.close();
-
-      std::hash<std::string> string_hash;
-      Hash = std::to_string(string_hash(Data));
+    int FD = open(Filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (FD == -1) {
+      return false;
+    }
+
+    struct stat Stat{};
+    if (fstat(FD, &Stat) != 0) {
+      close(FD);
+      return false;
+    }
+
+    // An unchanged file has the same hash, so it only ever gets read once
+    FileHashRecord Record {
+      static_cast<uint64_t>(Stat.st_dev),
+      static_cast<uint64_t>(Stat.st_ino),
+      static_cast<uint64_t>(Stat.st_mtim.tv_sec),
+      static_cast<uint64_t>(Stat.st_mtim.tv_nsec),
+      static_cast<uint64_t>(Stat.st_size),
+      GetFilenameHashSalt(),
+      0,
+    };
+    auto Key = std::make_tuple(Record.Device, Record.Inode, Record.MTimeSec, Record.MTimeNSec, Record.Size);
+
+    auto Cached = FilenameHashes.find(Key);
+    if (Cached != FilenameHashes.end()) {
+      close(FD);
+      Hash = Cached->second;
       return true;
     }
-    return false;
+
+    auto RecordsPath = FEXCore::Paths::GetDataPath() + "/EntryCache/FileHashes";
+    if (!FindFileHashRecord(RecordsPath, &Record)) {
+      if (!HashFileContents(FD, Record.Size, &Record.Hash)) {
+        close(FD);
+        return false;
+      }
+      AddFileHashRecord(RecordsPath, Record);
+    }
+    close(FD);
+
+    char HashString[17];
+    snprintf(HashString, sizeof(HashString), "%016lx", Record.Hash);
+    Hash = HashString;
+    FilenameHashes.emplace(Key, Hash);
+    return true;
   }
 
-  void Context::AddThreadRIPsToEntryList(FEXCore::Core::InternalThreadState *Thread) {
-    for (auto &IR : Thread->IRLists) {
-      EntryList.insert(IR.first);
+  void Context::AddCachedRIPsToEntryList() {
+    // Older runs count for less so the order follows what the application does now
+    for (auto &Entry : EntryList) {
+      Entry.second /= 2;
+    }
+
+    // Every compiled block has debug data, the IR might have been dropped after compilation
+    std::shared_lock<std::shared_mutex> lk(CodeCacheMutex);
+    for (auto &Data : DebugData) {
+      EntryList[Data.first] += Data.second.RunCount;
     }
   }
 
@@ -170,8 +348,9 @@ namespace FEXCore::Context {
 
       std::ofstream Output (DataPath.c_str(), std::ios::out | std::ios::binary);
       if (Output.is_open()) {
-        for (auto Entry : EntryList) {
-          Output.write(reinterpret_cast<char const*>(&Entry), sizeof(Entry));
+        for (auto const &Entry : EntryList) {
+          Output.write(reinterpret_cast<char const*>(&Entry.first), sizeof(uint64_t));
+          Output.write(reinterpret_cast<char const*>(&Entry.second), sizeof(uint64_t));
         }
         Output.close();
       }
@@ -195,11 +374,12 @@ namespace FEXCore::Context {
         Data.resize(Size);
         Input.read(&Data.at(0), Size);
         Input.close();
-        size_t EntryCount = Size / sizeof(uint64_t);
+        // RIP and hit count pairs
+        size_t EntryCount = Size / (sizeof(uint64_t) * 2);
         uint64_t *Entries = reinterpret_cast<uint64_t*>(&Data.at(0));
 
         for (size_t i = 0; i < EntryCount; ++i) {
-          EntryList.insert(Entries[i]);
+          EntryList[Entries[i * 2]] = Entries[i * 2 + 1];
         }
       }
     }
@@ -209,14 +389,18 @@ namespace FEXCore::Context {
     ShouldStop.store(true);
 
     Pause();
+    StopPrecompile();
+    StopTierUpCompiler();
     {
       std::lock_guard<std::mutex> lk(ThreadCreationMutex);
       for (auto &Thread : Threads) {
         Thread->ExecutionThread.join();
       }
 
-      for (auto &Thread : Threads) {
-        AddThreadRIPsToEntryList(Thread);
+      AddCachedRIPsToEntryList();
+
+      if (Config.CompileStats) {
+        DumpCompileStats();
       }
 
       for (auto &Thread : Threads) {
@@ -226,6 +410,11 @@ namespace FEXCore::Context {
     }
 
     SaveEntryList();
+
+    if (Translations) {
+      std::shared_lock<std::shared_mutex> lk(CodeCacheMutex);
+      Translations->Save();
+    }
   }
 
   bool Context::InitCore(FEXCore::CodeLoader *Loader) {
@@ -248,6 +437,31 @@ namespace FEXCore::Context {
     NewThreadState.fs = FS_OFFSET;
     NewThreadState.flags[1] = 1;
 
+    BlockCache = std::make_shared<FEXCore::BlockCache>(this);
+
+    // Guest pages can only be protected when guest addresses are host addresses
+    CodePages = std::make_unique<FEXCore::CodePageTracker>(Config.UnifiedMemory);
+
+    // The guest memory region exists by now, mmap addresses have to stay inside of it
+    SyscallHandler->InitializeMMapAllocator(MemoryMapper.GetSHMSize());
+
+    if (Config.TranslationCache) {
+      std::string hash_string;
+      if (GetFilenameHash(SyscallHandler->GetFilename(), hash_string)) {
+        // Cached blocks are checked against guest memory through their host addresses
+        uint64_t MemoryBase = Config.UnifiedMemory ? 0 : MemoryMapper.GetBaseOffset<uintptr_t>(0);
+        Translations = std::make_unique<FEXCore::TranslationCache>(FEXCore::Paths::GetDataPath() + "/EntryCache/Translations_" + hash_string, MemoryBase);
+        LogMan::Msg::I("Loaded %zu blocks from the translation cache", Translations->LoadedBlockCount());
+      }
+    }
+
+    // Needs to happen before any guest thread exists, it decides which pass pipeline they get
+    StartTierUpCompiler();
+
+    // Only baseline blocks count, optimized code doesn't pay for a counter nothing checks
+    // The precompile profile picks up what they counted, without tiering it only records which blocks were compiled
+    CountBlockExecutions = TierUp.Thread != nullptr;
+
     FEXCore::Core::InternalThreadState *Thread = CreateThread(&NewThreadState, 0);
 
     // We are the parent thread
@@ -257,8 +471,11 @@ namespace FEXCore::Context {
     Loader->SetMemoryBase(MemoryBase, Config.UnifiedMemory);
 
     auto MemoryMapperFunction = [&](uint64_t Base, uint64_t Size, bool Fixed, bool RelativeToBase) -> void* {
-      Thread->BlockCache->HintUsedRange(Base, Base);
-      return MapRegion(Thread, Base, Size, Fixed, RelativeToBase);
+      BlockCache->HintUsedRange(Base, Base);
+      void *Ptr = MapRegion(Thread, Base, Size, Fixed, RelativeToBase);
+      uint64_t GuestBase = Config.UnifiedMemory ? reinterpret_cast<uint64_t>(Ptr) : Base;
+      Precompile.Regions.emplace_back(GuestBase, GuestBase + Size);
+      return Ptr;
     };
 
     Loader->MapMemoryRegion(MemoryMapperFunction);
@@ -272,6 +489,20 @@ namespace FEXCore::Context {
     if (Config.UnifiedMemory) {
       GuestStack = reinterpret_cast<uint64_t>(StackPointer);
     }
+
+    if (Config.VDSO) {
+      // Needs to be in place before the stack is set up so the loader can put it in the auxv
+      auto VDSO = FEXCore::HLE::GenerateVDSO();
+      void *VDSOPointer = MapRegion(Thread, VDSO_OFFSET, AlignUp(VDSO.size(), 0x1000), true, false);
+      memcpy(VDSOPointer, VDSO.data(), VDSO.size());
+
+      uint64_t GuestVDSO = VDSO_OFFSET;
+      if (Config.UnifiedMemory) {
+        GuestVDSO = reinterpret_cast<uint64_t>(VDSOPointer);
+      }
+      Loader->SetVDSOBase(GuestVDSO);
+    }
+
     Thread->State.State.gregs[X86State::REG_RSP] = Loader->SetupStack(StackPointer, GuestStack);
 
     // Now let the code loader setup memory
@@ -293,6 +524,12 @@ namespace FEXCore::Context {
 
     Thread->State.State.rip = StartingRIP = RIP;
 
+    // Precompiled blocks get in the way of stepping through code in the debugger
+    if (!DebugServer) {
+      LoadEntryList();
+      StartPrecompile();
+    }
+
     InitializeThread(Thread);
 
     return true;
@@ -381,13 +618,6 @@ namespace FEXCore::Context {
     Thread->CPUBackend->Initialize();
     Thread->FallbackBackend->Initialize();
 
-    // Compile all of our cached entries
-    LogMan::Msg::D("Precompiling: %ld blocks...", EntryList.size());
-    for (auto Entry : EntryList) {
-      CompileRIP(Thread, Entry);
-    }
-    LogMan::Msg::D("Done", EntryList.size());
-
     // This will create the execution thread but it won't actually start executing
     Thread->ExecutionThread = std::thread(&Context::ExecutionThread, this, Thread);
 
@@ -411,11 +641,14 @@ namespace FEXCore::Context {
       Thread->State.ThreadManager.TID = ++ThreadID;
     }
 
-    Thread->OpDispatcher = std::make_unique<FEXCore::IR::OpDispatchBuilder>(this);
-    Thread->OpDispatcher->SetMultiblock(Config.Multiblock);
-    Thread->BlockCache = std::make_unique<FEXCore::BlockCache>(this);
     Thread->CTX = this;
 
+    // With tiered compilation guest threads only ever compile the baseline tier
+    InitializeCompileState(Thread, !TierUp.Thread);
+
+    // Start out on the shared code cache, JIT cores bake the cache in to their dispatchers on creation
+    Thread->BlockCache = BlockCache;
+
     // Copy over the new thread state to the new object
     memcpy(&Thread->State.State, NewThreadState, sizeof(FEXCore::Core::CPUState));
 
@@ -423,62 +656,413 @@ namespace FEXCore::Context {
     Thread->State.ThreadManager.parent_tid = ParentTID;
 
     // Create CPU backend
-    switch (Config.Core) {
-    case FEXCore::Config::CONFIG_INTERPRETER: Thread->CPUBackend.reset(FEXCore::CPU::CreateInterpreterCore(this)); break;
-    case FEXCore::Config::CONFIG_IRJIT:       Thread->CPUBackend.reset(FEXCore::CPU::CreateJITCore(this, Thread)); break;
-    case FEXCore::Config::CONFIG_LLVMJIT:     Thread->CPUBackend.reset(FEXCore::CPU::CreateLLVMCore(Thread)); break;
-    case FEXCore::Config::CONFIG_CUSTOM:      Thread->CPUBackend.reset(CustomCPUFactory(this, &Thread->State)); break;
-    default: LogMan::Msg::A("Unknown core configuration");
-    }
-
+    Thread->CPUBackend.reset(CreateCPUBackend(Thread));
     Thread->FallbackBackend.reset(FallbackCPUFactory(this, &Thread->State));
 
     LogMan::Throw::A(!Thread->FallbackBackend->NeedsOpDispatch(), "Fallback CPU backend must not require OpDispatch");
 
+    if (!Thread->CPUBackend->SharesCodeBetweenThreads()) {
+      // This backend's code is tied to this thread, so it needs a cache of its own
+      // It still shares the IR cache with everyone else
+      Thread->BlockCache = std::make_shared<FEXCore::BlockCache>(this);
+
+      std::unique_lock<std::shared_mutex> lk(CodeCacheMutex);
+      PrivateBlockCaches.emplace_back(Thread->BlockCache);
+    }
+
     return Thread;
   }
 
-  IR::RegisterAllocationPass *Context::GetRegisterAllocatorPass() {
-    if (!RAPass) {
-      RAPass = IR::CreateRegisterAllocationPass();
-      PassManager.InsertPass(RAPass);
+  void Context::InitializeCompileState(FEXCore::Core::InternalThreadState *Thread, bool Optimize) {
+    bool Multiblock = Optimize && Config.Multiblock;
+
+    Thread->FrontendDecoder = std::make_unique<FEXCore::Frontend::Decoder>(this);
+    Thread->FrontendDecoder->SetMultiblock(Multiblock);
+    Thread->OpDispatcher = std::make_unique<FEXCore::IR::OpDispatchBuilder>(this);
+    Thread->OpDispatcher->SetMultiblock(Multiblock);
+    Thread->OpDispatcher->SetLazyFlags(Config.LazyFlags);
+    Thread->PassManager = std::make_unique<FEXCore::IR::PassManager>();
+    Thread->PassManager->SetStats(Config.CompileStats ? &Thread->Compilation : nullptr);
+    Thread->PassManager->SetLinearScanRA((Optimize ? Config.RegisterAllocator : Config.BaselineRegisterAllocator) == FEXCore::Config::CONFIG_RA_LINEAR_SCAN);
+    if (Optimize) {
+      Thread->PassManager->AddDefaultPasses();
     }
+    else {
+      Thread->PassManager->AddBaselinePasses();
+    }
+    Thread->PassManager->AddDefaultValidationPasses();
+  }
 
-    return RAPass;
+  FEXCore::CPU::CPUBackend *Context::CreateCPUBackend(FEXCore::Core::InternalThreadState *Thread) {
+    switch (Config.Core) {
+    case FEXCore::Config::CONFIG_INTERPRETER: return FEXCore::CPU::CreateInterpreterCore(this);
+    case FEXCore::Config::CONFIG_IRJIT:       return FEXCore::CPU::CreateJITCore(this, Thread);
+    case FEXCore::Config::CONFIG_LLVMJIT:     return FEXCore::CPU::CreateLLVMCore(Thread);
+    case FEXCore::Config::CONFIG_CUSTOM:      return CustomCPUFactory(this, &Thread->State);
+    default: LogMan::Msg::A("Unknown core configuration");
+    }
+
+    return nullptr;
   }
 
-  uintptr_t Context::AddBlockMapping(FEXCore::Core::InternalThreadState *Thread, uint64_t Address, void *Ptr) {
+  uintptr_t Context::AddBlockMapping(FEXCore::Core::InternalThreadState *Thread, uint64_t Address, void *Ptr, FEXCore::IR::IRListView<true> const *IR) {
+    std::unique_lock<std::shared_mutex> lk(CodeCacheMutex);
+    if (IR) {
+      auto CachedIR = IRLists.find(Address);
+      if (CachedIR == IRLists.end() || CachedIR->second.get() != IR) {
+        // The IR was thrown out or replaced while we compiled it, the guest code could have changed under it
+        // Let the caller run it this once but don't publish it
+        return reinterpret_cast<uintptr_t>(Ptr);
+      }
+    }
+
     auto BlockMapPtr = Thread->BlockCache->AddBlockMapping(Address, Ptr);
     if (BlockMapPtr == 0) {
+      // Only the lookup tables ran out of space
+      // The code they pointed at is still valid so nothing else needs to be thrown away
       Thread->BlockCache->ClearCache();
-
-      // Pull out the current IR we added and store it back after we cleared the rest of the list
-      // Needed in the case the the block mapping has aliased
-      auto IR = Thread->IRLists.find(Address)->second.release();
-      Thread->IRLists.clear();
-      Thread->IRLists.try_emplace(Address, IR);
       BlockMapPtr = Thread->BlockCache->AddBlockMapping(Address, Ptr);
       LogMan::Throw::A(BlockMapPtr, "Couldn't add mapping after clearing mapping cache");
     }
 
+    if (IR && !Thread->CPUBackend->NeedsIRAfterCompile()) {
+      // Nothing reads the IR once the code exists, other threads might still be compiling from it though
+      auto CachedIR = IRLists.find(Address);
+      RetireIR(std::move(CachedIR->second));
+      IRLists.erase(CachedIR);
+    }
+
     return BlockMapPtr;
   }
 
-  void Context::ClearCodeCache(FEXCore::Core::InternalThreadState *Thread, uint64_t GuestRIP) {
-    Thread->BlockCache->ClearCache();
-    Thread->CPUBackend->ClearCache();
-    if (GuestRIP != 0) {
-      auto IR = Thread->IRLists.find(GuestRIP)->second.release();
-      Thread->IRLists.clear();
-      Thread->IRLists.try_emplace(GuestRIP, IR);
+  void Context::ClearCodeCache(FEXCore::Core::InternalThreadState *Thread) {
+    std::unique_lock<std::shared_mutex> lk(CodeCacheMutex);
+
+    // The IR cache survives this. Other threads might be interpreting it and it saves decoding everything again
+    if (!HasSharedBlockCache(Thread)) {
+      Thread->BlockCache->ClearCache();
+      Thread->CPUBackend->ClearCache();
+      return;
+    }
+
+    // Blocks other threads compiled in to their own code buffers stay mapped, only ours go
+    auto CodeRange = Thread->CPUBackend->GetCodeRange();
+    Thread->BlockCache->EvictCodeRange(CodeRange.first, CodeRange.second);
+
+    // Other threads can be running out of this backend's code buffer, even sitting in a syscall inside of it
+    // So it can't be reset in place. Retire it and give the thread a fresh backend instead
+    ReclaimRetiredBackends();
+    uint64_t RetiredEpoch = CodeCacheEpoch.fetch_add(1) + 1;
+    RetiredBackends.emplace_back(RetiredEpoch, std::move(Thread->CPUBackend));
+
+    // Start the new code with fresh IR slabs, the old ones get freed as soon as the IR in them is retired
+    IRStorage.NewGeneration();
+
+    Thread->CPUBackend.reset(CreateCPUBackend(Thread));
+    Thread->CPUBackend->Initialize();
+    for (auto const& Region : MemoryMapper.GetRegions()) {
+      Thread->CPUBackend->MapRegion(Region.Ptr, Region.Offset, Region.Size);
+    }
+  }
+
+  void Context::ReclaimRetiredBackends() {
+    uint64_t OldestEpoch = ~0ULL;
+    {
+      // This is opportunistic, whatever is left gets picked up next time
+      std::unique_lock<std::mutex> lk(ThreadCreationMutex, std::try_to_lock);
+      if (!lk.owns_lock()) {
+        return;
+      }
+
+      for (auto &Thread : Threads) {
+        OldestEpoch = std::min(OldestEpoch, Thread->CodeCacheEpoch.load());
+      }
+
+      if (TierUp.Thread) {
+        OldestEpoch = std::min(OldestEpoch, TierUp.Thread->CodeCacheEpoch.load());
+      }
+
+      for (auto &Thread : Precompile.Threads) {
+        OldestEpoch = std::min(OldestEpoch, Thread->CodeCacheEpoch.load());
+      }
+    }
+
+    // Every thread has been back through its dispatcher since these were retired, nothing can be executing them
+    // Blocks always return to ExecutionThread's loop, which is what moves a thread's epoch forward
+    RetiredBackends.erase(std::remove_if(RetiredBackends.begin(), RetiredBackends.end(),
+      [OldestEpoch](auto const &Retired) {
+        return Retired.first <= OldestEpoch;
+      }), RetiredBackends.end());
+
+    RetiredIR.erase(std::remove_if(RetiredIR.begin(), RetiredIR.end(),
+      [OldestEpoch](auto const &Retired) {
+        return Retired.first <= OldestEpoch;
+      }), RetiredIR.end());
+  }
+
+  void Context::RetireIR(std::unique_ptr<FEXCore::IR::IRListView<true>> IR) {
+    constexpr uint64_t RETIRED_IR_BATCH = 4096;
+
+    // Anything still reading it has published the current epoch or an older one
+    // It can't be found again, so once every thread moved past the next epoch it is unused
+    RetiredIR.emplace_back(CodeCacheEpoch.load() + 1, std::move(IR));
+    if (++IRRetiredSinceEpoch >= RETIRED_IR_BATCH) {
+      CodeCacheEpoch.fetch_add(1);
+      IRRetiredSinceEpoch = 0;
+    }
+
+    ReclaimRetiredBackends();
+  }
+
+  void Context::InvalidateGuestCodeRange(uint64_t Start, uint64_t Length) {
+    std::set<uint64_t> Blocks;
+    CodePages->RemoveRange(Start, Length, &Blocks);
+    InvalidateBlocks(Blocks);
+  }
+
+  void Context::InvalidateWrittenCodePages() {
+    std::unique_lock<std::shared_mutex> lk(CodeCacheMutex);
+    std::set<uint64_t> Blocks;
+    CodePages->RemoveWrittenPages(&Blocks);
+    InvalidateBlocks(Blocks);
+  }
+
+  void Context::InvalidateBlocks(std::set<uint64_t> const &Blocks) {
+    if (Blocks.empty()) {
+      return;
+    }
+
+    // Other threads might still be interpreting or compiling the IR
+    uint64_t RetiredEpoch = CodeCacheEpoch.fetch_add(1) + 1;
+
+    for (auto GuestRIP : Blocks) {
+      // Erasing also unlinks every block that jumps straight to it
+      BlockCache->Erase(GuestRIP);
+      for (auto &PrivateCache : PrivateBlockCaches) {
+        PrivateCache->Erase(GuestRIP);
+      }
+
+      auto CachedIR = IRLists.find(GuestRIP);
+      if (CachedIR != IRLists.end()) {
+        RetiredIR.emplace_back(RetiredEpoch, std::move(CachedIR->second));
+        IRLists.erase(CachedIR);
+      }
+
+      if (Translations) {
+        Translations->RemoveBlock(GuestRIP);
+      }
+    }
+
+    ReclaimRetiredBackends();
+  }
+
+  void Context::StartTierUpCompiler() {
+    if (Config.TierUpThreshold == 0) {
+      return;
+    }
+
+    auto Thread = std::make_unique<FEXCore::Core::InternalThreadState>();
+    Thread->CTX = this;
+    Thread->BlockCache = BlockCache;
+    InitializeCompileState(Thread.get(), true);
+    Thread->CPUBackend.reset(CreateCPUBackend(Thread.get()));
+
+    // Code compiled on the background thread gets executed by every guest thread
+    if (!Thread->CPUBackend->NeedsOpDispatch() || !Thread->CPUBackend->SharesCodeBetweenThreads()) {
+      LogMan::Msg::I("CPU backend can't share code between threads. Tiered compilation disabled");
+      return;
+    }
+
+    Thread->CPUBackend->Initialize();
+
+    // Only holds an epoch while it is compiling
+    Thread->CodeCacheEpoch.store(~0ULL);
+
+    TierUp.Thread = std::move(Thread);
+    TierUp.Worker = std::thread(&Context::TierUpCompilerThread, this);
+  }
+
+  void Context::StopTierUpCompiler() {
+    if (!TierUp.Thread) {
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lk(TierUp.QueueMutex);
+      TierUp.ShouldStop = true;
+    }
+    TierUp.QueueCV.notify_all();
+    TierUp.Worker.join();
+  }
+
+  void Context::QueueTierUp(uint64_t GuestRIP) {
+    std::lock_guard<std::mutex> lk(TierUp.QueueMutex);
+    // Blocks only ever get promoted once
+    if (TierUp.Queued.emplace(GuestRIP).second) {
+      TierUp.Queue.emplace_back(GuestRIP);
+      TierUp.QueueCV.notify_one();
+    }
+  }
+
+  void Context::TierUpCompilerThread() {
+    while (true) {
+      uint64_t GuestRIP;
+      {
+        std::unique_lock<std::mutex> lk(TierUp.QueueMutex);
+        TierUp.QueueCV.wait(lk, [this] { return TierUp.ShouldStop || !TierUp.Queue.empty(); });
+        if (TierUp.ShouldStop) {
+          return;
+        }
+
+        GuestRIP = TierUp.Queue.front();
+        TierUp.Queue.pop_front();
+      }
+
+      // The IR being compiled can be thrown out from under us when the guest overwrites its code
+      uint64_t Epoch;
+      do {
+        Epoch = CodeCacheEpoch.load();
+        TierUp.Thread->CodeCacheEpoch.store(Epoch);
+      } while (Epoch != CodeCacheEpoch.load());
+
+      // This swaps the block in the BlockCache and unlinks the blocks jumping to it, they relink to the new code
+      CompileBlockInternal(TierUp.Thread.get(), GuestRIP, true);
+      TierUp.Thread->CodeCacheEpoch.store(~0ULL);
+
+      {
+        // Free the baseline IR once nobody can be interpreting it any more
+        std::unique_lock<std::shared_mutex> lk(CodeCacheMutex);
+        ReclaimRetiredBackends();
+      }
+    }
+  }
+
+  void Context::StartPrecompile() {
+    if (EntryList.empty()) {
+      return;
+    }
+
+    // Only blocks that are in memory we know about can be decoded before the guest maps anything itself
+    std::vector<std::pair<uint64_t, uint64_t>> Entries;
+    for (auto const &Entry : EntryList) {
+      for (auto const &Region : Precompile.Regions) {
+        if (Entry.first >= Region.first && Entry.first < Region.second) {
+          Entries.emplace_back(Entry.second, Entry.first);
+          break;
+        }
+      }
+    }
+
+    // Most executed first, ties in address order
+    std::sort(Entries.begin(), Entries.end(), [](auto const &A, auto const &B) {
+      return A.first != B.first ? A.first > B.first : A.second < B.second;
+    });
+    for (auto const &Entry : Entries) {
+      Precompile.Queue.emplace_back(Entry.second);
+    }
+
+    if (Precompile.Queue.empty()) {
+      return;
+    }
+
+    // Leave a core for the guest
+    size_t WorkerCount = std::clamp<size_t>(std::thread::hardware_concurrency(), 2, 5) - 1;
+    WorkerCount = std::min(WorkerCount, Precompile.Queue.size());
+
+    for (size_t i = 0; i < WorkerCount; ++i) {
+      auto Thread = std::make_unique<FEXCore::Core::InternalThreadState>();
+      Thread->CTX = this;
+      Thread->BlockCache = BlockCache;
+      InitializeCompileState(Thread.get(), !TierUp.Thread);
+      Thread->CPUBackend.reset(CreateCPUBackend(Thread.get()));
+
+      // Everything the workers compile gets executed by the guest threads
+      if (!Thread->CPUBackend->NeedsOpDispatch() || !Thread->CPUBackend->SharesCodeBetweenThreads()) {
+        LogMan::Msg::I("CPU backend can't share code between threads. Precompiling disabled");
+        Precompile.Threads.clear();
+        return;
+      }
+
+      Thread->CPUBackend->Initialize();
+      for (auto const& Region : MemoryMapper.GetRegions()) {
+        Thread->CPUBackend->MapRegion(Region.Ptr, Region.Offset, Region.Size);
+      }
+
+      Precompile.Threads.emplace_back(std::move(Thread));
+    }
+
+    LogMan::Msg::D("Precompiling %ld blocks on %ld threads", Precompile.Queue.size(), Precompile.Threads.size());
+    for (auto &Thread : Precompile.Threads) {
+      Precompile.Workers.emplace_back(&Context::PrecompileThread, this, Thread.get());
+    }
+  }
+
+  void Context::StopPrecompile() {
+    Precompile.ShouldStop.store(true);
+    for (auto &Worker : Precompile.Workers) {
+      Worker.join();
+    }
+    Precompile.Workers.clear();
+  }
+
+  void Context::PrecompileThread(FEXCore::Core::InternalThreadState *Thread) {
+    while (!Precompile.ShouldStop.load(std::memory_order_relaxed)) {
+      size_t Index = Precompile.Next.fetch_add(1);
+      if (Index >= Precompile.Queue.size()) {
+        return;
+      }
+
+      uint64_t GuestRIP = Precompile.Queue[Index];
+      if (BlockCache->FindBlock(GuestRIP)) {
+        // The guest got to it first
+        continue;
+      }
+
+      // The IR being compiled can be thrown out from under us when the guest overwrites its code
+      uint64_t Epoch;
+      do {
+        Epoch = CodeCacheEpoch.load();
+        Thread->CodeCacheEpoch.store(Epoch);
+      } while (Epoch != CodeCacheEpoch.load());
+
+      // A guest thread wanting this block now waits for us instead of compiling it again
+      CompileBlock(Thread, GuestRIP);
+      Thread->CodeCacheEpoch.store(~0ULL);
     }
   }
 
   uintptr_t Context::CompileBlock(FEXCore::Core::InternalThreadState *Thread, uint64_t GuestRIP) {
-    // XXX: Threaded mutex hack until we support proper threaded compilation. Issue #13
-    static std::mutex SyscallMutex;
-    std::scoped_lock<std::mutex> lk(SyscallMutex);
+    if (!HasSharedBlockCache(Thread)) {
+      // Nobody else can publish in to this thread's cache
+      return CompileBlockInternal(Thread, GuestRIP);
+    }
+
+    {
+      // Only one thread compiles any given block, everyone else waits for it to be published
+      std::unique_lock<std::mutex> lk(CompileInFlightMutex);
+      CompileInFlightCV.wait(lk, [this, GuestRIP] { return CompileInFlight.find(GuestRIP) == CompileInFlight.end(); });
+
+      // Another thread might have published this block while we were waiting
+      if (uintptr_t HostCode = Thread->BlockCache->FindBlock(GuestRIP)) {
+        return HostCode;
+      }
 
+      CompileInFlight.emplace(GuestRIP);
+    }
+
+    uintptr_t HostCode = CompileBlockInternal(Thread, GuestRIP);
+
+    {
+      // If compilation failed then the waiters will try for themselves
+      std::lock_guard<std::mutex> lk(CompileInFlightMutex);
+      CompileInFlight.erase(GuestRIP);
+    }
+    CompileInFlightCV.notify_all();
+
+    return HostCode;
+  }
+
+  uintptr_t Context::CompileBlockInternal(FEXCore::Core::InternalThreadState *Thread, uint64_t GuestRIP, bool Reoptimize) {
     void *CodePtr {nullptr};
     uint8_t const *GuestCode{};
     if (Thread->CTX->Config.UnifiedMemory) {
@@ -489,127 +1073,194 @@ namespace FEXCore::Context {
     }
 
     // Do we already have this in the IR cache?
-    auto IR = Thread->IRLists.find(GuestRIP);
     FEXCore::IR::IRListView<true> *IRList {};
-    FEXCore::Core::DebugData *DebugData {};
+    FEXCore::Core::DebugData *BlockDebugData {};
+
+    FEXCore::Core::CompileStats *Stats = Config.CompileStats ? &Thread->Compilation : nullptr;
+    std::chrono::steady_clock::time_point StageStart;
+    auto StageTime = [&StageStart]() -> uint64_t {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - StageStart).count();
+    };
 
-    if (IR == Thread->IRLists.end()) {
+    // Reoptimizing a block always generates new IR from the guest code
+    if (Reoptimize || !FindIRForRIP(GuestRIP, &IRList, &BlockDebugData)) {
       bool HadDispatchError {false};
 
       uint64_t TotalInstructions {0};
       uint64_t TotalInstructionsLength {0};
 
-      if (!FrontendDecoder.DecodeInstructionsAtEntry(GuestCode, GuestRIP)) {
-        if (Config.BreakOnFrontendFailure) {
-           LogMan::Msg::E("Had Frontend decoder error");
-           ShouldStop = true;
+      // Guest code the blocks were decoded from, so writes to it can throw them out
+      std::vector<std::pair<uint64_t, uint64_t>> CodeRanges;
+
+      // IR before register allocation for the translation cache, the RA adds spills sized for this run's frame
+      std::unique_ptr<FEXCore::IR::IRListView<true>> TranslatedIR;
+
+      FEXCore::TranslationCache::CachedBlock CachedBlock;
+      if (!Reoptimize && Translations && Translations->Find(GuestRIP, &CachedBlock)) {
+        // Seen in an earlier run, the IR was saved before register allocation so the RA sets up this run's spill slots
+        Thread->OpDispatcher->LoadIR(CachedBlock.IRData, CachedBlock.IRDataSize, CachedBlock.ListData, CachedBlock.ListSize);
+        if (Thread->PassManager->HasRegisterAllocationPass()) {
+          Thread->PassManager->GetRegisterAllocatorPass()->Run(Thread->OpDispatcher.get());
         }
-        return 0;
+
+        TotalInstructions = CachedBlock.GuestInstructionCount;
+        TotalInstructionsLength = CachedBlock.GuestCodeSize;
+        CodeRanges = std::move(CachedBlock.Ranges);
       }
+      else {
+        if (Stats) {
+          StageStart = std::chrono::steady_clock::now();
+        }
+
+        if (!Thread->FrontendDecoder->DecodeInstructionsAtEntry(GuestCode, GuestRIP)) {
+          if (Config.BreakOnFrontendFailure) {
+             LogMan::Msg::E("Had Frontend decoder error");
+             ShouldStop = true;
+          }
+          return 0;
+        }
 
-      auto CodeBlocks = FrontendDecoder.GetDecodedBlocks();
+        if (Stats) {
+          Stats->Decode.AddRun(StageTime(), 0, 0, false);
+          StageStart = std::chrono::steady_clock::now();
+        }
 
-      Thread->OpDispatcher->BeginFunction(GuestRIP, CodeBlocks);
+        auto CodeBlocks = Thread->FrontendDecoder->GetDecodedBlocks();
 
-      for (size_t j = 0; j < CodeBlocks->size(); ++j) {
-        FEXCore::Frontend::Decoder::DecodedBlocks const &Block = CodeBlocks->at(j);
-        // Set the block entry point
-        Thread->OpDispatcher->SetNewBlockIfChanged(Block.Entry);
+        Thread->OpDispatcher->BeginFunction(GuestRIP, CodeBlocks);
 
-        uint64_t BlockInstructionsLength {};
+        for (size_t j = 0; j < CodeBlocks->size(); ++j) {
+          FEXCore::Frontend::Decoder::DecodedBlocks const &Block = CodeBlocks->at(j);
+          // Set the block entry point
+          Thread->OpDispatcher->SetNewBlockIfChanged(Block.Entry);
 
-        uint64_t InstsInBlock = Block.NumInstructions;
-        for (size_t i = 0; i < InstsInBlock; ++i) {
-          FEXCore::X86Tables::X86InstInfo const* TableInfo {nullptr};
-          FEXCore::X86Tables::DecodedInst const* DecodedInfo {nullptr};
+          uint64_t BlockInstructionsLength {};
 
-          TableInfo = Block.DecodedInstructions[i].TableInfo;
-          DecodedInfo = &Block.DecodedInstructions[i];
+          uint64_t InstsInBlock = Block.NumInstructions;
+          for (size_t i = 0; i < InstsInBlock; ++i) {
+            FEXCore::X86Tables::X86InstInfo const* TableInfo {nullptr};
+            FEXCore::X86Tables::DecodedInst const* DecodedInfo {nullptr};
 
-          if (TableInfo->OpcodeDispatcher) {
-            auto Fn = TableInfo->OpcodeDispatcher;
-            std::invoke(Fn, Thread->OpDispatcher, DecodedInfo);
-            if (Thread->OpDispatcher->HadDecodeFailure()) {
-              if (Config.BreakOnFrontendFailure) {
-                LogMan::Msg::E("Had OpDispatcher error at 0x%lx", GuestRIP);
-                ShouldStop = true;
+            TableInfo = Block.DecodedInstructions[i].TableInfo;
+            DecodedInfo = &Block.DecodedInstructions[i];
+
+            if (TableInfo->OpcodeDispatcher) {
+              auto Fn = TableInfo->OpcodeDispatcher;
+              std::invoke(Fn, Thread->OpDispatcher, DecodedInfo);
+              if (Thread->OpDispatcher->HadDecodeFailure()) {
+                if (Config.BreakOnFrontendFailure) {
+                  LogMan::Msg::E("Had OpDispatcher error at 0x%lx", GuestRIP);
+                  ShouldStop = true;
+                }
+                HadDispatchError = true;
+              }
+              else {
+                BlockInstructionsLength += DecodedInfo->InstSize;
+                TotalInstructionsLength += DecodedInfo->InstSize;
+                ++TotalInstructions;
               }
-              HadDispatchError = true;
             }
             else {
-              BlockInstructionsLength += DecodedInfo->InstSize;
-              TotalInstructionsLength += DecodedInfo->InstSize;
-              ++TotalInstructions;
+              LogMan::Msg::E("Missing OpDispatcher at 0x%lx{'%s'}", Block.Entry + BlockInstructionsLength, TableInfo->Name);
+              HadDispatchError = true;
             }
-          }
-          else {
-            LogMan::Msg::E("Missing OpDispatcher at 0x%lx{'%s'}", Block.Entry + BlockInstructionsLength, TableInfo->Name);
-            HadDispatchError = true;
-          }
 
-          // If we had a dispatch error then leave early
-          if (HadDispatchError) {
-            if (TotalInstructions == 0) {
-              // Couldn't handle any instruction in op dispatcher
-              Thread->OpDispatcher->ResetWorkingList();
-              return 0;
+            // If we had a dispatch error then leave early
+            if (HadDispatchError) {
+              if (TotalInstructions == 0) {
+                // Couldn't handle any instruction in op dispatcher
+                Thread->OpDispatcher->ResetWorkingList();
+                return 0;
+              }
+              else {
+                // We had some instructions. Early exit
+                Thread->OpDispatcher->_StoreContext(IR::GPRClass, 8, offsetof(FEXCore::Core::CPUState, rip), Thread->OpDispatcher->_Constant(Block.Entry + BlockInstructionsLength));
+                Thread->OpDispatcher->_ExitFunction();
+                break;
+              }
             }
-            else {
-              // We had some instructions. Early exit
-              Thread->OpDispatcher->_StoreContext(IR::GPRClass, 8, offsetof(FEXCore::Core::CPUState, rip), Thread->OpDispatcher->_Constant(Block.Entry + BlockInstructionsLength));
-              Thread->OpDispatcher->_ExitFunction();
+
+            if (Thread->OpDispatcher->FinishOp(DecodedInfo->PC + DecodedInfo->InstSize, i + 1 == InstsInBlock)) {
               break;
             }
           }
 
-          if (Thread->OpDispatcher->FinishOp(DecodedInfo->PC + DecodedInfo->InstSize, i + 1 == InstsInBlock)) {
-            break;
-          }
+          CodeRanges.emplace_back(Block.Entry, Block.Entry + BlockInstructionsLength);
         }
-      }
 
-      Thread->OpDispatcher->Finalize();
+        Thread->OpDispatcher->Finalize();
 
-      // Run the passmanager over the IR from the dispatcher
-      PassManager.Run(Thread->OpDispatcher.get());
+        if (Stats) {
+          uint64_t Time = StageTime();
+          Stats->Dispatch.AddRun(Time, 0, FEXCore::IR::PassManager::CountNodes(Thread->OpDispatcher.get()), true);
+        }
+
+        // Run the passmanager over the IR from the dispatcher
+        if (Translations) {
+          Thread->PassManager->RunBeforeRA(Thread->OpDispatcher.get());
+          TranslatedIR.reset(Thread->OpDispatcher->CreateIRCopy());
+          Thread->PassManager->RunRA(Thread->OpDispatcher.get());
+        }
+        else {
+          Thread->PassManager->Run(Thread->OpDispatcher.get());
+        }
+      }
 
       if (Thread->OpDispatcher->ShouldDump) {
         std::stringstream out;
         auto NewIR = Thread->OpDispatcher->ViewIR();
+        auto RAPass = Thread->PassManager->HasRegisterAllocationPass() ? Thread->PassManager->GetRegisterAllocatorPass() : nullptr;
         FEXCore::IR::Dump(&out, &NewIR, RAPass);
         printf("IR 0x%lx:\n%s\n@@@@@\n", GuestRIP, out.str().c_str());
       }
 
-      // Create a copy of the IR and place it in this thread's IR cache
-      auto AddedIR = Thread->IRLists.try_emplace(GuestRIP, Thread->OpDispatcher->CreateIRCopy());
-      Thread->OpDispatcher->ResetWorkingList();
+      // Create a copy of the IR and publish it in the shared IR cache
+      {
+        std::unique_lock<std::shared_mutex> lk(CodeCacheMutex);
+        auto &CachedIR = IRLists[GuestRIP];
+        if (!CachedIR || Reoptimize) {
+          if (CachedIR) {
+            // Other threads might still be interpreting the old IR
+            RetireIR(std::move(CachedIR));
+          }
+          CachedIR.reset(Thread->OpDispatcher->CreateIRCopy(&IRStorage));
+          CodePages->AddBlock(GuestRIP, CodeRanges);
+          if (TranslatedIR) {
+            Translations->AddBlock(GuestRIP, CodeRanges, TranslatedIR.release(), TotalInstructionsLength, TotalInstructions);
+          }
+        }
 
-      auto Debugit = Thread->DebugData.try_emplace(GuestRIP);
-      Debugit.first->second.GuestCodeSize = TotalInstructionsLength;
-      Debugit.first->second.GuestInstructionCount = TotalInstructions;
+        auto Debugit = DebugData.try_emplace(GuestRIP);
+        Debugit.first->second.GuestCodeSize = TotalInstructionsLength;
+        Debugit.first->second.GuestInstructionCount = TotalInstructions;
 
-      IRList = AddedIR.first->second.get();
-      DebugData = &Debugit.first->second;
-      Thread->Stats.BlocksCompiled.fetch_add(1);
-    }
-    else {
-      IRList = IR->second.get();
-      auto Debugit = Thread->DebugData.find(GuestRIP);
-      if (Debugit != Thread->DebugData.end()) {
-        DebugData = &Debugit->second;
+        IRList = CachedIR.get();
+        BlockDebugData = &Debugit.first->second;
       }
+      Thread->OpDispatcher->ResetWorkingList();
+      Thread->Stats.BlocksCompiled.fetch_add(1);
     }
 
     // Attempt to get the CPU backend to compile this code
-    CodePtr = Thread->CPUBackend->CompileCode(IRList, DebugData);
+    if (Stats) {
+      StageStart = std::chrono::steady_clock::now();
+    }
+
+    CodePtr = Thread->CPUBackend->CompileCode(IRList, BlockDebugData);
+
+    if (Stats && IRList) {
+      uint64_t Time = StageTime();
+      uint64_t Nodes = FEXCore::IR::PassManager::CountNodes(IRList);
+      Stats->Codegen.AddRun(Time, Nodes, Nodes, false);
+    }
 
     if (CodePtr != nullptr) {
       // The core managed to compile the code.
 #if ENABLE_JITSYMBOLS
-      Symbols.Register(CodePtr, GuestRIP, DebugData->HostCodeSize);
+      Symbols.Register(CodePtr, GuestRIP, BlockDebugData->HostCodeSize);
 #endif
 
-      return AddBlockMapping(Thread, GuestRIP, CodePtr);
+      return AddBlockMapping(Thread, GuestRIP, CodePtr, IRList);
     }
 
     return 0;
@@ -622,6 +1273,11 @@ namespace FEXCore::Context {
     // It's mainly for testing new instruction encodings
     void *CodePtr = Thread->FallbackBackend->CompileCode(nullptr, nullptr);
     if (CodePtr) {
+      if (HasSharedBlockCache(Thread) && !Thread->FallbackBackend->SharesCodeBetweenThreads()) {
+        // Thread specific code can't be published to the shared cache, it just gets compiled again next time
+        return reinterpret_cast<uintptr_t>(CodePtr);
+      }
+
      uintptr_t Ptr = reinterpret_cast<uintptr_t >(AddBlockMapping(Thread, GuestRIP, CodePtr));
      return Ptr;
     }
@@ -629,6 +1285,63 @@ namespace FEXCore::Context {
     return 0;
   }
 
+  void Context::DumpCompileStats() {
+    // Background compilers count as well, tiering up and precompiling is compile time too
+    std::vector<FEXCore::Core::InternalThreadState*> CompileThreads {Threads};
+    if (TierUp.Thread) {
+      CompileThreads.emplace_back(TierUp.Thread.get());
+    }
+    for (auto &Thread : Precompile.Threads) {
+      CompileThreads.emplace_back(Thread.get());
+    }
+
+    FEXCore::Core::CompileStageStats Decode{}, Dispatch{}, Codegen{};
+    std::vector<std::pair<std::string, FEXCore::Core::CompileStageStats>> Passes;
+    auto Merge = [](FEXCore::Core::CompileStageStats *Total, FEXCore::Core::CompileStageStats const &Stage) {
+      Total->Runs += Stage.Runs;
+      Total->Nanoseconds += Stage.Nanoseconds;
+      Total->NodesBefore += Stage.NodesBefore;
+      Total->NodesAfter += Stage.NodesAfter;
+      Total->Changed += Stage.Changed;
+    };
+
+    for (auto Thread : CompileThreads) {
+      Merge(&Decode, Thread->Compilation.Decode);
+      Merge(&Dispatch, Thread->Compilation.Dispatch);
+      Merge(&Codegen, Thread->Compilation.Codegen);
+      for (auto const &Pass : Thread->Compilation.Passes) {
+        auto Total = std::find_if(Passes.begin(), Passes.end(), [&Pass](auto const &Total) { return Total.first == Pass.first; });
+        if (Total == Passes.end()) {
+          Passes.emplace_back(Pass.first, FEXCore::Core::CompileStageStats{});
+          Total = Passes.end() - 1;
+        }
+        Merge(&Total->second, Pass.second);
+      }
+    }
+
+    uint64_t TotalTime = Decode.Nanoseconds + Dispatch.Nanoseconds + Codegen.Nanoseconds;
+    for (auto const &Pass : Passes) {
+      TotalTime += Pass.second.Nanoseconds;
+    }
+
+    auto Print = [TotalTime](char const *Name, FEXCore::Core::CompileStageStats const &Stage) {
+      if (Stage.Runs == 0) {
+        return;
+      }
+      LogMan::Msg::I("%-32s %10.3fms %5.1f%% %8ld runs %10ld -> %10ld nodes %8ld changed",
+        Name, Stage.Nanoseconds / 1000000.0, TotalTime ? Stage.Nanoseconds * 100.0 / TotalTime : 0.0,
+        Stage.Runs, Stage.NodesBefore, Stage.NodesAfter, Stage.Changed);
+    };
+
+    LogMan::Msg::I("Compile stats over %ld threads, %.3fms total:", CompileThreads.size(), TotalTime / 1000000.0);
+    Print("Decode", Decode);
+    Print("Dispatch", Dispatch);
+    for (auto const &Pass : Passes) {
+      Print(Pass.first.c_str(), Pass.second);
+    }
+    Print("Codegen", Codegen);
+  }
+
   void Context::HandleExit(FEXCore::Core::InternalThreadState *thread) {
     PauseWait.NotifyAll();
 
@@ -660,6 +1373,7 @@ namespace FEXCore::Context {
 
     // Let's do some initial bookkeeping here
     Thread->State.ThreadManager.TID = ::gettid();
+    Thread->State.ThreadManager.PID = ::getpid();
     ++IdleWaitRefCount;
 
     // Now notify the thread that we are initialized
@@ -700,145 +1414,162 @@ namespace FEXCore::Context {
       }
     }
 
-    if (Thread->CPUBackend->HasCustomDispatch()) {
-      Thread->CPUBackend->ExecuteCustomDispatch(&Thread->State);
-    }
-    else {
-      while (!ShouldStop.load() && !Thread->State.RunningEvents.ShouldStop.load()) {
-        if (Initializing) {
-          if (Thread->State.State.rip == ~0ULL) {
-            if (InitializationStep < InitLocations.size()) {
-              Thread->State.State.gregs[X86State::REG_RSP] -= 8;
-              *MemoryMapper.GetPointer<uint64_t*>(Thread->State.State.gregs[X86State::REG_RSP]) = ~0ULL;
-              LogMan::Msg::D("Going down init path: 0x%lx", InitLocations[InitializationStep]);
-              Thread->State.State.rip = InitLocations[InitializationStep++];
-            }
-            else {
-              Initializing = false;
-              Thread->State.State.rip = StartingRIP;
-            }
+    uint64_t LastEpoch = CodeCacheEpoch.load();
+    while (!ShouldStop.load() && !Thread->State.RunningEvents.ShouldStop.load()) {
+      if (Initializing) {
+        if (Thread->State.State.rip == ~0ULL) {
+          if (InitializationStep < InitLocations.size()) {
+            Thread->State.State.gregs[X86State::REG_RSP] -= 8;
+            *MemoryMapper.GetPointer<uint64_t*>(Thread->State.State.gregs[X86State::REG_RSP]) = ~0ULL;
+            LogMan::Msg::D("Going down init path: 0x%lx", InitLocations[InitializationStep]);
+            Thread->State.State.rip = InitLocations[InitializationStep++];
+          }
+          else {
+            Initializing = false;
+            Thread->State.State.rip = StartingRIP;
           }
         }
-        uint64_t GuestRIP = Thread->State.State.rip;
+      }
+      uint64_t GuestRIP = Thread->State.State.rip;
+
+      // Publish the code cache epoch we are dispatching under before looking up any code
+      // Check it again so a retirement racing with us coming out of idle can't miss this thread
+      uint64_t Epoch;
+      do {
+        Epoch = CodeCacheEpoch.load();
+        Thread->CodeCacheEpoch.store(Epoch);
+      } while (Epoch != CodeCacheEpoch.load());
+
+      if (CodePages->HasWrittenPages()) {
+        // The guest wrote to its own code, throw out what was compiled from it before running anything
+        InvalidateWrittenCodePages();
+      }
+
+      if (Epoch != LastEpoch) {
+        // Return stack entries can point in to code buffers that are about to be freed
+        Thread->State.IndirectBranches.ResetReturns();
+        LastEpoch = Epoch;
+      }
+
+      if (CoreDebugLevel >= 1) {
+        char const *Name = LocalLoader->FindSymbolNameInRange(GuestRIP - MemoryBase);
+        LogMan::Msg::D(">>>>RIP: 0x%lx(0x%lx): '%s'", GuestRIP, GuestRIP - MemoryBase, Name ? Name : "<Unknown>");
+      }
 
-        if (CoreDebugLevel >= 1) {
-          char const *Name = LocalLoader->FindSymbolNameInRange(GuestRIP - MemoryBase);
-          LogMan::Msg::D(">>>>RIP: 0x%lx(0x%lx): '%s'", GuestRIP, GuestRIP - MemoryBase, Name ? Name : "<Unknown>");
+      if (!Thread->CPUBackend->NeedsOpDispatch()) {
+        BlockFn Ptr = reinterpret_cast<BlockFn>(Thread->CPUBackend->CompileCode(nullptr, nullptr));
+        Ptr(Thread);
+      }
+      else {
+        // Do have have this block compiled?
+        auto it = Thread->BlockCache->FindBlock(GuestRIP);
+        if (it == 0) {
+          // If not compile it
+          it = CompileBlock(Thread, GuestRIP);
         }
 
-        if (!Thread->CPUBackend->NeedsOpDispatch()) {
-          BlockFn Ptr = reinterpret_cast<BlockFn>(Thread->CPUBackend->CompileCode(nullptr, nullptr));
+        // Did we successfully compile this block?
+        if (it != 0) {
+          // Block is compiled, run it
+          BlockFn Ptr = reinterpret_cast<BlockFn>(it);
           Ptr(Thread);
         }
         else {
-          // Do have have this block compiled?
-          auto it = Thread->BlockCache->FindBlock(GuestRIP);
-          if (it == 0) {
-            // If not compile it
-            it = CompileBlock(Thread, GuestRIP);
-          }
-
-          // Did we successfully compile this block?
-          if (it != 0) {
-            // Block is compiled, run it
-            BlockFn Ptr = reinterpret_cast<BlockFn>(it);
+          // We have ONE more chance to try and fallback to the fallback CPU backend
+          // This will most likely fail since regular code use won't be using a fallback core.
+          // It's mainly for testing new instruction encodings
+          uintptr_t CodePtr = CompileFallbackBlock(Thread, GuestRIP);
+          if (CodePtr) {
+            BlockFn Ptr = reinterpret_cast<BlockFn>(CodePtr);
             Ptr(Thread);
           }
           else {
-            // We have ONE more chance to try and fallback to the fallback CPU backend
-            // This will most likely fail since regular code use won't be using a fallback core.
-            // It's mainly for testing new instruction encodings
-            uintptr_t CodePtr = CompileFallbackBlock(Thread, GuestRIP);
-            if (CodePtr) {
-              BlockFn Ptr = reinterpret_cast<BlockFn>(CodePtr);
-              Ptr(Thread);
-            }
-            else {
-              // Let the frontend know that something has happened that is unhandled
-              Thread->State.RunningEvents.ShouldPause = true;
-              Thread->ExitReason = FEXCore::Context::ExitReason::EXIT_UNKNOWNERROR;
-            }
+            // Let the frontend know that something has happened that is unhandled
+            Thread->State.RunningEvents.ShouldPause = true;
+            Thread->ExitReason = FEXCore::Context::ExitReason::EXIT_UNKNOWNERROR;
           }
         }
+      }
 
-        if (CoreDebugLevel >= 2) {
-          int i = 0;
-          LogMan::Msg::D("\tGPR[%d]: %016lx %016lx %016lx %016lx", i, Thread->State.State.gregs[i + 0], Thread->State.State.gregs[i + 1], Thread->State.State.gregs[i + 2], Thread->State.State.gregs[i + 3]);
-          i += 4;
-          LogMan::Msg::D("\tGPR[%d]: %016lx %016lx %016lx %016lx", i, Thread->State.State.gregs[i + 0], Thread->State.State.gregs[i + 1], Thread->State.State.gregs[i + 2], Thread->State.State.gregs[i + 3]);
-          i += 4;
-          LogMan::Msg::D("\tGPR[%d]: %016lx %016lx %016lx %016lx", i, Thread->State.State.gregs[i + 0], Thread->State.State.gregs[i + 1], Thread->State.State.gregs[i + 2], Thread->State.State.gregs[i + 3]);
-          i += 4;
-          LogMan::Msg::D("\tGPR[%d]: %016lx %016lx %016lx %016lx", i, Thread->State.State.gregs[i + 0], Thread->State.State.gregs[i + 1], Thread->State.State.gregs[i + 2], Thread->State.State.gregs[i + 3]);
-          uint64_t PackedFlags{};
-          for (i = 0; i < 32; ++i) {
-            PackedFlags |= static_cast<uint64_t>(Thread->State.State.flags[i]) << i;
-          }
-          LogMan::Msg::D("\tFlags: %016lx", PackedFlags);
+      if (CoreDebugLevel >= 2) {
+        int i = 0;
+        LogMan::Msg::D("\tGPR[%d]: %016lx %016lx %016lx %016lx", i, Thread->State.State.gregs[i + 0], Thread->State.State.gregs[i + 1], Thread->State.State.gregs[i + 2], Thread->State.State.gregs[i + 3]);
+        i += 4;
+        LogMan::Msg::D("\tGPR[%d]: %016lx %016lx %016lx %016lx", i, Thread->State.State.gregs[i + 0], Thread->State.State.gregs[i + 1], Thread->State.State.gregs[i + 2], Thread->State.State.gregs[i + 3]);
+        i += 4;
+        LogMan::Msg::D("\tGPR[%d]: %016lx %016lx %016lx %016lx", i, Thread->State.State.gregs[i + 0], Thread->State.State.gregs[i + 1], Thread->State.State.gregs[i + 2], Thread->State.State.gregs[i + 3]);
+        i += 4;
+        LogMan::Msg::D("\tGPR[%d]: %016lx %016lx %016lx %016lx", i, Thread->State.State.gregs[i + 0], Thread->State.State.gregs[i + 1], Thread->State.State.gregs[i + 2], Thread->State.State.gregs[i + 3]);
+        uint64_t PackedFlags{};
+        for (i = 0; i < 32; ++i) {
+          PackedFlags |= static_cast<uint64_t>(Thread->State.State.flags[i]) << i;
         }
+        LogMan::Msg::D("\tFlags: %016lx", PackedFlags);
+      }
 
-        if (CoreDebugLevel >= 3) {
-          int i = 0;
-          LogMan::Msg::D("\tXMM[%d][0]: %016lx %016lx %016lx %016lx", i, Thread->State.State.xmm[i + 0][0], Thread->State.State.xmm[i + 1][0], Thread->State.State.xmm[i + 2][0], Thread->State.State.xmm[i + 3][0]);
-          LogMan::Msg::D("\tXMM[%d][1]: %016lx %016lx %016lx %016lx", i, Thread->State.State.xmm[i + 0][1], Thread->State.State.xmm[i + 1][1], Thread->State.State.xmm[i + 2][1], Thread->State.State.xmm[i + 3][1]);
-
-          i += 4;
-          LogMan::Msg::D("\tXMM[%d][0]: %016lx %016lx %016lx %016lx", i, Thread->State.State.xmm[i + 0][0], Thread->State.State.xmm[i + 1][0], Thread->State.State.xmm[i + 2][0], Thread->State.State.xmm[i + 3][0]);
-          LogMan::Msg::D("\tXMM[%d][1]: %016lx %016lx %016lx %016lx", i, Thread->State.State.xmm[i + 0][1], Thread->State.State.xmm[i + 1][1], Thread->State.State.xmm[i + 2][1], Thread->State.State.xmm[i + 3][1]);
-          i += 4;
-          LogMan::Msg::D("\tXMM[%d][0]: %016lx %016lx %016lx %016lx", i, Thread->State.State.xmm[i + 0][0], Thread->State.State.xmm[i + 1][0], Thread->State.State.xmm[i + 2][0], Thread->State.State.xmm[i + 3][0]);
-          LogMan::Msg::D("\tXMM[%d][1]: %016lx %016lx %016lx %016lx", i, Thread->State.State.xmm[i + 0][1], Thread->State.State.xmm[i + 1][1], Thread->State.State.xmm[i + 2][1], Thread->State.State.xmm[i + 3][1]);
-          i += 4;
-          LogMan::Msg::D("\tXMM[%d][0]: %016lx %016lx %016lx %016lx", i, Thread->State.State.xmm[i + 0][0], Thread->State.State.xmm[i + 1][0], Thread->State.State.xmm[i + 2][0], Thread->State.State.xmm[i + 3][0]);
-          LogMan::Msg::D("\tXMM[%d][1]: %016lx %016lx %016lx %016lx", i, Thread->State.State.xmm[i + 0][1], Thread->State.State.xmm[i + 1][1], Thread->State.State.xmm[i + 2][1], Thread->State.State.xmm[i + 3][1]);
-          uint64_t PackedFlags{};
-          for (i = 0; i < 32; ++i) {
-            PackedFlags |= static_cast<uint64_t>(Thread->State.State.flags[i]) << i;
-          }
-          LogMan::Msg::D("\tFlags: %016lx", PackedFlags);
+      if (CoreDebugLevel >= 3) {
+        int i = 0;
+        LogMan::Msg::D("\tXMM[%d][0]: %016lx %016lx %016lx %016lx", i, Thread->State.State.xmm[i + 0][0], Thread->State.State.xmm[i + 1][0], Thread->State.State.xmm[i + 2][0], Thread->State.State.xmm[i + 3][0]);
+        LogMan::Msg::D("\tXMM[%d][1]: %016lx %016lx %016lx %016lx", i, Thread->State.State.xmm[i + 0][1], Thread->State.State.xmm[i + 1][1], Thread->State.State.xmm[i + 2][1], Thread->State.State.xmm[i + 3][1]);
+
+        i += 4;
+        LogMan::Msg::D("\tXMM[%d][0]: %016lx %016lx %016lx %016lx", i, Thread->State.State.xmm[i + 0][0], Thread->State.State.xmm[i + 1][0], Thread->State.State.xmm[i + 2][0], Thread->State.State.xmm[i + 3][0]);
+        LogMan::Msg::D("\tXMM[%d][1]: %016lx %016lx %016lx %016lx", i, Thread->State.State.xmm[i + 0][1], Thread->State.State.xmm[i + 1][1], Thread->State.State.xmm[i + 2][1], Thread->State.State.xmm[i + 3][1]);
+        i += 4;
+        LogMan::Msg::D("\tXMM[%d][0]: %016lx %016lx %016lx %016lx", i, Thread->State.State.xmm[i + 0][0], Thread->State.State.xmm[i + 1][0], Thread->State.State.xmm[i + 2][0], Thread->State.State.xmm[i + 3][0]);
+        LogMan::Msg::D("\tXMM[%d][1]: %016lx %016lx %016lx %016lx", i, Thread->State.State.xmm[i + 0][1], Thread->State.State.xmm[i + 1][1], Thread->State.State.xmm[i + 2][1], Thread->State.State.xmm[i + 3][1]);
+        i += 4;
+        LogMan::Msg::D("\tXMM[%d][0]: %016lx %016lx %016lx %016lx", i, Thread->State.State.xmm[i + 0][0], Thread->State.State.xmm[i + 1][0], Thread->State.State.xmm[i + 2][0], Thread->State.State.xmm[i + 3][0]);
+        LogMan::Msg::D("\tXMM[%d][1]: %016lx %016lx %016lx %016lx", i, Thread->State.State.xmm[i + 0][1], Thread->State.State.xmm[i + 1][1], Thread->State.State.xmm[i + 2][1], Thread->State.State.xmm[i + 3][1]);
+        uint64_t PackedFlags{};
+        for (i = 0; i < 32; ++i) {
+          PackedFlags |= static_cast<uint64_t>(Thread->State.State.flags[i]) << i;
         }
+        LogMan::Msg::D("\tFlags: %016lx", PackedFlags);
+      }
 
-        if (Thread->State.RunningEvents.ShouldStop.load()) {
-          // If it is the parent thread that died then just leave
-          // XXX: This doesn't make sense when the parent thread doesn't outlive its children
-          if (Thread->State.ThreadManager.parent_tid == 0) {
-            ShouldStop = true;
-            Thread->ExitReason = FEXCore::Context::ExitReason::EXIT_SHUTDOWN;
-          }
-
-          --IdleWaitRefCount;
-          IdleWaitCV.notify_all();
-          break;
+      if (Thread->State.RunningEvents.ShouldStop.load()) {
+        // If it is the parent thread that died then just leave
+        // XXX: This doesn't make sense when the parent thread doesn't outlive its children
+        if (Thread->State.ThreadManager.parent_tid == 0) {
+          ShouldStop = true;
+          Thread->ExitReason = FEXCore::Context::ExitReason::EXIT_SHUTDOWN;
         }
 
-        if (RunningMode == FEXCore::Context::CoreRunningMode::MODE_SINGLESTEP || Thread->State.RunningEvents.ShouldPause) {
-          Thread->State.RunningEvents.Running = false;
-          Thread->State.RunningEvents.WaitingToStart = false;
+        --IdleWaitRefCount;
+        IdleWaitCV.notify_all();
+        break;
+      }
 
-          // If something previously hasn't set the exit state then set it now
-          if (Thread->ExitReason == FEXCore::Context::ExitReason::EXIT_NONE)
-            Thread->ExitReason = FEXCore::Context::ExitReason::EXIT_DEBUG;
+      if (RunningMode == FEXCore::Context::CoreRunningMode::MODE_SINGLESTEP || Thread->State.RunningEvents.ShouldPause) {
+        Thread->State.RunningEvents.Running = false;
+        Thread->State.RunningEvents.WaitingToStart = false;
 
-          --IdleWaitRefCount;
-          IdleWaitCV.notify_all();
+        // If something previously hasn't set the exit state then set it now
+        if (Thread->ExitReason == FEXCore::Context::ExitReason::EXIT_NONE)
+          Thread->ExitReason = FEXCore::Context::ExitReason::EXIT_DEBUG;
 
-          HandleExit(Thread);
+        --IdleWaitRefCount;
+        IdleWaitCV.notify_all();
 
-          Thread->StartRunning.Wait();
+        Thread->CodeCacheEpoch.store(~0ULL);
+        HandleExit(Thread);
 
-          // If we set it to debug then set it back to none after this
-          // We want to retain the state if the frontend decides to leave
-          if (Thread->ExitReason == FEXCore::Context::ExitReason::EXIT_DEBUG)
-            Thread->ExitReason = FEXCore::Context::ExitReason::EXIT_NONE;
+        Thread->StartRunning.Wait();
 
-          Thread->State.RunningEvents.Running = true;
-          ++IdleWaitRefCount;
-        }
+        // If we set it to debug then set it back to none after this
+        // We want to retain the state if the frontend decides to leave
+        if (Thread->ExitReason == FEXCore::Context::ExitReason::EXIT_DEBUG)
+          Thread->ExitReason = FEXCore::Context::ExitReason::EXIT_NONE;
+
+        Thread->State.RunningEvents.Running = true;
+        ++IdleWaitRefCount;
       }
     }
 
     Thread->State.RunningEvents.WaitingToStart = false;
     Thread->State.RunningEvents.Running = false;
+    Thread->CodeCacheEpoch.store(~0ULL);
   }
 
   // Debug interface
@@ -847,9 +1578,17 @@ namespace FEXCore::Context {
     Thread->State.State.rip = RIP;
 
     // Erase the RIP from all the storage backings if it exists
-    Thread->IRLists.erase(RIP);
-    Thread->DebugData.erase(RIP);
-    Thread->BlockCache->Erase(RIP);
+    // Debug data stays, the old code still counts its runs in it
+    {
+      std::unique_lock<std::shared_mutex> lk(CodeCacheMutex);
+      // Other threads might still be interpreting it, or returning in to the old code
+      auto CachedIR = IRLists.find(RIP);
+      if (CachedIR != IRLists.end()) {
+        RetiredIR.emplace_back(CodeCacheEpoch.fetch_add(1) + 1, std::move(CachedIR->second));
+        IRLists.erase(CachedIR);
+      }
+      Thread->BlockCache->Erase(RIP);
+    }
 
     // We don't care if compilation passes or not
     CompileBlock(Thread, RIP);
@@ -859,6 +1598,8 @@ namespace FEXCore::Context {
 
   void *Context::MapRegion(FEXCore::Core::InternalThreadState *Thread, uint64_t Offset, uint64_t Size, bool Fixed, bool RelativeToBase) {
     void *Ptr = MemoryMapper.MapRegion(Offset, Size, Fixed, RelativeToBase);
+    // Loader and test regions can sit in the mmap window
+    SyscallHandler->ReserveGuestMemory(Offset, Size);
     Thread->CPUBackend->MapRegion(Ptr, Offset, Size);
     Thread->FallbackBackend->MapRegion(Ptr, Offset, Size);
     return Ptr;
@@ -874,7 +1615,7 @@ namespace FEXCore::Context {
   }
 
   void Context::CopyMemoryMapping([[maybe_unused]] FEXCore::Core::InternalThreadState*, FEXCore::Core::InternalThreadState *ChildThread) {
-    auto Regions = MemoryMapper.MappedRegions;
+    auto Regions = MemoryMapper.GetRegions();
     for (auto const& Region : Regions) {
       ChildThread->CPUBackend->MapRegion(Region.Ptr, Region.Offset, Region.Size);
       ChildThread->FallbackBackend->MapRegion(Region.Ptr, Region.Offset, Region.Size);
@@ -889,19 +1630,22 @@ namespace FEXCore::Context {
     return &Threads[Thread]->Stats;
   }
 
+  FEXCore::Core::CompileStats *Context::GetCompileStatsForThread(uint64_t Thread) {
+    return &Threads[Thread]->Compilation;
+  }
+
   FEXCore::Core::CPUState Context::GetCPUState() {
     return ParentThread->State.State;
   }
 
   void Context::GetMemoryRegions(std::vector<FEXCore::Memory::MemRegion> *Regions) {
-    Regions->clear();
-    Regions->resize(MemoryMapper.MappedRegions.size());
-    memcpy(&Regions->at(0), &MemoryMapper.MappedRegions.at(0), sizeof(FEXCore::Memory::MemRegion) * MemoryMapper.MappedRegions.size());
+    *Regions = MemoryMapper.GetRegions();
   }
 
   bool Context::GetDebugDataForRIP(uint64_t RIP, FEXCore::Core::DebugData *Data) {
-    auto it = ParentThread->DebugData.find(RIP);
-    if (it == ParentThread->DebugData.end()) {
+    std::shared_lock<std::shared_mutex> lk(CodeCacheMutex);
+    auto it = DebugData.find(RIP);
+    if (it == DebugData.end()) {
       return false;
     }
 
@@ -919,20 +1663,27 @@ namespace FEXCore::Context {
     return true;
   }
 
-	// XXX:
-  // bool Context::FindIRForRIP(uint64_t RIP, FEXCore::IR::IntrusiveIRList **ir) {
-  //   auto IR = ParentThread->IRLists.find(RIP);
-  //   if (IR == ParentThread->IRLists.end()) {
-  //     return false;
-  //   }
+  void Context::GetCachedRIPs(std::vector<uint64_t> *RIPs) {
+    std::shared_lock<std::shared_mutex> lk(CodeCacheMutex);
+    RIPs->clear();
+    for (auto &Data : DebugData) {
+      RIPs->emplace_back(Data.first);
+    }
+  }
+
+  bool Context::FindIRForRIP(uint64_t RIP, FEXCore::IR::IRListView<true> **IR, FEXCore::Core::DebugData **Data) {
+    std::shared_lock<std::shared_mutex> lk(CodeCacheMutex);
+    auto it = IRLists.find(RIP);
+    if (it == IRLists.end()) {
+      return false;
+    }
 
-  //   //*ir = &IR->second;
-  //   return true;
-  // }
+    *IR = it->second.get();
 
-  // void Context::SetIRForRIP(uint64_t RIP, FEXCore::IR::IntrusiveIRList *const ir) {
-  //   //ParentThread->IRLists.try_emplace(RIP, *ir);
-  // }
+    auto Debugit = DebugData.find(RIP);
+    *Data = Debugit != DebugData.end() ? &Debugit->second : nullptr;
+    return true;
+  }
 
   FEXCore::Core::ThreadState *Context::GetThreadState() {
     return &ParentThread->State;
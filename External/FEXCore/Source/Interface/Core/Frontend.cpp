@@ -860,7 +860,7 @@ bool Decoder::DecodeInstruction(uint64_t PC) {
 }
 
 void Decoder::BranchTargetInMultiblockRange() {
-  if (!CTX->Config.Multiblock)
+  if (!Multiblock)
     return;
 
   // If the RIP setting is conditional AND within our symbol range then it can be considered for multiblock
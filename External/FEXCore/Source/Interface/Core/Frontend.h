@@ -29,6 +29,8 @@ public:
     return &Blocks;
   }
 
+  void SetMultiblock(bool _Multiblock) { Multiblock = _Multiblock; }
+
 private:
   FEXCore::Context::Context *CTX;
 
@@ -57,6 +59,7 @@ private:
   FEXCore::X86Tables::DecodedInst *DecodeInst;
 
   // This is for multiblock data tracking
+  bool Multiblock {false};
   bool SymbolAvailable {false};
   uint64_t EntryPoint {};
   uint64_t MaxCondBranchForward {};
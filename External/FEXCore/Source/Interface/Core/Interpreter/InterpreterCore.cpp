@@ -1,6 +1,7 @@
 #include "LogManager.h"
 #include "Common/MathUtils.h"
 #include "Interface/Context/Context.h"
+#include "Interface/Core/BulkMemoryOps.h"
 #include "Interface/Core/DebugData.h"
 #include "Interface/Core/InternalThreadState.h"
 #include "Interface/HLE/Syscalls.h"
@@ -35,6 +36,9 @@ public:
 
   bool NeedsOpDispatch() override { return true; }
 
+  // Every block compiles to the same thunk which looks the IR up at execution time
+  bool SharesCodeBetweenThreads() const override { return true; }
+
   void ExecuteCode(FEXCore::Core::InternalThreadState *Thread);
 private:
   FEXCore::Context::Context *CTX;
@@ -46,6 +50,9 @@ private:
   template<typename Res>
   Res GetSrc(IR::OrderedNodeWrapper Src);
 
+  uint64_t GetMemAddress(IR::IROp_Header const *IROp);
+  uint8_t *GetMemPointer(uint64_t Addr);
+
   std::vector<uint8_t> TmpSpace;
   DestMapType DestMap;
   size_t TmpOffset{};
@@ -104,13 +111,51 @@ Res InterpreterCore::GetSrc(IR::OrderedNodeWrapper Src) {
   return reinterpret_cast<Res>(DstPtr);
 }
 
+// Guest address of a memory op, Base + Index * Scale + Displacement
+uint64_t InterpreterCore::GetMemAddress(IR::IROp_Header const *IROp) {
+  uint64_t Addr = *GetSrc<uint64_t*>(IROp->Args[0]);
+  switch (IROp->Op) {
+  case IR::OP_LOADMEM:
+    return Addr + IROp->C<IR::IROp_LoadMem>()->Displacement;
+  case IR::OP_STOREMEM:
+    return Addr + IROp->C<IR::IROp_StoreMem>()->Displacement;
+  case IR::OP_LOADMEMINDEXED: {
+    auto Op = IROp->C<IR::IROp_LoadMemIndexed>();
+    return Addr + *GetSrc<uint64_t*>(Op->Index) * Op->Scale + Op->Displacement;
+  }
+  case IR::OP_STOREMEMINDEXED: {
+    auto Op = IROp->C<IR::IROp_StoreMemIndexed>();
+    return Addr + *GetSrc<uint64_t*>(Op->Index) * Op->Scale + Op->Displacement;
+  }
+  default: LogMan::Msg::A("Not a memory op"); break;
+  }
+  return 0;
+}
+
+uint8_t *InterpreterCore::GetMemPointer(uint64_t Addr) {
+  if (CTX->Config.UnifiedMemory) {
+    return reinterpret_cast<uint8_t*>(Addr);
+  }
+
+  auto Data = CTX->MemoryMapper.GetPointer<uint8_t*>(Addr);
+  LogMan::Throw::A(Data != nullptr, "Couldn't Map pointer to 0x%lx\n", Addr);
+  return Data;
+}
+
 void *InterpreterCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const *IR, [[maybe_unused]] FEXCore::Core::DebugData *DebugData) {
   return reinterpret_cast<void*>(InterpreterExecution);
 }
 
 void InterpreterCore::ExecuteCode(FEXCore::Core::InternalThreadState *Thread) {
-  auto IR = Thread->IRLists.find(Thread->State.State.rip);
-  CurrentIR = IR->second.get();
+  FEXCore::Core::DebugData *DebugData {};
+  CTX->FindIRForRIP(Thread->State.State.rip, &CurrentIR, &DebugData);
+
+  if (DebugData && CTX->CountBlockExecutions) {
+    uint64_t RunCount = __atomic_add_fetch(&DebugData->RunCount, 1, __ATOMIC_RELAXED);
+    if (RunCount == CTX->Config.TierUpThreshold && CTX->IsBaselineTier(Thread)) {
+      CTX->QueueTierUp(Thread->State.State.rip);
+    }
+  }
 
   TmpOffset = 0; // Reset where we are in the temp data range
 
@@ -230,6 +275,21 @@ void InterpreterCore::ExecuteCode(FEXCore::Core::InternalThreadState *Thread) {
             GD = Res;
             break;
           }
+          case IR::OP_INLINESYSCALL: {
+            auto Op = IROp->C<IR::IROp_InlineSyscall>();
+
+            // Nothing to gain from calling the handler directly here, rebuild the arguments for the generic path
+            FEXCore::HLE::SyscallArguments Args{};
+            Args.Argument[0] = Op->SyscallNumber;
+            for (size_t j = 0; j < FEXCore::HLE::SyscallArguments::MAX_ARGS - 1; ++j) {
+              if (Op->Header.Args[j].IsInvalid()) break;
+              Args.Argument[j + 1] = *GetSrc<uint64_t*>(Op->Header.Args[j]);
+            }
+
+            uint64_t Res = FEXCore::HandleSyscall(CTX->SyscallHandler.get(), Thread, &Args);
+            GD = Res;
+            break;
+          }
           case IR::OP_CPUID: {
             auto Op = IROp->C<IR::IROp_CPUID>();
             uint64_t *DstPtr = GetDest<uint64_t*>(*WrapperOp);
@@ -257,6 +317,12 @@ void InterpreterCore::ExecuteCode(FEXCore::Core::InternalThreadState *Thread) {
               LogMan::Msg::A("Unknown value size: %d", OpSize);
             break;
           }
+          case IR::OP_LOADTHREADMANAGER: {
+            auto Op = IROp->C<IR::IROp_LoadThreadManager>();
+            uintptr_t ThreadManager = reinterpret_cast<uintptr_t>(&Thread->State.ThreadManager);
+            memcpy(GDP, reinterpret_cast<void*>(ThreadManager + Op->Offset), 8);
+            break;
+          }
           case IR::OP_CYCLECOUNTER: {
             #ifdef DEBUG_CYCLES
               GD = 0;
@@ -543,58 +609,75 @@ void InterpreterCore::ExecuteCode(FEXCore::Core::InternalThreadState *Thread) {
             *Data = Arg;
             break;
           }
-          case IR::OP_LOADMEM: {
-            auto Op = IROp->C<IR::IROp_LoadMem>();
+          case IR::OP_LOADMEM:
+          case IR::OP_LOADMEMINDEXED: {
+            uint64_t Addr = GetMemAddress(IROp);
             void const *Data{};
             if (Thread->CTX->Config.UnifiedMemory) {
-              Data = *GetSrc<void const**>(Op->Header.Args[0]);
+              Data = reinterpret_cast<void const*>(Addr);
             }
             else {
-              Data = Thread->CTX->MemoryMapper.GetPointer<void const*>(*GetSrc<uint64_t*>(Op->Header.Args[0]));
-              LogMan::Throw::A(Data != nullptr, "Couldn't Map pointer to 0x%lx\n", *GetSrc<uint64_t*>(Op->Header.Args[0]));
+              Data = Thread->CTX->MemoryMapper.GetPointer<void const*>(Addr);
+              LogMan::Throw::A(Data != nullptr, "Couldn't Map pointer to 0x%lx\n", Addr);
             }
             memcpy(GDP, Data, OpSize);
             break;
           }
-          case IR::OP_STOREMEM: {
-            #define STORE_DATA(x, y) \
-              case x: { \
-                y *Data{}; \
-                if (Thread->CTX->Config.UnifiedMemory) { \
-                  Data = *GetSrc<y**>(Op->Header.Args[0]); \
-                } \
-                else { \
-                  Data = Thread->CTX->MemoryMapper.GetPointer<y*>(*GetSrc<uint64_t*>(Op->Header.Args[0])); \
-                  LogMan::Throw::A(Data != nullptr, "Couldn't Map pointer to 0x%lx\n", *GetSrc<uint64_t*>(Op->Header.Args[0])); \
-                } \
-                memcpy(Data, GetSrc<y*>(Op->Header.Args[1]), sizeof(y)); \
-                break; \
-              }
-
-            auto Op = IROp->C<IR::IROp_StoreMem>();
-
-            switch (Op->Size) {
-              STORE_DATA(1, uint8_t)
-              STORE_DATA(2, uint16_t)
-              STORE_DATA(4, uint32_t)
-              STORE_DATA(8, uint64_t)
-              case 16: {
-                void *Data{};
-                if (Thread->CTX->Config.UnifiedMemory) {
-                  Data = *GetSrc<void**>(Op->Header.Args[0]);
-                }
-                else {
-                  Data = Thread->CTX->MemoryMapper.GetPointer<void*>(*GetSrc<uint64_t*>(Op->Header.Args[0]));
-                  LogMan::Throw::A(Data != nullptr, "Couldn't Map pointer to 0x%lx\n", *GetSrc<uint64_t*>(Op->Header.Args[0]));
-                }
+          case IR::OP_STOREMEM:
+          case IR::OP_STOREMEMINDEXED: {
+            uint64_t Addr = GetMemAddress(IROp);
+            uint8_t Size = IROp->Op == IR::OP_STOREMEM ? IROp->C<IR::IROp_StoreMem>()->Size : IROp->C<IR::IROp_StoreMemIndexed>()->Size;
+            void *Data{};
+            if (Thread->CTX->Config.UnifiedMemory) {
+              Data = reinterpret_cast<void*>(Addr);
+            }
+            else {
+              Data = Thread->CTX->MemoryMapper.GetPointer<void*>(Addr);
+              LogMan::Throw::A(Data != nullptr, "Couldn't Map pointer to 0x%lx\n", Addr);
+            }
 
-                void *Src = GetSrc<void*>(Op->Header.Args[1]);
-                memcpy(Data, Src, 16);
+            switch (Size) {
+              case 1:
+              case 2:
+              case 4:
+              case 8:
+              case 16:
+                memcpy(Data, GetSrc<void*>(IROp->Args[1]), Size);
                 break;
-              }
               default: LogMan::Msg::A("Unhandled StoreMem size"); break;
             }
-            #undef STORE_DATA
+            break;
+          }
+          case IR::OP_MEMCPY: {
+            auto Op = IROp->C<IR::IROp_MemCpy>();
+            uint64_t Count = *GetSrc<uint64_t*>(Op->Count);
+            if (Count) {
+              BulkCopy(GetMemPointer(*GetSrc<uint64_t*>(Op->Dest)),
+                GetMemPointer(*GetSrc<uint64_t*>(Op->Src)),
+                Count, Op->Size, *GetSrc<uint8_t*>(Op->Direction) != 0);
+            }
+            break;
+          }
+          case IR::OP_MEMSET: {
+            auto Op = IROp->C<IR::IROp_MemSet>();
+            uint64_t Count = *GetSrc<uint64_t*>(Op->Count);
+            if (Count) {
+              BulkFill(GetMemPointer(*GetSrc<uint64_t*>(Op->Dest)),
+                *GetSrc<uint64_t*>(Op->Value),
+                Count, Op->Size, *GetSrc<uint8_t*>(Op->Direction) != 0);
+            }
+            break;
+          }
+          case IR::OP_MEMCMP: {
+            auto Op = IROp->C<IR::IROp_MemCmp>();
+            uint64_t Count = *GetSrc<uint64_t*>(Op->Count);
+            uint64_t Compared{};
+            if (Count) {
+              Compared = BulkCompare(GetMemPointer(*GetSrc<uint64_t*>(Op->Src1)),
+                GetMemPointer(*GetSrc<uint64_t*>(Op->Src2)),
+                Count, Op->Size, *GetSrc<uint8_t*>(Op->Direction) != 0, Op->WhileEqual);
+            }
+            memcpy(GDP, &Compared, sizeof(Compared));
             break;
           }
           #define DO_OP(size, type, func)              \
@@ -3874,9 +3957,8 @@ void InterpreterCore::ExecuteCode(FEXCore::Core::InternalThreadState *Thread) {
     }
   }
 
-  auto DebugData = Thread->DebugData.find(Thread->State.State.rip);
-  if (DebugData != Thread->DebugData.end()) {
-    Thread->Stats.InstructionsExecuted.fetch_add(DebugData->second.GuestInstructionCount);
+  if (DebugData) {
+    Thread->Stats.InstructionsExecuted.fetch_add(DebugData->GuestInstructionCount);
   }
 }
 
@@ -2,10 +2,14 @@
 
 #include "Interface/Core/BlockCache.h"
 #include "Interface/Core/InternalThreadState.h"
+#include "Interface/Core/JIT/StaticRegisterAllocation.h"
 
 #include "Interface/HLE/Syscalls.h"
 
 #include "Interface/IR/Passes/RegisterAllocationPass.h"
+#include "Interface/IR/SelectFusion.h"
+
+#include "Interface/Memory/HugePages.h"
 
 #if _M_X86_64
 #define VIXL_INCLUDE_SIMULATOR_AARCH64
@@ -20,6 +24,7 @@
 #include <FEXCore/IR/IR.h>
 #include <FEXCore/IR/IntrusiveIRList.h>
 
+#include <errno.h>
 #include <sys/mman.h>
 
 namespace FEXCore::CPU {
@@ -58,6 +63,10 @@ const std::array<std::pair<aarch64::Register, aarch64::Register>, 11> RA64Pair =
   {x26, x27},
 }};
 
+// Callee saved registers that can hold guest GPRs with static register allocation
+// Blocks are always called from C++ so the RA never gets these, a block only saves the ones it picks
+const std::array<aarch64::Register, 6> SRA64 = { x20, x21, x22, x23, x24, x25 };
+
 const std::array<std::pair<aarch64::Register, aarch64::Register>, 11> RA32Pair = {{
   {w4, w5},
   {w6, w7},
@@ -93,13 +102,18 @@ static uint64_t CompileBlockThunk(FEXCore::Context::Context* CTX, FEXCore::Core:
   return Result;
 }
 
+static void QueueTierUpThunk(FEXCore::Context::Context* CTX, uint64_t RIP) {
+  CTX->QueueTierUp(RIP);
+}
+
 static uint64_t CompileFallbackBlockThunk(FEXCore::Context::Context* CTX, FEXCore::Core::InternalThreadState *Thread, uint64_t RIP) {
   uint64_t Result = CTX->CompileFallbackBlock(Thread, RIP);
   return Result;
 }
 
 // XXX: Switch from MacroAssembler to Assembler once we drop the simulator
-class JITCore final : public CPUBackend, public vixl::aarch64::MacroAssembler  {
+// Code memory comes first so it outlives the assembler writing in to it
+class JITCore final : public CPUBackend, private FEXCore::Memory::CodeBuffer, public vixl::aarch64::MacroAssembler  {
 public:
   explicit JITCore(FEXCore::Context::Context *ctx, FEXCore::Core::InternalThreadState *Thread);
   ~JITCore() override;
@@ -110,18 +124,19 @@ public:
 
   bool NeedsOpDispatch() override { return true; }
 
-#if _M_X86_64
-  void SimulationExecution(FEXCore::Core::InternalThreadState *Thread);
-#endif
+  // Blocks only work off of the STATE pointer passed in, any thread can run them
+  bool SharesCodeBetweenThreads() const override { return true; }
 
-  bool HasCustomDispatch() const override { return CustomDispatchGenerated; }
+  // The IR is only walked while emitting code
+  bool NeedsIRAfterCompile() const override { return false; }
 
-#if _M_X86_64
-  void ExecuteCustomDispatch(FEXCore::Core::ThreadState *Thread) override;
-#else
-  void ExecuteCustomDispatch(FEXCore::Core::ThreadState *Thread) override {
-    DispatchPtr(reinterpret_cast<FEXCore::Core::InternalThreadState*>(Thread));
+  std::pair<uintptr_t, uintptr_t> GetCodeRange() const override {
+    auto Begin = reinterpret_cast<uintptr_t>(GetCodeMemory());
+    return {Begin, Begin + MAX_CODE_SIZE};
   }
+
+#if _M_X86_64
+  void SimulationExecution(FEXCore::Core::InternalThreadState *Thread);
 #endif
 
 private:
@@ -148,6 +163,9 @@ private:
 
   /**  @} */
 
+  // Keep the guest GPRs a block uses most in SRA64, picked per block
+  bool StaticRegisters {false};
+
   constexpr static uint8_t RA_32 = 0;
   constexpr static uint8_t RA_64 = 1;
   constexpr static uint8_t RA_FPR = 2;
@@ -182,29 +200,20 @@ private:
 
 #if _M_X86_64
   vixl::aarch64::Simulator Sim;
-  std::unordered_map<uint64_t, std::pair<uint64_t, uint64_t>> HostToGuest;
+  // Blocks are shared between threads, so every thread's simulator needs to be able to find them
+  static std::mutex HostToGuestMutex;
+  static std::unordered_map<uint64_t, std::pair<uint64_t, uint64_t>> HostToGuest;
 #endif
   void LoadConstant(vixl::aarch64::Register Reg, uint64_t Constant);
 
-  void CreateCustomDispatch(FEXCore::Core::InternalThreadState *Thread);
-  bool CustomDispatchGenerated {false};
-  using CustomDispatch = void(*)(FEXCore::Core::InternalThreadState *Thread);
-  CustomDispatch DispatchPtr{};
   IR::RegisterAllocationPass *RAPass;
 
-#if _M_X86_64
-  uint64_t CustomDispatchEnd;
-#endif
+  static constexpr uint32_t MAX_CODE_SIZE = 1024 * 1024 * 128;
 };
 
 #if _M_X86_64
-void JITCore::ExecuteCustomDispatch(FEXCore::Core::ThreadState *Thread) {
-  PrintDisassembler PrintDisasm(stdout);
-  PrintDisasm.DisassembleBuffer(vixl::aarch64::Instruction::Cast(DispatchPtr), vixl::aarch64::Instruction::Cast(CustomDispatchEnd));
-
-  Sim.WriteXRegister(0, reinterpret_cast<uint64_t>(Thread));
-  Sim.RunFrom(vixl::aarch64::Instruction::Cast(DispatchPtr));
-}
+std::mutex JITCore::HostToGuestMutex;
+std::unordered_map<uint64_t, std::pair<uint64_t, uint64_t>> JITCore::HostToGuest;
 
 static void SimulatorExecution(FEXCore::Core::InternalThreadState *Thread) {
   JITCore *Core = reinterpret_cast<JITCore*>(Thread->CPUBackend.get());
@@ -213,7 +222,11 @@ static void SimulatorExecution(FEXCore::Core::InternalThreadState *Thread) {
 
 void JITCore::SimulationExecution(FEXCore::Core::InternalThreadState *Thread) {
   using namespace vixl::aarch64;
-  auto SimulatorAddress = HostToGuest[Thread->State.State.rip];
+  std::pair<uint64_t, uint64_t> SimulatorAddress;
+  {
+    std::lock_guard<std::mutex> lk(HostToGuestMutex);
+    SimulatorAddress = HostToGuest[Thread->State.State.rip];
+  }
   // PrintDisassembler PrintDisasm(stdout);
   // PrintDisasm.DisassembleBuffer(vixl::aarch64::Instruction::Cast(SimulatorAddress.first), vixl::aarch64::Instruction::Cast(SimulatorAddress.second));
 
@@ -224,7 +237,8 @@ void JITCore::SimulationExecution(FEXCore::Core::InternalThreadState *Thread) {
 #endif
 
 JITCore::JITCore(FEXCore::Context::Context *ctx, FEXCore::Core::InternalThreadState *Thread)
-  : vixl::aarch64::MacroAssembler(1024 * 1024 * 128, vixl::aarch64::PositionDependentCode)
+  : FEXCore::Memory::CodeBuffer(MAX_CODE_SIZE, ctx->Config.HugePages)
+  , vixl::aarch64::MacroAssembler(GetCodeMemory(), MAX_CODE_SIZE, vixl::aarch64::PositionDependentCode)
   , CTX {ctx}
   , State {Thread}
 #if _M_X86_64
@@ -234,12 +248,10 @@ JITCore::JITCore(FEXCore::Context::Context *ctx, FEXCore::Core::InternalThreadSt
   // XXX: Set this to a real minimum feature set in the future
   SetCPUFeatures(vixl::CPUFeatures::All());
 
-  bool HadRA = CTX->HasRegisterAllocationPass();
-  RAPass = CTX->GetRegisterAllocatorPass();
+  // Register allocation results are per compiling thread, so the pass lives in the thread's pipeline
+  bool HadRA = Thread->PassManager->HasRegisterAllocationPass();
+  RAPass = Thread->PassManager->GetRegisterAllocatorPass();
 
-  // Just set the entire range as executable
-  auto Buffer = GetBuffer();
-  mprotect(Buffer->GetOffsetAddress<void*>(0), Buffer->GetCapacity(), PROT_READ | PROT_WRITE | PROT_EXEC);
 #if DEBUG
   Decoder.AppendVisitor(&Disasm)
 #endif
@@ -248,18 +260,13 @@ JITCore::JITCore(FEXCore::Context::Context *ctx, FEXCore::Core::InternalThreadSt
 #endif
   CPU.SetUp();
   SetAllowAssembler(true);
-  CreateCustomDispatch(Thread);
 
-  uint32_t NumUsedGPRs = NumGPRs;
-  uint32_t NumUsedGPRPairs = NumGPRPairs;
-  uint32_t UsedRegisterCount = RegisterCount;
+  // Blocks are called from C++, cut out the callee saved registers
+  uint32_t NumUsedGPRs = NumGPRs - NumCalleeGPRs;
+  uint32_t NumUsedGPRPairs = NumGPRPairs - NumCalleeGPRPairs;
+  uint32_t UsedRegisterCount = RegisterCount - (NumCalleeGPRs + NumCalleeGPRPairs);
 
-  if (!CustomDispatchGenerated) {
-    // If we aren't using our custom dispatcher then cut out the callee saved registers
-    NumUsedGPRs -= NumCalleeGPRs;
-    NumUsedGPRPairs -= NumCalleeGPRPairs;
-    UsedRegisterCount -= NumCalleeGPRs + NumCalleeGPRPairs;
-  }
+  StaticRegisters = CTX->Config.StaticRegisters;
 
   if (!HadRA) {
     RAPass->AllocateRegisterSet(UsedRegisterCount, RegisterClasses);
@@ -377,20 +384,159 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
   auto Buffer = GetBuffer();
   auto Entry = Buffer->GetOffsetAddress<uint64_t>(GetCursorOffset());
 
-  if (!CustomDispatchGenerated) {
-    mov(STATE, x0);
+  mov(STATE, x0);
+
+  StaticRegisterSet StaticRegs;
+  if (StaticRegisters) {
+    StaticRegs = SelectStaticRegisters(CurrentIR, SRA64.size());
+  }
+
+  // Only the registers this block uses are saved, an odd one out still takes a whole 16 bytes to keep sp aligned
+  for (size_t i = 0; i + 1 < StaticRegs.Count; i += 2) {
+    stp(SRA64[i], SRA64[i + 1], MemOperand(sp, -16, PreIndex));
+  }
+  if (StaticRegs.Count & 1) {
+    str(SRA64[StaticRegs.Count - 1], MemOperand(sp, -16, PreIndex));
   }
 
   if (SpillSlots) {
     sub(sp, sp, SpillSlots * 16);
   }
 
+  // Anything that can see the guest state from outside of the block needs the stored static registers in the context
+  auto SpillStaticRegisters = [&](uint32_t Slots) {
+    for (size_t i = 0; i < StaticRegs.Count; ++i) {
+      if (Slots & (1U << i)) {
+        str(SRA64[i], MemOperand(STATE, StaticRegs.Offsets[i]));
+      }
+    }
+  };
+
+  auto FillStaticRegisters = [&](uint32_t Slots) {
+    for (size_t i = 0; i < StaticRegs.Count; ++i) {
+      if (Slots & (1U << i)) {
+        ldr(SRA64[i], MemOperand(STATE, StaticRegs.Offsets[i]));
+      }
+    }
+  };
+
+  // Memory ops and their indexed forms only differ in how the address is built
+  struct MemAccess {
+    uint8_t Size;
+    uint8_t Align;
+    IR::RegisterClassType Class;
+    bool HasIndex;
+    uint32_t Index;
+    uint8_t Scale;
+    int32_t Displacement;
+  };
+
+  auto GetMemAccess = [](IR::IROp_Header const *IROp) -> MemAccess {
+    switch (IROp->Op) {
+    case IR::OP_LOADMEM: {
+      auto Op = IROp->C<IR::IROp_LoadMem>();
+      return {Op->Size, Op->Align, Op->Class, false, 0, 1, Op->Displacement};
+    }
+    case IR::OP_STOREMEM: {
+      auto Op = IROp->C<IR::IROp_StoreMem>();
+      return {Op->Size, Op->Align, Op->Class, false, 0, 1, Op->Displacement};
+    }
+    case IR::OP_LOADMEMINDEXED: {
+      auto Op = IROp->C<IR::IROp_LoadMemIndexed>();
+      return {Op->Size, Op->Align, Op->Class, true, Op->Index.ID(), Op->Scale, Op->Displacement};
+    }
+    case IR::OP_STOREMEMINDEXED: {
+      auto Op = IROp->C<IR::IROp_StoreMemIndexed>();
+      return {Op->Size, Op->Align, Op->Class, true, Op->Index.ID(), Op->Scale, Op->Displacement};
+    }
+    default: LogMan::Msg::A("Not a memory op: %s", std::string(IR::GetName(IROp->Op)).c_str());
+    }
+    return {};
+  };
+
+  // ldr/str only encode an unsigned 12bit offset scaled by the access size or a signed 9bit unscaled offset
+  // Any other displacement gets added in to TMP1 first
+  auto DisplacementMemOperand = [&](Register Base, uint8_t Size, int32_t Displacement) -> MemOperand {
+    bool Scaled = Displacement >= 0 && (Displacement % Size) == 0 && (Displacement / Size) < 4096;
+    bool Unscaled = Displacement >= -256 && Displacement < 256;
+    if (Scaled || Unscaled) {
+      return MemOperand(Base, Displacement);
+    }
+
+    LoadConstant(TMP2, static_cast<int64_t>(Displacement));
+    add(TMP1, Base, TMP2);
+    return MemOperand(TMP1);
+  };
+
+  // [Xn, Xm, LSL #s] covers an index scaled by the access size, anything else gets the index added in to TMP1 first
+  auto GenerateMemOperand = [&](MemAccess const &Access, uint32_t BaseNode) -> MemOperand {
+    Register Base = GetSrc<RA_64>(BaseNode);
+    if (!CTX->Config.UnifiedMemory) {
+      LoadConstant(TMP1, (uint64_t)CTX->MemoryMapper.GetMemoryBase());
+      if (!Access.HasIndex && Access.Displacement == 0) {
+        return MemOperand(TMP1, Base);
+      }
+      add(TMP1, TMP1, Base);
+      Base = TMP1;
+    }
+
+    if (!Access.HasIndex) {
+      return DisplacementMemOperand(Base, Access.Size, Access.Displacement);
+    }
+
+    Register Index = GetSrc<RA_64>(Access.Index);
+    unsigned Shift = __builtin_ctz(Access.Scale);
+    if (Access.Displacement == 0 && (Access.Scale == 1 || Access.Scale == Access.Size)) {
+      return MemOperand(Base, Index, LSL, Shift);
+    }
+
+    add(TMP1, Base, Operand(Index, LSL, Shift));
+    return DisplacementMemOperand(TMP1, Access.Size, Access.Displacement);
+  };
+
+  auto RegularExit = [&]() {
+    SpillStaticRegisters(StaticRegs.Written);
+
+    if (SpillSlots) {
+      add(sp, sp, SpillSlots * 16);
+    }
+
+    if (StaticRegs.Count & 1) {
+      ldr(SRA64[StaticRegs.Count - 1], MemOperand(sp, 16, PostIndex));
+    }
+    for (size_t i = StaticRegs.Count & ~size_t(1); i > 0; i -= 2) {
+      ldp(SRA64[i - 2], SRA64[i - 1], MemOperand(sp, 16, PostIndex));
+    }
+
+    ret();
+  };
+
+  // Optimized blocks don't count, nothing checks their count
+  bool CheckTierUp = DebugData && CTX->CountBlockExecutions && CTX->IsBaselineTier(State);
+  aarch64::Label TierUpStub, TierUpDone;
+  if (CheckTierUp) {
+    // Not atomic, a lost update from another thread only delays tiering up
+    LoadConstant(TMP1, reinterpret_cast<uint64_t>(&DebugData->RunCount));
+    ldr(TMP2, MemOperand(TMP1));
+    add(TMP2, TMP2, 1);
+    str(TMP2, MemOperand(TMP1));
+    LoadConstant(TMP3, CTX->Config.TierUpThreshold);
+    cmp(TMP2, TMP3);
+    b(&TierUpStub, Condition::eq);
+    bind(&TierUpDone);
+  }
+
+  FillStaticRegisters(StaticRegs.All());
+
   auto HeaderIterator = CurrentIR->begin();
   IR::OrderedNodeWrapper *HeaderNodeWrapper = HeaderIterator();
   IR::OrderedNode *HeaderNode = HeaderNodeWrapper->GetNode(ListBegin);
   auto HeaderOp = HeaderNode->Op(DataBegin)->CW<FEXCore::IR::IROp_IRHeader>();
   LogMan::Throw::A(HeaderOp->Header.Op == IR::OP_IRHEADER, "First op wasn't IRHeader");
 
+  // Node whose compare is in NZCV, only valid for the op directly after it
+  uint32_t HostFlagsNode = ~0U;
+
   IR::OrderedNode *BlockNode = HeaderOp->Blocks.GetNode(ListBegin);
 
   while (1) {
@@ -410,6 +556,7 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
       }
 
       bind(&IsTarget->second);
+      HostFlagsNode = ~0U;
     }
 
     while (1) {
@@ -419,6 +566,9 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
       uint8_t OpSize = IROp->Size;
       uint32_t Node = WrapperOp->ID();
 
+      uint32_t FlagsNode = HostFlagsNode;
+      HostFlagsNode = ~0U;
+
       if (0) {
         std::stringstream Inst;
         auto Name = FEXCore::IR::GetName(IROp->Op);
@@ -472,11 +622,7 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
         break;
       }
       case IR::OP_EXITFUNCTION: {
-        if (SpillSlots) {
-          add(sp, sp, SpillSlots * 16);
-        }
-
-        ret();
+        RegularExit();
         break;
       }
       case IR::OP_SYSCALL: {
@@ -486,6 +632,9 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
         // X1: ThreadState
         // X2: Pointer to SyscallArguments
 
+        // The syscall handler works on the guest state in the context
+        SpillStaticRegisters(StaticRegs.Written);
+
         uint64_t SPOffset = AlignUp((RA64.size() + 7 + 1) * 8, 16);
 
         sub(sp, sp, SPOffset);
@@ -526,6 +675,137 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
         ldr(lr,       MemOperand(sp, 7 * 8 + RA64.size() * 8 + 0 * 8));
 
         add(sp, sp, SPOffset);
+
+        FillStaticRegisters(StaticRegs.All());
+        break;
+      }
+      case IR::OP_INLINESYSCALL: {
+        auto Op = IROp->C<IR::IROp_InlineSyscall>();
+        [[maybe_unused]] auto Def = CTX->SyscallHandler->GetDefinition(Op->SyscallNumber);
+
+        // Only caller saved registers with values that are used after the call need saving
+        // x4-x15 and x18 at the start of RA64 are caller saved
+        // v8-v15 only keep their bottom half so every FPR is treated as caller saved
+        constexpr uint32_t CallerSavedGPRs = 13;
+        uint32_t SavedGPRs {};
+        uint32_t SavedFPRs {};
+        for (uint32_t i = 0; i < CurrentIR->GetSSACount(); ++i) {
+          if (!RAPass->IsLiveAcross(i, Node)) continue;
+          uint64_t RegAndClass = RAPass->GetNodeRegister(i);
+          uint32_t Reg = RegAndClass;
+          uint32_t Class = RegAndClass >> 32;
+          if (Class == FEXCore::IR::GPRClass.Val) {
+            SavedGPRs |= 1U << Reg;
+          }
+          else if (Class == FEXCore::IR::GPRPairClass.Val) {
+            SavedGPRs |= 3U << (Reg * 2);
+          }
+          else if (Class == FEXCore::IR::FPRClass.Val) {
+            SavedFPRs |= 1U << Reg;
+          }
+        }
+        SavedGPRs &= (1U << CallerSavedGPRs) - 1;
+
+        // [sp + 0]: SyscallArguments for the fallback, unused arguments are zero so they don't look like pointers
+        // Followed by the saved GPRs, lr and then the saved FPRs
+        constexpr uint32_t ArgsSize = FEXCore::HLE::SyscallArguments::MAX_ARGS * 8 + 8;
+        uint32_t FPROffset = AlignUp(ArgsSize + (__builtin_popcount(SavedGPRs) + 1) * 8, 16);
+        uint64_t SPOffset = FPROffset + __builtin_popcount(SavedFPRs) * 16;
+
+        sub(sp, sp, SPOffset);
+        LoadConstant(TMP1, Op->SyscallNumber);
+        str(TMP1, MemOperand(sp, 0));
+        for (uint32_t i = 0; i < FEXCore::HLE::SyscallArguments::MAX_ARGS - 1; ++i) {
+          if (Op->Header.Args[i].IsInvalid()) {
+            str(xzr, MemOperand(sp, (i + 1) * 8));
+          }
+          else {
+            str(GetSrc<RA_64>(Op->Header.Args[i].ID()), MemOperand(sp, (i + 1) * 8));
+          }
+        }
+
+        uint32_t Slot = 0;
+        for (uint32_t i = 0; i < CallerSavedGPRs; ++i) {
+          if (SavedGPRs & (1U << i)) {
+            str(RA64[i], MemOperand(sp, ArgsSize + Slot * 8));
+            ++Slot;
+          }
+        }
+        str(lr, MemOperand(sp, ArgsSize + Slot * 8));
+
+        Slot = 0;
+        for (uint32_t i = 0; i < NumFPRs; ++i) {
+          if (SavedFPRs & (1U << i)) {
+            str(RAFPR[i].Q(), MemOperand(sp, FPROffset + Slot * 16));
+            ++Slot;
+          }
+        }
+
+        // The handler works on the guest state in the context
+        SpillStaticRegisters(StaticRegs.Written);
+
+#if _M_X86_64
+        // The simulator can only call out through the runtime thunks, go through the generic handler
+        LoadConstant(x0, reinterpret_cast<uint64_t>(CTX->SyscallHandler.get()));
+        mov(x1, STATE);
+        mov(x2, sp);
+        CallRuntime(SyscallThunk);
+#else
+        // The generic handler times and records the syscall while tracing is on
+        aarch64::Label Traced, Done;
+        LoadConstant(x0, reinterpret_cast<uint64_t>(CTX->SyscallHandler->Tracer.GetEnabledFlag()));
+        ldrb(w0, MemOperand(x0));
+        cbnz(w0, &Traced);
+
+        if (Def->NumOutputs) {
+          // The kernel can't write to guest code pages we protected, the generic path does this itself
+          LoadConstant(x0, reinterpret_cast<uint64_t>(CTX->SyscallHandler.get()));
+          mov(x1, sp);
+          LoadConstant(x2, reinterpret_cast<uint64_t>(&FEXCore::ReleaseCodePagesForOutputs));
+          blr(x2);
+        }
+
+        // Arguments come from the array since RA registers overlap the argument registers
+        const std::array<aarch64::Register, 6> ArgRegs = { x1, x2, x3, x4, x5, x6 };
+        mov(x0, STATE);
+        for (uint8_t i = 0; i < Def->NumArgs; ++i) {
+          ldr(ArgRegs[i], MemOperand(sp, (i + 1) * 8));
+        }
+        LoadConstant(x7, reinterpret_cast<uint64_t>(Def->Ptr));
+        blr(x7);
+        b(&Done);
+
+        bind(&Traced);
+        LoadConstant(x0, reinterpret_cast<uint64_t>(CTX->SyscallHandler.get()));
+        mov(x1, STATE);
+        mov(x2, sp);
+        LoadConstant(x3, reinterpret_cast<uint64_t>(FEXCore::HandleSyscall));
+        blr(x3);
+        bind(&Done);
+#endif
+
+        Slot = 0;
+        for (uint32_t i = 0; i < CallerSavedGPRs; ++i) {
+          if (SavedGPRs & (1U << i)) {
+            ldr(RA64[i], MemOperand(sp, ArgsSize + Slot * 8));
+            ++Slot;
+          }
+        }
+        ldr(lr, MemOperand(sp, ArgsSize + Slot * 8));
+
+        Slot = 0;
+        for (uint32_t i = 0; i < NumFPRs; ++i) {
+          if (SavedFPRs & (1U << i)) {
+            ldr(RAFPR[i].Q(), MemOperand(sp, FPROffset + Slot * 16));
+            ++Slot;
+          }
+        }
+
+        add(sp, sp, SPOffset);
+
+        FillStaticRegisters(StaticRegs.All());
+
+        mov(GetDst<RA_64>(Node), x0);
         break;
       }
       case IR::OP_CPUID: {
@@ -646,12 +926,46 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
           FalseTargetLabel = &FalseIter->second;
         }
 
+        if (Op->Header.Args[0].ID() == FlagsNode) {
+          // Branch on the compare the Select left in NZCV
+          auto SelectNode = Op->Header.Args[0].GetNode(ListBegin);
+          bool Invert;
+          IR::CanFuseSelectBranch(CurrentIR, SelectNode, RealNode, &Invert);
+          if (Invert) {
+            std::swap(TrueTargetLabel, FalseTargetLabel);
+          }
+
+          switch (SelectNode->Op(DataBegin)->C<IR::IROp_Select>()->Cond.Val) {
+          case FEXCore::IR::COND_EQ:  b(TrueTargetLabel, Condition::eq); break;
+          case FEXCore::IR::COND_NEQ: b(TrueTargetLabel, Condition::ne); break;
+          case FEXCore::IR::COND_SGE: b(TrueTargetLabel, Condition::ge); break;
+          case FEXCore::IR::COND_SLT: b(TrueTargetLabel, Condition::lt); break;
+          case FEXCore::IR::COND_SGT: b(TrueTargetLabel, Condition::gt); break;
+          case FEXCore::IR::COND_SLE: b(TrueTargetLabel, Condition::le); break;
+          case FEXCore::IR::COND_UGE: b(TrueTargetLabel, Condition::cs); break;
+          case FEXCore::IR::COND_ULT: b(TrueTargetLabel, Condition::cc); break;
+          case FEXCore::IR::COND_UGT: b(TrueTargetLabel, Condition::hi); break;
+          case FEXCore::IR::COND_ULE: b(TrueTargetLabel, Condition::ls); break;
+          default: LogMan::Msg::A("Unsupported compare type"); break;
+          }
+          b(FalseTargetLabel);
+          break;
+        }
+
         cbnz(GetSrc<RA_64>(Op->Header.Args[0].ID()), TrueTargetLabel);
         b(FalseTargetLabel);
         break;
       }
       case IR::OP_LOADCONTEXT: {
         auto Op = IROp->C<IR::IROp_LoadContext>();
+        int32_t StaticReg = StaticRegs.Find(Op->Offset, OpSize, Op->Class);
+        if (StaticReg != -1) {
+          mov(GetDst<RA_64>(Node), SRA64[StaticReg]);
+          break;
+        }
+
+        SpillStaticRegisters(StaticRegs.Overlapping(Op->Offset, OpSize) & StaticRegs.Written);
+
         if (Op->Class.Val == 0) {
           switch (OpSize) {
           case 1:
@@ -694,6 +1008,15 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
       }
       case IR::OP_STORECONTEXT: {
         auto Op = IROp->C<IR::IROp_StoreContext>();
+        int32_t StaticReg = StaticRegs.Find(Op->Offset, OpSize, Op->Class);
+        if (StaticReg != -1) {
+          mov(SRA64[StaticReg], GetSrc<RA_64>(Op->Header.Args[0].ID()));
+          break;
+        }
+
+        uint32_t PartialStaticRegs = StaticRegs.Overlapping(Op->Offset, OpSize);
+        SpillStaticRegisters(PartialStaticRegs & StaticRegs.Written);
+
         if (Op->Class.Val == 0) {
           switch (OpSize) {
           case 1:
@@ -732,6 +1055,8 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
           default:  LogMan::Msg::A("Unhandled LoadContext size: %d", OpSize);
           }
         }
+
+        FillStaticRegisters(PartialStaticRegs);
         break;
       }
       case IR::OP_LOADCONTEXTINDEXED: {
@@ -908,6 +1233,8 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
       }
       case IR::OP_LOADCONTEXTPAIR: {
         auto Op = IROp->C<IR::IROp_LoadContextPair>();
+        SpillStaticRegisters(StaticRegs.Overlapping(Op->Offset, Op->Size * 2) & StaticRegs.Written);
+
         switch (Op->Size) {
           case 4: {
             auto Dst = GetSrcPair<RA_32>(Node);
@@ -925,6 +1252,9 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
       }
       case IR::OP_STORECONTEXTPAIR: {
         auto Op = IROp->C<IR::IROp_StoreContextPair>();
+        uint32_t PartialStaticRegs = StaticRegs.Overlapping(Op->Offset, Op->Size * 2);
+        SpillStaticRegisters(PartialStaticRegs & StaticRegs.Written);
+
         switch (Op->Size) {
           case 4: {
             auto Src = GetSrcPair<RA_32>(Op->Header.Args[0].ID());
@@ -937,6 +1267,8 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
             break;
           }
         }
+
+        FillStaticRegisters(PartialStaticRegs);
         break;
       }
       case IR::OP_CREATEELEMENTPAIR: {
@@ -1098,6 +1430,7 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
         switch (Op->Reason) {
           case 0: // Hard fault
           case 5: // Guest ud2
+            SpillStaticRegisters(StaticRegs.Written);
             hlt(4);
             break;
           case 4: // HLT
@@ -1111,10 +1444,7 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
 
             stlrb(TMP1, MemOperand(TMP2));
 
-            if (SpillSlots) {
-              add(sp, sp, SpillSlots * 16);
-            }
-            ret();
+            RegularExit();
             break;
           }
           default: LogMan::Msg::A("Unknown Break reason: %d", Op->Reason);
@@ -1522,6 +1852,169 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
         }
         break;
       }
+      case IR::OP_MEMCPY:
+      case IR::OP_MEMSET:
+      case IR::OP_MEMCMP: {
+        // Args are laid out the same for all three, 0: Dest/Src1, 1: Src/Value/Src2, 2: Count, 3: Direction
+        uint8_t Size{};
+        switch (IROp->Op) {
+        case IR::OP_MEMCPY: Size = IROp->C<IR::IROp_MemCpy>()->Size; break;
+        case IR::OP_MEMSET: Size = IROp->C<IR::IROp_MemSet>()->Size; break;
+        default: Size = IROp->C<IR::IROp_MemCmp>()->Size; break;
+        }
+        unsigned Shift = __builtin_ctz(Size);
+
+        auto LoadElement = [&](aarch64::Register Dst, aarch64::Register Ptr, int Step) {
+          switch (Size) {
+          case 1: ldrb(Dst.W(), MemOperand(Ptr, Step, PostIndex)); break;
+          case 2: ldrh(Dst.W(), MemOperand(Ptr, Step, PostIndex)); break;
+          case 4: ldr(Dst.W(), MemOperand(Ptr, Step, PostIndex)); break;
+          case 8: ldr(Dst.X(), MemOperand(Ptr, Step, PostIndex)); break;
+          default: LogMan::Msg::A("Unhandled bulk memory size: %d", Size); break;
+          }
+        };
+
+        auto StoreElement = [&](aarch64::Register Src, aarch64::Register Ptr, int Step) {
+          switch (Size) {
+          case 1: strb(Src.W(), MemOperand(Ptr, Step, PostIndex)); break;
+          case 2: strh(Src.W(), MemOperand(Ptr, Step, PostIndex)); break;
+          case 4: str(Src.W(), MemOperand(Ptr, Step, PostIndex)); break;
+          case 8: str(Src.X(), MemOperand(Ptr, Step, PostIndex)); break;
+          default: LogMan::Msg::A("Unhandled bulk memory size: %d", Size); break;
+          }
+        };
+
+        auto Direction = GetSrc<RA_32>(IROp->Args[3].ID());
+        mov(TMP1, GetSrc<RA_64>(IROp->Args[0].ID()));
+        mov(TMP2, GetSrc<RA_64>(IROp->Args[1].ID()));
+
+        aarch64::Label Backward;
+        aarch64::Label Done;
+
+        if (IROp->Op == IR::OP_MEMCMP) {
+          // Out of temporaries, the original count lives in a vector register and the destination is scratch until the end
+          auto Dst = GetDst<RA_64>(Node);
+          mov(TMP3, GetSrc<RA_64>(IROp->Args[2].ID()));
+          fmov(VTMP1.D(), TMP3);
+          if (!CTX->Config.UnifiedMemory) {
+            LoadConstant(TMP4, (uint64_t)CTX->MemoryMapper.GetMemoryBase());
+            add(TMP1, TMP1, TMP4);
+            add(TMP2, TMP2, TMP4);
+          }
+
+          bool WhileEqual = IROp->C<IR::IROp_MemCmp>()->WhileEqual;
+          auto CompareLoop = [&](int Step) {
+            aarch64::Label Loop;
+            bind(&Loop);
+            cbz(TMP3, &Done);
+            LoadElement(TMP4, TMP1, Step);
+            LoadElement(Dst, TMP2, Step);
+            sub(TMP3, TMP3, 1);
+            cmp(TMP4, Dst);
+            b(&Loop, WhileEqual ? Condition::eq : Condition::ne);
+            b(&Done);
+          };
+
+          cbnz(Direction, &Backward);
+          CompareLoop(Size);
+          bind(&Backward);
+          CompareLoop(-Size);
+          bind(&Done);
+
+          // Compared = Count - Remaining
+          fmov(TMP4, VTMP1.D());
+          sub(Dst, TMP4, TMP3);
+          break;
+        }
+
+        // Work in bytes from here on
+        lsl(TMP3, GetSrc<RA_64>(IROp->Args[2].ID()), Shift);
+        if (!CTX->Config.UnifiedMemory) {
+          LoadConstant(TMP4, (uint64_t)CTX->MemoryMapper.GetMemoryBase());
+          add(TMP1, TMP1, TMP4);
+          if (IROp->Op == IR::OP_MEMCPY) {
+            add(TMP2, TMP2, TMP4);
+          }
+        }
+
+        if (IROp->Op == IR::OP_MEMSET) {
+          // Every element is the same, a backwards fill is a forwards fill from the lowest element
+          aarch64::Label Forward;
+          cbz(Direction, &Forward);
+          sub(TMP1, TMP1, TMP3);
+          add(TMP1, TMP1, Size);
+          bind(&Forward);
+
+          switch (Size) {
+          case 1: dup(VTMP1.V16B(), TMP2.W()); break;
+          case 2: dup(VTMP1.V8H(), TMP2.W()); break;
+          case 4: dup(VTMP1.V4S(), TMP2.W()); break;
+          case 8: dup(VTMP1.V2D(), TMP2.X()); break;
+          default: LogMan::Msg::A("Unhandled MemSet size: %d", Size); break;
+          }
+
+          aarch64::Label VectorLoop;
+          aarch64::Label Tail;
+          bind(&VectorLoop);
+          cmp(TMP3, 32);
+          b(&Tail, Condition::lo);
+          stp(VTMP1.Q(), VTMP1.Q(), MemOperand(TMP1, 32, PostIndex));
+          sub(TMP3, TMP3, 32);
+          b(&VectorLoop);
+
+          bind(&Tail);
+          cbz(TMP3, &Done);
+          StoreElement(TMP2, TMP1, Size);
+          sub(TMP3, TMP3, Size);
+          b(&Tail);
+
+          bind(&Done);
+          break;
+        }
+
+        // MemCpy
+        // x86 copies element by element, so a destination that starts inside of the source repeats the data
+        // 32 byte chunks give the same result as long as the destination is at least a chunk ahead of the source or behind it
+        aarch64::Label ElementLoop;
+        aarch64::Label VectorLoop;
+        aarch64::Label Tail;
+        cbnz(Direction, &Backward);
+        sub(TMP4, TMP1, TMP2);
+        cmp(TMP4, 32);
+        b(&ElementLoop, Condition::lo);
+
+        bind(&VectorLoop);
+        cmp(TMP3, 32);
+        b(&Tail, Condition::lo);
+        ldp(VTMP1.Q(), VTMP2.Q(), MemOperand(TMP2, 32, PostIndex));
+        stp(VTMP1.Q(), VTMP2.Q(), MemOperand(TMP1, 32, PostIndex));
+        sub(TMP3, TMP3, 32);
+        b(&VectorLoop);
+
+        bind(&Tail);
+        cbz(TMP3, &Done);
+        ldrb(TMP4.W(), MemOperand(TMP2, 1, PostIndex));
+        strb(TMP4.W(), MemOperand(TMP1, 1, PostIndex));
+        sub(TMP3, TMP3, 1);
+        b(&Tail);
+
+        bind(&ElementLoop);
+        cbz(TMP3, &Done);
+        LoadElement(TMP4, TMP2, Size);
+        StoreElement(TMP4, TMP1, Size);
+        sub(TMP3, TMP3, Size);
+        b(&ElementLoop);
+
+        bind(&Backward);
+        cbz(TMP3, &Done);
+        LoadElement(TMP4, TMP2, -Size);
+        StoreElement(TMP4, TMP1, -Size);
+        sub(TMP3, TMP3, Size);
+        b(&Backward);
+
+        bind(&Done);
+        break;
+      }
       case IR::OP_CAS: {
         auto Op = IROp->C<IR::IROp_CAS>();
         // Args[0]: Expected
@@ -1770,6 +2263,16 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
 
         cmp(GetSrc<RA_64>(Op->Header.Args[0].ID()), GetSrc<RA_64>(Op->Header.Args[1].ID()));
 
+        if (CodeBegin != CodeLast) {
+          auto NextIter = CodeBegin;
+          ++NextIter;
+          bool Invert;
+          if (IR::CanFuseSelectBranch(CurrentIR, RealNode, NextIter()->GetNode(ListBegin), &Invert)) {
+            HostFlagsNode = Node;
+            break;
+          }
+        }
+
         switch (Op->Cond.Val) {
         case FEXCore::IR::COND_EQ:
           csel(GetDst<RA_64>(Node), GetSrc<RA_64>(Op->Header.Args[2].ID()), GetSrc<RA_64>(Op->Header.Args[3].ID()), Condition::eq);
@@ -1812,18 +2315,14 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
 
         break;
       }
-      case IR::OP_LOADMEM: {
-        auto Op = IROp->C<IR::IROp_LoadMem>();
+      case IR::OP_LOADMEM:
+      case IR::OP_LOADMEMINDEXED: {
+        auto Op = GetMemAccess(IROp);
+        auto MemSrc = GenerateMemOperand(Op, IROp->Args[0].ID());
 
-        auto MemSrc = MemOperand(GetSrc<RA_64>(Op->Header.Args[0].ID()));
-        if (!CTX->Config.UnifiedMemory) {
-          LoadConstant(TMP1, (uint64_t)CTX->MemoryMapper.GetMemoryBase());
-          MemSrc = MemOperand(TMP1, GetSrc<RA_64>(Op->Header.Args[0].ID()));
-        }
-
-        if (Op->Class.Val == 0) {
+        if (Op.Class.Val == 0) {
           auto Dst = GetDst<RA_64>(Node);
-          switch (Op->Size) {
+          switch (Op.Size) {
           case 1:
             ldrb(Dst, MemSrc);
           break;
@@ -1836,12 +2335,12 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
           case 8:
             ldr(Dst, MemSrc);
           break;
-          default:  LogMan::Msg::A("Unhandled LoadMem size: %d", Op->Size);
+          default:  LogMan::Msg::A("Unhandled LoadMem size: %d", Op.Size);
           }
         }
         else {
           auto Dst = GetDst(Node);
-          switch (Op->Size) {
+          switch (Op.Size) {
           case 1:
             ldr(Dst.B(), MemSrc);
           break;
@@ -1857,40 +2356,36 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
           case 16:
             ldr(Dst, MemSrc);
           break;
-          default:  LogMan::Msg::A("Unhandled LoadMem size: %d", Op->Size);
+          default:  LogMan::Msg::A("Unhandled LoadMem size: %d", Op.Size);
           }
         }
         break;
       }
-      case IR::OP_STOREMEM: {
-        auto Op = IROp->C<IR::IROp_StoreMem>();
-
-        auto MemSrc = MemOperand(GetSrc<RA_64>(Op->Header.Args[0].ID()));
-        if (!CTX->Config.UnifiedMemory) {
-          LoadConstant(TMP1, (uint64_t)CTX->MemoryMapper.GetMemoryBase());
-          MemSrc = MemOperand(TMP1, GetSrc<RA_64>(Op->Header.Args[0].ID()));
-        }
+      case IR::OP_STOREMEM:
+      case IR::OP_STOREMEMINDEXED: {
+        auto Op = GetMemAccess(IROp);
+        auto MemSrc = GenerateMemOperand(Op, IROp->Args[0].ID());
 
-        if (Op->Class.Val == 0) {
-          switch (Op->Size) {
+        if (Op.Class.Val == 0) {
+          switch (Op.Size) {
           case 1:
-            strb(GetSrc<RA_64>(Op->Header.Args[1].ID()), MemSrc);
+            strb(GetSrc<RA_64>(IROp->Args[1].ID()), MemSrc);
           break;
           case 2:
-            strh(GetSrc<RA_64>(Op->Header.Args[1].ID()), MemSrc);
+            strh(GetSrc<RA_64>(IROp->Args[1].ID()), MemSrc);
           break;
           case 4:
-            str(GetSrc<RA_32>(Op->Header.Args[1].ID()), MemSrc);
+            str(GetSrc<RA_32>(IROp->Args[1].ID()), MemSrc);
           break;
           case 8:
-            str(GetSrc<RA_64>(Op->Header.Args[1].ID()), MemSrc);
+            str(GetSrc<RA_64>(IROp->Args[1].ID()), MemSrc);
           break;
-          default:  LogMan::Msg::A("Unhandled StoreMem size: %d", Op->Size);
+          default:  LogMan::Msg::A("Unhandled StoreMem size: %d", Op.Size);
           }
         }
         else {
-          auto Src = GetSrc(Op->Header.Args[1].ID());
-          switch (Op->Size) {
+          auto Src = GetSrc(IROp->Args[1].ID());
+          switch (Op.Size) {
           case 1:
             str(Src.B(), MemSrc);
           break;
@@ -1906,7 +2401,7 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
           case 16:
             str(Src, MemSrc);
           break;
-          default:  LogMan::Msg::A("Unhandled StoreMem size: %d", Op->Size);
+          default:  LogMan::Msg::A("Unhandled StoreMem size: %d", Op.Size);
           }
 
         }
@@ -4141,6 +4636,11 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
         }
         break;
       }
+      case IR::OP_LOADTHREADMANAGER: {
+        auto Op = IROp->C<IR::IROp_LoadThreadManager>();
+        ldr(GetDst<RA_64>(Node), MemOperand(STATE, offsetof(FEXCore::Core::ThreadState, ThreadManager) + Op->Offset));
+        break;
+      }
       case IR::OP_CYCLECOUNTER: {
 #ifdef DEBUG_CYCLES
           movz(GetDst<RA_64>(Node), 0);
@@ -4170,14 +4670,31 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
     }
   }
 
+  if (CheckTierUp) {
+    // Only the callee saved registers hold anything yet, lr is where the block returns to
+    bind(&TierUpStub);
+    str(lr, MemOperand(sp, -16, PreIndex));
+    LoadConstant(x0, reinterpret_cast<uint64_t>(CTX));
+    LoadConstant(x1, HeaderOp->Entry);
+#if _M_X86_64
+    CallRuntime(QueueTierUpThunk);
+#else
+    LoadConstant(x2, reinterpret_cast<uint64_t>(QueueTierUpThunk));
+    blr(x2);
+#endif
+    ldr(lr, MemOperand(sp, 16, PostIndex));
+    b(&TierUpDone);
+  }
+
   FinalizeCode();
 
 
   auto CodeEnd = Buffer->GetOffsetAddress<uint64_t>(GetCursorOffset());
   CPU.EnsureIAndDCacheCoherency(reinterpret_cast<void*>(Entry), Buffer->GetOffsetAddress<uint64_t>(GetCursorOffset()) - reinterpret_cast<uint64_t>(Entry));
 #if _M_X86_64
-  if (!CustomDispatchGenerated) {
-    HostToGuest[State->State.State.rip] = std::make_pair(Entry, CodeEnd);
+  {
+    std::lock_guard<std::mutex> lk(HostToGuestMutex);
+    HostToGuest[HeaderOp->Entry] = std::make_pair(Entry, CodeEnd);
     return (void*)SimulatorExecution;
   }
 #endif
@@ -4186,175 +4703,6 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
   return reinterpret_cast<void*>(Entry);
 }
 
-void JITCore::CreateCustomDispatch(FEXCore::Core::InternalThreadState *Thread) {
-  auto Buffer = GetBuffer();
-  DispatchPtr = Buffer->GetOffsetAddress<CustomDispatch>(GetCursorOffset());
-  EmissionCheckScope(this, 0);
-
-  // while (!Thread->State.RunningEvents.ShouldStop.load()) {
-  //    Ptr = FindBlock(RIP)
-  //    if (!Ptr)
-  //      Ptr = CTX->CompileBlock(RIP);
-  //
-  //    if (Ptr)
-  //      Ptr();
-  //    else
-  //    {
-  //      Ptr = FallbackCore->CompileBlock()
-  //      if (Ptr)
-  //        Ptr()
-  //      else {
-  //        ShouldStop = true;
-  //      }
-  //    }
-  // }
-
-  // Push all the register we need to save
-  PushCalleeSavedRegisters();
-
-  // Push our memory base to the correct register
-  // Move our thread pointer to the correct register
-  // This is passed in to parameter 0 (x0)
-  mov(STATE, x0);
-
-  aarch64::Label LoopTop;
-  bind(&LoopTop);
-
-  // Load in our RIP
-  // Don't modify x2 since it contains our RIP once the block doesn't exist
-  ldr(x2, MemOperand(STATE, offsetof(FEXCore::Core::ThreadState, State.rip)));
-  auto RipReg = x2;
-  if (CTX->Config.UnifiedMemory) {
-    LoadConstant(x3, reinterpret_cast<uint64_t>(CTX->MemoryMapper.GetMemoryBase()));
-    sub(x3, x2, x3);
-    RipReg = x3;
-  }
-  LoadConstant(x0, Thread->BlockCache->GetPagePointer());
-
-  // Offset the address and add to our page pointer
-  lsr(x1, RipReg, 12);
-
-  // Load the pointer from the offset
-  ldr(x0, MemOperand(x0, x1, Shift::LSL, 3));
-  aarch64::Label NoBlock;
-
-  // If page pointer is zero then we have no block
-  cbz(x0, &NoBlock);
-
-  // Steal the page offset
-  and_(x1, RipReg, 0x0FFF);
-
-  // Now load from that pointer offset by the page offset to get our real block
-  ldr(x0, MemOperand(x0, x1, Shift::LSL, 3));
-  cbz(x0, &NoBlock);
-
-  // If we've made it here then we have a real compiled block
-  {
-    blr(x0);
-  }
-
-  aarch64::Label ExitCheck;
-  bind(&ExitCheck);
-
-  constexpr uint64_t ShouldStopOffset = offsetof(FEXCore::Core::ThreadState, RunningEvents.ShouldStop);
-  // If we don't need to stop then keep going
-  add(x1, STATE, ShouldStopOffset);
-  ldarb(x0, MemOperand(x1));
-  cbz(x0, &LoopTop);
-
-  PopCalleeSavedRegisters();
-
-  // Return from the function
-  // LR is set to the correct return location now
-  ret();
-
-  aarch64::Label FallbackCore;
-  // Need to create the block
-  {
-    bind(&NoBlock);
-
-    LoadConstant(x0, reinterpret_cast<uintptr_t>(CTX));
-    mov(x1, STATE);
-
-#if _M_X86_64
-    CallRuntime(CompileBlockThunk);
-#else
-    using ClassPtrType = uintptr_t (FEXCore::Context::Context::*)(FEXCore::Core::InternalThreadState *, uint64_t);
-    union PtrCast {
-      ClassPtrType ClassPtr;
-      uintptr_t Data;
-    };
-
-    PtrCast Ptr;
-    Ptr.ClassPtr = &FEXCore::Context::Context::CompileBlock;
-    LoadConstant(x3, Ptr.Data);
-
-    str(STATE, MemOperand(sp, -16, PreIndex));
-    // X2 contains our guest RIP
-    blr(x3); // { CTX, ThreadState, RIP}
-    ldr(STATE, MemOperand(sp, 16, PostIndex));
-#endif
-    // X0 now contains either nullptr or block pointer
-    cbz(x0, &FallbackCore);
-    blr(x0);
-
-    b(&ExitCheck);
-  }
-
-  aarch64::Label ExitError;
-  // We need to fallback to our fallback core
-  {
-    bind(&FallbackCore);
-
-#if _M_X86_64
-    // XXX: Fallback core doesn't work on x86-64
-    // We can't tell the difference between simulator entry points and not
-    b(&ExitError);
-#else
-    LoadConstant(x0, reinterpret_cast<uintptr_t>(CTX));
-    mov(x1, STATE);
-
-    using ClassPtrType = uintptr_t (FEXCore::Context::Context::*)(FEXCore::Core::InternalThreadState *, uint64_t);
-    union PtrCast {
-      ClassPtrType ClassPtr;
-      uintptr_t Data;
-    };
-
-    PtrCast Ptr;
-    Ptr.ClassPtr = &FEXCore::Context::Context::CompileFallbackBlock;
-    LoadConstant(x3, Ptr.Data);
-
-    str(STATE, MemOperand(sp, -16, PreIndex));
-    // X2 contains our guest RIP
-    blr(x3); // {ThreadState, RIP}
-    ldr(STATE, MemOperand(sp, 16, PostIndex));
-#endif
-    // X0 now contains either nullptr or block pointer
-    cbz(x0, &ExitError);
-    blr(x0);
-
-    b(&ExitCheck);
-  }
-
-  // Exit error
-  {
-    bind(&ExitError);
-    LoadConstant(x0, 1);
-    add(x1, STATE, ShouldStopOffset);
-    stlrb(x0, MemOperand(x1));
-    b(&ExitCheck);
-  }
-
-#if _M_X86_64
-  CustomDispatchEnd = Buffer->GetOffsetAddress<uint64_t>(GetCursorOffset());
-#endif
-
-  FinalizeCode();
-  CPU.EnsureIAndDCacheCoherency(reinterpret_cast<void*>(DispatchPtr), Buffer->GetOffsetAddress<uint64_t>(GetCursorOffset()) - reinterpret_cast<uint64_t>(DispatchPtr));
-  // Disabling will be useful for debugging ThreadState
-  //CustomDispatchGenerated = true;
-}
-
 FEXCore::CPU::CPUBackend *CreateJITCore(FEXCore::Context::Context *ctx, FEXCore::Core::InternalThreadState *Thread) {
   return new JITCore(ctx, Thread);
 }
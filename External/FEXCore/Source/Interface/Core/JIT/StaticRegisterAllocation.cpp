@@ -0,0 +1,159 @@
+#include "Interface/Core/JIT/StaticRegisterAllocation.h"
+#include "LogManager.h"
+
+#include <FEXCore/Core/CoreState.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace FEXCore::CPU {
+  namespace {
+    constexpr size_t NUM_GPRS = sizeof(FEXCore::Core::CPUState::gregs) / sizeof(FEXCore::Core::CPUState::gregs[0]);
+
+    constexpr uint32_t GPROffset(size_t Reg) {
+      return offsetof(FEXCore::Core::CPUState, gregs[0]) + Reg * sizeof(uint64_t);
+    }
+
+    struct GPRAccesses {
+      uint32_t Loads;
+      uint32_t Stores;
+      uint32_t Partial;
+    };
+  }
+
+  int32_t StaticRegisterSet::Find(uint32_t Offset, uint8_t Size, FEXCore::IR::RegisterClassType Class) const {
+    if (Size != sizeof(uint64_t) || Class != FEXCore::IR::GPRClass) {
+      return -1;
+    }
+
+    for (size_t i = 0; i < Count; ++i) {
+      if (Offsets[i] == Offset) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  uint32_t StaticRegisterSet::Overlapping(uint32_t Offset, uint32_t Size) const {
+    uint32_t Slots {};
+    for (size_t i = 0; i < Count; ++i) {
+      if (Offset < Offsets[i] + sizeof(uint64_t) && Offset + Size > Offsets[i]) {
+        Slots |= 1U << i;
+      }
+    }
+    return Slots;
+  }
+
+  StaticRegisterSet SelectStaticRegisters(FEXCore::IR::IRListView<true> const *IR, size_t MaxRegisters) {
+    using namespace FEXCore::IR;
+    uintptr_t ListBegin = IR->GetListData();
+    uintptr_t DataBegin = IR->GetData();
+
+    std::array<GPRAccesses, NUM_GPRS> Accesses {};
+    // Syscalls need the written registers in the context and every register filled again after
+    uint32_t ContextSyncs {};
+
+    auto RecordAccess = [&](uint32_t Offset, uint32_t Size, RegisterClassType Class, bool IsStore) {
+      for (size_t i = 0; i < NUM_GPRS; ++i) {
+        if (Offset >= GPROffset(i) + sizeof(uint64_t) || Offset + Size <= GPROffset(i)) {
+          continue;
+        }
+
+        if (Offset == GPROffset(i) && Size == sizeof(uint64_t) && Class == GPRClass) {
+          ++(IsStore ? Accesses[i].Stores : Accesses[i].Loads);
+        }
+        else {
+          ++Accesses[i].Partial;
+        }
+      }
+    };
+
+    auto HeaderIterator = IR->begin();
+    auto HeaderOp = HeaderIterator()->GetNode(ListBegin)->Op(DataBegin)->C<IROp_IRHeader>();
+    LogMan::Throw::A(HeaderOp->Header.Op == OP_IRHEADER, "First op wasn't IRHeader");
+
+    OrderedNode const *BlockNode = HeaderOp->Blocks.GetNode(ListBegin);
+    while (1) {
+      auto BlockIROp = BlockNode->Op(DataBegin)->C<IROp_CodeBlock>();
+      LogMan::Throw::A(BlockIROp->Header.Op == OP_CODEBLOCK, "IR type failed to be a code block");
+
+      auto CodeBegin = IR->at(BlockIROp->Begin);
+      auto CodeLast = IR->at(BlockIROp->Last);
+      while (1) {
+        IROp_Header const *IROp = CodeBegin()->GetNode(ListBegin)->Op(DataBegin);
+        switch (IROp->Op) {
+          case OP_LOADCONTEXT: {
+            auto Op = IROp->C<IROp_LoadContext>();
+            RecordAccess(Op->Offset, IROp->Size, Op->Class, false);
+            break;
+          }
+          case OP_STORECONTEXT: {
+            auto Op = IROp->C<IROp_StoreContext>();
+            RecordAccess(Op->Offset, IROp->Size, Op->Class, true);
+            break;
+          }
+          case OP_LOADCONTEXTPAIR: {
+            auto Op = IROp->C<IROp_LoadContextPair>();
+            RecordAccess(Op->Offset, Op->Size * 2, Op->Class, false);
+            break;
+          }
+          case OP_STORECONTEXTPAIR: {
+            auto Op = IROp->C<IROp_StoreContextPair>();
+            RecordAccess(Op->Offset, Op->Size * 2, Op->Class, true);
+            break;
+          }
+          case OP_SYSCALL:
+          case OP_INLINESYSCALL:
+            ++ContextSyncs;
+            break;
+          default: break;
+        }
+
+        // CodeLast is inclusive
+        if (CodeBegin == CodeLast) {
+          break;
+        }
+        ++CodeBegin;
+      }
+
+      if (BlockIROp->Next.ID() == 0) {
+        break;
+      }
+      BlockNode = BlockIROp->Next.GetNode(ListBegin);
+    }
+
+    // A pinned GPR costs a fill on entry and after every syscall, a write back at the exit and every syscall once it
+    // has been stored, and up to a spill and a refill around each partial access
+    // GPRs that are only stored would just trade their stores for the write back, those stay in the context
+    std::array<std::pair<int32_t, size_t>, NUM_GPRS> Candidates;
+    size_t NumCandidates {};
+    for (size_t i = 0; i < NUM_GPRS; ++i) {
+      auto &Access = Accesses[i];
+      if (!Access.Loads) {
+        continue;
+      }
+
+      int32_t Saved = Access.Loads + Access.Stores;
+      int32_t Cost = 1 + ContextSyncs + (Access.Stores ? 1 + ContextSyncs : 0) + Access.Partial * 2;
+      if (Saved > Cost) {
+        Candidates[NumCandidates++] = {Saved - Cost, i};
+      }
+    }
+
+    std::stable_sort(Candidates.begin(), Candidates.begin() + NumCandidates, [](auto const &a, auto const &b) {
+      return a.first > b.first;
+    });
+
+    StaticRegisterSet Result;
+    Result.Count = std::min({NumCandidates, MaxRegisters, StaticRegisterSet::MAX_REGISTERS});
+    for (size_t i = 0; i < Result.Count; ++i) {
+      size_t Reg = Candidates[i].second;
+      Result.Offsets[i] = GPROffset(Reg);
+      if (Accesses[Reg].Stores) {
+        Result.Written |= 1U << i;
+      }
+    }
+
+    return Result;
+  }
+}
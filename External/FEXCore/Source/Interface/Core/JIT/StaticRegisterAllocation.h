@@ -0,0 +1,45 @@
+#pragma once
+#include <FEXCore/IR/IR.h>
+#include <FEXCore/IR/IntrusiveIRList.h>
+
+#include <array>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace FEXCore::CPU {
+  /**
+   * @brief Guest GPRs a compiled IR function keeps in host registers instead of the context
+   *
+   * Slot i is the backend's i'th host register handed to SelectStaticRegisters
+   * Every slot gets filled on entry, only the Written ones need writing back before the context is looked at
+   */
+  struct StaticRegisterSet {
+    constexpr static size_t MAX_REGISTERS = 8;
+
+    size_t Count {};
+    // Context offset of the guest GPR in each slot, most profitable first
+    std::array<uint32_t, MAX_REGISTERS> Offsets {};
+    // Slot bits of the guest GPRs the IR stores whole, anything else still matches the context
+    uint32_t Written {};
+
+    uint32_t All() const { return (1U << Count) - 1; }
+
+    /**
+     * @brief Slot a context access covers exactly, -1 if it goes through the context
+     */
+    int32_t Find(uint32_t Offset, uint8_t Size, FEXCore::IR::RegisterClassType Class) const;
+
+    /**
+     * @brief Slot bits of the guest GPRs that [Offset, Offset + Size) touches
+     */
+    uint32_t Overlapping(uint32_t Offset, uint32_t Size) const;
+  };
+
+  /**
+   * @brief Picks up to MaxRegisters guest GPRs that are worth keeping in host registers for the whole IR function
+   *
+   * Only GPRs the IR loads whole are picked, and only when the context accesses that turn in to moves outnumber
+   * the fills, write backs and partial access round trips pinning them costs
+   */
+  StaticRegisterSet SelectStaticRegisters(FEXCore::IR::IRListView<true> const *IR, size_t MaxRegisters);
+}
@@ -1,8 +1,12 @@
 #include "Interface/Context/Context.h"
 #include "Interface/Core/BlockCache.h"
 #include "Interface/Core/BlockSamplingData.h"
+#include "Interface/Core/CodePageTracker.h"
 #include "Interface/Core/InternalThreadState.h"
+#include "Interface/Core/JIT/StaticRegisterAllocation.h"
 #include "Interface/IR/Passes/RegisterAllocationPass.h"
+#include "Interface/IR/SelectFusion.h"
+#include "Interface/Memory/HugePages.h"
 
 #include "Interface/Core/JIT/x86_64/JIT.h"
 #include <xbyak/xbyak.h>
@@ -11,6 +15,10 @@ using namespace Xbyak;
 #include <FEXCore/Core/CPUBackend.h>
 #include <FEXCore/IR/IR.h>
 #include <FEXCore/IR/IntrusiveIRList.h>
+
+#include <algorithm>
+#include <errno.h>
+
 // #define DEBUG_RA 1
 // #define DEBUG_CYCLES
 
@@ -37,11 +45,14 @@ static void PrintValue(uint64_t Value) {
 #define TMP5 rbx
 using namespace Xbyak::util;
 const std::array<Xbyak::Reg, 9> RA64 = { rsi, r8, r9, r10, r11, rbp, r12, r13, r15 };
+// rbp, r12, r13 and r15 are callee saved, the block frame saves them so static register allocation can take the ones the RA didn't use
+constexpr uint32_t FirstCalleeSavedGPR = 5;
 const std::array<std::pair<Xbyak::Reg, Xbyak::Reg>, 4> RA64Pair = {{ {rsi, r8}, {r9, r10}, {r11, rbp}, {r12, r13} }};
 const std::array<Xbyak::Reg, 11> RAXMM = { xmm0, xmm1, xmm2, xmm3, xmm4, xmm5, xmm6, xmm7, xmm8, xmm9, xmm10 };
 const std::array<Xbyak::Xmm, 11> RAXMM_x = { xmm0, xmm1, xmm2, xmm3, xmm4, xmm5, xmm6, xmm7, xmm8, xmm9, xmm10 };
 
-class JITCore final : public CPUBackend, public Xbyak::CodeGenerator {
+// Code memory comes first so it outlives the assembler writing in to it
+class JITCore final : public CPUBackend, private FEXCore::Memory::CodeBuffer, public Xbyak::CodeGenerator {
 public:
   explicit JITCore(FEXCore::Context::Context *ctx, FEXCore::Core::InternalThreadState *Thread);
   ~JITCore() override;
@@ -52,10 +63,15 @@ public:
 
   bool NeedsOpDispatch() override { return true; }
 
-  bool HasCustomDispatch() const override { return CustomDispatchGenerated; }
+  // Blocks only work off of the STATE pointer passed in, any thread can run them
+  bool SharesCodeBetweenThreads() const override { return true; }
+
+  // The IR is only walked while emitting code
+  bool NeedsIRAfterCompile() const override { return false; }
 
-  void ExecuteCustomDispatch(FEXCore::Core::ThreadState *Thread) override {
-    DispatchPtr(reinterpret_cast<FEXCore::Core::InternalThreadState*>(Thread));
+  std::pair<uintptr_t, uintptr_t> GetCodeRange() const override {
+    auto Begin = reinterpret_cast<uintptr_t>(GetCodeMemory());
+    return {Begin, Begin + MAX_CODE_SIZE};
   }
 
   void ClearCache() override {
@@ -86,6 +102,9 @@ private:
 
   /**  @} */
 
+  // Keep the guest GPRs a block uses most in host registers, picked per block
+  bool StaticRegisters {false};
+
   constexpr static uint8_t RA_8 = 0;
   constexpr static uint8_t RA_16 = 1;
   constexpr static uint8_t RA_32 = 2;
@@ -105,10 +124,32 @@ private:
   Xbyak::Xmm GetSrc(uint32_t Node);
   Xbyak::Xmm GetDst(uint32_t Node);
 
-  void CreateCustomDispatch(FEXCore::Core::InternalThreadState *Thread);
-  bool CustomDispatchGenerated {false};
-  using CustomDispatch = void(*)(FEXCore::Core::InternalThreadState *Thread);
-  CustomDispatch DispatchPtr{};
+
+  /**
+   * @brief Slow path of a linked block exit
+   *
+   * Looks up the block for GuestRIP and patches the exit's jump at PatchSite to go straight there
+   * Returns the host code to continue at, or zero if the dispatcher needs to compile it first
+   */
+  static uintptr_t LinkBlock(FEXCore::Core::InternalThreadState *Thread, uint64_t GuestRIP, uintptr_t PatchSite, uint64_t Generation, uintptr_t Stub);
+
+  /**
+   * @brief Slow path of an indirect block exit
+   *
+   * Looks up the block for GuestRIP and puts it in the thread's indirect branch cache
+   * Returns the host code to continue at, or zero if the dispatcher needs to compile it first
+   */
+  static uintptr_t FillIndirectBranchCache(FEXCore::Core::InternalThreadState *Thread, uint64_t GuestRIP);
+
+  /**
+   * @brief Empty indirect branch cache entries jump here, which goes back to the dispatcher
+   */
+  static void IndirectBranchMiss(FEXCore::Core::InternalThreadState *Thread);
+
+  /**
+   * @brief Slow path of a baseline block whose RunCount just reached the tier up threshold
+   */
+  static void QueueTierUp(FEXCore::Context::Context *CTX, uint64_t GuestRIP);
   IR::RegisterAllocationPass *RAPass;
 
 #ifdef BLOCKSTATS
@@ -118,13 +159,16 @@ private:
 };
 
 JITCore::JITCore(FEXCore::Context::Context *ctx, FEXCore::Core::InternalThreadState *Thread)
-  : CodeGenerator(MAX_CODE_SIZE)
+  : FEXCore::Memory::CodeBuffer(MAX_CODE_SIZE, ctx->Config.HugePages)
+  , CodeGenerator(MAX_CODE_SIZE, GetCodeMemory())
   , CTX {ctx}
-  , ThreadState {Thread} {
+  , ThreadState {Thread}
+  , StaticRegisters {ctx->Config.StaticRegisters} {
   Stack.resize(9000 * 16 * 64);
 
-  bool HadRA = CTX->HasRegisterAllocationPass();
-  RAPass = CTX->GetRegisterAllocatorPass();
+  // Register allocation results are per compiling thread, so the pass lives in the thread's pipeline
+  bool HadRA = Thread->PassManager->HasRegisterAllocationPass();
+  RAPass = Thread->PassManager->GetRegisterAllocatorPass();
 
   if (!HadRA) {
     RAPass->AllocateRegisterSet(RegisterCount, RegisterClasses);
@@ -141,7 +185,8 @@ JITCore::JITCore(FEXCore::Context::Context *ctx, FEXCore::Core::InternalThreadSt
     }
   }
 
-  CreateCustomDispatch(Thread);
+  // The caches point in to this backend's code buffer, anything left from a retired backend was already unlinked
+  Thread->State.IndirectBranches.Reset(reinterpret_cast<uintptr_t>(&JITCore::IndirectBranchMiss));
 }
 
 JITCore::~JITCore() {
@@ -158,6 +203,78 @@ static void StoreMem(uint64_t Addr, uint64_t Data, uint8_t Size) {
   LogMan::Msg::D("\tStoring: 0x%016lx", Data);
 }
 
+uintptr_t JITCore::LinkBlock(FEXCore::Core::InternalThreadState *Thread, uint64_t GuestRIP, uintptr_t PatchSite, uint64_t Generation, uintptr_t Stub) {
+  std::unique_lock<std::shared_mutex> lk(Thread->CTX->CodeCacheMutex);
+
+  uintptr_t HostCode = Thread->BlockCache->FindBlock(GuestRIP);
+  if (!HostCode || Thread->BlockCache->GetGeneration() != Generation) {
+    // Either the block doesn't exist yet or the code we are leaving was thrown out of the cache
+    // Don't link either way, retired code must never end up in the link list
+    return HostCode;
+  }
+
+  // The immediate is naturally aligned so threads executing the exit see either the stub or the block
+  auto Target = reinterpret_cast<std::atomic<uintptr_t>*>(PatchSite);
+  if (Target->load(std::memory_order_relaxed) != HostCode) {
+    Target->store(HostCode, std::memory_order_relaxed);
+    Thread->BlockCache->AddBlockLink(GuestRIP, PatchSite, [Target, Stub]() {
+      Target->store(Stub, std::memory_order_relaxed);
+    });
+  }
+
+  return HostCode;
+}
+
+uintptr_t JITCore::FillIndirectBranchCache(FEXCore::Core::InternalThreadState *Thread, uint64_t GuestRIP) {
+  // Most misses are for blocks that don't exist yet, those only need to look
+  {
+    std::shared_lock<std::shared_mutex> lk(Thread->CTX->CodeCacheMutex);
+    if (!Thread->BlockCache->FindBlock(GuestRIP)) {
+      return 0;
+    }
+  }
+
+  // Registering the link needs the lock to ourselves
+  // The block can be thrown out in between, so look it up again
+  std::unique_lock<std::shared_mutex> lk(Thread->CTX->CodeCacheMutex);
+
+  uintptr_t HostCode = Thread->BlockCache->FindBlock(GuestRIP);
+  if (!HostCode) {
+    return 0;
+  }
+
+  auto &Cache = Thread->State.IndirectBranches;
+  auto &Entry = Cache.Targets[GuestRIP & (Cache.TARGET_ENTRIES - 1)];
+  uintptr_t EntryAddress = reinterpret_cast<uintptr_t>(&Entry);
+
+  uint64_t OldRIP = Entry.GuestRIP.load(std::memory_order_relaxed);
+  if (OldRIP) {
+    Thread->BlockCache->RemoveBlockLink(OldRIP, EntryAddress);
+  }
+
+  // Only this thread reads the entry, but other threads can unlink it while it does
+  // Never let the guest RIP pair up with host code from a different block
+  uintptr_t Miss = Cache.Miss;
+  Entry.HostCode.store(Miss, std::memory_order_release);
+  Entry.GuestRIP.store(GuestRIP, std::memory_order_release);
+  Entry.HostCode.store(HostCode, std::memory_order_release);
+
+  Thread->BlockCache->AddBlockLink(GuestRIP, EntryAddress, [&Entry, Miss]() {
+    Entry.HostCode.store(Miss, std::memory_order_release);
+    Entry.GuestRIP.store(0, std::memory_order_release);
+  });
+
+  return HostCode;
+}
+
+void JITCore::IndirectBranchMiss([[maybe_unused]] FEXCore::Core::InternalThreadState *Thread) {
+  // Jumped to in place of a block, so returning here goes straight back to the dispatcher
+}
+
+void JITCore::QueueTierUp(FEXCore::Context::Context *CTX, uint64_t GuestRIP) {
+  CTX->QueueTierUp(GuestRIP);
+}
+
 uint32_t JITCore::GetPhys(uint32_t Node) {
   uint64_t Reg = RAPass->GetNodeRegister(Node);
 
@@ -236,10 +353,17 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
   LogMan::Throw::A(HeaderOp->Header.Op == IR::OP_IRHEADER, "First op wasn't IRHeader");
 
   // Fairly excessive buffer range to make sure we don't overflow
-  uint32_t BufferRange = SSACount * 16;
+  // Linked and indirect exits are quite a bit larger than a regular one, so leave room for them
+  uint32_t BufferRange = SSACount * 32 + 1024;
   if ((getSize() + BufferRange) > MAX_CODE_SIZE) {
     LogMan::Msg::D("Gotta clear code cache: 0x%lx is too close to 0x%lx", getSize(), MAX_CODE_SIZE);
-    ThreadState->CTX->ClearCodeCache(ThreadState, HeaderOp->Entry);
+    ThreadState->CTX->ClearCodeCache(ThreadState);
+
+    if (ThreadState->CPUBackend.get() != this) {
+      // Other threads could still be running our code so we were retired instead of reset
+      // Our replacement picks up this block
+      return ThreadState->CPUBackend->CompileCode(IR, DebugData);
+    }
   }
 
   uint64_t ListStackSize = SSACount * 16;
@@ -249,19 +373,23 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
 
 	void *Entry = getCurr<void*>();
 
+  uint64_t BlockLinkGeneration = ThreadState->BlockCache->GetGeneration();
+
+  // Guest RIP a code block is known to be leaving to, from a constant store to the context's RIP
+  bool HasKnownExitRIP {false};
+  uint64_t KnownExitRIP {};
+
   LogMan::Throw::A(RAPass->HasFullRA(), "Needs RA");
 
   uint32_t SpillSlots = RAPass->SpillSlots();
 
-  if (!CustomDispatchGenerated) {
-    push(rbx);
-    push(rbp);
-    push(r12);
-    push(r13);
-    push(r14);
-    push(r15);
-    mov(STATE, rdi);
-  }
+  push(rbx);
+  push(rbp);
+  push(r12);
+  push(r13);
+  push(r14);
+  push(r15);
+  mov(STATE, rdi);
 
   if (SpillSlots) {
     sub(rsp, SpillSlots * 16 + 8);
@@ -270,6 +398,122 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
     sub(rsp, 8);
   }
 
+  // Guest GPRs live in the callee saved registers the RA left free in this block, the frame already saves those
+  StaticRegisterSet StaticRegs;
+  std::array<Xbyak::Reg, StaticRegisterSet::MAX_REGISTERS> StaticHostRegs;
+  if (StaticRegisters) {
+    uint32_t UsedGPRs {};
+    for (uint32_t i = 0; i < SSACount; ++i) {
+      uint64_t RegAndClass = RAPass->GetNodeRegister(i);
+      uint32_t Reg = RegAndClass;
+      uint32_t Class = RegAndClass >> 32;
+      if (Class == FEXCore::IR::GPRClass.Val) {
+        UsedGPRs |= 1U << Reg;
+      }
+      else if (Class == FEXCore::IR::GPRPairClass.Val) {
+        UsedGPRs |= 3U << (Reg * 2);
+      }
+    }
+
+    size_t FreeGPRs {};
+    for (uint32_t i = FirstCalleeSavedGPR; i < NumGPRs; ++i) {
+      if (!(UsedGPRs & (1U << i))) {
+        StaticHostRegs[FreeGPRs++] = RA64[i];
+      }
+    }
+
+    StaticRegs = SelectStaticRegisters(CurrentIR, FreeGPRs);
+  }
+
+  // Anything that can see the guest state from outside of the block needs the stored static registers in the context
+  auto SpillStaticRegisters = [&](uint32_t Slots) {
+    for (size_t i = 0; i < StaticRegs.Count; ++i) {
+      if (Slots & (1U << i)) {
+        mov(qword [STATE + StaticRegs.Offsets[i]], StaticHostRegs[i]);
+      }
+    }
+  };
+
+  auto FillStaticRegisters = [&](uint32_t Slots) {
+    for (size_t i = 0; i < StaticRegs.Count; ++i) {
+      if (Slots & (1U << i)) {
+        mov(StaticHostRegs[i], qword [STATE + StaticRegs.Offsets[i]]);
+      }
+    }
+  };
+
+  // Memory ops and their indexed forms only differ in how the address is built
+  struct MemAccess {
+    uint8_t Size;
+    uint8_t Align;
+    IR::RegisterClassType Class;
+    bool HasIndex;
+    uint32_t Index;
+    uint8_t Scale;
+    int32_t Displacement;
+  };
+
+  auto GetMemAccess = [](IR::IROp_Header const *IROp) -> MemAccess {
+    switch (IROp->Op) {
+    case IR::OP_LOADMEM: {
+      auto Op = IROp->C<IR::IROp_LoadMem>();
+      return {Op->Size, Op->Align, Op->Class, false, 0, 1, Op->Displacement};
+    }
+    case IR::OP_STOREMEM: {
+      auto Op = IROp->C<IR::IROp_StoreMem>();
+      return {Op->Size, Op->Align, Op->Class, false, 0, 1, Op->Displacement};
+    }
+    case IR::OP_LOADMEMINDEXED: {
+      auto Op = IROp->C<IR::IROp_LoadMemIndexed>();
+      return {Op->Size, Op->Align, Op->Class, true, Op->Index.ID(), Op->Scale, Op->Displacement};
+    }
+    case IR::OP_STOREMEMINDEXED: {
+      auto Op = IROp->C<IR::IROp_StoreMemIndexed>();
+      return {Op->Size, Op->Align, Op->Class, true, Op->Index.ID(), Op->Scale, Op->Displacement};
+    }
+    default: LogMan::Msg::A("Not a memory op: %s", std::string(IR::GetName(IROp->Op)).c_str());
+    }
+    return {};
+  };
+
+  // [Base + Index * Scale + Displacement] in a single operand, only needs rax when guest memory isn't at its host address
+  auto GenerateMemOperand = [&](MemAccess const &Access, uint32_t Base) -> Xbyak::RegExp {
+    Xbyak::RegExp MemSrc;
+    if (CTX->Config.UnifiedMemory) {
+      MemSrc = Xbyak::RegExp(GetSrc<RA_64>(Base));
+    }
+    else {
+      mov(rax, CTX->MemoryMapper.GetBaseOffset<uint64_t>(0));
+      add(rax, GetSrc<RA_64>(Base));
+      MemSrc = Xbyak::RegExp(rax);
+    }
+
+    if (Access.HasIndex) {
+      MemSrc = MemSrc + GetSrc<RA_64>(Access.Index) * Access.Scale;
+    }
+
+    return MemSrc + Access.Displacement;
+  };
+
+  // Counted on entry, which is also where linked exits land, so hot chains of linked baseline blocks still tier up
+  // Optimized blocks don't count, nothing checks their count
+  bool CheckTierUp = DebugData && CTX->CountBlockExecutions && CTX->IsBaselineTier(ThreadState);
+  Label TierUpStub;
+  Label TierUpDone;
+  if (CheckTierUp) {
+    // Not atomic, a lost update from another thread only delays tiering up
+    mov(TMP1, reinterpret_cast<uintptr_t>(&DebugData->RunCount));
+    mov(TMP2, qword [TMP1]);
+    inc(TMP2);
+    mov(qword [TMP1], TMP2);
+    mov(TMP3, CTX->Config.TierUpThreshold);
+    cmp(TMP2, TMP3);
+    je(TierUpStub, T_NEAR);
+    L(TierUpDone);
+  }
+
+  FillStaticRegisters(StaticRegs.All());
+
 #ifdef BLOCKSTATS
   BlockSamplingData::BlockData *SamplingData = CTX->BlockData->GetBlockData(HeaderOp->Entry);
   if (GetSamplingData) {
@@ -313,7 +557,9 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
   };
 #endif
 
-  auto RegularExit = [&]() {
+  auto TearDownFrame = [&]() {
+    SpillStaticRegisters(StaticRegs.Written);
+
     if (SpillSlots) {
       add(rsp, SpillSlots * 16 + 8);
     }
@@ -321,20 +567,179 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
       add(rsp, 8);
     }
 
-    if (!CustomDispatchGenerated) {
-      pop(r15);
-      pop(r14);
-      pop(r13);
-      pop(r12);
-      pop(rbp);
-      pop(rbx);
-    }
+    pop(r15);
+    pop(r14);
+    pop(r13);
+    pop(r12);
+    pop(rbp);
+    pop(rbx);
 #ifdef BLOCKSTATS
     ExitBlock();
 #endif
+  };
+
+  auto RegularExit = [&]() {
+    TearDownFrame();
     ret();
   };
 
+  // Chained blocks never go through the dispatcher, so check whatever it would have checked
+  auto CheckDispatcherEvents = [&](Label &Unlinked) {
+    static_assert(offsetof(FEXCore::Core::ThreadState, RunningEvents.ShouldPause) == offsetof(FEXCore::Core::ThreadState, RunningEvents.ShouldStop) + 1,
+      "ShouldStop and ShouldPause need to be tested together");
+    cmp(word [STATE + offsetof(FEXCore::Core::ThreadState, RunningEvents.ShouldStop)], 0);
+    jne(Unlinked, T_NEAR);
+    mov(TMP1, reinterpret_cast<uint64_t>(&CTX->RunningMode));
+    cmp(dword [TMP1], FEXCore::Context::CoreRunningMode::MODE_RUN);
+    jne(Unlinked, T_NEAR);
+    // The guest wrote to its code, whatever we would chain to might be stale
+    mov(TMP1, reinterpret_cast<uint64_t>(CTX->CodePages->GetWrittenPagesPending()));
+    cmp(byte [TMP1], 0);
+    jne(Unlinked, T_NEAR);
+  };
+
+  // Finds the block for GuestRIP and patches the pointer at PatchSite to it, then continues there
+  // Entered with the frame torn down and the thread state in rdi, same as a block
+  auto LinkStub = [&](Label &Stub, uint64_t GuestRIP, uintptr_t PatchSite) {
+    Label NotCompiled;
+
+    L(Stub);
+    // Stack is back to how it was on entry, the push realigns it for the call
+    push(rdi);
+    mov(rsi, GuestRIP);
+    mov(rdx, PatchSite);
+    mov(rcx, BlockLinkGeneration);
+    mov(r8, Stub);
+    mov(TMP1, reinterpret_cast<uintptr_t>(&JITCore::LinkBlock));
+    call(TMP1);
+    pop(rdi);
+    test(rax, rax);
+    jz(NotCompiled);
+    jmp(rax);
+
+    L(NotCompiled);
+    // RIP has already been stored, the dispatcher compiles it
+    ret();
+  };
+
+  // Calls push where they return to on the thread's return stack
+  // The entry points at a pointer in the code buffer that starts out going to a link stub, ReturnSlots emits those
+  std::vector<std::pair<uint64_t, Label>> ReturnSlots;
+  auto PushReturn = [&](uint64_t ReturnRIP) {
+    constexpr auto ReturnsOffset = offsetof(FEXCore::Core::ThreadState, IndirectBranches.Returns);
+    constexpr auto TopOffset = offsetof(FEXCore::Core::ThreadState, IndirectBranches.ReturnTop);
+    auto &Slot = ReturnSlots.emplace_back(ReturnRIP, Label{}).second;
+
+    mov(TMP2, qword [STATE + TopOffset]);
+    mov(TMP1, TMP2);
+    and(TMP1, FEXCore::Core::IndirectBranchCache::RETURN_ENTRIES - 1);
+    shl(TMP1, 4);
+    mov(TMP3, ReturnRIP);
+    mov(qword [STATE + TMP1 + ReturnsOffset + offsetof(FEXCore::Core::IndirectBranchCache::ReturnEntry, GuestRIP)], TMP3);
+    mov(TMP3, Slot);
+    mov(qword [STATE + TMP1 + ReturnsOffset + offsetof(FEXCore::Core::IndirectBranchCache::ReturnEntry, HostCode)], TMP3);
+    inc(TMP2);
+    mov(qword [STATE + TopOffset], TMP2);
+  };
+
+  auto EmitReturnSlots = [&]() {
+    for (auto &ReturnSlot : ReturnSlots) {
+      Label Stub;
+      // Same as the linked exit immediate, naturally aligned so it can be patched while being used
+      while (getCurr<uintptr_t>() % 8) {
+        int3();
+      }
+      L(ReturnSlot.second);
+      uintptr_t PatchSite = getCurr<uintptr_t>();
+      putL(Stub);
+      LinkStub(Stub, ReturnSlot.first, PatchSite);
+    }
+    ReturnSlots.clear();
+  };
+
+  // Leaves the block by jumping directly to the block for GuestRIP
+  // The jump starts out going to a stub that finds the block and back-patches the jump
+  auto LinkedExit = [&](uint64_t GuestRIP) {
+    Label Unlinked;
+    Label Stub;
+
+    CheckDispatcherEvents(Unlinked);
+
+    // Blocks take the thread state as their first argument
+    mov(rdi, STATE);
+    TearDownFrame();
+
+    // Align the jump target's immediate so it can be patched while other threads are executing it
+    while ((getCurr<uintptr_t>() + 2) % 8) {
+      nop();
+    }
+    uintptr_t PatchSite = getCurr<uintptr_t>() + 2;
+    mov(TMP1, Stub);
+    jmp(TMP1);
+
+    LinkStub(Stub, GuestRIP, PatchSite);
+
+    L(Unlinked);
+    RegularExit();
+  };
+
+  // Leaves the block for a RIP that was computed at runtime
+  // Returns first try the return stack, then everything goes through the thread's indirect branch cache
+  auto IndirectExit = [&](bool IsReturn) {
+    constexpr auto ReturnsOffset = offsetof(FEXCore::Core::ThreadState, IndirectBranches.Returns);
+    constexpr auto TopOffset = offsetof(FEXCore::Core::ThreadState, IndirectBranches.ReturnTop);
+    constexpr auto TargetsOffset = offsetof(FEXCore::Core::ThreadState, IndirectBranches.Targets);
+    Label Unlinked;
+    Label Miss;
+    Label NotCompiled;
+
+    CheckDispatcherEvents(Unlinked);
+
+    mov(rdi, STATE);
+    TearDownFrame();
+    mov(TMP1, qword [rdi + offsetof(FEXCore::Core::CPUState, rip)]);
+
+    if (IsReturn) {
+      Label NotPredicted;
+      mov(TMP2, qword [rdi + TopOffset]);
+      dec(TMP2);
+      mov(qword [rdi + TopOffset], TMP2);
+      and(TMP2, FEXCore::Core::IndirectBranchCache::RETURN_ENTRIES - 1);
+      shl(TMP2, 4);
+      cmp(qword [rdi + TMP2 + ReturnsOffset + offsetof(FEXCore::Core::IndirectBranchCache::ReturnEntry, GuestRIP)], TMP1);
+      jne(NotPredicted);
+      mov(TMP2, qword [rdi + TMP2 + ReturnsOffset + offsetof(FEXCore::Core::IndirectBranchCache::ReturnEntry, HostCode)]);
+      jmp(qword [TMP2]);
+      L(NotPredicted);
+    }
+
+    mov(TMP2, TMP1);
+    and(TMP2, FEXCore::Core::IndirectBranchCache::TARGET_ENTRIES - 1);
+    shl(TMP2, 4);
+    cmp(qword [rdi + TMP2 + TargetsOffset + offsetof(FEXCore::Core::IndirectBranchCache::TargetEntry, GuestRIP)], TMP1);
+    jne(Miss);
+    jmp(qword [rdi + TMP2 + TargetsOffset + offsetof(FEXCore::Core::IndirectBranchCache::TargetEntry, HostCode)]);
+
+    L(Miss);
+    push(rdi);
+    mov(rsi, TMP1);
+    mov(TMP1, reinterpret_cast<uintptr_t>(&JITCore::FillIndirectBranchCache));
+    call(TMP1);
+    pop(rdi);
+    test(rax, rax);
+    jz(NotCompiled);
+    jmp(rax);
+
+    L(NotCompiled);
+    ret();
+
+    L(Unlinked);
+    RegularExit();
+  };
+
+  // Node whose compare is in the host flags, only valid for the op directly after it
+  uint32_t HostFlagsNode = ~0U;
+
   IR::OrderedNode *BlockNode = HeaderOp->Blocks.GetNode(ListBegin);
   while (1) {
     using namespace FEXCore::IR;
@@ -353,6 +758,8 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
       }
 
       L(IsTarget->second);
+      HasKnownExitRIP = false;
+      HostFlagsNode = ~0U;
     }
 
     while (1) {
@@ -362,6 +769,9 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
       uint8_t OpSize = IROp->Size;
       uint32_t Node = WrapperOp->ID();
 
+      uint32_t FlagsNode = HostFlagsNode;
+      HostFlagsNode = ~0U;
+
       #ifdef DEBUG_RA
       if (IROp->Op != IR::OP_BEGINBLOCK &&
           IROp->Op != IR::OP_CONDJUMP &&
@@ -408,17 +818,30 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
           }
 
           L(IsTarget->second);
+          HasKnownExitRIP = false;
           break;
         }
         case IR::OP_ENDBLOCK: {
           auto Op = IROp->C<IR::IROp_EndBlock>();
           if (Op->RIPIncrement) {
             add(qword [STATE + offsetof(FEXCore::Core::CPUState, rip)], Op->RIPIncrement);
+            KnownExitRIP += Op->RIPIncrement;
           }
           break;
         }
         case IR::OP_EXITFUNCTION: {
-          RegularExit();
+          auto Op = IROp->C<IR::IROp_ExitFunction>();
+          if (Op->Hint == IR::EXIT_HINT_CALL) {
+            PushReturn(Op->ReturnRIP);
+          }
+
+          if (Op->Hint != IR::EXIT_HINT_RETURN && HasKnownExitRIP) {
+            LinkedExit(KnownExitRIP);
+          }
+          else {
+            IndirectExit(Op->Hint == IR::EXIT_HINT_RETURN);
+          }
+          EmitReturnSlots();
           break;
         }
         case IR::OP_BREAK: {
@@ -426,6 +849,7 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
           switch (Op->Reason) {
             case 0: // Hard fault
             case 5: // Guest ud2
+              SpillStaticRegisters(StaticRegs.Written);
               ud2();
             break;
             case 4: // HLT
@@ -483,6 +907,32 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
             FalseTargetLabel = &FalseIter->second;
           }
 
+          if (Op->Header.Args[0].ID() == FlagsNode) {
+            // Branch on the compare the Select left in the flags
+            auto SelectNode = Op->Header.Args[0].GetNode(ListBegin);
+            bool Invert;
+            IR::CanFuseSelectBranch(CurrentIR, SelectNode, RealNode, &Invert);
+            if (Invert) {
+              std::swap(TrueTargetLabel, FalseTargetLabel);
+            }
+
+            switch (SelectNode->Op(DataBegin)->C<IR::IROp_Select>()->Cond.Val) {
+            case FEXCore::IR::COND_EQ:  je(*TrueTargetLabel, T_NEAR); break;
+            case FEXCore::IR::COND_NEQ: jne(*TrueTargetLabel, T_NEAR); break;
+            case FEXCore::IR::COND_SGE: jge(*TrueTargetLabel, T_NEAR); break;
+            case FEXCore::IR::COND_SLT: jl(*TrueTargetLabel, T_NEAR); break;
+            case FEXCore::IR::COND_SGT: jg(*TrueTargetLabel, T_NEAR); break;
+            case FEXCore::IR::COND_SLE: jle(*TrueTargetLabel, T_NEAR); break;
+            case FEXCore::IR::COND_UGE: jae(*TrueTargetLabel, T_NEAR); break;
+            case FEXCore::IR::COND_ULT: jb(*TrueTargetLabel, T_NEAR); break;
+            case FEXCore::IR::COND_UGT: ja(*TrueTargetLabel, T_NEAR); break;
+            case FEXCore::IR::COND_ULE: jbe(*TrueTargetLabel, T_NEAR); break;
+            default: LogMan::Msg::A("Unsupported compare type"); break;
+            }
+            jmp(*FalseTargetLabel, T_NEAR);
+            break;
+          }
+
           // Take branch if (src != 0)
           cmp(GetSrc<RA_64>(Op->Header.Args[0].ID()), 0);
           jne(*TrueTargetLabel, T_NEAR);
@@ -491,6 +941,14 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
         }
         case IR::OP_LOADCONTEXT: {
           auto Op = IROp->C<IR::IROp_LoadContext>();
+          int32_t StaticReg = StaticRegs.Find(Op->Offset, OpSize, Op->Class);
+          if (StaticReg != -1) {
+            mov(GetDst<RA_64>(Node), StaticHostRegs[StaticReg]);
+            break;
+          }
+
+          SpillStaticRegisters(StaticRegs.Overlapping(Op->Offset, OpSize) & StaticRegs.Written);
+
           if (Op->Class.Val == 0) {
             switch (OpSize) {
             case 1: {
@@ -646,6 +1104,23 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
         case IR::OP_STORECONTEXT: {
           auto Op = IROp->C<IR::IROp_StoreContext>();
 
+          if (Op->Offset == offsetof(FEXCore::Core::CPUState, rip)) {
+            auto ValueOp = Op->Header.Args[0].GetNode(ListBegin)->Op(DataBegin);
+            HasKnownExitRIP = ValueOp->Op == IR::OP_CONSTANT && OpSize == 8;
+            if (HasKnownExitRIP) {
+              KnownExitRIP = ValueOp->C<IR::IROp_Constant>()->Constant;
+            }
+          }
+
+          int32_t StaticReg = StaticRegs.Find(Op->Offset, OpSize, Op->Class);
+          if (StaticReg != -1) {
+            mov(StaticHostRegs[StaticReg], GetSrc<RA_64>(Op->Header.Args[0].ID()));
+            break;
+          }
+
+          uint32_t PartialStaticRegs = StaticRegs.Overlapping(Op->Offset, OpSize);
+          SpillStaticRegisters(PartialStaticRegs & StaticRegs.Written);
+
           if (Op->Class.Val == 0) {
             switch (OpSize) {
             case 1: {
@@ -700,6 +1175,8 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
             default:  LogMan::Msg::A("Unhandled StoreContext size: %d", OpSize);
             }
           }
+
+          FillStaticRegisters(PartialStaticRegs);
           break;
         }
         case IR::OP_STORECONTEXTINDEXED: {
@@ -788,6 +1265,8 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
         }
         case IR::OP_LOADCONTEXTPAIR: {
           auto Op = IROp->C<IR::IROp_LoadContextPair>();
+          SpillStaticRegisters(StaticRegs.Overlapping(Op->Offset, Op->Size * 2) & StaticRegs.Written);
+
           switch (Op->Size) {
             case 4: {
               auto Dst = GetSrcPair<RA_32>(Node);
@@ -807,6 +1286,9 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
         }
         case IR::OP_STORECONTEXTPAIR: {
           auto Op = IROp->C<IR::IROp_StoreContextPair>();
+          uint32_t PartialStaticRegs = StaticRegs.Overlapping(Op->Offset, Op->Size * 2);
+          SpillStaticRegisters(PartialStaticRegs & StaticRegs.Written);
+
           switch (Op->Size) {
             case 4: {
               auto Src = GetSrcPair<RA_32>(Op->Header.Args[0].ID());
@@ -821,6 +1303,8 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
               break;
             }
           }
+
+          FillStaticRegisters(PartialStaticRegs);
           break;
         }
         case IR::OP_CREATEELEMENTPAIR: {
@@ -1770,6 +2254,18 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
         }
         case IR::OP_SELECT: {
           auto Op = IROp->C<IR::IROp_Select>();
+
+          if (CodeBegin != CodeLast) {
+            auto NextIter = CodeBegin;
+            ++NextIter;
+            bool Invert;
+            if (IR::CanFuseSelectBranch(CurrentIR, RealNode, NextIter()->GetNode(ListBegin), &Invert)) {
+              cmp(GetSrc<RA_64>(Op->Header.Args[0].ID()), GetSrc<RA_64>(Op->Header.Args[1].ID()));
+              HostFlagsNode = Node;
+              break;
+            }
+          }
+
           auto Dst = GetDst<RA_64>(Node);
 
           mov(rax, GetSrc<RA_64>(Op->Header.Args[0].ID()));
@@ -1827,128 +2323,113 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
           mov (Dst, rax);
           break;
         }
-        case IR::OP_LOADMEM: {
-          auto Op = IROp->C<IR::IROp_LoadMem>();
-          uint64_t Memory = CTX->MemoryMapper.GetBaseOffset<uint64_t>(0);
+        case IR::OP_LOADMEM:
+        case IR::OP_LOADMEMINDEXED: {
+          auto Op = GetMemAccess(IROp);
+          auto Mem = GenerateMemOperand(Op, IROp->Args[0].ID());
 
-          Xbyak::Reg MemReg = rax;
-          if (CTX->Config.UnifiedMemory) {
-            MemReg = GetSrc<RA_64>(Op->Header.Args[0].ID());
-          }
-          else {
-            mov(MemReg, Memory);
-            add(MemReg, GetSrc<RA_64>(Op->Header.Args[0].ID()));
-          }
-          if (Op->Class.Val == 0) {
+          if (Op.Class.Val == 0) {
             auto Dst = GetDst<RA_64>(Node);
 
-            switch (Op->Size) {
+            switch (Op.Size) {
               case 1: {
-                movzx (Dst, byte [MemReg]);
+                movzx (Dst, byte [Mem]);
               }
               break;
               case 2: {
-                movzx (Dst, word [MemReg]);
+                movzx (Dst, word [Mem]);
               }
               break;
               case 4: {
-                mov(Dst.cvt32(), dword [MemReg]);
+                mov(Dst.cvt32(), dword [Mem]);
               }
               break;
               case 8: {
-                mov(Dst, qword [MemReg]);
+                mov(Dst, qword [Mem]);
               }
               break;
-              default:  LogMan::Msg::A("Unhandled LoadMem size: %d", Op->Size);
+              default:  LogMan::Msg::A("Unhandled LoadMem size: %d", Op.Size);
             }
           }
           else
           {
             auto Dst = GetDst(Node);
 
-            switch (Op->Size) {
+            switch (Op.Size) {
               case 1: {
-                pinsrb(Dst, byte [MemReg], 0);
+                pinsrb(Dst, byte [Mem], 0);
               }
               break;
               case 2: {
-                pinsrw(Dst, word [MemReg], 0);
+                pinsrw(Dst, word [Mem], 0);
               }
               break;
               case 4: {
-                vmovd(Dst, dword [MemReg]);
+                vmovd(Dst, dword [Mem]);
               }
               break;
               case 8: {
-                vmovq(Dst, qword [MemReg]);
+                vmovq(Dst, qword [Mem]);
               }
               break;
               case 16: {
-                 if (Op->Size == Op->Align)
-                   movups(GetDst(Node), xword [MemReg]);
+                 if (Op.Size == Op.Align)
+                   movups(GetDst(Node), xword [Mem]);
                  else
-                   movups(GetDst(Node), xword [MemReg]);
+                   movups(GetDst(Node), xword [Mem]);
                  if (MemoryDebug) {
                    movq(rcx, GetDst(Node));
                  }
                }
                break;
-              default:  LogMan::Msg::A("Unhandled LoadMem size: %d", Op->Size);
+              default:  LogMan::Msg::A("Unhandled LoadMem size: %d", Op.Size);
             }
           }
           break;
         }
-        case IR::OP_STOREMEM: {
-          auto Op = IROp->C<IR::IROp_StoreMem>();
-          uint64_t Memory = CTX->MemoryMapper.GetBaseOffset<uint64_t>(0);
-
-          Xbyak::Reg MemReg = rax;
-          if (CTX->Config.UnifiedMemory) {
-            MemReg = GetSrc<RA_64>(Op->Header.Args[0].ID());
-          }
-          else {
-            mov(MemReg, Memory);
-            add(MemReg, GetSrc<RA_64>(Op->Header.Args[0].ID()));
-          }
+        case IR::OP_STOREMEM:
+        case IR::OP_STOREMEMINDEXED: {
+          auto Op = GetMemAccess(IROp);
+          auto Mem = GenerateMemOperand(Op, IROp->Args[0].ID());
 
-          if (Op->Class.Val == 0) {
-            switch (Op->Size) {
+          if (Op.Class.Val == 0) {
+            switch (Op.Size) {
             case 1:
-              mov(byte [MemReg], GetSrc<RA_8>(Op->Header.Args[1].ID()));
+              mov(byte [Mem], GetSrc<RA_8>(IROp->Args[1].ID()));
             break;
             case 2:
-              mov(word [MemReg], GetSrc<RA_16>(Op->Header.Args[1].ID()));
+              mov(word [Mem], GetSrc<RA_16>(IROp->Args[1].ID()));
             break;
             case 4:
-              mov(dword [MemReg], GetSrc<RA_32>(Op->Header.Args[1].ID()));
+              mov(dword [Mem], GetSrc<RA_32>(IROp->Args[1].ID()));
             break;
             case 8:
-              mov(qword [MemReg], GetSrc<RA_64>(Op->Header.Args[1].ID()));
+              mov(qword [Mem], GetSrc<RA_64>(IROp->Args[1].ID()));
             break;
-            default:  LogMan::Msg::A("Unhandled StoreMem size: %d", Op->Size);
+            default:  LogMan::Msg::A("Unhandled StoreMem size: %d", Op.Size);
             }
           }
           else {
-            switch (Op->Size) {
+            switch (Op.Size) {
             case 1:
-              pextrb(byte [MemReg], GetSrc(Op->Header.Args[1].ID()), 0);
+              pextrb(byte [Mem], GetSrc(IROp->Args[1].ID()), 0);
             break;
             case 2:
-              pextrw(word [MemReg], GetSrc(Op->Header.Args[1].ID()), 0);
+              pextrw(word [Mem], GetSrc(IROp->Args[1].ID()), 0);
             break;
             case 4:
-              vmovd(dword [MemReg], GetSrc(Op->Header.Args[1].ID()));
+              vmovd(dword [Mem], GetSrc(IROp->Args[1].ID()));
             break;
             case 8:
-              vmovq(qword [MemReg], GetSrc(Op->Header.Args[1].ID()));
+              vmovq(qword [Mem], GetSrc(IROp->Args[1].ID()));
             break;
             case 16:
-              if (Op->Size == Op->Align)
-                movups(xword [MemReg], GetSrc(Op->Header.Args[1].ID()));
+              if (Op.Size == Op.Align)
+                movups(xword [Mem], GetSrc(IROp->Args[1].ID()));
               else
-                movups(xword [MemReg], GetSrc(Op->Header.Args[1].ID()));
+                movups(xword [Mem], GetSrc(IROp->Args[1].ID()));
             break;
-            default:  LogMan::Msg::A("Unhandled StoreMem size: %d", Op->Size);
+            default:  LogMan::Msg::A("Unhandled StoreMem size: %d", Op.Size);
             }
           }
           break;
@@ -1957,6 +2438,9 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
           auto Op = IROp->C<IR::IROp_Syscall>();
           // XXX: This is very terrible, but I don't care for right now
 
+          // The syscall handler works on the guest state in the context
+          SpillStaticRegisters(StaticRegs.Written);
+
           auto NumPush = 1 + RA64.size();
           push(rdi);
 
@@ -1977,7 +2461,7 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
             ++NumPush;
           }
 
-          mov(rsi, rdi); // Move thread in to rsi
+          mov(rsi, STATE); // Move thread in to rsi
           mov(rdi, reinterpret_cast<uint64_t>(CTX->SyscallHandler.get()));
           mov(rdx, rsp);
 
@@ -2002,9 +2486,136 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
 
           pop(rdi);
 
+          FillStaticRegisters(StaticRegs.All());
+
           mov (GetDst<RA_64>(Node), rax);
           break;
         }
+        case IR::OP_INLINESYSCALL: {
+          auto Op = IROp->C<IR::IROp_InlineSyscall>();
+          auto Def = CTX->SyscallHandler->GetDefinition(Op->SyscallNumber);
+
+          // Only caller saved registers with values that are used after the call need saving
+          constexpr uint32_t CallerSavedGPRs = FirstCalleeSavedGPR;
+          uint32_t SavedGPRs {};
+          uint32_t SavedXMMs {};
+          for (uint32_t i = 0; i < SSACount; ++i) {
+            if (!RAPass->IsLiveAcross(i, Node)) continue;
+            uint64_t RegAndClass = RAPass->GetNodeRegister(i);
+            uint32_t Reg = RegAndClass;
+            uint32_t Class = RegAndClass >> 32;
+            if (Class == FEXCore::IR::GPRClass.Val) {
+              SavedGPRs |= 1U << Reg;
+            }
+            else if (Class == FEXCore::IR::GPRPairClass.Val) {
+              SavedGPRs |= 3U << (Reg * 2);
+            }
+            else if (Class == FEXCore::IR::FPRClass.Val) {
+              SavedXMMs |= 1U << Reg;
+            }
+          }
+          SavedGPRs &= (1U << CallerSavedGPRs) - 1;
+
+          uint32_t NumGPRsSaved = 0;
+          for (uint32_t i = 0; i < CallerSavedGPRs; ++i) {
+            if (SavedGPRs & (1U << i)) {
+              push(RA64[i]);
+              ++NumGPRsSaved;
+            }
+          }
+
+          // XMM save area, padded to bring the stack back to 16byte alignment
+          uint32_t XMMSaveSize = __builtin_popcount(SavedXMMs) * 16 + (NumGPRsSaved & 1) * 8;
+          if (XMMSaveSize) {
+            sub(rsp, XMMSaveSize);
+          }
+          uint32_t XMMSlot = 0;
+          for (uint32_t i = 0; i < NumXMMs; ++i) {
+            if (SavedXMMs & (1U << i)) {
+              movups(xword [rsp + XMMSlot * 16], RAXMM_x[i]);
+              ++XMMSlot;
+            }
+          }
+
+          // [rsp + 0]: Sixth syscall argument, passed on the stack
+          // [rsp + 16]: SyscallArguments for the fallback, unused arguments are zero so they don't look like pointers
+          constexpr uint32_t ArgsOffset = 16;
+          constexpr uint32_t CallStackSize = 80;
+          sub(rsp, CallStackSize);
+          mov(qword [rsp + ArgsOffset], static_cast<uint32_t>(Op->SyscallNumber));
+          for (uint32_t i = 0; i < FEXCore::HLE::SyscallArguments::MAX_ARGS - 1; ++i) {
+            if (Op->Header.Args[i].IsInvalid()) {
+              mov(qword [rsp + ArgsOffset + (i + 1) * 8], 0);
+            }
+            else {
+              mov(qword [rsp + ArgsOffset + (i + 1) * 8], GetSrc<RA_64>(Op->Header.Args[i].ID()));
+            }
+          }
+
+          // The handler works on the guest state in the context
+          SpillStaticRegisters(StaticRegs.Written);
+
+          // The generic handler times and records the syscall while tracing is on
+          Label Traced, Done;
+          mov(rax, reinterpret_cast<uint64_t>(CTX->SyscallHandler->Tracer.GetEnabledFlag()));
+          cmp(byte [rax], 0);
+          jne(Traced, T_NEAR);
+
+          if (Def->NumOutputs) {
+            // The kernel can't write to guest code pages we protected, the generic path does this itself
+            mov(rdi, reinterpret_cast<uint64_t>(CTX->SyscallHandler.get()));
+            lea(rsi, ptr [rsp + ArgsOffset]);
+            mov(rax, reinterpret_cast<uint64_t>(&FEXCore::ReleaseCodePagesForOutputs));
+            call(rax);
+          }
+
+          // Arguments come from the array since RA registers overlap the argument registers
+          const std::array<Xbyak::Reg64, 5> ArgRegs = { rsi, rdx, rcx, r8, r9 };
+          for (uint32_t i = 0; i < std::min<uint32_t>(Def->NumArgs, ArgRegs.size()); ++i) {
+            mov(ArgRegs[i], qword [rsp + ArgsOffset + (i + 1) * 8]);
+          }
+          if (Def->NumArgs == 6) {
+            mov(rax, qword [rsp + ArgsOffset + 6 * 8]);
+            mov(qword [rsp], rax);
+          }
+
+          mov(rdi, STATE);
+          mov(rax, reinterpret_cast<uint64_t>(Def->Ptr));
+          call(rax);
+          jmp(Done, T_NEAR);
+
+          L(Traced);
+          mov(rdi, reinterpret_cast<uint64_t>(CTX->SyscallHandler.get()));
+          mov(rsi, STATE);
+          lea(rdx, ptr [rsp + ArgsOffset]);
+          mov(rax, reinterpret_cast<uint64_t>(FEXCore::HandleSyscall));
+          call(rax);
+          L(Done);
+
+          add(rsp, CallStackSize);
+
+          XMMSlot = 0;
+          for (uint32_t i = 0; i < NumXMMs; ++i) {
+            if (SavedXMMs & (1U << i)) {
+              movups(RAXMM_x[i], xword [rsp + XMMSlot * 16]);
+              ++XMMSlot;
+            }
+          }
+          if (XMMSaveSize) {
+            add(rsp, XMMSaveSize);
+          }
+
+          for (uint32_t i = CallerSavedGPRs; i > 0; --i) {
+            if (SavedGPRs & (1U << (i - 1))) {
+              pop(RA64[i - 1]);
+            }
+          }
+
+          FillStaticRegisters(StaticRegs.All());
+
+          mov(GetDst<RA_64>(Node), rax);
+          break;
+        }
         case IR::OP_VEXTRACTTOGPR: {
           auto Op = IROp->C<IR::IROp_VExtractToGPR>();
 
@@ -3817,6 +4428,106 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
           }
           break;
         }
+        case IR::OP_MEMCPY:
+        case IR::OP_MEMSET:
+        case IR::OP_MEMCMP: {
+          // The host string instructions have exactly the guest's semantics, element size and direction flag included
+          // Args are laid out the same for all three, 0: Dest/Src1, 1: Src/Value/Src2, 2: Count, 3: Direction
+          uint8_t Size{};
+          switch (IROp->Op) {
+          case IR::OP_MEMCPY: Size = IROp->C<IR::IROp_MemCpy>()->Size; break;
+          case IR::OP_MEMSET: Size = IROp->C<IR::IROp_MemSet>()->Size; break;
+          default: Size = IROp->C<IR::IROp_MemCmp>()->Size; break;
+          }
+
+          // rsi is the only register of the three the RA hands out, grab everything before it gets clobbered
+          bool UsesRSI = IROp->Op != IR::OP_MEMSET;
+          mov(rdi, GetSrc<RA_64>(IROp->Args[0].ID()));
+          mov(rax, GetSrc<RA_64>(IROp->Args[1].ID()));
+          mov(rcx, GetSrc<RA_64>(IROp->Args[2].ID()));
+          movzx(ebx, GetSrc<RA_8>(IROp->Args[3].ID()));
+
+          if (!CTX->Config.UnifiedMemory) {
+            mov(rdx, CTX->MemoryMapper.GetBaseOffset<uint64_t>(0));
+            add(rdi, rdx);
+            if (UsesRSI) {
+              add(rax, rdx);
+            }
+          }
+
+          // Original count, so MemCmp can work out how many elements it went through
+          mov(rdx, rcx);
+
+          if (UsesRSI) {
+            push(rsi);
+            mov(rsi, rax);
+          }
+
+          auto EmitString = [&]() {
+            switch (IROp->Op) {
+            case IR::OP_MEMCPY:
+              rep();
+              switch (Size) {
+              case 1: movsb(); break;
+              case 2: movsw(); break;
+              case 4: movsd(); break;
+              case 8: movsq(); break;
+              default: LogMan::Msg::A("Unhandled MemCpy size: %d", Size); break;
+              }
+            break;
+            case IR::OP_MEMSET:
+              rep();
+              switch (Size) {
+              case 1: stosb(); break;
+              case 2: stosw(); break;
+              case 4: stosd(); break;
+              case 8: stosq(); break;
+              default: LogMan::Msg::A("Unhandled MemSet size: %d", Size); break;
+              }
+            break;
+            default: {
+              auto Op = IROp->C<IR::IROp_MemCmp>();
+              if (Op->WhileEqual) {
+                repe();
+              }
+              else {
+                repne();
+              }
+              switch (Size) {
+              case 1: cmpsb(); break;
+              case 2: cmpsw(); break;
+              case 4: cmpsd(); break;
+              case 8: cmpsq(); break;
+              default: LogMan::Msg::A("Unhandled MemCmp size: %d", Size); break;
+              }
+            break;
+            }
+            }
+          };
+
+          Label Forward;
+          Label Done;
+          test(ebx, ebx);
+          jz(Forward);
+          std();
+          EmitString();
+          cld();
+          jmp(Done);
+          L(Forward);
+          EmitString();
+          L(Done);
+
+          if (UsesRSI) {
+            pop(rsi);
+          }
+
+          if (IROp->Op == IR::OP_MEMCMP) {
+            // The count register only goes down for elements that were compared
+            sub(rdx, rcx);
+            mov(GetDst<RA_64>(Node), rdx);
+          }
+          break;
+        }
         case IR::OP_CAS: {
           auto Op = IROp->C<IR::IROp_CAS>();
           // Args[0]: Desired
@@ -4407,6 +5118,11 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
           }
           break;
         }
+        case IR::OP_LOADTHREADMANAGER: {
+          auto Op = IROp->C<IR::IROp_LoadThreadManager>();
+          mov(GetDst<RA_64>(Node), qword [STATE + offsetof(FEXCore::Core::ThreadState, ThreadManager) + Op->Offset]);
+          break;
+        }
         case IR::OP_CYCLECOUNTER: {
           #ifdef DEBUG_CYCLES
           mov (GetDst<RA_64>(Node), 0);
@@ -4504,6 +5220,16 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
     }
   }
 
+  if (CheckTierUp) {
+    // Only the callee saved registers hold anything yet and the stack is aligned
+    L(TierUpStub);
+    mov(rdi, reinterpret_cast<uintptr_t>(CTX));
+    mov(rsi, HeaderOp->Entry);
+    mov(TMP1, reinterpret_cast<uintptr_t>(&JITCore::QueueTierUp));
+    call(TMP1);
+    jmp(TierUpDone, T_NEAR);
+  }
+
   void *Exit = getCurr<void*>();
 
   ready();
@@ -4514,130 +5240,6 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView<true> const
   return Entry;
 }
 
-void JITCore::CreateCustomDispatch(FEXCore::Core::InternalThreadState *Thread) {
-// Temp registers
-// rax, rcx, rdx, rsi, r8, r9,
-// r10, r11
-//
-// Callee Saved
-// rbx, rbp, r12, r13, r14, r15
-//
-// 1St Argument: rdi <ThreadState>
-// XMM:
-// All temp
-  DispatchPtr = getCurr<CustomDispatch>();
-
-  // while (!Thread->State.RunningEvents.ShouldStop.load()) {
-  //    Ptr = FindBlock(RIP)
-  //    if (!Ptr)
-  //      Ptr = CTX->CompileBlock(RIP);
-  //
-  //    if (Ptr)
-  //      Ptr();
-  //    else
-  //    {
-  //      Ptr = FallbackCore->CompileBlock()
-  //      if (Ptr)
-  //        Ptr()
-  //      else {
-  //        ShouldStop = true;
-  //      }
-  //    }
-  // }
-  // Bunch of exit state stuff
-  push(rbx);
-  push(rbp);
-  push(rbp);
-  push(r12);
-  push(r13);
-  push(r14);
-  push(r15);
-
-  mov(STATE, rdi);
-
-  Label LoopTop;
-  L(LoopTop);
-
-  mov(r13, Thread->BlockCache->GetPagePointer());
-
-  // Load our RIP
-  mov(rdx, qword [STATE + offsetof(FEXCore::Core::CPUState, rip)]);
-
-  mov(rax, rdx);
-  shr(rax, 12);
-
-  // Load page pointer
-  mov(rdi, qword [r13 + rax * 8]);
-
-  Label NoBlock;
-  cmp(rdi, 0);
-  je(NoBlock);
-
-  mov (rax, rdx);
-  and(rax, 0x0FFF);
-
-  // Load the block pointer
-  mov(rax, qword [rdi + rax * 8]);
-
-  cmp(rax, 0);
-  je(NoBlock);
-
-  // Real block if we made it here
-  push(0);
-  call(rax);
-  add(rsp, 8);
-
-  Label ExitCheck;
-  L(ExitCheck);
-
-  cmp(byte [STATE + offsetof(FEXCore::Core::ThreadState, RunningEvents.ShouldStop)], 0);
-  je(LoopTop);
-
-  pop(r15);
-  pop(r14);
-  pop(r13);
-  pop(r12);
-  pop(rbp);
-  pop(rbp);
-  pop(rbx);
-
-  ret();
-
-  Label FallbackCore;
-  // Block creation
-  {
-    L(NoBlock);
-
-    using ClassPtrType = uintptr_t (FEXCore::Context::Context::*)(FEXCore::Core::InternalThreadState *, uint64_t);
-    union PtrCast {
-      ClassPtrType ClassPtr;
-      uintptr_t Data;
-    };
-
-    PtrCast Ptr;
-    Ptr.ClassPtr = &FEXCore::Context::Context::CompileBlock;
-
-    // {rdi, rsi, rdx}
-    mov(rdi, reinterpret_cast<uint64_t>(CTX));
-    mov(rsi, STATE);
-    mov(rax, Ptr.Data);
-    call(rax);
-    // RAX contains nulptr or block ptr here
-    cmp(rax, 0);
-    je(FallbackCore);
-    // rdx already contains RIP here
-    jmp(ExitCheck);
-  }
-
-  {
-    L(FallbackCore);
-    ud2();
-  }
-
-  ready();
-  // CustomDispatchGenerated = true;
-}
-
 FEXCore::CPU::CPUBackend *CreateJITCore(FEXCore::Context::Context *ctx, FEXCore::Core::InternalThreadState *Thread) {
   return new JITCore(ctx, Thread);
 }
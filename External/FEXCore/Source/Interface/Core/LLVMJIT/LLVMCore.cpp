@@ -1,4 +1,5 @@
 #include "Interface/Context/Context.h"
+#include "Interface/Core/BulkMemoryOps.h"
 #include "Interface/Core/DebugData.h"
 #include "Interface/Core/LLVMJIT/LLVMMemoryManager.h"
 #include "Interface/HLE/Syscalls.h"
@@ -44,6 +45,18 @@ static CPUIDEmu::FunctionResults CPUIDRun_Thunk(FEXCore::CPUIDEmu *Class, uint32
   return Class->RunFunction(Function);
 }
 
+static void MemCpy_Thunk(uint8_t *Dest, uint8_t const *Src, uint64_t Count, uint8_t Size, uint8_t Backward) {
+  BulkCopy(Dest, Src, Count, Size, Backward != 0);
+}
+
+static void MemSet_Thunk(uint8_t *Dest, uint64_t Value, uint64_t Count, uint8_t Size, uint8_t Backward) {
+  BulkFill(Dest, Value, Count, Size, Backward != 0);
+}
+
+static uint64_t MemCmp_Thunk(uint8_t const *Src1, uint8_t const *Src2, uint64_t Count, uint8_t Size, uint8_t Backward, uint8_t WhileEqual) {
+  return BulkCompare(Src1, Src2, Count, Size, Backward != 0, WhileEqual != 0);
+}
+
 static void SetExitState_Thunk(FEXCore::Core::InternalThreadState *Thread) {
   Thread->State.RunningEvents.ShouldStop = true;
 }
@@ -70,6 +83,9 @@ public:
 
   bool NeedsOpDispatch() override { return true; }
 
+  // The IR is only walked while emitting code
+  bool NeedsIRAfterCompile() const override { return false; }
+
 private:
   void HandleIR(FEXCore::IR::IRListView<true> const *IR, IR::NodeWrapperIterator *Node);
   llvm::Value *CreateContextGEP(uint64_t Offset, uint8_t Size);
@@ -103,6 +119,9 @@ private:
   struct LLVMCurrentState {
     llvm::Function *SyscallFunction;
     llvm::Function *CPUIDFunction;
+    llvm::Function *MemCpyFunction;
+    llvm::Function *MemSetFunction;
+    llvm::Function *MemCmpFunction;
     llvm::Function *ExitVMFunction;
     llvm::Function *ValuePrinter;
 #if defined(_M_ARM_64) && !defined(AARCH64_ON_X86)
@@ -967,6 +986,46 @@ void LLVMJITCore::CreateGlobalVariables(llvm::ExecutionEngine *Engine, llvm::Mod
     Engine->addGlobalMapping(JITCurrentState.CPUIDFunction, Ptr.Data);
   }
 
+  // Bulk memory functions
+  {
+    auto FuncType = FunctionType::get(voidTy,
+      {
+        i64, // Technically these are pointers
+        i64,
+        i64,
+        i8,
+        i8,
+      },
+      false);
+    JITCurrentState.MemCpyFunction = Function::Create(FuncType,
+      Function::ExternalLinkage,
+      "MemCpy",
+      FunctionModule);
+    Engine->addGlobalMapping(JITCurrentState.MemCpyFunction, reinterpret_cast<void*>(&MemCpy_Thunk));
+
+    JITCurrentState.MemSetFunction = Function::Create(FuncType,
+      Function::ExternalLinkage,
+      "MemSet",
+      FunctionModule);
+    Engine->addGlobalMapping(JITCurrentState.MemSetFunction, reinterpret_cast<void*>(&MemSet_Thunk));
+
+    auto CmpFuncType = FunctionType::get(i64,
+      {
+        i64, // Technically these are pointers
+        i64,
+        i64,
+        i8,
+        i8,
+        i8,
+      },
+      false);
+    JITCurrentState.MemCmpFunction = Function::Create(CmpFuncType,
+      Function::ExternalLinkage,
+      "MemCmp",
+      FunctionModule);
+    Engine->addGlobalMapping(JITCurrentState.MemCmpFunction, reinterpret_cast<void*>(&MemCmp_Thunk));
+  }
+
 #if defined(_M_ARM_64) && !defined(AARCH64_ON_X86)
   // AArch64ReadCycleCounter Function
   {
@@ -1606,6 +1665,32 @@ void LLVMJITCore::HandleIR(FEXCore::IR::IRListView<true> const *IR, IR::NodeWrap
       SetDest(*WrapperOp, Result);
     break;
     }
+    case FEXCore::IR::IROps::OP_INLINESYSCALL: {
+      auto Op = IROp->C<IR::IROp_InlineSyscall>();
+
+      // Goes through the generic handler, the number is put back in front of the arguments
+      std::vector<llvm::Value*> Args;
+      Args.emplace_back(JITState.IRBuilder->getInt64(reinterpret_cast<uint64_t>(CTX->SyscallHandler.get())));
+      Args.emplace_back(Func->args().begin());
+
+      auto LLVMArgs = JITState.IRBuilder->CreateAlloca(ArrayType::get(Type::getInt64Ty(*Con), FEXCore::HLE::SyscallArguments::MAX_ARGS));
+      for (unsigned i = 0; i < FEXCore::HLE::SyscallArguments::MAX_ARGS; ++i) {
+        if (i != 0 && Op->Header.Args[i - 1].IsInvalid()) break;
+        auto Location = JITState.IRBuilder->CreateGEP(LLVMArgs,
+            {
+              JITState.IRBuilder->getInt32(0),
+              JITState.IRBuilder->getInt32(i),
+            },
+            "Arg");
+        auto Src = i == 0 ? JITState.IRBuilder->getInt64(Op->SyscallNumber) : GetSrc(Op->Header.Args[i - 1]);
+        JITState.IRBuilder->CreateStore(Src, Location);
+      }
+      Args.emplace_back(LLVMArgs);
+
+      auto Result = JITState.IRBuilder->CreateCall(JITCurrentState.SyscallFunction, Args);
+      SetDest(*WrapperOp, Result);
+    break;
+    }
     case IR::OP_CPUID: {
       auto Op = IROp->C<IR::IROp_CPUID>();
       auto Src = GetSrc(Op->Header.Args[0]);
@@ -2004,6 +2089,13 @@ void LLVMJITCore::HandleIR(FEXCore::IR::IRListView<true> const *IR, IR::NodeWrap
     break;
     }
 
+    case IR::OP_LOADTHREADMANAGER: {
+      auto Op = IROp->C<IR::IROp_LoadThreadManager>();
+      // ThreadManagement lives past the CPUState in the same ThreadState
+      auto Value = CreateContextPtr(offsetof(FEXCore::Core::ThreadState, ThreadManager) + Op->Offset, 8);
+      SetDest(*WrapperOp, JITState.IRBuilder->CreateAlignedLoad(Value, 8));
+    break;
+    }
     case IR::OP_CYCLECOUNTER: {
 #ifdef DEBUG_CYCLES
       SetDest(*WrapperOp, JITState.IRBuilder->getInt64(0));
@@ -3844,6 +3936,9 @@ void LLVMJITCore::HandleIR(FEXCore::IR::IRListView<true> const *IR, IR::NodeWrap
     case IR::OP_LOADMEM: {
       auto Op = IROp->C<IR::IROp_LoadMem>();
       auto Src = GetSrc(Op->Header.Args[0]);
+      if (Op->Displacement) {
+        Src = JITState.IRBuilder->CreateAdd(Src, JITState.IRBuilder->getInt64(static_cast<int64_t>(Op->Displacement)));
+      }
 
       if (!ThreadState->CTX->Config.UnifiedMemory) {
         Src = JITState.IRBuilder->CreateAdd(Src, JITState.IRBuilder->getInt64(CTX->MemoryMapper.GetBaseOffset<uint64_t>(0)));
@@ -3859,6 +3954,86 @@ void LLVMJITCore::HandleIR(FEXCore::IR::IRListView<true> const *IR, IR::NodeWrap
 
       auto Dst = GetSrc(Op->Header.Args[0]);
       auto Src = GetSrc(Op->Header.Args[1]);
+      if (Op->Displacement) {
+        Dst = JITState.IRBuilder->CreateAdd(Dst, JITState.IRBuilder->getInt64(static_cast<int64_t>(Op->Displacement)));
+      }
+
+      if (!ThreadState->CTX->Config.UnifiedMemory) {
+        Dst = JITState.IRBuilder->CreateAdd(Dst, JITState.IRBuilder->getInt64(CTX->MemoryMapper.GetBaseOffset<uint64_t>(0)));
+      }
+
+      auto Type = Type::getIntNTy(*Con, Op->Size * 8);
+      Src = JITState.IRBuilder->CreateZExtOrTrunc(Src, Type);
+      Dst = JITState.IRBuilder->CreateIntToPtr(Dst, Type->getPointerTo());
+      CreateMemoryStore(Dst, Src, Op->Align);
+    break;
+    }
+    case IR::OP_MEMCPY:
+    case IR::OP_MEMSET:
+    case IR::OP_MEMCMP: {
+      // Args are laid out the same for all three, 0: Dest/Src1, 1: Src/Value/Src2, 2: Count, 3: Direction
+      uint8_t Size{};
+      switch (IROp->Op) {
+      case IR::OP_MEMCPY: Size = IROp->C<IR::IROp_MemCpy>()->Size; break;
+      case IR::OP_MEMSET: Size = IROp->C<IR::IROp_MemSet>()->Size; break;
+      default: Size = IROp->C<IR::IROp_MemCmp>()->Size; break;
+      }
+
+      auto ToHost = [&](llvm::Value *Addr) {
+        Addr = JITState.IRBuilder->CreateZExtOrTrunc(Addr, Type::getInt64Ty(*Con));
+        if (!ThreadState->CTX->Config.UnifiedMemory) {
+          Addr = JITState.IRBuilder->CreateAdd(Addr, JITState.IRBuilder->getInt64(CTX->MemoryMapper.GetBaseOffset<uint64_t>(0)));
+        }
+        return Addr;
+      };
+
+      std::vector<llvm::Value*> Args{};
+      Args.emplace_back(ToHost(GetSrc(IROp->Args[0])));
+      if (IROp->Op == IR::OP_MEMSET) {
+        Args.emplace_back(JITState.IRBuilder->CreateZExtOrTrunc(GetSrc(IROp->Args[1]), Type::getInt64Ty(*Con)));
+      }
+      else {
+        Args.emplace_back(ToHost(GetSrc(IROp->Args[1])));
+      }
+      Args.emplace_back(JITState.IRBuilder->CreateZExtOrTrunc(GetSrc(IROp->Args[2]), Type::getInt64Ty(*Con)));
+      Args.emplace_back(JITState.IRBuilder->getInt8(Size));
+      Args.emplace_back(JITState.IRBuilder->CreateZExtOrTrunc(GetSrc(IROp->Args[3]), Type::getInt8Ty(*Con)));
+
+      switch (IROp->Op) {
+      case IR::OP_MEMCPY: JITState.IRBuilder->CreateCall(JITCurrentState.MemCpyFunction, Args); break;
+      case IR::OP_MEMSET: JITState.IRBuilder->CreateCall(JITCurrentState.MemSetFunction, Args); break;
+      default: {
+        Args.emplace_back(JITState.IRBuilder->getInt8(IROp->C<IR::IROp_MemCmp>()->WhileEqual));
+        auto Result = JITState.IRBuilder->CreateCall(JITCurrentState.MemCmpFunction, Args);
+        SetDest(*WrapperOp, Result);
+      break;
+      }
+      }
+    break;
+    }
+    case IR::OP_LOADMEMINDEXED: {
+      auto Op = IROp->C<IR::IROp_LoadMemIndexed>();
+      auto Src = GetSrc(Op->Base);
+      auto Index = JITState.IRBuilder->CreateMul(GetSrc(Op->Index), JITState.IRBuilder->getInt64(Op->Scale));
+      Src = JITState.IRBuilder->CreateAdd(Src, Index);
+      Src = JITState.IRBuilder->CreateAdd(Src, JITState.IRBuilder->getInt64(static_cast<int64_t>(Op->Displacement)));
+
+      if (!ThreadState->CTX->Config.UnifiedMemory) {
+        Src = JITState.IRBuilder->CreateAdd(Src, JITState.IRBuilder->getInt64(CTX->MemoryMapper.GetBaseOffset<uint64_t>(0)));
+      }
+      Src = JITState.IRBuilder->CreateIntToPtr(Src, Type::getIntNTy(*Con, Op->Size * 8)->getPointerTo());
+      auto Result = CreateMemoryLoad(Src, Op->Align);
+      SetDest(*WrapperOp, Result);
+    break;
+    }
+    case IR::OP_STOREMEMINDEXED: {
+      auto Op = IROp->C<IR::IROp_StoreMemIndexed>();
+
+      auto Dst = GetSrc(Op->Base);
+      auto Src = GetSrc(Op->Value);
+      auto Index = JITState.IRBuilder->CreateMul(GetSrc(Op->Index), JITState.IRBuilder->getInt64(Op->Scale));
+      Dst = JITState.IRBuilder->CreateAdd(Dst, Index);
+      Dst = JITState.IRBuilder->CreateAdd(Dst, JITState.IRBuilder->getInt64(static_cast<int64_t>(Op->Displacement)));
 
       if (!ThreadState->CTX->Config.UnifiedMemory) {
         Dst = JITState.IRBuilder->CreateAdd(Dst, JITState.IRBuilder->getInt64(CTX->MemoryMapper.GetBaseOffset<uint64_t>(0)));
@@ -98,7 +98,7 @@ void OpDispatchBuilder::RETOp(OpcodeArgs) {
 
   // Store the new RIP
   _StoreContext(GPRClass, 8, offsetof(FEXCore::Core::CPUState, rip), NewRIP);
-  _ExitFunction();
+  _ExitFunction(EXIT_HINT_RETURN, 0);
   BlockSetRIP = true;
 }
 
@@ -296,7 +296,7 @@ void OpDispatchBuilder::CALLOp(OpcodeArgs) {
 
   // Store the RIP
   _StoreContext(GPRClass, 8, offsetof(FEXCore::Core::CPUState, rip), NewRIP);
-  _ExitFunction(); // If we get here then leave the function now
+  _ExitFunction(EXIT_HINT_CALL, Op->PC + Op->InstSize); // If we get here then leave the function now
 }
 
 void OpDispatchBuilder::CALLAbsoluteOp(OpcodeArgs) {
@@ -319,7 +319,7 @@ void OpDispatchBuilder::CALLAbsoluteOp(OpcodeArgs) {
 
   // Store the RIP
   _StoreContext(GPRClass, 8, offsetof(FEXCore::Core::CPUState, rip), JMPPCOffset);
-  _ExitFunction(); // If we get here then leave the function now
+  _ExitFunction(EXIT_HINT_CALL, Op->PC + Op->InstSize); // If we get here then leave the function now
 }
 
 void OpDispatchBuilder::CondJUMPOp(OpcodeArgs) {
@@ -327,153 +327,157 @@ void OpDispatchBuilder::CondJUMPOp(OpcodeArgs) {
 
   auto ZeroConst = _Constant(0);
   auto OneConst = _Constant(1);
-  IRPair<IROp_Header> SrcCond;
+  OrderedNode *SrcCond;
 
   IRPair<IROp_Constant> TakeBranch;
   IRPair<IROp_Constant> DoNotTakeBranch;
   TakeBranch = _Constant(1);
   DoNotTakeBranch = _Constant(0);
 
-  switch (Op->OP) {
-    case 0x70:
-    case 0x80: { // JO - Jump if OF == 1
-      auto Flag = GetRFLAG(FEXCore::X86State::RFLAG_OF_LOC);
-      SrcCond = _Select(FEXCore::IR::COND_NEQ,
-          Flag, ZeroConst, TakeBranch, DoNotTakeBranch);
-    break;
-    }
-    case 0x71:
-    case 0x81: { // JNO - Jump if OF == 0
-      auto Flag = GetRFLAG(FEXCore::X86State::RFLAG_OF_LOC);
-      SrcCond = _Select(FEXCore::IR::COND_EQ,
-          Flag, ZeroConst, TakeBranch, DoNotTakeBranch);
-    break;
-    }
-    case 0x72:
-    case 0x82: { // JC - Jump if CF == 1
-      auto Flag = GetRFLAG(FEXCore::X86State::RFLAG_CF_LOC);
-      SrcCond = _Select(FEXCore::IR::COND_NEQ,
-          Flag, ZeroConst, TakeBranch, DoNotTakeBranch);
-    break;
-    }
-    case 0x73:
-    case 0x83: { // JNC - Jump if CF == 0
-      auto Flag = GetRFLAG(FEXCore::X86State::RFLAG_CF_LOC);
-      SrcCond = _Select(FEXCore::IR::COND_EQ,
-          Flag, ZeroConst, TakeBranch, DoNotTakeBranch);
-    break;
-    }
-    case 0x74:
-    case 0x84: { // JE - Jump if ZF == 1
-      auto Flag = GetRFLAG(FEXCore::X86State::RFLAG_ZF_LOC);
-      SrcCond = _Select(FEXCore::IR::COND_NEQ,
-          Flag, ZeroConst, TakeBranch, DoNotTakeBranch);
-    break;
-    }
-    case 0x75:
-    case 0x85: { // JNE - Jump if ZF == 0
-      auto Flag = GetRFLAG(FEXCore::X86State::RFLAG_ZF_LOC);
-      SrcCond = _Select(FEXCore::IR::COND_EQ,
-          Flag, ZeroConst, TakeBranch, DoNotTakeBranch);
-    break;
-    }
-    case 0x76:
-    case 0x86: { // JNA - Jump if CF == 1 || ZC == 1
-      auto Flag1 = GetRFLAG(FEXCore::X86State::RFLAG_ZF_LOC);
-      auto Flag2 = GetRFLAG(FEXCore::X86State::RFLAG_CF_LOC);
-      auto Check = _Or(Flag1, Flag2);
-      SrcCond = _Select(FEXCore::IR::COND_EQ,
-          Check, OneConst, TakeBranch, DoNotTakeBranch);
-    break;
-    }
-    case 0x77:
-    case 0x87: { // JA - Jump if CF == 0 && ZF == 0
-      auto Flag1 = GetRFLAG(FEXCore::X86State::RFLAG_ZF_LOC);
-      auto Flag2 = GetRFLAG(FEXCore::X86State::RFLAG_CF_LOC);
-      auto Check = _Or(Flag1, _Lshl(Flag2, _Constant(1)));
-      SrcCond = _Select(FEXCore::IR::COND_EQ,
-          Check, ZeroConst, TakeBranch, DoNotTakeBranch);
-    break;
-    }
-    case 0x78:
-    case 0x88: { // JS - Jump if SF == 1
-      auto Flag = GetRFLAG(FEXCore::X86State::RFLAG_SF_LOC);
-      SrcCond = _Select(FEXCore::IR::COND_NEQ,
-          Flag, ZeroConst, TakeBranch, DoNotTakeBranch);
-    break;
-    }
-    case 0x79:
-    case 0x89: { // JNS - Jump if SF == 0
-      auto Flag = GetRFLAG(FEXCore::X86State::RFLAG_SF_LOC);
-      SrcCond = _Select(FEXCore::IR::COND_EQ,
-          Flag, ZeroConst, TakeBranch, DoNotTakeBranch);
-    break;
-    }
-    case 0x7A:
-    case 0x8A: { // JP - Jump if PF == 1
-      auto Flag = GetRFLAG(FEXCore::X86State::RFLAG_PF_LOC);
-      SrcCond = _Select(FEXCore::IR::COND_NEQ,
-          Flag, ZeroConst, TakeBranch, DoNotTakeBranch);
-    break;
-    }
-    case 0x7B:
-    case 0x8B: { // JNP - Jump if PF == 0
-      auto Flag = GetRFLAG(FEXCore::X86State::RFLAG_PF_LOC);
-      SrcCond = _Select(FEXCore::IR::COND_EQ,
-          Flag, ZeroConst, TakeBranch, DoNotTakeBranch);
-    break;
-    }
-    case 0x7C: // SF <> OF
-    case 0x8C: {
-      auto Flag1 = GetRFLAG(FEXCore::X86State::RFLAG_SF_LOC);
-      auto Flag2 = GetRFLAG(FEXCore::X86State::RFLAG_OF_LOC);
-      SrcCond = _Select(FEXCore::IR::COND_NEQ,
-          Flag1, Flag2, TakeBranch, DoNotTakeBranch);
-    break;
-    }
-    case 0x7D: // SF = OF
-    case 0x8D: {
-      auto Flag1 = GetRFLAG(FEXCore::X86State::RFLAG_SF_LOC);
-      auto Flag2 = GetRFLAG(FEXCore::X86State::RFLAG_OF_LOC);
-      SrcCond = _Select(FEXCore::IR::COND_EQ,
-          Flag1, Flag2, TakeBranch, DoNotTakeBranch);
-    break;
-    }
-    case 0x7E: // ZF = 1 || SF <> OF
-    case 0x8E: {
-      auto Flag1 = GetRFLAG(FEXCore::X86State::RFLAG_ZF_LOC);
-      auto Flag2 = GetRFLAG(FEXCore::X86State::RFLAG_SF_LOC);
-      auto Flag3 = GetRFLAG(FEXCore::X86State::RFLAG_OF_LOC);
-
-      auto Select1 = _Select(FEXCore::IR::COND_EQ,
-          Flag1, OneConst, OneConst, ZeroConst);
-
-      auto Select2 = _Select(FEXCore::IR::COND_NEQ,
-          Flag2, Flag3, OneConst, ZeroConst);
-
-      auto Check = _Or(Select1, Select2);
-      SrcCond = _Select(FEXCore::IR::COND_EQ,
-          Check, OneConst, TakeBranch, DoNotTakeBranch);
-    break;
-    }
-    case 0x7F: // ZF = 0 && SF = OF
-    case 0x8F: {
-      auto Flag1 = GetRFLAG(FEXCore::X86State::RFLAG_ZF_LOC);
-      auto Flag2 = GetRFLAG(FEXCore::X86State::RFLAG_SF_LOC);
-      auto Flag3 = GetRFLAG(FEXCore::X86State::RFLAG_OF_LOC);
-
-      auto Select1 = _Select(FEXCore::IR::COND_EQ,
-          Flag1, ZeroConst, OneConst, ZeroConst);
-
-      auto Select2 = _Select(FEXCore::IR::COND_EQ,
-          Flag2, Flag3, OneConst, ZeroConst);
-
-      auto Check = _And(Select1, Select2);
-      SrcCond = _Select(FEXCore::IR::COND_EQ,
-          Check, OneConst, TakeBranch, DoNotTakeBranch);
-    break;
+  // Branches straight on the operands of a cmp or test when the flags haven't been stored yet
+  SrcCond = SelectDeferredCC(Op->OP & 0xF, TakeBranch, DoNotTakeBranch);
+  if (!SrcCond) {
+    switch (Op->OP) {
+      case 0x70:
+      case 0x80: { // JO - Jump if OF == 1
+        auto Flag = GetRFLAG(FEXCore::X86State::RFLAG_OF_LOC);
+        SrcCond = _Select(FEXCore::IR::COND_NEQ,
+            Flag, ZeroConst, TakeBranch, DoNotTakeBranch);
+      break;
+      }
+      case 0x71:
+      case 0x81: { // JNO - Jump if OF == 0
+        auto Flag = GetRFLAG(FEXCore::X86State::RFLAG_OF_LOC);
+        SrcCond = _Select(FEXCore::IR::COND_EQ,
+            Flag, ZeroConst, TakeBranch, DoNotTakeBranch);
+      break;
+      }
+      case 0x72:
+      case 0x82: { // JC - Jump if CF == 1
+        auto Flag = GetRFLAG(FEXCore::X86State::RFLAG_CF_LOC);
+        SrcCond = _Select(FEXCore::IR::COND_NEQ,
+            Flag, ZeroConst, TakeBranch, DoNotTakeBranch);
+      break;
+      }
+      case 0x73:
+      case 0x83: { // JNC - Jump if CF == 0
+        auto Flag = GetRFLAG(FEXCore::X86State::RFLAG_CF_LOC);
+        SrcCond = _Select(FEXCore::IR::COND_EQ,
+            Flag, ZeroConst, TakeBranch, DoNotTakeBranch);
+      break;
+      }
+      case 0x74:
+      case 0x84: { // JE - Jump if ZF == 1
+        auto Flag = GetRFLAG(FEXCore::X86State::RFLAG_ZF_LOC);
+        SrcCond = _Select(FEXCore::IR::COND_NEQ,
+            Flag, ZeroConst, TakeBranch, DoNotTakeBranch);
+      break;
+      }
+      case 0x75:
+      case 0x85: { // JNE - Jump if ZF == 0
+        auto Flag = GetRFLAG(FEXCore::X86State::RFLAG_ZF_LOC);
+        SrcCond = _Select(FEXCore::IR::COND_EQ,
+            Flag, ZeroConst, TakeBranch, DoNotTakeBranch);
+      break;
+      }
+      case 0x76:
+      case 0x86: { // JNA - Jump if CF == 1 || ZC == 1
+        auto Flag1 = GetRFLAG(FEXCore::X86State::RFLAG_ZF_LOC);
+        auto Flag2 = GetRFLAG(FEXCore::X86State::RFLAG_CF_LOC);
+        auto Check = _Or(Flag1, Flag2);
+        SrcCond = _Select(FEXCore::IR::COND_EQ,
+            Check, OneConst, TakeBranch, DoNotTakeBranch);
+      break;
+      }
+      case 0x77:
+      case 0x87: { // JA - Jump if CF == 0 && ZF == 0
+        auto Flag1 = GetRFLAG(FEXCore::X86State::RFLAG_ZF_LOC);
+        auto Flag2 = GetRFLAG(FEXCore::X86State::RFLAG_CF_LOC);
+        auto Check = _Or(Flag1, _Lshl(Flag2, _Constant(1)));
+        SrcCond = _Select(FEXCore::IR::COND_EQ,
+            Check, ZeroConst, TakeBranch, DoNotTakeBranch);
+      break;
+      }
+      case 0x78:
+      case 0x88: { // JS - Jump if SF == 1
+        auto Flag = GetRFLAG(FEXCore::X86State::RFLAG_SF_LOC);
+        SrcCond = _Select(FEXCore::IR::COND_NEQ,
+            Flag, ZeroConst, TakeBranch, DoNotTakeBranch);
+      break;
+      }
+      case 0x79:
+      case 0x89: { // JNS - Jump if SF == 0
+        auto Flag = GetRFLAG(FEXCore::X86State::RFLAG_SF_LOC);
+        SrcCond = _Select(FEXCore::IR::COND_EQ,
+            Flag, ZeroConst, TakeBranch, DoNotTakeBranch);
+      break;
+      }
+      case 0x7A:
+      case 0x8A: { // JP - Jump if PF == 1
+        auto Flag = GetRFLAG(FEXCore::X86State::RFLAG_PF_LOC);
+        SrcCond = _Select(FEXCore::IR::COND_NEQ,
+            Flag, ZeroConst, TakeBranch, DoNotTakeBranch);
+      break;
+      }
+      case 0x7B:
+      case 0x8B: { // JNP - Jump if PF == 0
+        auto Flag = GetRFLAG(FEXCore::X86State::RFLAG_PF_LOC);
+        SrcCond = _Select(FEXCore::IR::COND_EQ,
+            Flag, ZeroConst, TakeBranch, DoNotTakeBranch);
+      break;
+      }
+      case 0x7C: // SF <> OF
+      case 0x8C: {
+        auto Flag1 = GetRFLAG(FEXCore::X86State::RFLAG_SF_LOC);
+        auto Flag2 = GetRFLAG(FEXCore::X86State::RFLAG_OF_LOC);
+        SrcCond = _Select(FEXCore::IR::COND_NEQ,
+            Flag1, Flag2, TakeBranch, DoNotTakeBranch);
+      break;
+      }
+      case 0x7D: // SF = OF
+      case 0x8D: {
+        auto Flag1 = GetRFLAG(FEXCore::X86State::RFLAG_SF_LOC);
+        auto Flag2 = GetRFLAG(FEXCore::X86State::RFLAG_OF_LOC);
+        SrcCond = _Select(FEXCore::IR::COND_EQ,
+            Flag1, Flag2, TakeBranch, DoNotTakeBranch);
+      break;
+      }
+      case 0x7E: // ZF = 1 || SF <> OF
+      case 0x8E: {
+        auto Flag1 = GetRFLAG(FEXCore::X86State::RFLAG_ZF_LOC);
+        auto Flag2 = GetRFLAG(FEXCore::X86State::RFLAG_SF_LOC);
+        auto Flag3 = GetRFLAG(FEXCore::X86State::RFLAG_OF_LOC);
+
+        auto Select1 = _Select(FEXCore::IR::COND_EQ,
+            Flag1, OneConst, OneConst, ZeroConst);
+
+        auto Select2 = _Select(FEXCore::IR::COND_NEQ,
+            Flag2, Flag3, OneConst, ZeroConst);
+
+        auto Check = _Or(Select1, Select2);
+        SrcCond = _Select(FEXCore::IR::COND_EQ,
+            Check, OneConst, TakeBranch, DoNotTakeBranch);
+      break;
+      }
+      case 0x7F: // ZF = 0 && SF = OF
+      case 0x8F: {
+        auto Flag1 = GetRFLAG(FEXCore::X86State::RFLAG_ZF_LOC);
+        auto Flag2 = GetRFLAG(FEXCore::X86State::RFLAG_SF_LOC);
+        auto Flag3 = GetRFLAG(FEXCore::X86State::RFLAG_OF_LOC);
+
+        auto Select1 = _Select(FEXCore::IR::COND_EQ,
+            Flag1, ZeroConst, OneConst, ZeroConst);
+
+        auto Select2 = _Select(FEXCore::IR::COND_EQ,
+            Flag2, Flag3, OneConst, ZeroConst);
+
+        auto Check = _And(Select1, Select2);
+        SrcCond = _Select(FEXCore::IR::COND_EQ,
+            Check, OneConst, TakeBranch, DoNotTakeBranch);
+      break;
+      }
+      default: LogMan::Msg::A("Unknown Jmp Op: 0x%x\n", Op->OP); return;
     }
-    default: LogMan::Msg::A("Unknown Jmp Op: 0x%x\n", Op->OP); return;
   }
 
   LogMan::Throw::A(Op->Src[0].TypeNone.Type == FEXCore::X86Tables::DecodedOperand::TYPE_LITERAL, "Src1 needs to be literal here");
@@ -730,6 +734,11 @@ void OpDispatchBuilder::SETccOp(OpcodeArgs) {
   auto ZeroConst = _Constant(0);
   auto OneConst = _Constant(1);
 
+  if (auto Cond = SelectDeferredCC(Op->OP & 0xF, OneConst, ZeroConst)) {
+    StoreResult(GPRClass, Op, Cond, -1);
+    return;
+  }
+
   switch (Op->OP) {
   case 0x90:
     FLAGMask = 1 << FEXCore::X86State::RFLAG_OF_LOC;
@@ -1102,6 +1111,11 @@ void OpDispatchBuilder::CMOVOp(OpcodeArgs) {
   OrderedNode *Src = LoadSource(GPRClass, Op, Op->Src[0], Op->Flags, -1);
   OrderedNode *Dest = LoadSource(GPRClass, Op, Op->Dest, Op->Flags, -1);
 
+  if (auto Cond = SelectDeferredCC(Op->OP & 0xF, Src, Dest)) {
+    StoreResult(GPRClass, Op, Cond, -1);
+    return;
+  }
+
   switch (Op->OP) {
   case 0x40:
     FLAGMask = 1 << FEXCore::X86State::RFLAG_OF_LOC;
@@ -2133,67 +2147,22 @@ void OpDispatchBuilder::STOSOp(OpcodeArgs) {
 
   }
   else {
-    // Create all our blocks
-    auto LoopHead = CreateNewCodeBlock();
-    auto LoopTail = CreateNewCodeBlock();
-    auto LoopEnd = CreateNewCodeBlock();
-
-    // At the time this was written, our RA can't handle accessing nodes across blocks.
-    // So we need to re-load and re-calculate essential values each iteration of the loop.
-
-    // First thing we need to do is finish this block and jump to the start of the loop.
-    _Jump(LoopHead);
-
-      SetCurrentCodeBlock(LoopHead);
-      {
-        OrderedNode *Counter = _LoadContext(8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RCX]), GPRClass);
-        auto ZeroConst = _Constant(0);
-
-        // Can we end the block?
-        auto CanLeaveCond = _Select(FEXCore::IR::COND_EQ,
-            Counter, ZeroConst,
-            _Constant(1), ZeroConst);
-
-        _CondJump(CanLeaveCond, LoopEnd, LoopTail);
-      }
-
-      SetCurrentCodeBlock(LoopTail);
-      {
-        OrderedNode *Src = LoadSource(GPRClass, Op, Op->Src[0], Op->Flags, -1);
-        OrderedNode *Dest = _LoadContext(8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RDI]), GPRClass);
-
-        // Store to memory where RDI points
-        _StoreMem(GPRClass, Size, Dest, Src, Size);
-
-        OrderedNode *TailCounter = _LoadContext(8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RCX]), GPRClass);
-        OrderedNode *TailDest = _LoadContext(8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RDI]), GPRClass);
-
-        // Decrement counter
-        TailCounter = _Sub(TailCounter, _Constant(1));
-
-        // Store the counter so we don't have to deal with PHI here
-        _StoreContext(GPRClass, 8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RCX]), TailCounter);
-
-        auto SizeConst = _Constant(Size);
-        auto NegSizeConst = _Constant(-Size);
-
-        // Calculate direction.
-        auto DF = GetRFLAG(FEXCore::X86State::RFLAG_DF_LOC);
-        auto PtrDir = _Select(FEXCore::IR::COND_EQ,
-            DF,  _Constant(0),
-            SizeConst, NegSizeConst);
-
-        // Offset the pointer
-        TailDest = _Add(TailDest, PtrDir);
-        _StoreContext(GPRClass, 8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RDI]), TailDest);
+    // The backend does the whole fill, honouring the direction flag
+    OrderedNode *Src = LoadSource(GPRClass, Op, Op->Src[0], Op->Flags, -1);
+    OrderedNode *Dest = _LoadContext(8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RDI]), GPRClass);
+    OrderedNode *Counter = _LoadContext(8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RCX]), GPRClass);
 
-        // Jump back to the start, we have more work to do
-        _Jump(LoopHead);
-      }
+    auto DF = GetRFLAG(FEXCore::X86State::RFLAG_DF_LOC);
+    _MemSet(Dest, Src, Counter, DF, Size);
 
-    // Make sure to start a new block after ending this one
+    auto PtrDir = _Select(FEXCore::IR::COND_EQ,
+        DF,  _Constant(0),
+        _Constant(Size), _Constant(-Size));
 
-    SetCurrentCodeBlock(LoopEnd);
+    // RDI ends up past the last element and RCX is always exhausted
+    Dest = _Add(Dest, _Mul(Counter, PtrDir));
+    _StoreContext(GPRClass, 8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RDI]), Dest);
+    _StoreContext(GPRClass, 8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RCX]), _Constant(0));
   }
 }
 
@@ -2203,72 +2172,22 @@ void OpDispatchBuilder::MOVSOp(OpcodeArgs) {
   if (Op->Flags & FEXCore::X86Tables::DecodeFlags::FLAG_REP_PREFIX) {
     auto Size = GetSrcSize(Op);
 
-    // Create all our blocks
-    auto LoopHead = CreateNewCodeBlock();
-    auto LoopTail = CreateNewCodeBlock();
-    auto LoopEnd = CreateNewCodeBlock();
-
-    // At the time this was written, our RA can't handle accessing nodes across blocks.
-    // So we need to re-load and re-calculate essential values each iteration of the loop.
-
-    // First thing we need to do is finish this block and jump to the start of the loop.
-    _Jump(LoopHead);
-
-      SetCurrentCodeBlock(LoopHead);
-      {
-        OrderedNode *Counter = _LoadContext(8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RCX]), GPRClass);
-        auto ZeroConst = _Constant(0);
-
-        // Can we end the block?
-        auto CanLeaveCond = _Select(FEXCore::IR::COND_EQ,
-            Counter, ZeroConst,
-            _Constant(1), ZeroConst);
-
-        _CondJump(CanLeaveCond, LoopEnd, LoopTail);
-      }
-
-      SetCurrentCodeBlock(LoopTail);
-      {
-        OrderedNode *Src = _LoadContext(8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RSI]), GPRClass);
-        OrderedNode *Dest = _LoadContext(8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RDI]), GPRClass);
-
-        Src = _LoadMem(GPRClass, Size, Src, Size);
-
-        // Store to memory where RDI points
-        _StoreMem(GPRClass, Size, Dest, Src, Size);
-
-        OrderedNode *TailCounter = _LoadContext(8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RCX]), GPRClass);
-
-        // Decrement counter
-        TailCounter = _Sub(TailCounter, _Constant(1));
-
-        // Store the counter so we don't have to deal with PHI here
-        _StoreContext(GPRClass, 8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RCX]), TailCounter);
-
-        auto SizeConst = _Constant(Size);
-        auto NegSizeConst = _Constant(-Size);
-
-        // Calculate direction.
-        auto DF = GetRFLAG(FEXCore::X86State::RFLAG_DF_LOC);
-        auto PtrDir = _Select(FEXCore::IR::COND_EQ,
-            DF,  _Constant(0),
-            SizeConst, NegSizeConst);
+    // The backend does the whole copy, honouring the direction flag and x86's element by element overlap behaviour
+    OrderedNode *Src = _LoadContext(8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RSI]), GPRClass);
+    OrderedNode *Dest = _LoadContext(8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RDI]), GPRClass);
+    OrderedNode *Counter = _LoadContext(8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RCX]), GPRClass);
 
-        // Offset the pointer
-        OrderedNode *TailSrc = _LoadContext(8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RSI]), GPRClass);
-        OrderedNode *TailDest = _LoadContext(8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RDI]), GPRClass);
-        TailSrc = _Add(TailSrc, PtrDir);
-        TailDest = _Add(TailDest, PtrDir);
-        _StoreContext(GPRClass, 8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RSI]), TailSrc);
-        _StoreContext(GPRClass, 8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RDI]), TailDest);
-
-        // Jump back to the start, we have more work to do
-        _Jump(LoopHead);
-      }
+    auto DF = GetRFLAG(FEXCore::X86State::RFLAG_DF_LOC);
+    _MemCpy(Dest, Src, Counter, DF, Size);
 
-    // Make sure to start a new block after ending this one
+    auto PtrDir = _Select(FEXCore::IR::COND_EQ,
+        DF,  _Constant(0),
+        _Constant(Size), _Constant(-Size));
 
-    SetCurrentCodeBlock(LoopEnd);
+    auto Offset = _Mul(Counter, PtrDir);
+    _StoreContext(GPRClass, 8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RSI]), _Add(Src, Offset));
+    _StoreContext(GPRClass, 8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RDI]), _Add(Dest, Offset));
+    _StoreContext(GPRClass, 8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RCX]), _Constant(0));
   }
   else {
     auto Size = GetSrcSize(Op);
@@ -2309,8 +2228,9 @@ void OpDispatchBuilder::CMPSOp(OpcodeArgs) {
     OrderedNode *Dest_RDI = _LoadContext(8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RDI]), GPRClass);
     OrderedNode *Dest_RSI = _LoadContext(8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RSI]), GPRClass);
 
-    auto Src1 = _LoadMem(GPRClass, Size, Dest_RDI, Size);
-    auto Src2 = _LoadMem(GPRClass, Size, Dest_RSI, Size);
+    // Flags are from [RSI] - [RDI]
+    auto Src1 = _LoadMem(GPRClass, Size, Dest_RSI, Size);
+    auto Src2 = _LoadMem(GPRClass, Size, Dest_RDI, Size);
 
     auto ALUOp = _Sub(Src1, Src2);
     GenerateFlags_SUB(Op, _Bfe(Size * 8, 0, ALUOp), _Bfe(Size * 8, 0, Src1), _Bfe(Size * 8, 0, Src2));
@@ -2331,80 +2251,48 @@ void OpDispatchBuilder::CMPSOp(OpcodeArgs) {
   else {
     bool REPE = Op->Flags & FEXCore::X86Tables::DecodeFlags::FLAG_REP_PREFIX;
 
-    auto JumpStart = _Jump();
-    // Make sure to start a new block after ending this one
-      auto LoopStart = CreateNewCodeBlock();
-      SetJumpTarget(JumpStart, LoopStart);
-      SetCurrentCodeBlock(LoopStart);
-
-      OrderedNode *Counter = _LoadContext(8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RCX]), GPRClass);
-
-      // Can we end the block?
-      OrderedNode *CanLeaveCond = _Select(FEXCore::IR::COND_EQ,
-        Counter, _Constant(0),
-        _Constant(1), _Constant(0));
-
-      auto CondJump = _CondJump(CanLeaveCond);
-      IRPair<IROp_CondJump> InternalCondJump;
-
-      auto LoopTail = CreateNewCodeBlock();
-      SetFalseJumpTarget(CondJump, LoopTail);
-      SetCurrentCodeBlock(LoopTail);
-
-      // Working loop
-      {
-        OrderedNode *Dest_RDI = _LoadContext(8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RDI]), GPRClass);
-        OrderedNode *Dest_RSI = _LoadContext(8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RSI]), GPRClass);
+    auto CompareBlock = CreateNewCodeBlock();
+    auto LoopEnd = CreateNewCodeBlock();
 
-        auto Src1 = _LoadMem(GPRClass, Size, Dest_RDI, Size);
-        auto Src2 = _LoadMem(GPRClass, Size, Dest_RSI, Size);
+    // RCX == 0 leaves the flags and pointers alone
+    OrderedNode *Counter = _LoadContext(8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RCX]), GPRClass);
+    OrderedNode *CanLeaveCond = _Select(FEXCore::IR::COND_EQ,
+      Counter, _Constant(0),
+      _Constant(1), _Constant(0));
+    _CondJump(CanLeaveCond, LoopEnd, CompareBlock);
 
-        auto ALUOp = _Sub(Src1, Src2);
-        GenerateFlags_SUB(Op, _Bfe(Size * 8, 0, ALUOp), _Bfe(Size * 8, 0, Src1), _Bfe(Size * 8, 0, Src2));
+    SetCurrentCodeBlock(CompareBlock);
+    {
+      OrderedNode *Dest_RDI = _LoadContext(8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RDI]), GPRClass);
+      OrderedNode *Dest_RSI = _LoadContext(8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RSI]), GPRClass);
+      OrderedNode *TailCounter = _LoadContext(8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RCX]), GPRClass);
 
-        OrderedNode *TailCounter = _LoadContext(8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RCX]), GPRClass);
+      auto DF = GetRFLAG(FEXCore::X86State::RFLAG_DF_LOC);
 
-        // Decrement counter
-        TailCounter = _Sub(TailCounter, _Constant(1));
+      // Number of elements compared, including the one that ended the repeat
+      OrderedNode *Compared = _MemCmp(Dest_RDI, Dest_RSI, TailCounter, DF, Size, REPE);
 
-        // Store the counter so we don't have to deal with PHI here
-        _StoreContext(GPRClass, 8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RCX]), TailCounter);
+      auto PtrDir = _Select(FEXCore::IR::COND_EQ,
+          DF, _Constant(0),
+          _Constant(Size), _Constant(-Size));
 
-        auto DF = GetRFLAG(FEXCore::X86State::RFLAG_DF_LOC);
-        auto PtrDir = _Select(FEXCore::IR::COND_EQ,
-            DF, _Constant(0),
-            _Constant(Size), _Constant(-Size));
-
-        // Offset the pointer
-        Dest_RDI = _Add(Dest_RDI, PtrDir);
-        _StoreContext(GPRClass, 8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RDI]), Dest_RDI);
+      auto Offset = _Mul(Compared, PtrDir);
+      Dest_RDI = _Add(Dest_RDI, Offset);
+      Dest_RSI = _Add(Dest_RSI, Offset);
+      _StoreContext(GPRClass, 8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RDI]), Dest_RDI);
+      _StoreContext(GPRClass, 8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RSI]), Dest_RSI);
+      _StoreContext(GPRClass, 8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RCX]), _Sub(TailCounter, Compared));
 
-        // Offset second pointer
-        Dest_RSI = _Add(Dest_RSI, PtrDir);
-        _StoreContext(GPRClass, 8, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RSI]), Dest_RSI);
-
-        OrderedNode *ZF = GetRFLAG(FEXCore::X86State::RFLAG_ZF_LOC);
-        InternalCondJump = _CondJump(ZF);
+      // The flags come from [RSI] - [RDI] of the last compared element
+      auto Src1 = _LoadMem(GPRClass, Size, _Sub(Dest_RSI, PtrDir), Size);
+      auto Src2 = _LoadMem(GPRClass, Size, _Sub(Dest_RDI, PtrDir), Size);
 
-        if (REPE) {
-          // Jump back to the start if we have more work to do
-          SetTrueJumpTarget(InternalCondJump, LoopStart);
-        }
-        else {
-          // Jump back to the start if we have more work to do
-          SetFalseJumpTarget(InternalCondJump, LoopStart);
-        }
-      }
+      auto ALUOp = _Sub(Src1, Src2);
+      GenerateFlags_SUB(Op, _Bfe(Size * 8, 0, ALUOp), _Bfe(Size * 8, 0, Src1), _Bfe(Size * 8, 0, Src2));
 
-    // Make sure to start a new block after ending this one
-    auto LoopEnd = CreateNewCodeBlock();
-    SetTrueJumpTarget(CondJump, LoopEnd);
-    if (REPE) {
-      SetFalseJumpTarget(InternalCondJump, LoopEnd);
-    }
-    else {
-      SetTrueJumpTarget(InternalCondJump, LoopEnd);
+      _Jump(LoopEnd);
     }
+
     SetCurrentCodeBlock(LoopEnd);
   }
 }
@@ -3336,6 +3224,8 @@ OpDispatchBuilder::IRPair<IROp_CodeBlock> OpDispatchBuilder::CreateNewCodeBlock(
 }
 
 void OpDispatchBuilder::SetCurrentCodeBlock(OrderedNode *Node) {
+  // Deferred flag operands might not be available in the new block
+  StoreDeferredFlags();
   CurrentCodeBlock = Node;
   LogMan::Throw::A(Node->Op(Data.Begin())->Op == OP_CODEBLOCK, "Node wasn't codeblock. It was '%s'", std::string(IR::GetName(Node->Op(Data.Begin())->Op)).c_str());
   SetWriteCursor(Node->Op(Data.Begin())->CW<IROp_CodeBlock>()->Begin.GetNode(ListData.Begin()));
@@ -3378,6 +3268,8 @@ void OpDispatchBuilder::Finalize() {
   FEXCore::IR::IROp_Header *IROp = RealNode->Op(Data.Begin());
   LogMan::Throw::A(IROp->Op == OP_IRHEADER, "First op in function must be our header");
 
+  StoreDeferredFlags();
+
   // Let's walk the jump blocks and see if we have handled every block target
   for (auto &Handler : JumpTargets) {
     if (Handler.second.HaveEmitted) continue;
@@ -3675,19 +3567,191 @@ void OpDispatchBuilder::ResetWorkingList() {
   DecodeFailure = false;
   ShouldDump = false;
   CurrentCodeBlock = nullptr;
+  DeferredFlags = {};
 }
 
 template<unsigned BitOffset>
 void OpDispatchBuilder::SetRFLAG(OrderedNode *Value) {
+  // Deferred flags this doesn't overwrite still need to end up in the context
+  StoreDeferredFlags();
   _StoreFlag(Value, BitOffset);
 }
 void OpDispatchBuilder::SetRFLAG(OrderedNode *Value, unsigned BitOffset) {
+  StoreDeferredFlags();
   _StoreFlag(Value, BitOffset);
 }
 
 OrderedNode *OpDispatchBuilder::GetRFLAG(unsigned BitOffset) {
+  if (DeferredFlags.Type != DEFERRED_NONE) {
+    if (auto Flag = CalculateDeferredFlag(BitOffset)) {
+      return Flag;
+    }
+  }
   return _LoadFlag(BitOffset);
 }
+
+void OpDispatchBuilder::DeferFlags(DeferredFlagsType Type, FEXCore::X86Tables::DecodedOp Op, OrderedNode *Res, OrderedNode *Src1, OrderedNode *Src2) {
+  // Flags from an earlier op are stored where that op would have stored them
+  // They are all overwritten here, so dead flag elimination removes them unless something read them in between
+  StoreDeferredFlags();
+
+  DeferredFlags = DeferredFlagState {
+    Type,
+    GetSrcSize(Op),
+    Res,
+    Src1,
+    Src2,
+    GetWriteCursor(),
+  };
+
+  if (!LazyFlags) {
+    StoreDeferredFlags();
+  }
+}
+
+OrderedNode *OpDispatchBuilder::CalculateDeferredFlag(unsigned BitOffset) {
+  auto const &Flags = DeferredFlags;
+  uint8_t Size = Flags.SrcSize * 8;
+
+  switch (BitOffset) {
+    case FEXCore::X86State::RFLAG_AF_LOC: {
+      if (Flags.Type == DEFERRED_LOGICAL) {
+        // Undefined
+        // Set to zero anyway
+        return _Constant(0);
+      }
+      OrderedNode *AFRes = _Xor(_Xor(Flags.Src1, Flags.Src2), Flags.Res);
+      return _Bfe(1, 4, AFRes);
+    }
+    case FEXCore::X86State::RFLAG_SF_LOC: {
+      auto SignBitConst = _Constant(Size - 1);
+      return _Lshr(Flags.Res, SignBitConst);
+    }
+    case FEXCore::X86State::RFLAG_PF_LOC: {
+      auto EightBitMask = _Constant(0xFF);
+      auto PopCountOp = _Popcount(_And(Flags.Res, EightBitMask));
+      return _Xor(PopCountOp, _Constant(1));
+    }
+    case FEXCore::X86State::RFLAG_ZF_LOC: {
+      OrderedNode *Res = Flags.Res;
+      if (Flags.Type == DEFERRED_SUB) {
+        Res = _Bfe(Size, 0, Res);
+      }
+      return _Select(FEXCore::IR::COND_EQ,
+          Res, _Constant(0), _Constant(1), _Constant(0));
+    }
+    case FEXCore::X86State::RFLAG_CF_LOC: {
+      switch (Flags.Type) {
+        case DEFERRED_ADD: {
+          auto Dst8 = _Bfe(Size, 0, Flags.Res);
+          auto Src8 = _Bfe(Size, 0, Flags.Src2);
+          return _Select(FEXCore::IR::COND_ULT, Dst8, Src8, _Constant(1), _Constant(0));
+        }
+        case DEFERRED_SUB:
+          return _Select(FEXCore::IR::COND_ULT,
+              Flags.Src1, Flags.Src2, _Constant(1), _Constant(0));
+        default:
+          return _Constant(0);
+      }
+    }
+    case FEXCore::X86State::RFLAG_OF_LOC: {
+      switch (Flags.Type) {
+        case DEFERRED_ADD: {
+          auto NegOne = _Constant(~0ULL);
+          auto XorOp1 = _Xor(_Xor(Flags.Src1, Flags.Src2), NegOne);
+          auto XorOp2 = _Xor(Flags.Res, Flags.Src1);
+          return _Bfe(1, Size - 1, _And(XorOp1, XorOp2));
+        }
+        case DEFERRED_SUB: {
+          auto XorOp1 = _Xor(Flags.Src1, Flags.Src2);
+          auto XorOp2 = _Xor(Flags.Res, Flags.Src1);
+          return _Bfe(1, Size - 1, _And(XorOp1, XorOp2));
+        }
+        default:
+          return _Constant(0);
+      }
+    }
+    default:
+      // Not one the ALU ops set
+      return nullptr;
+  }
+}
+
+void OpDispatchBuilder::StoreDeferredFlags() {
+  if (DeferredFlags.Type == DEFERRED_NONE) {
+    return;
+  }
+
+  auto OriginalWriteCursor = GetWriteCursor();
+  bool AtStorePoint = OriginalWriteCursor == DeferredFlags.StorePoint;
+  SetWriteCursor(DeferredFlags.StorePoint);
+
+  constexpr std::array<unsigned, 6> ArithmeticFlags = {
+    FEXCore::X86State::RFLAG_AF_LOC,
+    FEXCore::X86State::RFLAG_SF_LOC,
+    FEXCore::X86State::RFLAG_PF_LOC,
+    FEXCore::X86State::RFLAG_ZF_LOC,
+    FEXCore::X86State::RFLAG_CF_LOC,
+    FEXCore::X86State::RFLAG_OF_LOC,
+  };
+  for (auto Flag : ArithmeticFlags) {
+    _StoreFlag(CalculateDeferredFlag(Flag), Flag);
+  }
+
+  // Anything emitted after the store point since then has to stay after the stores
+  if (!AtStorePoint) {
+    SetWriteCursor(OriginalWriteCursor);
+  }
+  DeferredFlags.Type = DEFERRED_NONE;
+}
+
+OrderedNode *OpDispatchBuilder::SelectDeferredCC(uint8_t CC, OrderedNode *TrueValue, OrderedNode *FalseValue) {
+  auto const &Flags = DeferredFlags;
+  if (Flags.Type != DEFERRED_SUB && Flags.Type != DEFERRED_LOGICAL) {
+    return nullptr;
+  }
+
+  uint8_t Size = Flags.SrcSize * 8;
+  auto Unsigned = [this, Size](OrderedNode *Value) -> OrderedNode* {
+    return Size == 64 ? Value : _Bfe(Size, 0, Value);
+  };
+  auto Signed = [this, Size](OrderedNode *Value) -> OrderedNode* {
+    return Size == 64 ? Value : _Sext(Size, Value);
+  };
+
+  if (Flags.Type == DEFERRED_SUB) {
+    // cmp Src1, Src2 then jcc compares the operands themselves
+    switch (CC) {
+      case 0x2: return _Select(FEXCore::IR::COND_ULT, Unsigned(Flags.Src1), Unsigned(Flags.Src2), TrueValue, FalseValue);
+      case 0x3: return _Select(FEXCore::IR::COND_UGE, Unsigned(Flags.Src1), Unsigned(Flags.Src2), TrueValue, FalseValue);
+      case 0x4: return _Select(FEXCore::IR::COND_EQ,  Unsigned(Flags.Src1), Unsigned(Flags.Src2), TrueValue, FalseValue);
+      case 0x5: return _Select(FEXCore::IR::COND_NEQ, Unsigned(Flags.Src1), Unsigned(Flags.Src2), TrueValue, FalseValue);
+      case 0x6: return _Select(FEXCore::IR::COND_ULE, Unsigned(Flags.Src1), Unsigned(Flags.Src2), TrueValue, FalseValue);
+      case 0x7: return _Select(FEXCore::IR::COND_UGT, Unsigned(Flags.Src1), Unsigned(Flags.Src2), TrueValue, FalseValue);
+      case 0xC: return _Select(FEXCore::IR::COND_SLT, Signed(Flags.Src1), Signed(Flags.Src2), TrueValue, FalseValue);
+      case 0xD: return _Select(FEXCore::IR::COND_SGE, Signed(Flags.Src1), Signed(Flags.Src2), TrueValue, FalseValue);
+      case 0xE: return _Select(FEXCore::IR::COND_SLE, Signed(Flags.Src1), Signed(Flags.Src2), TrueValue, FalseValue);
+      case 0xF: return _Select(FEXCore::IR::COND_SGT, Signed(Flags.Src1), Signed(Flags.Src2), TrueValue, FalseValue);
+      default: return nullptr;
+    }
+  }
+
+  // Logical ops clear CF and OF, everything left depends on the result alone
+  auto ZeroConst = _Constant(0);
+  switch (CC) {
+    case 0x4:
+    case 0x6: return _Select(FEXCore::IR::COND_EQ,  Unsigned(Flags.Res), ZeroConst, TrueValue, FalseValue);
+    case 0x5:
+    case 0x7: return _Select(FEXCore::IR::COND_NEQ, Unsigned(Flags.Res), ZeroConst, TrueValue, FalseValue);
+    case 0x8:
+    case 0xC: return _Select(FEXCore::IR::COND_SLT, Signed(Flags.Res), ZeroConst, TrueValue, FalseValue);
+    case 0x9:
+    case 0xD: return _Select(FEXCore::IR::COND_SGE, Signed(Flags.Res), ZeroConst, TrueValue, FalseValue);
+    case 0xE: return _Select(FEXCore::IR::COND_SLE, Signed(Flags.Res), ZeroConst, TrueValue, FalseValue);
+    case 0xF: return _Select(FEXCore::IR::COND_SGT, Signed(Flags.Res), ZeroConst, TrueValue, FalseValue);
+    default: return nullptr;
+  }
+}
 constexpr std::array<uint32_t, 17> FlagOffsets = {
   FEXCore::X86State::RFLAG_CF_LOC,
   FEXCore::X86State::RFLAG_PF_LOC,
@@ -3728,7 +3792,7 @@ OrderedNode *OpDispatchBuilder::GetPackedRFLAG(bool Lower8) {
   }
 
   for (int i = 0; i < NumFlags; ++i) {
-    OrderedNode *Flag = _LoadFlag(FlagOffsets[i]);
+    OrderedNode *Flag = GetRFLAG(FlagOffsets[i]);
     Flag = _Zext(32, Flag);
     Flag = _Lshl(Flag, _Constant(FlagOffsets[i]));
     Original = _Or(Original, Flag);
@@ -3879,126 +3943,11 @@ void OpDispatchBuilder::GenerateFlags_SBB(FEXCore::X86Tables::DecodedOp Op, Orde
 }
 
 void OpDispatchBuilder::GenerateFlags_SUB(FEXCore::X86Tables::DecodedOp Op, OrderedNode *Res, OrderedNode *Src1, OrderedNode *Src2) {
-  // AF
-  {
-    OrderedNode *AFRes = _Xor(_Xor(Src1, Src2), Res);
-    AFRes = _Bfe(1, 4, AFRes);
-    SetRFLAG<FEXCore::X86State::RFLAG_AF_LOC>(AFRes);
-  }
-
-  // SF
-  {
-    auto SignBitConst = _Constant(GetSrcSize(Op) * 8 - 1);
-
-    auto LshrOp = _Lshr(Res, SignBitConst);
-    SetRFLAG<FEXCore::X86State::RFLAG_SF_LOC>(LshrOp);
-  }
-
-  // PF
-  {
-    auto EightBitMask = _Constant(0xFF);
-    auto PopCountOp = _Popcount(_And(Res, EightBitMask));
-    auto XorOp = _Xor(PopCountOp, _Constant(1));
-    SetRFLAG<FEXCore::X86State::RFLAG_PF_LOC>(XorOp);
-  }
-
-  // ZF
-  {
-    auto ZeroConst = _Constant(0);
-    auto OneConst = _Constant(1);
-    auto Bfe8 = _Bfe(GetSrcSize(Op) * 8, 0, Res);
-    auto SelectOp = _Select(FEXCore::IR::COND_EQ,
-        Bfe8, ZeroConst, OneConst, ZeroConst);
-    SetRFLAG<FEXCore::X86State::RFLAG_ZF_LOC>(SelectOp);
-  }
-
-  // CF
-  {
-    auto ZeroConst = _Constant(0);
-    auto OneConst = _Constant(1);
-
-    auto SelectOp = _Select(FEXCore::IR::COND_ULT,
-        Src1, Src2, OneConst, ZeroConst);
-
-    SetRFLAG<FEXCore::X86State::RFLAG_CF_LOC>(SelectOp);
-  }
-  // OF
-  {
-    auto XorOp1 = _Xor(Src1, Src2);
-    auto XorOp2 = _Xor(Res, Src1);
-    OrderedNode *FinalAnd = _And(XorOp1, XorOp2);
-
-    FinalAnd = _Bfe(1, GetSrcSize(Op) * 8 - 1, FinalAnd);
-
-    SetRFLAG<FEXCore::X86State::RFLAG_OF_LOC>(FinalAnd);
-  }
+  DeferFlags(DEFERRED_SUB, Op, Res, Src1, Src2);
 }
 
 void OpDispatchBuilder::GenerateFlags_ADD(FEXCore::X86Tables::DecodedOp Op, OrderedNode *Res, OrderedNode *Src1, OrderedNode *Src2) {
-  // AF
-  {
-    OrderedNode *AFRes = _Xor(_Xor(Src1, Src2), Res);
-    AFRes = _Bfe(1, 4, AFRes);
-    SetRFLAG<FEXCore::X86State::RFLAG_AF_LOC>(AFRes);
-  }
-
-  // SF
-  {
-    auto SignBitConst = _Constant(GetSrcSize(Op) * 8 - 1);
-
-    auto LshrOp = _Lshr(Res, SignBitConst);
-    SetRFLAG<FEXCore::X86State::RFLAG_SF_LOC>(LshrOp);
-  }
-
-  // PF
-  {
-    auto EightBitMask = _Constant(0xFF);
-    auto PopCountOp = _Popcount(_And(Res, EightBitMask));
-    auto XorOp = _Xor(PopCountOp, _Constant(1));
-    SetRFLAG<FEXCore::X86State::RFLAG_PF_LOC>(XorOp);
-  }
-
-  // ZF
-  {
-    auto SelectOp = _Select(FEXCore::IR::COND_EQ,
-        Res, _Constant(0), _Constant(1), _Constant(0));
-    SetRFLAG<FEXCore::X86State::RFLAG_ZF_LOC>(SelectOp);
-  }
-  // CF
-  {
-    auto Dst8 = _Bfe(GetSrcSize(Op) * 8, 0, Res);
-    auto Src8 = _Bfe(GetSrcSize(Op) * 8, 0, Src2);
-
-    auto SelectOp = _Select(FEXCore::IR::COND_ULT, Dst8, Src8, _Constant(1), _Constant(0));
-
-    SetRFLAG<FEXCore::X86State::RFLAG_CF_LOC>(SelectOp);
-  }
-
-  // OF
-  {
-    auto NegOne = _Constant(~0ULL);
-    auto XorOp1 = _Xor(_Xor(Src1, Src2), NegOne);
-    auto XorOp2 = _Xor(Res, Src1);
-
-    OrderedNode *AndOp1 = _And(XorOp1, XorOp2);
-
-    switch (GetSrcSize(Op)) {
-    case 1:
-      AndOp1 = _Bfe(1, 7, AndOp1);
-    break;
-    case 2:
-      AndOp1 = _Bfe(1, 15, AndOp1);
-    break;
-    case 4:
-      AndOp1 = _Bfe(1, 31, AndOp1);
-    break;
-    case 8:
-      AndOp1 = _Bfe(1, 63, AndOp1);
-    break;
-    default: LogMan::Msg::A("Unknown BFESize: %d", GetSrcSize(Op)); break;
-    }
-    SetRFLAG<FEXCore::X86State::RFLAG_OF_LOC>(AndOp1);
-  }
+  DeferFlags(DEFERRED_ADD, Op, Res, Src1, Src2);
 }
 
 void OpDispatchBuilder::GenerateFlags_MUL(FEXCore::X86Tables::DecodedOp Op, OrderedNode *Res, OrderedNode *High) {
@@ -4050,41 +3999,7 @@ void OpDispatchBuilder::GenerateFlags_UMUL(FEXCore::X86Tables::DecodedOp Op, Ord
 }
 
 void OpDispatchBuilder::GenerateFlags_Logical(FEXCore::X86Tables::DecodedOp Op, OrderedNode *Res, OrderedNode *Src1, OrderedNode *Src2) {
-  // AF
-  {
-    // Undefined
-    // Set to zero anyway
-    SetRFLAG<FEXCore::X86State::RFLAG_AF_LOC>(_Constant(0));
-  }
-
-  // SF
-  {
-    auto SignBitConst = _Constant(GetSrcSize(Op) * 8 - 1);
-
-    auto LshrOp = _Lshr(Res, SignBitConst);
-    SetRFLAG<FEXCore::X86State::RFLAG_SF_LOC>(LshrOp);
-  }
-
-  // PF
-  {
-    auto EightBitMask = _Constant(0xFF);
-    auto PopCountOp = _Popcount(_And(Res, EightBitMask));
-    auto XorOp = _Xor(PopCountOp, _Constant(1));
-    SetRFLAG<FEXCore::X86State::RFLAG_PF_LOC>(XorOp);
-  }
-
-  // ZF
-  {
-    auto SelectOp = _Select(FEXCore::IR::COND_EQ,
-        Res, _Constant(0), _Constant(1), _Constant(0));
-    SetRFLAG<FEXCore::X86State::RFLAG_ZF_LOC>(SelectOp);
-  }
-
-  // CF/OF
-  {
-    SetRFLAG<FEXCore::X86State::RFLAG_CF_LOC>(_Constant(0));
-    SetRFLAG<FEXCore::X86State::RFLAG_OF_LOC>(_Constant(0));
-  }
+  DeferFlags(DEFERRED_LOGICAL, Op, Res, Src1, Src2);
 }
 
 void OpDispatchBuilder::GenerateFlags_ShiftLeft(FEXCore::X86Tables::DecodedOp Op, OrderedNode *Res, OrderedNode *Src1, OrderedNode *Src2) {
@@ -5606,6 +5521,8 @@ void OpDispatchBuilder::RemoveArgUses(OrderedNode *Node) {
 
   uint8_t NumArgs = IR::GetArgs(IROp->Op);
   for (uint8_t i = 0; i < NumArgs; ++i) {
+    // Unused arguments point at the invalid node, it doesn't count uses
+    if (IROp->Args[i].IsInvalid()) continue;
     auto ArgNode = IROp->Args[i].GetNode(ListBegin);
     ArgNode->RemoveUse();
   }
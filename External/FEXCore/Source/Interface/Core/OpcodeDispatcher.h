@@ -85,6 +85,7 @@ public:
 
   IRListView<false> ViewIR() { return IRListView<false>(&Data, &ListData); }
   IRListView<true> *CreateIRCopy() { return new IRListView<true>(&Data, &ListData); }
+  IRListView<true> *CreateIRCopy(IRArena *Arena) { return new IRListView<true>(&Data, &ListData, Arena); }
   void ResetWorkingList();
   bool HadDecodeFailure() { return DecodeFailure; }
 
@@ -382,10 +383,10 @@ public:
     return _Bfi(ssa0, ssa1, Width, lsb);
   }
   IRPair<IROp_StoreMem> _StoreMem(FEXCore::IR::RegisterClassType Class, uint8_t Size, OrderedNode *ssa0, OrderedNode *ssa1, uint8_t Align = 1) {
-    return _StoreMem(ssa0, ssa1, Size, Align, Class);
+    return _StoreMem(ssa0, ssa1, Size, Align, Class, 0);
   }
   IRPair<IROp_LoadMem> _LoadMem(FEXCore::IR::RegisterClassType Class, uint8_t Size, OrderedNode *ssa0, uint8_t Align = 1) {
-    return _LoadMem(ssa0, Size, Align, Class);
+    return _LoadMem(ssa0, Size, Align, Class, 0);
   }
   IRPair<IROp_Select> _Select(uint8_t Cond, OrderedNode *ssa0, OrderedNode *ssa1, OrderedNode *ssa2, OrderedNode *ssa3) {
     return _Select(ssa0, ssa1, ssa2, ssa3, {Cond});
@@ -597,6 +598,9 @@ public:
   IRPair<IROp_Jump> _Jump() {
     return _Jump(InvalidNode);
   }
+  IRPair<IROp_ExitFunction> _ExitFunction() {
+    return _ExitFunction(EXIT_HINT_NONE, 0);
+  }
   IRPair<IROp_CondJump> _CondJump(OrderedNode *ssa0) {
     return _CondJump(ssa0, InvalidNode, InvalidNode);
   }
@@ -726,6 +730,19 @@ public:
     CodeBlocks = rhs.CodeBlocks;
   }
 
+  /**
+   * @brief Replaces the working list with IR that was generated earlier
+   *
+   * Lets passes run over IR without going through the frontend again
+   */
+  void LoadIR(void const *IRData, size_t IRDataSize, void const *IRListData, size_t IRListSize) {
+    LogMan::Throw::A(IRDataSize <= Data.BackingSize(), "Trying to load IR that is too large");
+    LogMan::Throw::A(IRListSize <= ListData.BackingSize(), "Trying to load IR that is too large");
+    ResetWorkingList();
+    Data.CopyData(IRData, IRDataSize);
+    ListData.CopyData(IRListData, IRListSize);
+  }
+
   void SetWriteCursor(OrderedNode *Node) {
     CurrentWriteCursor = Node;
   }
@@ -797,6 +814,8 @@ public:
   void SetMultiblock(bool _Multiblock) { Multiblock = _Multiblock; }
   bool GetMultiblock() { return Multiblock; }
 
+  void SetLazyFlags(bool _LazyFlags) { LazyFlags = _LazyFlags; }
+
 private:
   void RemoveArgUses(OrderedNode *Node);
   bool DecodeFailure{false};
@@ -833,6 +852,45 @@ private:
   void GenerateFlags_RotateRightImmediate(FEXCore::X86Tables::DecodedOp Op, OrderedNode *Res, OrderedNode *Src1, uint64_t Shift);
   void GenerateFlags_RotateLeftImmediate(FEXCore::X86Tables::DecodedOp Op, OrderedNode *Res, OrderedNode *Src1, uint64_t Shift);
 
+  /**
+   * @name Lazy flags
+   *
+   * ALU ops that set all of the arithmetic flags only record what they were calculated from.
+   * Flags read while the record is current are calculated straight from the operands, and conditions on a compare use the operands directly.
+   * The flags still get stored at the point the ALU op would have stored them. That happens once the record is replaced, another flag is written or a new code block starts.
+   * Stores that nothing reads are cleaned up by dead flag elimination.
+   * @{ */
+  enum DeferredFlagsType {
+    DEFERRED_NONE,
+    DEFERRED_ADD,
+    DEFERRED_SUB,
+    DEFERRED_LOGICAL,
+  };
+
+  struct DeferredFlagState {
+    DeferredFlagsType Type {DEFERRED_NONE};
+    uint8_t SrcSize;
+    OrderedNode *Res;
+    OrderedNode *Src1;
+    OrderedNode *Src2;
+    // Flags get stored right after this node
+    OrderedNode *StorePoint;
+  };
+
+  void DeferFlags(DeferredFlagsType Type, FEXCore::X86Tables::DecodedOp Op, OrderedNode *Res, OrderedNode *Src1, OrderedNode *Src2);
+  OrderedNode *CalculateDeferredFlag(unsigned BitOffset);
+  void StoreDeferredFlags();
+  /**
+   * @brief Selects between the values on the x86 condition code CC using the operands of the deferred flags
+   *
+   * @return nullptr if the condition can't be calculated directly, the flags need to be used then
+   */
+  OrderedNode *SelectDeferredCC(uint8_t CC, OrderedNode *TrueValue, OrderedNode *FalseValue);
+
+  DeferredFlagState DeferredFlags;
+  bool LazyFlags{};
+  /**  @} */
+
   OrderedNode * GetX87Top();
   void SetX87Top(OrderedNode *Value);
 
@@ -0,0 +1,241 @@
+#include "Common/Hash.h"
+#include "Interface/Core/TranslationCache.h"
+#include "LogManager.h"
+
+#include <FEXCore/IR/IR.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <set>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace FEXCore {
+namespace {
+  constexpr uint64_t AlignUp(uint64_t Value) {
+    return (Value + 7) & ~7ULL;
+  }
+}
+
+TranslationCache::TranslationCache(std::string const &Path, uint64_t MemoryBase)
+  : Path {Path}
+  , MemoryBase {MemoryBase} {
+  if (!LoadFile()) {
+    Entries.clear();
+  }
+}
+
+TranslationCache::~TranslationCache() {
+  if (Mapping) {
+    munmap(Mapping, MappingSize);
+  }
+}
+
+uint32_t TranslationCache::GetIRKey() {
+  // Any change to the IR ops makes IR from an older build unusable
+  FEXCore::Hash::XXHash64 State;
+  for (uint32_t i = 0; i < IR::IROps::OP_LAST; ++i) {
+    auto Op = static_cast<IR::IROps>(i);
+    auto Name = IR::GetName(Op);
+    uint64_t Size = IR::GetSize(Op);
+    uint8_t Args = IR::GetArgs(Op);
+    State.Update(Name.data(), Name.size());
+    State.Update(&Size, sizeof(Size));
+    State.Update(&Args, sizeof(Args));
+  }
+  uint64_t NodeSize = sizeof(IR::OrderedNode);
+  State.Update(&NodeSize, sizeof(NodeSize));
+  uint64_t Hash = State.Final();
+  return static_cast<uint32_t>(Hash ^ (Hash >> 32));
+}
+
+bool TranslationCache::HashGuestCode(CodeRanges const &Ranges, uint64_t *Hash) const {
+  // The guest might have unmapped code we saw in an earlier run, so it is read through the kernel instead of faulting
+  uint8_t Buffer[4096];
+  FEXCore::Hash::XXHash64 State;
+  for (auto const &Range : Ranges) {
+    for (uint64_t Address = Range.first; Address < Range.second;) {
+      size_t Size = std::min<uint64_t>(sizeof(Buffer), Range.second - Address);
+      iovec Local {Buffer, Size};
+      iovec Remote {reinterpret_cast<void*>(Address + MemoryBase), Size};
+      if (process_vm_readv(getpid(), &Local, 1, &Remote, 1, 0) != static_cast<ssize_t>(Size)) {
+        return false;
+      }
+      State.Update(Buffer, Size);
+      Address += Size;
+    }
+  }
+
+  *Hash = State.Final();
+  return true;
+}
+
+bool TranslationCache::LoadFile() {
+  int FD = open(Path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (FD == -1) {
+    return false;
+  }
+
+  struct stat Stat{};
+  if (fstat(FD, &Stat) != 0 || Stat.st_size < static_cast<off_t>(sizeof(FileHeader))) {
+    close(FD);
+    return false;
+  }
+
+  MappingSize = Stat.st_size;
+  Mapping = mmap(nullptr, MappingSize, PROT_READ, MAP_PRIVATE, FD, 0);
+  close(FD);
+  if (Mapping == MAP_FAILED) {
+    Mapping = nullptr;
+    return false;
+  }
+
+  auto Base = reinterpret_cast<uint8_t const*>(Mapping);
+  auto Header = reinterpret_cast<FileHeader const*>(Base);
+  if (Header->Magic != FILE_MAGIC ||
+      Header->Version != FILE_VERSION ||
+      Header->IRKey != GetIRKey()) {
+    LogMan::Msg::D("Translation cache %s is from a different version, ignoring it", Path.c_str());
+    return false;
+  }
+
+  // Don't trust anything in the file to be in bounds
+  uint64_t Offset = sizeof(FileHeader);
+  for (uint64_t i = 0; i < Header->EntryCount; ++i) {
+    if (MappingSize - Offset < sizeof(FileEntry)) {
+      return false;
+    }
+
+    auto Entry = reinterpret_cast<FileEntry const*>(Base + Offset);
+    uint64_t Remaining = MappingSize - Offset - sizeof(FileEntry);
+    if (Entry->RangeCount > Remaining / (sizeof(uint64_t) * 2) ||
+        Entry->IRDataSize > Remaining ||
+        Entry->ListSize > Remaining) {
+      return false;
+    }
+
+    uint64_t EntrySize = sizeof(FileEntry) + Entry->RangeCount * sizeof(uint64_t) * 2 + AlignUp(Entry->IRDataSize) + AlignUp(Entry->ListSize);
+    if (EntrySize > MappingSize - Offset) {
+      return false;
+    }
+
+    Entries[Entry->GuestRIP] = Entry;
+    Offset += EntrySize;
+  }
+
+  return true;
+}
+
+bool TranslationCache::Find(uint64_t GuestRIP, CachedBlock *Block) const {
+  auto it = Entries.find(GuestRIP);
+  if (it == Entries.end()) {
+    return false;
+  }
+
+  auto Entry = it->second;
+  auto RangeData = reinterpret_cast<uint64_t const*>(Entry + 1);
+  CodeRanges Ranges;
+  Ranges.reserve(Entry->RangeCount);
+  for (uint64_t i = 0; i < Entry->RangeCount; ++i) {
+    Ranges.emplace_back(RangeData[i * 2], RangeData[i * 2 + 1]);
+  }
+
+  // Libraries can end up at other addresses and files change between runs
+  uint64_t CodeHash;
+  if (!HashGuestCode(Ranges, &CodeHash) || CodeHash != Entry->CodeHash) {
+    return false;
+  }
+
+  auto IRData = reinterpret_cast<uint8_t const*>(RangeData + Entry->RangeCount * 2);
+  Block->IRData = IRData;
+  Block->IRDataSize = Entry->IRDataSize;
+  Block->ListData = IRData + AlignUp(Entry->IRDataSize);
+  Block->ListSize = Entry->ListSize;
+  Block->GuestCodeSize = Entry->GuestCodeSize;
+  Block->GuestInstructionCount = Entry->GuestInstructionCount;
+  Block->Ranges = std::move(Ranges);
+  return true;
+}
+
+void TranslationCache::AddBlock(uint64_t GuestRIP, CodeRanges const &Ranges, FEXCore::IR::IRListView<true> *IR,
+                                uint64_t GuestCodeSize, uint64_t GuestInstructionCount) {
+  std::unique_ptr<FEXCore::IR::IRListView<true>> OwnedIR {IR};
+  uint64_t CodeHash;
+  if (!HashGuestCode(Ranges, &CodeHash)) {
+    Blocks.erase(GuestRIP);
+    return;
+  }
+
+  Blocks.insert_or_assign(GuestRIP, BlockCode{CodeHash, Ranges, std::move(OwnedIR), GuestCodeSize, GuestInstructionCount});
+}
+
+void TranslationCache::RemoveBlock(uint64_t GuestRIP) {
+  Blocks.erase(GuestRIP);
+}
+
+void TranslationCache::Save() {
+  // Written next to the cache and moved over it, another instance might be running from the old file
+  std::string TempPath = Path + "." + std::to_string(getpid());
+  std::ofstream Output (TempPath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!Output.is_open()) {
+    return;
+  }
+
+  constexpr uint64_t Padding {};
+  auto WritePadded = [&Output, &Padding](void const *Data, uint64_t Size) {
+    Output.write(reinterpret_cast<char const*>(Data), Size);
+    Output.write(reinterpret_cast<char const*>(&Padding), AlignUp(Size) - Size);
+  };
+
+  FileHeader Header {FILE_MAGIC, FILE_VERSION, GetIRKey(), 0};
+  Output.write(reinterpret_cast<char const*>(&Header), sizeof(Header));
+
+  std::set<uint64_t> Written;
+  for (auto const &Block : Blocks) {
+    auto const &IR = Block.second.IR;
+    FileEntry Entry {
+      Block.first,
+      Block.second.CodeHash,
+      Block.second.GuestCodeSize,
+      Block.second.GuestInstructionCount,
+      IR->GetDataSize(),
+      IR->GetListSize(),
+      Block.second.Ranges.size(),
+    };
+    Output.write(reinterpret_cast<char const*>(&Entry), sizeof(Entry));
+    for (auto const &Range : Block.second.Ranges) {
+      Output.write(reinterpret_cast<char const*>(&Range.first), sizeof(uint64_t));
+      Output.write(reinterpret_cast<char const*>(&Range.second), sizeof(uint64_t));
+    }
+    WritePadded(reinterpret_cast<void const*>(IR->GetData()), Entry.IRDataSize);
+    WritePadded(reinterpret_cast<void const*>(IR->GetListData()), Entry.ListSize);
+
+    Written.emplace(Block.first);
+  }
+
+  // Code that didn't run this time is still valid for the next run
+  for (auto const &Entry : Entries) {
+    if (Written.find(Entry.first) != Written.end()) {
+      continue;
+    }
+
+    uint64_t EntrySize = sizeof(FileEntry) + Entry.second->RangeCount * sizeof(uint64_t) * 2 + AlignUp(Entry.second->IRDataSize) + AlignUp(Entry.second->ListSize);
+    Output.write(reinterpret_cast<char const*>(Entry.second), EntrySize);
+    Written.emplace(Entry.first);
+  }
+
+  Header.EntryCount = Written.size();
+  Output.seekp(0);
+  Output.write(reinterpret_cast<char const*>(&Header), sizeof(Header));
+  Output.close();
+
+  if (Output.fail() || rename(TempPath.c_str(), Path.c_str()) != 0) {
+    LogMan::Msg::E("Couldn't write translation cache %s", Path.c_str());
+    unlink(TempPath.c_str());
+  }
+}
+}
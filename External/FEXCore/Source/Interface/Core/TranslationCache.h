@@ -0,0 +1,110 @@
+#pragma once
+#include <FEXCore/IR/IntrusiveIRList.h>
+
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace FEXCore {
+// Keeps the optimized IR of blocks on disk between runs of the same application
+// The IR is stored before register allocation, the RA pass runs again on load to set up its state
+// An entry is only used when the guest code it was generated from is unchanged in memory
+// Find can be called from any thread, everything else must be serialized by the owner
+class TranslationCache {
+public:
+  using CodeRanges = std::vector<std::pair<uint64_t, uint64_t>>;
+
+  struct CachedBlock {
+    void const *IRData;
+    uint64_t IRDataSize;
+    void const *ListData;
+    uint64_t ListSize;
+    uint64_t GuestCodeSize;
+    uint64_t GuestInstructionCount;
+    CodeRanges Ranges;
+  };
+
+  /**
+   * @param Path File the cache is loaded from and saved back to
+   * @param MemoryBase Host address of guest address 0, guest code is read through it
+   */
+  TranslationCache(std::string const &Path, uint64_t MemoryBase);
+  ~TranslationCache();
+
+  /**
+   * @brief Finds IR for GuestRIP from an earlier run
+   *
+   * The IR pointed to stays valid for the lifetime of the cache
+   */
+  bool Find(uint64_t GuestRIP, CachedBlock *Block) const;
+
+  /**
+   * @brief Number of blocks loaded from the earlier run
+   */
+  size_t LoadedBlockCount() const { return Entries.size(); }
+
+  /**
+   * @brief Records IR for GuestRIP and the guest code in the [Begin, End) ranges it was generated from
+   *
+   * @param IR Copy of the IR before register allocation, the cache takes ownership
+   */
+  void AddBlock(uint64_t GuestRIP, CodeRanges const &Ranges, FEXCore::IR::IRListView<true> *IR,
+                uint64_t GuestCodeSize, uint64_t GuestInstructionCount);
+  void RemoveBlock(uint64_t GuestRIP);
+
+  /**
+   * @brief Writes the IR of every recorded block, entries from the earlier run that weren't used are kept
+   */
+  void Save();
+
+private:
+  constexpr static uint64_t FILE_MAGIC = 0x4843'4143'5845'46ULL; // "FEXCACH"
+  // Bump whenever the frontend or the passes change the IR they generate for the same guest code
+  // 2: IR is stored before register allocation
+  constexpr static uint32_t FILE_VERSION = 2;
+
+  struct FileHeader {
+    uint64_t Magic;
+    uint32_t Version;
+    uint32_t IRKey;
+    uint64_t EntryCount;
+  };
+
+  // Followed by RangeCount pairs of range begin and end, the IR data and then the IR list
+  // Everything is padded to 8 bytes
+  struct FileEntry {
+    uint64_t GuestRIP;
+    uint64_t CodeHash;
+    uint64_t GuestCodeSize;
+    uint64_t GuestInstructionCount;
+    uint64_t IRDataSize;
+    uint64_t ListSize;
+    uint64_t RangeCount;
+  };
+
+  static uint32_t GetIRKey();
+  bool HashGuestCode(CodeRanges const &Ranges, uint64_t *Hash) const;
+  bool LoadFile();
+
+  std::string Path;
+  uint64_t MemoryBase;
+  void *Mapping {};
+  size_t MappingSize {};
+
+  // Entries of the file we loaded, read only after construction
+  std::unordered_map<uint64_t, FileEntry const*> Entries;
+
+  struct BlockCode {
+    uint64_t CodeHash;
+    CodeRanges Ranges;
+    std::unique_ptr<FEXCore::IR::IRListView<true>> IR;
+    uint64_t GuestCodeSize;
+    uint64_t GuestInstructionCount;
+  };
+  std::map<uint64_t, BlockCode> Blocks;
+};
+}
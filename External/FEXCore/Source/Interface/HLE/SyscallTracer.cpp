@@ -0,0 +1,141 @@
+#include "Interface/Core/InternalThreadState.h"
+#include "Interface/HLE/SyscallTracer.h"
+#include "LogManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+
+namespace FEXCore::HLE {
+  // How often the drainer empties the buffers, a buffer fills up after SIZE syscalls in this time
+  constexpr auto DRAIN_INTERVAL = std::chrono::milliseconds(10);
+
+  SyscallTracer::~SyscallTracer() {
+    Stop();
+  }
+
+  bool SyscallTracer::Start(std::string const &Path) {
+    std::lock_guard<std::mutex> lk(ControlMutex);
+    StopLocked();
+
+    Output.open(Path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!Output.is_open()) {
+      LogMan::Msg::E("Couldn't open syscall trace %s", Path.c_str());
+      return false;
+    }
+
+    SyscallTraceHeader Header {SYSCALL_TRACE_MAGIC, SYSCALL_TRACE_VERSION, sizeof(SyscallTraceRecord), 0};
+    Output.write(reinterpret_cast<char const*>(&Header), sizeof(Header));
+
+    {
+      // Anything recorded while the last trace was stopping doesn't belong in this one
+      std::lock_guard<std::mutex> lk(BuffersMutex);
+      for (auto &Buffer : Buffers) {
+        Buffer->Tail.store(Buffer->Head.load(std::memory_order_acquire), std::memory_order_release);
+        Buffer->Dropped.store(0, std::memory_order_relaxed);
+      }
+    }
+
+    DrainerShouldStop = false;
+    Drainer = std::thread(&SyscallTracer::DrainerThread, this);
+    Enabled.store(true);
+    return true;
+  }
+
+  void SyscallTracer::Stop() {
+    std::lock_guard<std::mutex> lk(ControlMutex);
+    StopLocked();
+  }
+
+  void SyscallTracer::StopLocked() {
+    if (!Enabled.load()) {
+      return;
+    }
+
+    // Threads that already saw the flag can still finish their syscall, their records go out with the final drain or are discarded on the next Start
+    Enabled.store(false);
+    {
+      std::lock_guard<std::mutex> lk(DrainerMutex);
+      DrainerShouldStop = true;
+    }
+    DrainerCV.notify_one();
+    Drainer.join();
+
+    Drain();
+
+    uint64_t Dropped {};
+    {
+      std::lock_guard<std::mutex> lk(BuffersMutex);
+      for (auto &Buffer : Buffers) {
+        Dropped += Buffer->Dropped.exchange(0, std::memory_order_relaxed);
+      }
+    }
+
+    if (Dropped) {
+      LogMan::Msg::E("Syscall trace dropped %ld records, the drainer couldn't keep up", Dropped);
+    }
+
+    Output.seekp(offsetof(SyscallTraceHeader, Dropped));
+    Output.write(reinterpret_cast<char const*>(&Dropped), sizeof(Dropped));
+    Output.close();
+    if (Output.fail()) {
+      LogMan::Msg::E("Couldn't write syscall trace");
+    }
+    Output.clear();
+  }
+
+  void SyscallTracer::Record(FEXCore::Core::InternalThreadState *Thread, SyscallArguments const *Args, uint64_t Result, uint64_t Timestamp, uint64_t Duration) {
+    auto Buffer = Thread->SyscallTrace;
+    if (!Buffer) {
+      Buffer = AllocateBuffer(Thread);
+    }
+
+    uint64_t Head = Buffer->Head.load(std::memory_order_relaxed);
+    if (Head - Buffer->Tail.load(std::memory_order_acquire) == SyscallTraceBuffer::SIZE) {
+      Buffer->Dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    auto &Entry = Buffer->Records[Head % SyscallTraceBuffer::SIZE];
+    Entry.Timestamp = Timestamp;
+    Entry.Duration = Duration;
+    Entry.TID = Thread->State.ThreadManager.GetTID();
+    Entry.Number = Args->Argument[0];
+    std::copy(&Args->Argument[1], &Args->Argument[SyscallArguments::MAX_ARGS], Entry.Arguments);
+    Entry.Result = Result;
+
+    Buffer->Head.store(Head + 1, std::memory_order_release);
+  }
+
+  SyscallTraceBuffer *SyscallTracer::AllocateBuffer(FEXCore::Core::InternalThreadState *Thread) {
+    std::lock_guard<std::mutex> lk(BuffersMutex);
+    Thread->SyscallTrace = Buffers.emplace_back(std::make_unique<SyscallTraceBuffer>()).get();
+    return Thread->SyscallTrace;
+  }
+
+  void SyscallTracer::DrainerThread() {
+    std::unique_lock<std::mutex> lk(DrainerMutex);
+    while (!DrainerCV.wait_for(lk, DRAIN_INTERVAL, [this] { return DrainerShouldStop; })) {
+      Drain();
+    }
+  }
+
+  void SyscallTracer::Drain() {
+    std::lock_guard<std::mutex> lk(BuffersMutex);
+    for (auto &Buffer : Buffers) {
+      uint64_t Tail = Buffer->Tail.load(std::memory_order_relaxed);
+      uint64_t Head = Buffer->Head.load(std::memory_order_acquire);
+
+      // At most two contiguous runs, up to the end of the ring and then from the start
+      while (Tail != Head) {
+        uint64_t Index = Tail % SyscallTraceBuffer::SIZE;
+        uint64_t Count = std::min(Head - Tail, SyscallTraceBuffer::SIZE - Index);
+        Output.write(reinterpret_cast<char const*>(&Buffer->Records[Index]), Count * sizeof(SyscallTraceRecord));
+        Tail += Count;
+      }
+
+      Buffer->Tail.store(Tail, std::memory_order_release);
+    }
+    Output.flush();
+  }
+}
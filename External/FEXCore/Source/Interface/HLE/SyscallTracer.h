@@ -0,0 +1,81 @@
+#pragma once
+#include <FEXCore/HLE/SyscallHandler.h>
+#include <FEXCore/HLE/SyscallTrace.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace FEXCore::Core {
+struct InternalThreadState;
+}
+
+namespace FEXCore::HLE {
+  /**
+   * @brief One guest thread's syscall records that haven't been written out yet
+   *
+   * Single producer single consumer ring, only the owning thread pushes and only the drainer pops
+   */
+  struct SyscallTraceBuffer {
+    static constexpr uint64_t SIZE = 4096;
+
+    alignas(64) std::atomic<uint64_t> Head {}; ///< Next record the thread writes
+    alignas(64) std::atomic<uint64_t> Tail {}; ///< Next record the drainer reads
+    std::atomic<uint64_t> Dropped {}; ///< Records thrown away because the ring was full
+    SyscallTraceRecord Records[SIZE];
+  };
+
+  /**
+   * @brief Records every guest syscall that goes through the handler while enabled
+   *
+   * Threads only ever touch their own ring buffer, a background thread drains them all in to the trace file
+   * Can be started and stopped at any point while the guest is running
+   */
+  class SyscallTracer {
+  public:
+    ~SyscallTracer();
+
+    /**
+     * @brief Starts writing records to a new trace file at Path, stopping any trace that was already running
+     */
+    bool Start(std::string const &Path);
+    void Stop();
+
+    bool IsEnabled() const { return Enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Flag that JIT code tests before calling a syscall's handler directly
+     */
+    std::atomic<bool> const *GetEnabledFlag() const { return &Enabled; }
+
+    void Record(FEXCore::Core::InternalThreadState *Thread, SyscallArguments const *Args, uint64_t Result, uint64_t Timestamp, uint64_t Duration);
+
+  private:
+    SyscallTraceBuffer *AllocateBuffer(FEXCore::Core::InternalThreadState *Thread);
+    void StopLocked();
+    void DrainerThread();
+    void Drain();
+
+    // Generated code reads this as a single byte
+    static_assert(sizeof(std::atomic<bool>) == 1);
+    std::atomic<bool> Enabled {};
+
+    // Serializes Start and Stop
+    std::mutex ControlMutex;
+
+    // Buffers live as long as the tracer, threads keep a pointer to theirs
+    std::mutex BuffersMutex;
+    std::vector<std::unique_ptr<SyscallTraceBuffer>> Buffers;
+
+    std::ofstream Output;
+    std::thread Drainer;
+    std::mutex DrainerMutex;
+    std::condition_variable DrainerCV;
+    bool DrainerShouldStop {};
+  };
+}
@@ -1,15 +1,21 @@
 #include "Common/MathUtils.h"
 
 #include "Interface/Context/Context.h"
+#include "Interface/Core/CodePageTracker.h"
 #include "Interface/Core/InternalThreadState.h"
 #include "Interface/HLE/Syscalls.h"
 #include "Interface/HLE/x64/Syscalls.h"
+#include "Interface/Memory/HugePages.h"
 
 #include "LogManager.h"
 
 #include <FEXCore/Core/X86Enums.h>
+#include <algorithm>
+#include <chrono>
 #include <fcntl.h>
 #include <limits.h>
+#include <mutex>
+#include <shared_mutex>
 #include <linux/futex.h>
 #include <numaif.h>
 #include <poll.h>
@@ -19,14 +25,16 @@
 #include <sys/sysinfo.h>
 #include <sys/utsname.h>
 #include <sys/shm.h>
+#include <sys/socket.h>
 #include <sys/syscall.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 constexpr uint64_t PAGE_SIZE = 4096;
 
 namespace FEXCore {
 uint64_t SyscallHandler::HandleBRK(FEXCore::Core::InternalThreadState *Thread, void *Addr) {
-  std::lock_guard<std::mutex> lk(MMapMutex);
+  std::lock_guard<std::mutex> lk(BRKMutex);
   uint64_t Result;
   if (Addr == nullptr) { // Just wants to get the location of the program break atm
     if (DataSpace == 0) {
@@ -52,79 +60,117 @@ uint64_t SyscallHandler::HandleBRK(FEXCore::Core::InternalThreadState *Thread, v
   return Result;
 }
 
-uint64_t SyscallHandler::HandleMMAP(FEXCore::Core::InternalThreadState *Thread, void *addr, size_t length, int prot, int flags, int fd, off_t offset) {
-  std::lock_guard<std::mutex> lk(MMapMutex);
+void SyscallHandler::InitializeMMapAllocator(uint64_t GuestMemorySize) {
+  // The ELF, BRK and stack live below this
+  constexpr uint64_t MMAP_WINDOW_BEGIN = 0x1'0000'0000;
+
+  if (GuestMemorySize <= MMAP_WINDOW_BEGIN) {
+    LogMan::Msg::D("0x%lx bytes of guest memory has no room for mmap", GuestMemorySize);
+    return;
+  }
+
+  // Offsets past the guest memory region would MAP_FIXED over unrelated host memory
+  MMapAllocator = std::make_unique<FEXCore::Memory::VMAAllocator>(MMAP_WINDOW_BEGIN, GuestMemorySize);
+}
+
+void SyscallHandler::ReserveGuestMemory(uint64_t Offset, uint64_t Size) {
+  if (MMapAllocator) {
+    MMapAllocator->Reserve(Offset, AlignUp(Size, PAGE_SIZE));
+  }
+}
 
-  uint64_t Base = AlignDown(LastMMAP, PAGE_SIZE);
+uint64_t SyscallHandler::HandleMMAP(FEXCore::Core::InternalThreadState *Thread, void *addr, size_t length, int prot, int flags, int fd, off_t offset) {
   uint64_t Size = AlignUp(length, PAGE_SIZE);
   if (length == 0) {
     return -EINVAL;
   }
-  if ((LastMMAP + length) >= ENDMMAP) {
-    LogMan::Msg::D("uhoh, mmap failed\n");
-    return -ENOMEM;
-  }
 
+  // Guest addresses are host addresses with unified memory, offsets in to guest memory otherwise
+  uint64_t MemoryBase = CTX->MemoryMapper.GetBaseOffset<uint64_t>(0);
+  uint64_t GuestBase = CTX->Config.UnifiedMemory ? MemoryBase : 0;
+
+  // Mapping changes hold off compilation so nothing gets protected with a stale guest protection
+  // Only a fixed mapping can replace code, that takes the lock exclusively below
+  std::shared_lock<std::shared_mutex> lk(CTX->CodeCacheMutex);
+  std::unique_lock<std::shared_mutex> UniqueLock;
+
+  uint64_t Base;
+  uint64_t Offset{};
   if (flags & MAP_FIXED) {
     Base = reinterpret_cast<uint64_t>(addr);
-    if (fd != -1) {
-      auto Name = FM.FindFDName(fd);
-      if (Name) {
-        LogMan::Msg::D("Mapping File to [0x%lx, 0x%lx) -> '%s' -> %p", Base, Base + Size, Name->c_str(), Base);
-      }
-    }
 
-    void *Res{};
-    if (fd != -1) {
-      Res = mmap(addr, length, prot, flags, fd, offset);
-      if (Res == MAP_FAILED) {
-        LogMan::Msg::A("Couldn't map file to %p\n", addr);
-      }
-    }
-    else {
-      Res = mmap(addr, length, prot, flags, fd, offset);
+    // Taken before the host mapping exists so nothing else gets handed the range in the meantime
+    if (MMapAllocator) {
+      MMapAllocator->Reserve(Base - GuestBase, Size);
     }
 
-    if (Res == MAP_FAILED) {
-      return -errno;
+    // Replaces whatever was mapped there, including any code
+    if (CTX->CodePages->HasCode(Base, Size)) {
+      lk.unlock();
+      UniqueLock = std::unique_lock<std::shared_mutex>(CTX->CodeCacheMutex);
+      CTX->InvalidateGuestCodeRange(Base, Size);
     }
-
-    return Base;
   }
   else {
+    // Threads allocate from their own shard so they don't wait on each other
+    Offset = MMapAllocator ? MMapAllocator->Allocate(Size, Thread->State.ThreadManager.GetTID()) : 0;
+    if (Offset == 0) {
+      LogMan::Msg::D("uhoh, mmap failed\n");
+      return -ENOMEM;
+    }
+    LogMan::Throw::A(Offset + Size <= CTX->MemoryMapper.GetSHMSize(), "mmap offset 0x%lx is outside of guest memory", Offset);
+
     // If we are running unified memory then we want to be after our base
     // This makes code page loading less of a burden
-    Base = CTX->MemoryMapper.GetBaseOffset<uint64_t>(LastMMAP);
+    Base = GuestBase + Offset;
+  }
 
-    void *HostPtr = reinterpret_cast<void*>(Base);
-    if (fd != -1) {
-      auto Name = FM.FindFDName(fd);
-      if (Name) {
-        LogMan::Msg::D("Mapping File to [0x%lx, 0x%lx) -> '%s' -> %p", Base, Base + Size, Name->c_str(), HostPtr);
-      }
+  void *HostPtr = reinterpret_cast<void*>(Base - GuestBase + MemoryBase);
+  if (fd != -1) {
+    auto Name = FM.FindFDName(fd);
+    if (Name) {
+      LogMan::Msg::D("Mapping File to [0x%lx, 0x%lx) -> '%s' -> %p", Base, Base + Size, Name->c_str(), HostPtr);
     }
+  }
 
-    void *Res{};
+  void *Res = mmap(HostPtr, length, prot, flags | MAP_FIXED, fd, offset);
+  if (Res == MAP_FAILED) {
+    int Error = errno;
     if (fd != -1) {
-      Res = mmap(HostPtr, length, prot, flags | MAP_FIXED, fd, offset);
-      if (Res == MAP_FAILED) {
-        perror(nullptr);
-        LogMan::Msg::A("Couldn't map file to %p. error %d(%s)\n", HostPtr, errno, strerror(errno));
-      }
-      else {
-      }
+      LogMan::Msg::A("Couldn't map file to %p. error %d(%s)\n", HostPtr, Error, strerror(Error));
     }
-    else {
-      Res = mmap(HostPtr, length, prot, flags | MAP_FIXED, fd, offset);
+    if (!(flags & MAP_FIXED)) {
+      MMapAllocator->Free(Offset, Size);
     }
+    return -Error;
+  }
 
-    if (Res == MAP_FAILED) {
-      return -errno;
-    }
+  CTX->CodePages->SetGuestProtection(Base, Size, prot);
 
-    LastMMAP += Size;
-    return Base;
+  // Heaps and arenas, anything smaller can't hold a huge page anyway
+  if (CTX->Config.HugePages && (flags & (MAP_ANONYMOUS | MAP_HUGETLB)) == MAP_ANONYMOUS && length >= FEXCore::Memory::HUGE_PAGE_SIZE) {
+    FEXCore::Memory::AdviseHugePages(HostPtr, length);
   }
+
+  return Base;
+}
+
+uint64_t SyscallHandler::HandleMUNMAP(FEXCore::Core::InternalThreadState *Thread, void *addr, size_t length) {
+  uint64_t MemoryBase = CTX->MemoryMapper.GetBaseOffset<uint64_t>(0);
+  uint64_t GuestBase = CTX->Config.UnifiedMemory ? MemoryBase : 0;
+  uint64_t Base = reinterpret_cast<uint64_t>(addr);
+
+  if (::munmap(reinterpret_cast<void*>(Base - GuestBase + MemoryBase), length) == -1) {
+    return -errno;
+  }
+
+  CTX->CodePages->SetGuestProtection(Base, length, -1);
+
+  // The host range is already gone, the allocator can hand it out again
+  if (MMapAllocator) {
+    MMapAllocator->Free(Base - GuestBase, AlignUp(length, PAGE_SIZE));
+  }
+  return 0;
 }
 
 void SyscallHandler::DefaultProgramBreak(FEXCore::Core::InternalThreadState *Thread, uint64_t Addr) {
@@ -152,13 +198,157 @@ SyscallHandler *CreateHandler(OperatingMode Mode, FEXCore::Context::Context *ctx
   return nullptr;
 }
 
-uint64_t HandleSyscall(SyscallHandler *Handler, FEXCore::Core::InternalThreadState *Thread, FEXCore::HLE::SyscallArguments *Args) {
-  uint64_t Result{};
-  Result = Handler->HandleSyscall(Thread, Args);
-#ifdef DEBUG_STRACE
-  Handler->Strace(Args, Result);
-#endif
+// Reads guest memory without faulting, a bad pointer is for the syscall to report
+static bool ReadGuestMemory(void *Dst, uint64_t Src, size_t Size) {
+  iovec Local {Dst, Size};
+  iovec Remote {reinterpret_cast<void*>(Src), Size};
+  return process_vm_readv(getpid(), &Local, 1, &Remote, 1, 0) == static_cast<ssize_t>(Size);
+}
+
+void SyscallHandler::ReleaseCodePagesForOutputs(FEXCore::HLE::SyscallArguments const *Args) {
+  // Guest pages are only write protected when guest addresses are host addresses
+  if (Args->Argument[0] >= Definitions.size() || !CTX->Config.UnifiedMemory) {
+    return;
+  }
+
+  auto &Def = Definitions[Args->Argument[0]];
+  if (Def.NumOutputs == 0) {
+    return;
+  }
+
+  std::vector<std::pair<uint64_t, uint64_t>> Ranges;
+  auto AddRange = [&Ranges](uint64_t Address, uint64_t Length) {
+    if (Address && Length) {
+      Ranges.emplace_back(Address, std::min<uint64_t>(Length, ~0ULL - Address));
+    }
+  };
+
+  auto AddIOVecs = [&](uint64_t Address, uint64_t Count) {
+    std::vector<iovec> IOVecs(std::min<uint64_t>(Count, IOV_MAX));
+    if (ReadGuestMemory(IOVecs.data(), Address, IOVecs.size() * sizeof(iovec))) {
+      for (auto const &IOVec : IOVecs) {
+        AddRange(reinterpret_cast<uint64_t>(IOVec.iov_base), IOVec.iov_len);
+      }
+    }
+  };
+
+  for (uint8_t i = 0; i < Def.NumOutputs; ++i) {
+    auto const &Output = Def.Outputs[i];
+    uint64_t Address = Args->Argument[Output.Arg];
+    switch (Output.Kind) {
+    case SyscallOutput::OUTPUT_FIXED:
+      AddRange(Address, Output.Size);
+      break;
+    case SyscallOutput::OUTPUT_ARRAY: {
+      uint64_t Length;
+      if (__builtin_mul_overflow(Args->Argument[Output.SizeArg], Output.Size, &Length)) {
+        Length = ~0ULL;
+      }
+      AddRange(Address, Length);
+      break;
+    }
+    case SyscallOutput::OUTPUT_LENGTH: {
+      socklen_t Length;
+      if (Args->Argument[Output.SizeArg] && ReadGuestMemory(&Length, Args->Argument[Output.SizeArg], sizeof(Length))) {
+        AddRange(Address, Length);
+      }
+      break;
+    }
+    case SyscallOutput::OUTPUT_IOVEC:
+      AddIOVecs(Address, Args->Argument[Output.SizeArg]);
+      break;
+    case SyscallOutput::OUTPUT_MSGHDR: {
+      msghdr Header;
+      if (Address && ReadGuestMemory(&Header, Address, sizeof(Header))) {
+        AddRange(Address, sizeof(Header));
+        AddRange(reinterpret_cast<uint64_t>(Header.msg_name), Header.msg_namelen);
+        AddRange(reinterpret_cast<uint64_t>(Header.msg_control), Header.msg_controllen);
+        AddIOVecs(reinterpret_cast<uint64_t>(Header.msg_iov), Header.msg_iovlen);
+      }
+      break;
+    }
+    }
+  }
+
+  // Almost never anything to do, check before holding off every other thread's compilation
+  {
+    std::shared_lock<std::shared_mutex> lk(CTX->CodeCacheMutex);
+    if (std::none_of(Ranges.begin(), Ranges.end(), [this](auto const &Range) {
+        return CTX->CodePages->IsWriteProtected(Range.first, Range.second); })) {
+      return;
+    }
+  }
+
+  std::unique_lock<std::shared_mutex> lk(CTX->CodeCacheMutex);
+  for (auto const &Range : Ranges) {
+    CTX->InvalidateGuestCodeRange(Range.first, Range.second);
+  }
+}
+
+bool SyscallHandler::ReleaseCodePagesForUnknownOutputs(FEXCore::HLE::SyscallArguments const *Args) {
+  if (Args->Argument[0] >= Definitions.size() || !CTX->Config.UnifiedMemory) {
+    return false;
+  }
+
+  auto &Def = Definitions[Args->Argument[0]];
+  if (!Def.UnknownOutputs) {
+    return false;
+  }
+
+  // Anything that looks like a pointer might be one, the page it starts on is the one the kernel most likely tripped over
+  std::vector<uint64_t> Pages;
+  for (uint8_t i = 1; i <= Def.NumArgs; ++i) {
+    if (Args->Argument[i] >= PAGE_SIZE) {
+      Pages.emplace_back(Args->Argument[i] & ~(PAGE_SIZE - 1));
+    }
+  }
+
+  {
+    std::shared_lock<std::shared_mutex> lk(CTX->CodeCacheMutex);
+    if (std::none_of(Pages.begin(), Pages.end(), [this](uint64_t Page) {
+        return CTX->CodePages->IsWriteProtected(Page, PAGE_SIZE); })) {
+      return false;
+    }
+  }
+
+  std::unique_lock<std::shared_mutex> lk(CTX->CodeCacheMutex);
+  for (auto Page : Pages) {
+    CTX->InvalidateGuestCodeRange(Page, PAGE_SIZE);
+  }
+  return true;
+}
+
+static uint64_t DispatchSyscall(SyscallHandler *Handler, FEXCore::Core::InternalThreadState *Thread, FEXCore::HLE::SyscallArguments *Args) {
+  Handler->ReleaseCodePagesForOutputs(Args);
+  uint64_t Result = Handler->HandleSyscall(Thread, Args);
+
+  // The kernel fails writes to pages we protected with EFAULT, syscalls that didn't say where they write get one retry
+  if (Result == static_cast<uint64_t>(-EFAULT) && Handler->ReleaseCodePagesForUnknownOutputs(Args)) {
+    Result = Handler->HandleSyscall(Thread, Args);
+  }
+  return Result;
+}
+
+static uint64_t DispatchTracedSyscall(SyscallHandler *Handler, FEXCore::Core::InternalThreadState *Thread, FEXCore::HLE::SyscallArguments *Args) {
+  auto Begin = std::chrono::steady_clock::now();
+  uint64_t Result = DispatchSyscall(Handler, Thread, Args);
+  auto End = std::chrono::steady_clock::now();
+
+  Handler->Tracer.Record(Thread, Args, Result,
+    std::chrono::duration_cast<std::chrono::nanoseconds>(Begin.time_since_epoch()).count(),
+    std::chrono::duration_cast<std::chrono::nanoseconds>(End - Begin).count());
   return Result;
 }
 
+uint64_t HandleSyscall(SyscallHandler *Handler, FEXCore::Core::InternalThreadState *Thread, FEXCore::HLE::SyscallArguments *Args) {
+  if (Handler->Tracer.IsEnabled()) {
+    return DispatchTracedSyscall(Handler, Thread, Args);
+  }
+  return DispatchSyscall(Handler, Thread, Args);
+}
+
+void ReleaseCodePagesForOutputs(SyscallHandler *Handler, FEXCore::HLE::SyscallArguments const *Args) {
+  Handler->ReleaseCodePagesForOutputs(Args);
+}
+
 }
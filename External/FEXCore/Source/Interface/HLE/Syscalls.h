@@ -1,10 +1,13 @@
 #pragma once
 
 #include "Interface/HLE/FileManagement.h"
+#include "Interface/HLE/SyscallTracer.h"
+#include "Interface/Memory/VMAAllocator.h"
 #include <FEXCore/HLE/SyscallHandler.h>
 
 #include <atomic>
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <unordered_map>
 
@@ -36,7 +39,6 @@ namespace FEXCore {
     __kernel_long_t   __unused[3];
   };
 
-// #define DEBUG_STRACE
 class SyscallHandler {
 public:
   SyscallHandler(FEXCore::Context::Context *ctx);
@@ -57,6 +59,25 @@ public:
   using SyscallPtrArg5 = uint64_t(*)(FEXCore::Core::InternalThreadState *Thread, uint64_t, uint64_t, uint64_t, uint64_t, uint64_t);
   using SyscallPtrArg6 = uint64_t(*)(FEXCore::Core::InternalThreadState *Thread, uint64_t, uint64_t, uint64_t, uint64_t, uint64_t, uint64_t);
 
+  /**
+   * @brief Guest memory a syscall writes to through one of its arguments
+   */
+  struct SyscallOutput {
+    enum Type : uint8_t {
+      OUTPUT_FIXED,    ///< Size bytes at the pointer
+      OUTPUT_ARRAY,    ///< SizeArg elements of Size bytes at the pointer
+      OUTPUT_LENGTH,   ///< As many bytes as the socklen_t SizeArg points to says
+      OUTPUT_IOVEC,    ///< Every buffer of the SizeArg iovecs at the pointer
+      OUTPUT_MSGHDR,   ///< Name, buffers and control data of the msghdr at the pointer
+    };
+    Type Kind;
+    uint8_t Arg; ///< Argument holding the pointer, 1 is the first syscall argument
+    uint8_t SizeArg;
+    uint32_t Size;
+  };
+
+  constexpr static size_t MAX_SYSCALL_OUTPUTS = 4;
+
   struct SyscallFunctionDefinition {
     uint8_t NumArgs;
     union {
@@ -69,6 +90,9 @@ public:
       SyscallPtrArg5 Ptr5;
       SyscallPtrArg6 Ptr6;
     };
+    uint8_t NumOutputs;
+    SyscallOutput Outputs[MAX_SYSCALL_OUTPUTS];
+    bool UnknownOutputs; ///< Writes to guest memory the arguments alone don't describe, ioctl and friends
   };
 
   SyscallFunctionDefinition const *GetDefinition(uint64_t Syscall) {
@@ -76,26 +100,61 @@ public:
   }
 
   uint64_t HandleBRK(FEXCore::Core::InternalThreadState *Thread, void *Addr);
+  /**
+   * @brief Guest mmap, the allocator picks the address of anything that isn't fixed
+   *
+   * Mappings always land in guest memory, so they work without unified memory too
+   */
   uint64_t HandleMMAP(FEXCore::Core::InternalThreadState *Thread, void *addr, size_t length, int prot, int flags, int fd, off_t offset);
+  /**
+   * @brief Guest munmap, the range goes back to the allocator
+   *
+   * Caller must hold CodeCacheMutex and have thrown out the code in the range
+   */
+  uint64_t HandleMUNMAP(FEXCore::Core::InternalThreadState *Thread, void *addr, size_t length);
+
+  /**
+   * @brief Sizes the mmap window to the guest memory region, called once it exists
+   *
+   * Guest memory too small to hold the window leaves HandleMMAP only able to do fixed mappings
+   */
+  void InitializeMMapAllocator(uint64_t GuestMemorySize);
+
+  /**
+   * @brief Keeps mmap from handing out guest memory that got mapped for the guest without it
+   */
+  void ReserveGuestMemory(uint64_t Offset, uint64_t Size);
+
+  /**
+   * @brief Makes the guest memory the syscall in Args writes to writable before it runs
+   *
+   * The kernel can't write through our write protection on guest code pages, it fails with EFAULT instead
+   * Code decoded from anything in the syscall's Outputs gets thrown out, which drops the protection
+   */
+  void ReleaseCodePagesForOutputs(FEXCore::HLE::SyscallArguments const *Args);
+
+  /**
+   * @brief Throws out code on the pages the pointer arguments of a syscall with UnknownOutputs point at
+   *
+   * Called once the syscall failed with EFAULT, returns true if there was any and the syscall is worth retrying
+   * Never used from backends calling handlers directly, syscalls with UnknownOutputs always go through HandleSyscall
+   */
+  bool ReleaseCodePagesForUnknownOutputs(FEXCore::HLE::SyscallArguments const *Args);
 
   FileManager FM;
-
-#ifdef DEBUG_STRACE
-  virtual void Strace(FEXCore::HLE::SyscallArguments *Args, uint64_t Ret) = 0;
-#endif
+  FEXCore::HLE::SyscallTracer Tracer;
 
 protected:
   std::vector<SyscallFunctionDefinition> Definitions;
-  std::mutex MMapMutex;
 
   // BRK management
+  std::mutex BRKMutex;
   uint64_t DataSpace {};
   uint64_t DataSpaceSize {};
   uint64_t DefaultProgramBreakAddress {};
 
-  // MMap management
-  uint64_t LastMMAP = 0x1'0000'0000;
-  uint64_t ENDMMAP  = 0x2'0000'0000;
+  // MMap management, guest offsets of mappings we pick the address for
+  std::unique_ptr<FEXCore::Memory::VMAAllocator> MMapAllocator;
 
 private:
 
@@ -112,6 +171,8 @@ enum OperatingMode {
 
 SyscallHandler *CreateHandler(OperatingMode Mode, FEXCore::Context::Context *ctx);
 uint64_t HandleSyscall(SyscallHandler *Handler, FEXCore::Core::InternalThreadState *Thread, FEXCore::HLE::SyscallArguments *Args);
+// For backends that call a syscall's handler directly, has to be called first for syscalls with outputs
+void ReleaseCodePagesForOutputs(SyscallHandler *Handler, FEXCore::HLE::SyscallArguments const *Args);
 
 #define SYSCALL_ERRNO() do { if (Result == -1) return -errno; return Result; } while(0)
 #define SYSCALL_ERRNO_NULL() do { if (Result == 0) return -errno; return Result; } while(0)
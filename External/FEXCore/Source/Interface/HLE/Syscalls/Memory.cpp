@@ -1,7 +1,10 @@
 #include "Interface/HLE/Syscalls.h"
 #include "Interface/Context/Context.h"
+#include "Interface/Core/CodePageTracker.h"
 #include "Interface/Core/InternalThreadState.h"
 
+#include <mutex>
+#include <shared_mutex>
 #include <stddef.h>
 #include <stdint.h>
 #include <sys/mman.h>
@@ -10,25 +13,59 @@ namespace FEXCore::Core {
 struct InternalThreadState;
 }
 
-#define MEM_PASSTHROUGH
+namespace {
+  // Mapping changes hold off compilation so nothing gets protected with a stale guest protection
+  // Almost none of them touch code, only throwing code out needs to hold off every other thread's lookups too
+  class MappingChangeLock final {
+  public:
+    explicit MappingChangeLock(FEXCore::Context::Context *CTX)
+      : CTX {CTX}
+      , SharedLock {CTX->CodeCacheMutex} {
+    }
+
+    void InvalidateGuestCodeRange(uint64_t Start, uint64_t Length) {
+      if (!UniqueLock.owns_lock()) {
+        if (!CTX->CodePages->HasCode(Start, Length)) {
+          return;
+        }
+
+        // Nothing can compile in the meantime that isn't thrown out below
+        SharedLock.unlock();
+        UniqueLock = std::unique_lock<std::shared_mutex>(CTX->CodeCacheMutex);
+      }
+
+      CTX->InvalidateGuestCodeRange(Start, Length);
+    }
+
+  private:
+    FEXCore::Context::Context *CTX;
+    std::shared_lock<std::shared_mutex> SharedLock;
+    std::unique_lock<std::shared_mutex> UniqueLock;
+  };
+}
+
 namespace FEXCore::HLE {
   uint64_t Mmap(FEXCore::Core::InternalThreadState *Thread, void *addr, size_t length, int prot, int flags, int fd, off_t offset) {
-#ifdef MEM_PASSTHROUGH
-    uint64_t Result = reinterpret_cast<uint64_t>(::mmap(addr, length, prot, flags, fd, offset));
-    SYSCALL_ERRNO();
-#else
     return Thread->CTX->SyscallHandler->HandleMMAP(Thread, addr, length, prot, flags, fd, offset);
-#endif
   }
 
   uint64_t Mprotect(FEXCore::Core::InternalThreadState *Thread, void *addr, size_t len, int prot) {
+    // Code in the range is thrown out, which also drops our write protection before the guest's gets applied
+    MappingChangeLock lk(Thread->CTX);
+    lk.InvalidateGuestCodeRange(reinterpret_cast<uint64_t>(addr), len);
+
     uint64_t Result = ::mprotect(addr, len, prot);
+    if (Result != ~0ULL) {
+      Thread->CTX->CodePages->SetGuestProtection(reinterpret_cast<uint64_t>(addr), len, prot);
+    }
     SYSCALL_ERRNO();
   }
 
   uint64_t Munmap(FEXCore::Core::InternalThreadState *Thread, void *addr, size_t length) {
-    uint64_t Result = ::munmap(addr, length);
-    SYSCALL_ERRNO();
+    MappingChangeLock lk(Thread->CTX);
+    lk.InvalidateGuestCodeRange(reinterpret_cast<uint64_t>(addr), length);
+
+    return Thread->CTX->SyscallHandler->HandleMUNMAP(Thread, addr, length);
   }
 
   uint64_t Brk(FEXCore::Core::InternalThreadState *Thread, void *addr) {
@@ -37,7 +74,20 @@ namespace FEXCore::HLE {
   }
 
   uint64_t Mremap(FEXCore::Core::InternalThreadState *Thread, void *old_address, size_t old_size, size_t new_size, int flags, void *new_address) {
+    // The old range's code goes away even if it only moved, blocks are keyed on where they were decoded from
+    MappingChangeLock lk(Thread->CTX);
+    uint64_t OldAddress = reinterpret_cast<uint64_t>(old_address);
+    lk.InvalidateGuestCodeRange(OldAddress, old_size);
+    if (flags & MREMAP_FIXED) {
+      lk.InvalidateGuestCodeRange(reinterpret_cast<uint64_t>(new_address), new_size);
+    }
+    int Prot = Thread->CTX->CodePages->GetGuestProtection(OldAddress);
+
     uint64_t Result = reinterpret_cast<uint64_t>(::mremap(old_address, old_size, new_size, flags, new_address));
+    if (Result != ~0ULL) {
+      Thread->CTX->CodePages->SetGuestProtection(OldAddress, old_size, -1);
+      Thread->CTX->CodePages->SetGuestProtection(Result, new_size, Prot);
+    }
     SYSCALL_ERRNO();
   }
 
@@ -87,4 +87,9 @@ namespace FEXCore::HLE {
     uint64_t Result = ::syscall(SYS_sched_getattr, pid, attr, size, flags);
     SYSCALL_ERRNO();
   }
+
+  uint64_t Getcpu(FEXCore::Core::InternalThreadState *Thread, unsigned *cpu, unsigned *node, void *tcache) {
+    uint64_t Result = ::syscall(SYS_getcpu, cpu, node, tcache);
+    SYSCALL_ERRNO();
+  }
 }
@@ -21,4 +21,5 @@ namespace FEXCore::HLE {
   uint64_t Sched_Getaffinity(FEXCore::Core::InternalThreadState *Thread, pid_t pid, size_t cpusetsize, unsigned long *mask);
   uint64_t Sched_Setattr(FEXCore::Core::InternalThreadState *Thread, pid_t pid, struct sched_attr *attr, unsigned int flags);
   uint64_t Sched_Getattr(FEXCore::Core::InternalThreadState *Thread, pid_t pid, struct sched_attr *attr, unsigned int size, unsigned int flags);
+  uint64_t Getcpu(FEXCore::Core::InternalThreadState *Thread, unsigned *cpu, unsigned *node, void *tcache);
 }
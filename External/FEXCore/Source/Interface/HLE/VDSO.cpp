@@ -0,0 +1,145 @@
+#include "Interface/HLE/VDSO.h"
+#include "Interface/HLE/x64/Syscalls.h"
+
+#include <array>
+#include <cstring>
+#include <elf.h>
+#include <string>
+
+namespace FEXCore::HLE {
+  struct VDSOSymbol {
+    char const *Name;
+    uint8_t Binding;
+    FEXCore::HLE::x64::Syscalls Syscall;
+  };
+
+  // Same exports as the kernel, libc looks up the __vdso_ names and programs can use the weak ones
+  constexpr std::array<VDSOSymbol, 10> Symbols = {{
+    {"__vdso_clock_gettime", STB_GLOBAL, FEXCore::HLE::x64::SYSCALL_CLOCK_GETTIME},
+    {"clock_gettime",        STB_WEAK,   FEXCore::HLE::x64::SYSCALL_CLOCK_GETTIME},
+    {"__vdso_gettimeofday",  STB_GLOBAL, FEXCore::HLE::x64::SYSCALL_GETTIMEOFDAY},
+    {"gettimeofday",         STB_WEAK,   FEXCore::HLE::x64::SYSCALL_GETTIMEOFDAY},
+    {"__vdso_time",          STB_GLOBAL, FEXCore::HLE::x64::SYSCALL_TIME},
+    {"time",                 STB_WEAK,   FEXCore::HLE::x64::SYSCALL_TIME},
+    {"__vdso_getcpu",        STB_GLOBAL, FEXCore::HLE::x64::SYSCALL_GETCPU},
+    {"getcpu",               STB_WEAK,   FEXCore::HLE::x64::SYSCALL_GETCPU},
+    {"__vdso_clock_getres",  STB_GLOBAL, FEXCore::HLE::x64::SYSCALL_CLOCK_GETRES},
+    {"clock_getres",         STB_WEAK,   FEXCore::HLE::x64::SYSCALL_CLOCK_GETRES},
+  }};
+
+  constexpr char SOName[] = "linux-vdso.so.1";
+
+  // mov eax, imm32; syscall; ret
+  // The guest arguments are already where the syscall wants them, none of these take more than three
+  constexpr size_t EntrySize = 16;
+  constexpr std::array<uint8_t, 8> EntryCode = {0xb8, 0, 0, 0, 0, 0x0f, 0x05, 0xc3};
+
+  std::vector<uint8_t> GenerateVDSO() {
+    // [Ehdr][PT_LOAD, PT_DYNAMIC][Dynamic][Hash][Symbols][Strings][Code]
+    // Nothing needs section headers, the dynamic loader only looks at the program headers
+    constexpr size_t NumSymbols = Symbols.size() + 1;
+    constexpr size_t NumDynamic = 7;
+
+    std::string Strings(1, '\0');
+    auto AddString = [&Strings](char const *Str) -> uint32_t {
+      uint32_t Offset = Strings.size();
+      Strings.append(Str);
+      Strings.push_back('\0');
+      return Offset;
+    };
+    uint32_t SONameOffset = AddString(SOName);
+
+    size_t PhdrOffset = sizeof(Elf64_Ehdr);
+    size_t DynamicOffset = PhdrOffset + sizeof(Elf64_Phdr) * 2;
+    size_t HashOffset = DynamicOffset + sizeof(Elf64_Dyn) * NumDynamic;
+    // nbucket, nchain, one bucket and a chain entry per symbol
+    size_t HashSize = sizeof(uint32_t) * (3 + NumSymbols);
+    size_t SymbolOffset = (HashOffset + HashSize + 7) & ~7ULL;
+    size_t StringOffset = SymbolOffset + sizeof(Elf64_Sym) * NumSymbols;
+
+    std::array<uint32_t, NumSymbols> NameOffsets{};
+    for (size_t i = 0; i < Symbols.size(); ++i) {
+      NameOffsets[i + 1] = AddString(Symbols[i].Name);
+    }
+
+    size_t CodeOffset = (StringOffset + Strings.size() + EntrySize - 1) & ~(EntrySize - 1);
+    size_t ImageSize = CodeOffset + EntrySize * Symbols.size();
+
+    std::vector<uint8_t> Image(ImageSize);
+    uint8_t *Data = Image.data();
+
+    auto Header = reinterpret_cast<Elf64_Ehdr*>(Data);
+    memcpy(Header->e_ident, ELFMAG, SELFMAG);
+    Header->e_ident[EI_CLASS] = ELFCLASS64;
+    Header->e_ident[EI_DATA] = ELFDATA2LSB;
+    Header->e_ident[EI_VERSION] = EV_CURRENT;
+    Header->e_ident[EI_OSABI] = ELFOSABI_SYSV;
+    Header->e_type = ET_DYN;
+    Header->e_machine = EM_X86_64;
+    Header->e_version = EV_CURRENT;
+    Header->e_phoff = PhdrOffset;
+    Header->e_ehsize = sizeof(Elf64_Ehdr);
+    Header->e_phentsize = sizeof(Elf64_Phdr);
+    Header->e_phnum = 2;
+    Header->e_shentsize = sizeof(Elf64_Shdr);
+    Header->e_shstrndx = SHN_UNDEF;
+
+    // Linked at zero, the loader relocates everything by where it finds the image
+    auto Phdrs = reinterpret_cast<Elf64_Phdr*>(Data + PhdrOffset);
+    Phdrs[0].p_type = PT_LOAD;
+    Phdrs[0].p_flags = PF_R | PF_X;
+    Phdrs[0].p_filesz = ImageSize;
+    Phdrs[0].p_memsz = ImageSize;
+    Phdrs[0].p_align = 0x1000;
+
+    Phdrs[1].p_type = PT_DYNAMIC;
+    Phdrs[1].p_flags = PF_R;
+    Phdrs[1].p_offset = DynamicOffset;
+    Phdrs[1].p_vaddr = DynamicOffset;
+    Phdrs[1].p_paddr = DynamicOffset;
+    Phdrs[1].p_filesz = sizeof(Elf64_Dyn) * NumDynamic;
+    Phdrs[1].p_memsz = sizeof(Elf64_Dyn) * NumDynamic;
+    Phdrs[1].p_align = alignof(Elf64_Dyn);
+
+    auto Dynamic = reinterpret_cast<Elf64_Dyn*>(Data + DynamicOffset);
+    Dynamic[0] = {DT_HASH, {HashOffset}};
+    Dynamic[1] = {DT_STRTAB, {StringOffset}};
+    Dynamic[2] = {DT_SYMTAB, {SymbolOffset}};
+    Dynamic[3] = {DT_STRSZ, {Strings.size()}};
+    Dynamic[4] = {DT_SYMENT, {sizeof(Elf64_Sym)}};
+    Dynamic[5] = {DT_SONAME, {SONameOffset}};
+    Dynamic[6] = {DT_NULL, {0}};
+
+    // A single bucket chaining through every symbol, there are few enough that hashing wouldn't gain anything
+    auto Hash = reinterpret_cast<uint32_t*>(Data + HashOffset);
+    Hash[0] = 1;
+    Hash[1] = NumSymbols;
+    Hash[2] = 1;
+    uint32_t *Chain = &Hash[3];
+    for (size_t i = 1; i < NumSymbols; ++i) {
+      Chain[i] = (i + 1) < NumSymbols ? i + 1 : STN_UNDEF;
+    }
+
+    auto Syms = reinterpret_cast<Elf64_Sym*>(Data + SymbolOffset);
+    for (size_t i = 0; i < Symbols.size(); ++i) {
+      size_t EntryOffset = CodeOffset + EntrySize * i;
+      auto &Sym = Syms[i + 1];
+      Sym.st_name = NameOffsets[i + 1];
+      Sym.st_info = ELF64_ST_INFO(Symbols[i].Binding, STT_FUNC);
+      Sym.st_other = STV_DEFAULT;
+      // Anything other than SHN_UNDEF or SHN_ABS, there aren't any sections to point at
+      Sym.st_shndx = 1;
+      Sym.st_value = EntryOffset;
+      Sym.st_size = EntryCode.size();
+
+      uint32_t Syscall = Symbols[i].Syscall;
+      memset(Data + EntryOffset, 0xcc, EntrySize);
+      memcpy(Data + EntryOffset, EntryCode.data(), EntryCode.size());
+      memcpy(Data + EntryOffset + 1, &Syscall, sizeof(Syscall));
+    }
+
+    memcpy(Data + StringOffset, Strings.data(), Strings.size());
+
+    return Image;
+  }
+}
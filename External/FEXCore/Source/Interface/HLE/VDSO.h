@@ -0,0 +1,13 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace FEXCore::HLE {
+  /**
+   * @brief Builds the vDSO image that gets mapped in to the guest
+   *
+   * A position independent ELF shared object exporting the same symbols as the kernel's x86-64 vDSO.
+   * Every entry point is a syscall with a constant number, which the JIT lowers to a direct call in to its handler.
+   */
+  std::vector<uint8_t> GenerateVDSO();
+}
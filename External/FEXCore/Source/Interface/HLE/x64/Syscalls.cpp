@@ -19,6 +19,21 @@
 
 #include "LogManager.h"
 
+#include <poll.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/select.h>
+#include <sys/shm.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/sysinfo.h>
+#include <sys/time.h>
+#include <sys/utsname.h>
+#include <sys/vfs.h>
+#include <time.h>
+
 namespace {
   uint64_t Unimplemented(FEXCore::Core::InternalThreadState *Thread) {
     LogMan::Msg::A("Unhandled system call");
@@ -45,654 +60,10 @@ public:
   // In the case that the syscall doesn't hit the optimized path then we still need to go here
   uint64_t HandleSyscall(FEXCore::Core::InternalThreadState *Thread, FEXCore::HLE::SyscallArguments *Args) override;
 
-#ifdef DEBUG_STRACE
-  void Strace(FEXCore::HLE::SyscallArguments *Args, uint64_t Ret) override;
-#endif
-
 private:
   void RegisterSyscallHandlers();
 };
 
-#ifdef DEBUG_STRACE
-void x64SyscallHandler::Strace(FEXCore::HLE::SyscallArguments *Args, uint64_t Ret) {
-  switch (Args->Argument[0]) {
-  case SYSCALL_BRK: LogMan::Msg::D("brk(%p)                               = 0x%lx", Args->Argument[1], Ret); break;
-  case SYSCALL_ACCESS:
-    LogMan::Msg::D("access(\"%s\", %d) = %ld", reinterpret_cast<char const*>(Args->Argument[1]), Args->Argument[2], Ret);
-    break;
-  case SYSCALL_PIPE:
-    LogMan::Msg::D("pipe({...}) = %ld", Ret);
-    break;
-  case SYSCALL_SELECT:
-    LogMan::Msg::D("select(%ld, 0x%lx, 0x%lx, 0x%lx, 0x%lx) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Args->Argument[3],
-      Args->Argument[4],
-      Args->Argument[5],
-      Ret);
-    break;
-  case SYSCALL_SCHED_YIELD:
-    LogMan::Msg::D("sched_yield() = %ld",
-      Ret);
-    break;
-  case SYSCALL_MREMAP:
-    LogMan::Msg::D("mremap(0x%lx, 0x%lx, 0x%lx, 0x%lx, 0x%lx) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Args->Argument[3],
-      Args->Argument[4],
-      Args->Argument[5],
-      Ret);
-    break;
-  case SYSCALL_MINCORE:
-    LogMan::Msg::D("mincore(0x%lx, 0x%lx, 0x%lx) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Args->Argument[3],
-      Ret);
-    break;
-  case SYSCALL_MADVISE:
-    LogMan::Msg::D("madvise(0x%lx, 0x%lx, 0x%lx) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Args->Argument[3],
-      Ret);
-    break;
-  case SYSCALL_SHMGET:
-    LogMan::Msg::D("shmget(0x%lx, 0x%lx, 0x%lx) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Args->Argument[3],
-      Ret);
-    break;
-  case SYSCALL_SHMAT:
-    LogMan::Msg::D("shmat(0x%lx, 0x%lx, 0x%lx) = %lx",
-      Args->Argument[1],
-      Args->Argument[2],
-      Args->Argument[3],
-      Ret);
-    break;
-  case SYSCALL_SHMCTL:
-    LogMan::Msg::D("shmctl(0x%lx, 0x%lx, 0x%lx) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Args->Argument[3],
-      Ret);
-    break;
-  case SYSCALL_DUP:
-    LogMan::Msg::D("dup(0x%lx) = %ld",
-      Args->Argument[1],
-      Ret);
-    break;
-  case SYSCALL_DUP2:
-    LogMan::Msg::D("dup2(0x%lx, 0x%lx) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Ret);
-    break;
-  case SYSCALL_NANOSLEEP:
-    LogMan::Msg::D("nanosleep(0x%ld, 0x%lx) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Ret);
-    break;
-  case SYSCALL_GETITIMER:
-    LogMan::Msg::D("getitimer(0x%ld, 0x%lx) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Ret);
-    break;
-  case SYSCALL_ALARM:
-    LogMan::Msg::D("alarm(%ld) = %ld",
-      Args->Argument[1],
-      Ret);
-    break;
-  case SYSCALL_SETITIMER:
-    LogMan::Msg::D("setitimer(0x%ld, 0x%lx) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Ret);
-    break;
-  case SYSCALL_OPENAT:
-    LogMan::Msg::D("openat(%ld, \"%s\", %d) = %ld", Args->Argument[1], reinterpret_cast<char const*>(Args->Argument[2]), Args->Argument[3], Ret);
-    break;
-  case SYSCALL_NEWFSTATAT:
-    LogMan::Msg::D("newfstatat(%ld, \"%s\", %p, 0x%lx) = %ld",
-      Args->Argument[1],
-      reinterpret_cast<char const*>(Args->Argument[2]),
-      Args->Argument[3],
-      Args->Argument[4],
-      Ret);
-    break;
-  case SYSCALL_READLINKAT:
-    LogMan::Msg::D("readlinkat(\"%s\") = %ld", reinterpret_cast<char const*>(Args->Argument[2]), Ret);
-    break;
-  case SYSCALL_FACCESSAT:
-    LogMan::Msg::D("faccessat(\"%s\", %d) = %ld", reinterpret_cast<char const*>(Args->Argument[2]), Args->Argument[3], Ret);
-    break;
-  case SYSCALL_STAT:
-    LogMan::Msg::D("stat(\"%s\", {...}) = %ld", reinterpret_cast<char const*>(Args->Argument[1]), Ret);
-    break;
-  case SYSCALL_FSTAT:
-    LogMan::Msg::D("fstat(%ld, {...}) = %ld", Args->Argument[1], Ret);
-    break;
-  case SYSCALL_LSTAT:
-    LogMan::Msg::D("lstat(\"%s\", {...}) = %ld", reinterpret_cast<char const*>(Args->Argument[1]), Ret);
-    break;
-  case SYSCALL_POLL:
-    LogMan::Msg::D("poll(0x%lx, %ld, %ld) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Ret);
-    break;
-  case SYSCALL_MMAP:
-    LogMan::Msg::D("mmap(%p, 0x%lx, %ld, %lx, %d, %p) = %p", Args->Argument[1], Args->Argument[2], Args->Argument[3], Args->Argument[4], static_cast<int32_t>(Args->Argument[5]), Args->Argument[6], Ret);
-    break;
-  case SYSCALL_CLOSE:
-    LogMan::Msg::D("close(%ld) = %ld", Args->Argument[1], Ret);
-    break;
-  case SYSCALL_READ:
-    LogMan::Msg::D("read(%ld, {...}, %ld) = %ld", Args->Argument[1], Args->Argument[3], Ret);
-    break;
-  case SYSCALL_SCHED_SETSCHEDULER:
-    LogMan::Msg::D("sched_setscheduler(%ld, %p, %p) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Args->Argument[3],
-      Ret);
-    break;
-  case SYSCALL_MLOCK:
-    LogMan::Msg::D("mlock(%p, 0x%lx) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Ret);
-    break;
-  case SYSCALL_MUNLOCK:
-    LogMan::Msg::D("munlock(%p, 0x%lx) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Ret);
-    break;
-  case SYSCALL_MLOCKALL:
-    LogMan::Msg::D("mlockall(0x%lx) = %ld",
-      Args->Argument[1],
-      Ret);
-    break;
-  case SYSCALL_MUNLOCKALL:
-    LogMan::Msg::D("munlockall(0x%lx) = %ld",
-      Ret);
-    break;
-  case SYSCALL_PRCTL:
-    LogMan::Msg::D("arch_prctl(%ld, %p, %p, %p, %p) = %ld",
-      Args->Argument[1], Args->Argument[2],
-      Args->Argument[3], Args->Argument[4],
-      Args->Argument[5],
-      Ret);
-    break;
-  case SYSCALL_ARCH_PRCTL:
-    LogMan::Msg::D("arch_prctl(0x%lx, %p) = %ld", Args->Argument[1], Args->Argument[2], Ret);
-    break;
-  case SYSCALL_MPROTECT:
-    LogMan::Msg::D("mprotect(%p, %ld, %ld) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Ret);
-    break;
-  case SYSCALL_MUNMAP:
-    LogMan::Msg::D("munmap(%p, %ld) = %ld", Args->Argument[1], Args->Argument[2], Ret);
-    break;
-  case SYSCALL_UNAME:
-    LogMan::Msg::D("uname ({...}) = %ld", Ret);
-    break;
-  case SYSCALL_SEMGET:
-    LogMan::Msg::D("semget(0x%lx, %d, 0x%lx) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Args->Argument[3],
-      Ret);
-    break;
-  case SYSCALL_SEMOP:
-    LogMan::Msg::D("semop(%ld, %p, %ld) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Args->Argument[3],
-      Ret);
-    break;
-  case SYSCALL_SEMCTL:
-    LogMan::Msg::D("semctl(%ld, %ld, %ld, %p) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Args->Argument[3],
-      Args->Argument[4],
-      Ret);
-    break;
-  case SYSCALL_SHMDT:
-    LogMan::Msg::D("shmdt(%p)= %ld", Args->Argument[1], Ret);
-    break;
-  case SYSCALL_FCNTL:
-    LogMan::Msg::D("fcntl (%ld, %ld, 0x%lx) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Ret);
-    break;
-  case SYSCALL_FLOCK:
-    LogMan::Msg::D("flock(%ld, %ld) = %ld", Args->Argument[1], Args->Argument[2], Ret);
-    break;
-  case SYSCALL_FSYNC:
-    LogMan::Msg::D("fsync(%ld) = %ld", Args->Argument[1], Ret);
-    break;
-  case SYSCALL_FDATASYNC:
-    LogMan::Msg::D("fdatasync(%ld) = %ld", Args->Argument[1], Ret);
-    break;
-  case SYSCALL_FTRUNCATE:
-    LogMan::Msg::D("ftruncate(%ld, 0x%lx) = %ld", Args->Argument[1], Args->Argument[2], Ret);
-    break;
-  case SYSCALL_GETDENTS:
-    LogMan::Msg::D("getdents(%ld, 0x%lx, %ld) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Ret);
-    break;
-  case SYSCALL_UMASK:
-    LogMan::Msg::D("umask(0x%lx) = %ld", Args->Argument[1], Ret);
-    break;
-  case SYSCALL_GETTIMEOFDAY:
-    LogMan::Msg::D("gettimeofday(0x%lx, 0x%lx) = %ld", Args->Argument[1], Args->Argument[2], Ret);
-    break;
-  case SYSCALL_SYSINFO:
-    LogMan::Msg::D("sysinfo(0x%lx) = %ld", Args->Argument[1], Ret);
-    break;
-  case SYSCALL_PTRACE:
-    LogMan::Msg::D("ptrace(%d, %d, 0x%lx, 0x%lx) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Args->Argument[4], Ret);
-    break;
-  case SYSCALL_GETCWD:
-    LogMan::Msg::D("getcwd(\"%s\", %ld) = %ld", reinterpret_cast<char const*>(Args->Argument[1]), Args->Argument[2], Ret);
-    break;
-  case SYSCALL_CHDIR:
-    LogMan::Msg::D("chdir(\"%s\") = %ld", reinterpret_cast<char const*>(Args->Argument[1]), Ret);
-    break;
-  case SYSCALL_RENAME:
-    LogMan::Msg::D("rename(\"%s\", \"%s\") = %ld", reinterpret_cast<char const*>(Args->Argument[1]), reinterpret_cast<char const*>(Args->Argument[2]), Ret);
-    break;
-  case SYSCALL_MKDIR:
-    LogMan::Msg::D("mkdir(\"%s\", 0x%lx) = %ld", reinterpret_cast<char const*>(Args->Argument[1]), Args->Argument[2], Ret);
-    break;
-  case SYSCALL_RMDIR:
-    LogMan::Msg::D("rmdir(\"%s\", 0x%lx) = %ld", reinterpret_cast<char const*>(Args->Argument[1]), Args->Argument[2], Ret);
-    break;
-  case SYSCALL_LINK:
-    LogMan::Msg::D("link(\"%s\", \"%s\") = %ld", reinterpret_cast<char const*>(Args->Argument[1]), reinterpret_cast<char const*>(Args->Argument[2]), Ret);
-    break;
-  case SYSCALL_UNLINK:
-    LogMan::Msg::D("unlink(\"%s\") = %ld", reinterpret_cast<char const*>(Args->Argument[1]), Ret);
-    break;
-  case SYSCALL_READLINK:
-    LogMan::Msg::D("readlink(\"%s\") = %ld", reinterpret_cast<char const*>(Args->Argument[1]), Ret);
-    break;
-  case SYSCALL_CHMOD:
-    LogMan::Msg::D("chmod(\"%s\", 0x%lx) = %ld", reinterpret_cast<char const*>(Args->Argument[1]), Args->Argument[2], Ret);
-    break;
-  case SYSCALL_FCHMOD:
-    LogMan::Msg::D("fchmod(%d, 0x%lx) = %ld", Args->Argument[1], Args->Argument[2], Ret);
-    break;
-  case SYSCALL_EXIT:
-    LogMan::Msg::D("exit(0x%lx)", Args->Argument[1]);
-    break;
-  case SYSCALL_WAIT4:
-    LogMan::Msg::D("wait4(0x%lx, 0x%lx, %ld, 0x%lx) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Args->Argument[3],
-      Args->Argument[4],
-      Ret);
-    break;
-  case SYSCALL_KILL:
-    LogMan::Msg::D("kill(0x%lx, %ld) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Ret);
-    break;
-  case SYSCALL_WRITE:
-    LogMan::Msg::D("write(%ld, %p, %ld) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Ret);
-    break;
-  case SYSCALL_WRITEV:
-    LogMan::Msg::D("writev(%ld, %p, %ld) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Ret);
-    break;
-  case SYSCALL_EXIT_GROUP:
-    LogMan::Msg::D("exit_group(0x%lx)", Args->Argument[1]);
-    break;
-  case SYSCALL_EPOLL_CTL:
-    LogMan::Msg::D("epoll_ctl(%ld, %ld, %ld, %p) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Args->Argument[3],
-      Args->Argument[4],
-      Ret);
-    break;
-  case SYSCALL_EPOLL_CREATE:
-    LogMan::Msg::D("epoll_create(%ld) = %ld", Args->Argument[1], Ret);
-    break;
-  case SYSCALL_GETDENTS64:
-    LogMan::Msg::D("getdents(%ld, 0x%lx, %ld) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Ret);
-    break;
-  case SYSCALL_FADVISE64:
-    LogMan::Msg::D("fadvise64(%ld, 0x%lx, %ld, %lx) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Args->Argument[4], Ret);
-    break;
-  case SYSCALL_SET_TID_ADDRESS:
-    LogMan::Msg::D("set_tid_address(%p) = %ld", Args->Argument[1], Ret);
-    break;
-  case SYSCALL_SEMTIMEDOP:
-    LogMan::Msg::D("semtimedop(%d, %p, %d, %p) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Args->Argument[3],
-      Args->Argument[4],
-      Ret);
-    break;
-  case SYSCALL_PPOLL:
-    LogMan::Msg::D("ppoll(%p, %d, %p, %p, %d) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Args->Argument[3],
-      Args->Argument[4],
-      Args->Argument[5],
-      Ret);
-    break;
-  case SYSCALL_SET_ROBUST_LIST:
-    LogMan::Msg::D("set_robust_list(%p, %ld) = %ld", Args->Argument[1], Args->Argument[2], Ret);
-    break;
-  case SYSCALL_GET_ROBUST_LIST:
-    LogMan::Msg::D("get_robust_list(%d, %p, %p) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Ret);
-    break;
-  case SYSCALL_EPOLL_PWAIT:
-    LogMan::Msg::D("epoll_pwait(%ld, %p, %ld, %ld) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Args->Argument[3],
-      Args->Argument[4],
-      Ret);
-    break;
-  case SYSCALL_TIMERFD_CREATE:
-    LogMan::Msg::D("timerfd_create(%lx, %lx) = %ld", Args->Argument[1], Args->Argument[2], Ret);
-    break;
-  case SYSCALL_EVENTFD:
-    LogMan::Msg::D("eventfd(%lx, %ld) = %ld", Args->Argument[1], Args->Argument[2], Ret);
-    break;
-  case SYSCALL_EPOLL_CREATE1:
-    LogMan::Msg::D("epoll_create1(%ld) = %ld", Args->Argument[1], Ret);
-    break;
-  case SYSCALL_PIPE2:
-    LogMan::Msg::D("pipe2({...}, %d) = %ld", Args->Argument[2], Ret);
-    break;
-  case SYSCALL_INOTIFY_INIT1:
-    LogMan::Msg::D("inotify_init1(%lx) = %ld", Args->Argument[1], Ret);
-    break;
-  case SYSCALL_RT_SIGACTION:
-    LogMan::Msg::D("rt_sigaction(%ld, %p, %p) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Ret);
-    break;
-  case SYSCALL_RT_SIGPROCMASK:
-    LogMan::Msg::D("rt_sigprocmask(%ld, %p, %p, %ld) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Args->Argument[4], Ret);
-    break;
-  case SYSCALL_PRLIMIT64:
-    LogMan::Msg::D("prlimit64(%ld, %ld, %p, %p) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Args->Argument[4], Ret);
-    break;
-  case SYSCALL_SENDMMSG:
-    LogMan::Msg::D("sendmmsg(%ld, 0x%lx, %ld, %ld) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Args->Argument[4], Ret);
-    break;
-  case SYSCALL_SCHED_SETATTR:
-    LogMan::Msg::D("sched_setattr(%ld, %p, 0x%lx) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Ret);
-    break;
-  case SYSCALL_SCHED_GETATTR:
-    LogMan::Msg::D("sched_getattr(%ld, %p, 0x%lx, 0x%lx) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Args->Argument[4], Ret);
-    break;
-  case SYSCALL_GETPID:
-    LogMan::Msg::D("getpid() = %ld", Ret);
-    break;
-  case SYSCALL_SOCKET:
-    LogMan::Msg::D("socket(%ld, %ld, %ld) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Ret);
-    break;
-  case SYSCALL_CONNECT:
-    LogMan::Msg::D("connect(%ld, 0x%lx, %ld) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Ret);
-    break;
-  case SYSCALL_SENDTO:
-    LogMan::Msg::D("sendto(%ld, 0x%lx, %ld, %lx, 0x%lx, %ld) = %ld",
-        Args->Argument[1],
-        Args->Argument[2],
-        Args->Argument[3],
-        Args->Argument[4],
-        Args->Argument[5],
-        Args->Argument[6],
-        Ret);
-    break;
-  case SYSCALL_RECVFROM:
-    LogMan::Msg::D("recvfrom(%ld, 0x%lx, %ld, %ld, 0x%lx, 0x%lx) = %ld",
-        Args->Argument[1],
-        Args->Argument[2],
-        Args->Argument[3],
-        Args->Argument[4],
-        Args->Argument[5],
-        Args->Argument[6],
-        Ret);
-    break;
-  case SYSCALL_SENDMSG:
-    LogMan::Msg::D("sendmsg(%ld, 0x%lx, %ld) = %ld",
-        Args->Argument[1],
-        Args->Argument[2],
-        Args->Argument[3],
-        Ret);
-    break;
-  case SYSCALL_RECVMSG:
-    LogMan::Msg::D("recvmsg(%ld, 0x%lx, %ld) = %ld",
-        Args->Argument[1],
-        Args->Argument[2],
-        Args->Argument[3],
-        Ret);
-    break;
-  case SYSCALL_SHUTDOWN:
-    LogMan::Msg::D("shutdown(%ld, %ld) = %ld", Args->Argument[1], Args->Argument[2], Ret);
-    break;
-  case SYSCALL_BIND:
-    LogMan::Msg::D("bind(%ld, %p, %ld) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Ret);
-    break;
-  case SYSCALL_LISTEN:
-    LogMan::Msg::D("listen(%ld, %ld) = %ld", Args->Argument[1], Args->Argument[2], Ret);
-    break;
-  case SYSCALL_GETSOCKNAME:
-    LogMan::Msg::D("getsockname(%ld, 0x%lx, 0x%lx) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Ret);
-    break;
-  case SYSCALL_GETPEERNAME:
-    LogMan::Msg::D("getpeername(%ld, 0x%lx, 0x%lx) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Ret);
-    break;
-  case SYSCALL_SOCKETPAIR:
-    LogMan::Msg::D("socketpair({...}) = %ld", Ret);
-    break;
-  case SYSCALL_SETSOCKOPT:
-    LogMan::Msg::D("setsockopt(%ld, %ld, %ld, 0x%lx, %ld) = %ld",
-        Args->Argument[1],
-        Args->Argument[2],
-        Args->Argument[3],
-        Args->Argument[4],
-        Args->Argument[5],
-        Ret);
-    break;
-  case SYSCALL_GETSOCKOPT:
-    LogMan::Msg::D("getsockopt(%ld, %ld, %ld, 0x%lx, 0x%lx) = %ld",
-        Args->Argument[1],
-        Args->Argument[2],
-        Args->Argument[3],
-        Args->Argument[4],
-        Args->Argument[5],
-        Ret);
-    break;
-  case SYSCALL_CLONE:
-    LogMan::Msg::I("clone(%lx,\n\t%lx,\n\t%lx,\n\t%lx,\n\t%lx,\n\t%lx,\n\t%lx)",
-        Args->Argument[1],
-        Args->Argument[2],
-        Args->Argument[3],
-        Args->Argument[4],
-        Args->Argument[5],
-        Args->Argument[6]);
-    break;
-  case SYSCALL_EXECVE:
-    LogMan::Msg::I("execve('%s', %p, %p) = %ld",
-        reinterpret_cast<char const *>(Args->Argument[1]),
-        Args->Argument[2],
-        Args->Argument[3],
-        Ret);
-    break;
-  case SYSCALL_GETUID:
-    LogMan::Msg::D("getuid() = %ld", Ret);
-    break;
-  case SYSCALL_SYSLOG:
-    LogMan::Msg::D("syslog(%ld, %p, 0x%lx) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Args->Argument[3],
-      Ret);
-    break;
-  case SYSCALL_GETGID:
-    LogMan::Msg::D("getgid() = %ld", Ret);
-    break;
-  case SYSCALL_SETUID:
-    LogMan::Msg::D("setuid(%ld) = %ld", Args->Argument[1], Ret);
-    break;
-  case SYSCALL_GETEUID:
-    LogMan::Msg::D("geteuid() = %ld", Ret);
-    break;
-  case SYSCALL_GETEGID:
-    LogMan::Msg::D("getegid() = %ld", Ret);
-    break;
-  case SYSCALL_GETPPID:
-    LogMan::Msg::D("getppid() = %ld", Ret);
-    break;
-  case SYSCALL_GETPGRP:
-    LogMan::Msg::D("getpgrp() = %ld", Ret);
-    break;
-  case SYSCALL_SETSID:
-    LogMan::Msg::D("setsid() = %ld", Ret);
-    break;
-  case SYSCALL_SETREUID:
-    LogMan::Msg::D("setreuid(%ld, %ld) = %ld", Args->Argument[1], Args->Argument[2], Ret);
-    break;
-  case SYSCALL_SETREGID:
-    LogMan::Msg::D("setregid(%ld, %ld) = %ld", Args->Argument[1], Args->Argument[2], Ret);
-    break;
-  case SYSCALL_SETRESUID:
-    LogMan::Msg::D("setresuid(%ld, %ld, %ld) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Ret);
-    break;
-  case SYSCALL_GETRESUID:
-    LogMan::Msg::D("getresuid(%ld, %ld, %ld) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Ret);
-    break;
-  case SYSCALL_GETRESGID:
-    LogMan::Msg::D("getresgid(%ld, %ld, %ld) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Ret);
-    break;
-  case SYSCALL_SETRESGID:
-    LogMan::Msg::D("setresgid(%ld, %ld, %ld) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Ret);
-    break;
-  case SYSCALL_SIGALTSTACK:
-    LogMan::Msg::D("sigaltstack(%lx, %lx) = %ld", Args->Argument[1], Args->Argument[2], Ret);
-    break;
-  case SYSCALL_MKNOD:
-    LogMan::Msg::D("mknod(\"%s\", %ld, %ld) = %ld", reinterpret_cast<char const*>(Args->Argument[1]),
-      Args->Argument[2], Args->Argument[3],
-      Ret);
-    break;
-  case SYSCALL_PERSONALITY:
-    LogMan::Msg::D("personality(0x%lx) = %lx", Args->Argument[1], Ret);
-    break;
-  case SYSCALL_STATFS:
-    LogMan::Msg::D("statfs(\"%s\", {...}) = %ld", reinterpret_cast<char const*>(Args->Argument[1]), Ret);
-    break;
-  case SYSCALL_FSTATFS:
-    LogMan::Msg::D("fstatfs(%ld, {...}) = %ld", Args->Argument[1], Ret);
-    break;
-  case SYSCALL_GETPRIORITY:
-    LogMan::Msg::D("getpriority(%ld, %ld) = %ld", Args->Argument[1], Args->Argument[2], Ret);
-    break;
-  case SYSCALL_SETPRIORITY:
-    LogMan::Msg::D("setpriority(%ld, %ld, %ld) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Ret);
-    break;
-  case SYSCALL_GETTID:
-    LogMan::Msg::D("gettid() = %ld", Ret);
-    break;
-  case SYSCALL_TGKILL:
-    LogMan::Msg::D("tgkill(%ld, %ld) = %ld", Args->Argument[1], Args->Argument[2], Ret);
-    break;
-  case SYSCALL_GET_MEMPOLICY:
-    LogMan::Msg::D("get_mempolicy(%p, %p, %ld, %p, 0x%lx) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Args->Argument[3],
-      Args->Argument[4],
-      Args->Argument[5],
-      Ret);
-    break;
-  case SYSCALL_LSEEK:
-    LogMan::Msg::D("lseek(%ld, %ld, %ld) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Ret);
-    break;
-  case SYSCALL_IOCTL:
-    LogMan::Msg::D("ioctl(%ld, 0x%lx, %p) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Ret);
-    break;
-  case SYSCALL_PREAD64:
-    LogMan::Msg::D("pread64(%ld, 0x%lx, %ld, %ld) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Args->Argument[4], Ret);
-    break;
-  case SYSCALL_TIME:
-    LogMan::Msg::D("time(%p) = %ld", Args->Argument[1], Ret);
-    break;
-  case SYSCALL_FUTEX:
-    LogMan::Msg::D("futex(%p, %ld, %ld, 0x%lx, 0x%lx, %ld) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Args->Argument[3],
-      Args->Argument[4],
-      Args->Argument[5],
-      Args->Argument[6],
-      Ret);
-    break;
-  case SYSCALL_SCHED_SETAFFINITY:
-    LogMan::Msg::D("sched_setaffinity(%ld, %ld, 0x%lx) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Args->Argument[3],
-      Ret);
-    break;
-  case SYSCALL_SCHED_GETAFFINITY:
-    LogMan::Msg::D("sched_getaffinity(%ld, %ld, 0x%lx) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Args->Argument[3],
-      Ret);
-    break;
-  case SYSCALL_CLOCK_GETTIME:
-    LogMan::Msg::D("clock_gettime(%ld, %p) = %ld", Args->Argument[1], Args->Argument[2], Ret);
-    break;
-  case SYSCALL_CLOCK_GETRES:
-    LogMan::Msg::D("clock_getres(%ld, %p) = %ld", Args->Argument[1], Args->Argument[2], Ret);
-    break;
-  case SYSCALL_CLOCK_NANOSLEEP:
-    LogMan::Msg::D("clock_nanosleep(%ld, %lx, %ld, %p) = %ld", Args->Argument[1], Args->Argument[2], Args->Argument[3], Args->Argument[4], Ret);
-    break;
-  case SYSCALL_GETRANDOM:
-    LogMan::Msg::D("getrandom(0x%lx, 0x%lx, 0x%lx) = %ld",
-        Args->Argument[1],
-        Args->Argument[2],
-        Args->Argument[3],
-        Ret);
-    break;
-  case SYSCALL_MEMFD_CREATE:
-    LogMan::Msg::D("memfd_create(\"%s\", 0x%lx) = %ld",
-        reinterpret_cast<char const*>(Args->Argument[1]),
-        Args->Argument[2],
-        Ret);
-    break;
-  case SYSCALL_MLOCK2:
-    LogMan::Msg::D("mlock2(%p, 0x%lx, 0x%lx) = %ld",
-      Args->Argument[1],
-      Args->Argument[2],
-      Args->Argument[3],
-      Ret);
-    break;
-  case SYSCALL_STATX:
-    LogMan::Msg::D("statx(%ld, \"%s\", 0x%lx, 0x%lx, {...}) = %ld",
-      Args->Argument[1],
-      reinterpret_cast<char const*>(Args->Argument[2]),
-      Args->Argument[3], Args->Argument[4],
-      Ret);
-    break;
-  default: LogMan::Msg::D("Unknown strace: %d", Args->Argument[0]);
-  }
-}
-#endif
-
 x64SyscallHandler::x64SyscallHandler(FEXCore::Context::Context *ctx)
   : SyscallHandler {ctx} {
   RegisterSyscallHandlers();
@@ -713,6 +84,8 @@ void x64SyscallHandler::RegisterSyscallHandlers() {
   for (auto &Def : Definitions) {
     Def.NumArgs = 0;
     Def.Ptr = cvt(&Unimplemented);
+    Def.NumOutputs = 0;
+    Def.UnknownOutputs = false;
   }
 
   const std::vector<std::tuple<uint16_t, void*, uint8_t>> Syscalls = {
@@ -875,6 +248,7 @@ void x64SyscallHandler::RegisterSyscallHandlers() {
     {SYSCALL_INOTIFY_INIT1,          cvt(&FEXCore::HLE::Inotify_init1),          1},
     {SYSCALL_PRLIMIT64,              cvt(&FEXCore::HLE::Prlimit64),              4},
     {SYSCALL_SENDMMSG,               cvt(&FEXCore::HLE::Sendmmsg),               4},
+    {SYSCALL_GETCPU,                 cvt(&FEXCore::HLE::Getcpu),                 3},
     {SYSCALL_SCHED_SETATTR,          cvt(&FEXCore::HLE::Sched_Setattr),          3},
     {SYSCALL_SCHED_GETATTR,          cvt(&FEXCore::HLE::Sched_Getattr),          4},
     {SYSCALL_GETRANDOM,              cvt(&FEXCore::HLE::Getrandom),              3},
@@ -890,6 +264,97 @@ void x64SyscallHandler::RegisterSyscallHandlers() {
     Def.Ptr = std::get<1>(Syscall);
     Def.NumArgs = std::get<2>(Syscall);
   }
+
+  // Guest memory each syscall writes to, code on it gets thrown out before the syscall runs
+  // Sizes can be larger than what gets written, that only throws out code that didn't need to be
+  auto Fixed = [](uint8_t Arg, uint32_t Size) { return SyscallOutput{SyscallOutput::OUTPUT_FIXED, Arg, 0, Size}; };
+  auto Array = [](uint8_t Arg, uint8_t CountArg, uint32_t Size = 1) { return SyscallOutput{SyscallOutput::OUTPUT_ARRAY, Arg, CountArg, Size}; };
+  auto Length = [](uint8_t Arg, uint8_t LengthArg) { return SyscallOutput{SyscallOutput::OUTPUT_LENGTH, Arg, LengthArg, 0}; };
+  auto IOVec = [](uint8_t Arg, uint8_t CountArg) { return SyscallOutput{SyscallOutput::OUTPUT_IOVEC, Arg, CountArg, 0}; };
+  auto MsgHdr = [](uint8_t Arg) { return SyscallOutput{SyscallOutput::OUTPUT_MSGHDR, Arg, 0, 0}; };
+
+  const std::vector<std::pair<uint16_t, std::vector<SyscallOutput>>> Outputs = {
+    {SYSCALL_READ,                   {Array(2, 3)}},
+    {SYSCALL_STAT,                   {Fixed(2, sizeof(FEXCore::guest_stat))}},
+    {SYSCALL_FSTAT,                  {Fixed(2, sizeof(FEXCore::guest_stat))}},
+    {SYSCALL_LSTAT,                  {Fixed(2, sizeof(FEXCore::guest_stat))}},
+    {SYSCALL_POLL,                   {Array(1, 2, sizeof(pollfd))}},
+    {SYSCALL_RT_SIGACTION,           {Fixed(3, sizeof(struct sigaction))}},
+    {SYSCALL_RT_SIGPROCMASK,         {Fixed(3, sizeof(uint64_t))}},
+    {SYSCALL_PREAD64,                {Array(2, 3)}},
+    {SYSCALL_READV,                  {IOVec(2, 3)}},
+    {SYSCALL_PIPE,                   {Fixed(1, sizeof(int) * 2)}},
+    {SYSCALL_SELECT,                 {Fixed(2, sizeof(fd_set)), Fixed(3, sizeof(fd_set)), Fixed(4, sizeof(fd_set)), Fixed(5, sizeof(timeval))}},
+    // One byte per page of the range, the length in bytes covers it
+    {SYSCALL_MINCORE,                {Array(3, 2)}},
+    {SYSCALL_SHMCTL,                 {Fixed(3, sizeof(shmid_ds))}},
+    {SYSCALL_NANOSLEEP,              {Fixed(2, sizeof(timespec))}},
+    {SYSCALL_RECVFROM,               {Array(2, 3), Length(5, 6), Fixed(6, sizeof(socklen_t))}},
+    {SYSCALL_RECVMSG,                {MsgHdr(2)}},
+    {SYSCALL_GETSOCKNAME,            {Length(2, 3), Fixed(3, sizeof(socklen_t))}},
+    {SYSCALL_GETPEERNAME,            {Length(2, 3), Fixed(3, sizeof(socklen_t))}},
+    {SYSCALL_SOCKETPAIR,             {Fixed(4, sizeof(int) * 2)}},
+    {SYSCALL_GETSOCKOPT,             {Length(4, 5), Fixed(5, sizeof(socklen_t))}},
+    {SYSCALL_WAIT4,                  {Fixed(2, sizeof(int)), Fixed(4, sizeof(rusage))}},
+    {SYSCALL_UNAME,                  {Fixed(1, sizeof(utsname))}},
+    {SYSCALL_GETDENTS,               {Array(2, 3)}},
+    {SYSCALL_GETCWD,                 {Array(1, 2)}},
+    {SYSCALL_READLINK,               {Array(2, 3)}},
+    {SYSCALL_GETTIMEOFDAY,           {Fixed(1, sizeof(timeval)), Fixed(2, sizeof(struct timezone))}},
+    {SYSCALL_SYSINFO,                {Fixed(1, sizeof(struct sysinfo))}},
+    {SYSCALL_SYSLOG,                 {Array(2, 3)}},
+    {SYSCALL_GETRESUID,              {Fixed(1, sizeof(uid_t)), Fixed(2, sizeof(uid_t)), Fixed(3, sizeof(uid_t))}},
+    {SYSCALL_GETRESGID,              {Fixed(1, sizeof(gid_t)), Fixed(2, sizeof(gid_t)), Fixed(3, sizeof(gid_t))}},
+    {SYSCALL_SIGALTSTACK,            {Fixed(2, sizeof(stack_t))}},
+    {SYSCALL_STATFS,                 {Fixed(2, sizeof(struct statfs))}},
+    {SYSCALL_FSTATFS,                {Fixed(2, sizeof(struct statfs))}},
+    {SYSCALL_SCHED_GETPARAM,         {Fixed(2, sizeof(sched_param))}},
+    {SYSCALL_SCHED_RR_GET_INTERVAL,  {Fixed(2, sizeof(timespec))}},
+    {SYSCALL_TIME,                   {Fixed(1, sizeof(time_t))}},
+    {SYSCALL_SCHED_GETAFFINITY,      {Array(3, 2)}},
+    {SYSCALL_GETDENTS64,             {Array(2, 3)}},
+    // Kernel timer IDs are ints
+    {SYSCALL_TIMER_CREATE,           {Fixed(3, sizeof(int))}},
+    {SYSCALL_TIMER_SETTIME,          {Fixed(4, sizeof(itimerspec))}},
+    {SYSCALL_TIMER_GETTIME,          {Fixed(2, sizeof(itimerspec))}},
+    {SYSCALL_CLOCK_GETTIME,          {Fixed(2, sizeof(timespec))}},
+    {SYSCALL_CLOCK_GETRES,           {Fixed(2, sizeof(timespec))}},
+    {SYSCALL_CLOCK_NANOSLEEP,        {Fixed(4, sizeof(timespec))}},
+    {SYSCALL_EPOLL_WAIT,             {Array(2, 3, sizeof(epoll_event))}},
+    {SYSCALL_NEWFSTATAT,             {Fixed(3, sizeof(FEXCore::guest_stat))}},
+    {SYSCALL_READLINKAT,             {Array(3, 4)}},
+    {SYSCALL_PPOLL,                  {Array(1, 2, sizeof(pollfd)), Fixed(3, sizeof(timespec))}},
+    {SYSCALL_GET_ROBUST_LIST,        {Fixed(2, sizeof(uint64_t)), Fixed(3, sizeof(size_t))}},
+    {SYSCALL_EPOLL_PWAIT,            {Array(2, 3, sizeof(epoll_event))}},
+    {SYSCALL_PIPE2,                  {Fixed(1, sizeof(int) * 2)}},
+    {SYSCALL_PRLIMIT64,              {Fixed(4, sizeof(rlimit))}},
+    {SYSCALL_SENDMMSG,               {Array(2, 3, sizeof(mmsghdr))}},
+    {SYSCALL_GETCPU,                 {Fixed(1, sizeof(unsigned)), Fixed(2, sizeof(unsigned))}},
+    {SYSCALL_SCHED_GETATTR,          {Array(2, 3)}},
+    {SYSCALL_GETRANDOM,              {Array(1, 2)}},
+    {SYSCALL_STATX,                  {Fixed(5, sizeof(struct statx))}},
+  };
+
+  for (auto &Output : Outputs) {
+    auto &Def = Definitions.at(Output.first);
+    LogMan::Throw::A(Output.second.size() <= MAX_SYSCALL_OUTPUTS, "Too many outputs for syscall %d", Output.first);
+    Def.NumOutputs = Output.second.size();
+    std::copy(Output.second.begin(), Output.second.end(), Def.Outputs);
+  }
+
+  // What these write to depends on the command, they get retried after an EFAULT instead
+  const std::vector<uint16_t> UnknownOutputs = {
+    SYSCALL_IOCTL,
+    SYSCALL_SEMCTL,
+    SYSCALL_FCNTL,
+    SYSCALL_PRCTL,
+    SYSCALL_FUTEX,
+    SYSCALL_GET_MEMPOLICY,
+  };
+
+  for (auto Syscall : UnknownOutputs) {
+    Definitions.at(Syscall).UnknownOutputs = true;
+  }
 }
 
 uint64_t x64SyscallHandler::HandleSyscall(FEXCore::Core::InternalThreadState *Thread, FEXCore::HLE::SyscallArguments *Args) {
@@ -182,6 +182,7 @@ enum Syscalls {
   SYSCALL_INOTIFY_INIT1   = 294, ///< __NR_inotify_init1
   SYSCALL_PRLIMIT64       = 302, ///< __NR_prlimit64
   SYSCALL_SENDMMSG        = 307, ///< __NR_sendmmsg
+  SYSCALL_GETCPU          = 309, ///< __NR_getcpu
   SYSCALL_SCHED_SETATTR   = 314, ///< __NR_sched_setattr
   SYSCALL_SCHED_GETATTR   = 315, ///< __NR_sched_getattr
   SYSCALL_GETRANDOM       = 318, ///< __NR_getrandom
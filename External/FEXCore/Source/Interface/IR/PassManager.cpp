@@ -1,38 +1,147 @@
 #include "Interface/IR/Passes.h"
 #include "Interface/IR/Passes/RegisterAllocationPass.h"
 #include "Interface/IR/PassManager.h"
+#include "Interface/Core/OpcodeDispatcher.h"
+
+#include <FEXCore/Debug/InternalThreadState.h>
+
+#include <chrono>
 
 namespace FEXCore::IR {
 
 void PassManager::AddDefaultPasses() {
-  Passes.emplace_back(std::unique_ptr<FEXCore::IR::Pass>(CreateContextLoadStoreElimination()));
-  Passes.emplace_back(std::unique_ptr<FEXCore::IR::Pass>(CreateConstProp()));
-  ////// Passes.emplace_back(std::unique_ptr<FEXCore::IR::Pass>(CreateDeadFlagCalculationEliminination()));
-  Passes.emplace_back(std::unique_ptr<FEXCore::IR::Pass>(CreateSyscallOptimization()));
-  Passes.emplace_back(std::unique_ptr<FEXCore::IR::Pass>(CreatePassDeadCodeElimination()));
+  InsertPass(CreateContextLoadStoreElimination(), "ContextLoadStoreElimination");
+  InsertPass(CreateConstProp(), "ConstProp");
+  InsertPass(CreateDeadFlagCalculationEliminination(), "DeadFlagCalculationElimination");
+  InsertPass(CreateSyscallOptimization(), "SyscallOptimization");
+  // Constants and context loads have been cleaned up, so identical decoder sequences now hash the same
+  InsertPass(CreateGlobalValueNumbering(), "GlobalValueNumbering");
+  // After constants are propagated so more of the address arithmetic is foldable, DCE cleans up what it leaves behind
+  InsertPass(CreateAddressModeFolding(), "AddressModeFolding");
+  InsertPass(CreatePassDeadCodeElimination(), "DeadCodeElimination");
 
   // If the IR is compacted post-RA then the node indexing gets messed up and the backend isn't able to find the register assigned to a node
   // Compact before IR, don't worry about RA generating spills/fills
-  Passes.emplace_back(std::unique_ptr<FEXCore::IR::Pass>(CreateIRCompaction()));
+  InsertPass(CreateIRCompaction(), "IRCompaction");
+}
+
+void PassManager::AddBaselinePasses() {
+  // Fast first tier for tiered compilation, only what the backends need to consume the IR
+  // Hot blocks get recompiled with the default passes later
+  InsertPass(CreateIRCompaction(), "IRCompaction");
 }
 
 void PassManager::AddDefaultValidationPasses() {
 #ifndef NDEBUG
-  ValidationPasses.emplace_back(std::unique_ptr<FEXCore::IR::Pass>(Validation::CreatePhiValidation()));
-  ValidationPasses.emplace_back(std::unique_ptr<FEXCore::IR::Pass>(Validation::CreateIRValidation()));
-  ValidationPasses.emplace_back(std::unique_ptr<FEXCore::IR::Pass>(Validation::CreateValueDominanceValidation()));
+  for (auto Pass : {Validation::CreatePhiValidation(), Validation::CreateIRValidation(), Validation::CreateValueDominanceValidation()}) {
+    Pass->Manager = this;
+    ValidationPasses.emplace_back(Pass);
+  }
 #endif
 }
 
+IR::RegisterAllocationPass *PassManager::GetRegisterAllocatorPass() {
+  if (!RAPass) {
+    RAPass = LinearScanRA ? IR::CreateLinearScanRegisterAllocationPass() : IR::CreateRegisterAllocationPass();
+    InsertPass(RAPass, LinearScanRA ? "LinearScanRA" : "RA");
+  }
+
+  return RAPass;
+}
+
+template<bool Copy>
+static uint64_t CountNodesInIR(IRListView<Copy> const &CurrentIR) {
+  uintptr_t ListBegin = CurrentIR.GetListData();
+  uintptr_t DataBegin = CurrentIR.GetData();
+
+  NodeWrapperIterator Begin = CurrentIR.begin();
+  OrderedNode *HeaderNode = Begin()->GetNode(ListBegin);
+  auto HeaderOp = HeaderNode->Op(DataBegin)->CW<FEXCore::IR::IROp_IRHeader>();
+  OrderedNode *BlockNode = HeaderOp->Blocks.GetNode(ListBegin);
+
+  uint64_t Count {};
+  while (1) {
+    auto BlockIROp = BlockNode->Op(DataBegin)->CW<FEXCore::IR::IROp_CodeBlock>();
+    NodeWrapperIterator CodeBegin = CurrentIR.at(BlockIROp->Begin);
+    NodeWrapperIterator CodeLast = CurrentIR.at(BlockIROp->Last);
+
+    while (1) {
+      ++Count;
+      if (CodeBegin == CodeLast) {
+        break;
+      }
+      ++CodeBegin;
+    }
+
+    if (BlockIROp->Next.ID() == 0) {
+      break;
+    }
+    BlockNode = BlockIROp->Next.GetNode(ListBegin);
+  }
+
+  return Count;
+}
+
+uint64_t PassManager::CountNodes(OpDispatchBuilder *Disp) {
+  return CountNodesInIR(Disp->ViewIR());
+}
+
+uint64_t PassManager::CountNodes(IRListView<true> const *IR) {
+  return CountNodesInIR(*IR);
+}
+
+size_t PassManager::RAPassIndex() const {
+  // The backends add the RA after everything else
+  for (size_t i = 0; i < Passes.size(); ++i) {
+    if (Passes[i].get() == RAPass) {
+      return i;
+    }
+  }
+  return Passes.size();
+}
+
 bool PassManager::Run(OpDispatchBuilder *Disp) {
+  return RunPasses(Disp, 0, Passes.size());
+}
+
+bool PassManager::RunBeforeRA(OpDispatchBuilder *Disp) {
+  return RunPasses(Disp, 0, RAPassIndex());
+}
+
+bool PassManager::RunRA(OpDispatchBuilder *Disp) {
+  return RunPasses(Disp, RAPassIndex(), Passes.size());
+}
+
+bool PassManager::RunPasses(OpDispatchBuilder *Disp, size_t Begin, size_t End) {
   bool Changed = false;
-  for (auto const &Pass : Passes) {
-    Changed |= Pass->Run(Disp);
+  if (Stats) {
+    // The RA pass gets added on first use, so the pipeline can grow between runs
+    Stats->Passes.resize(Passes.size());
+    uint64_t Nodes = CountNodes(Disp);
+    for (size_t i = Begin; i < End; ++i) {
+      auto Start = std::chrono::steady_clock::now();
+      bool PassChanged = Passes[i]->Run(Disp);
+      auto Time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - Start).count();
+
+      uint64_t NodesAfter = CountNodes(Disp);
+      Stats->Passes[i].first = PassNames[i];
+      Stats->Passes[i].second.AddRun(Time, Nodes, NodesAfter, PassChanged);
+      Nodes = NodesAfter;
+      Changed |= PassChanged;
+    }
+  }
+  else {
+    for (size_t i = Begin; i < End; ++i) {
+      Changed |= Passes[i]->Run(Disp);
+    }
   }
 
 #ifndef NDEBUG
-  for (auto const &Pass : ValidationPasses) {
-    Changed |= Pass->Run(Disp);
+  // Validation looks up registers, so it only runs once the pipeline is done
+  if (End == Passes.size()) {
+    for (auto const &Pass : ValidationPasses) {
+      Changed |= Pass->Run(Disp);
+    }
   }
 #endif
 
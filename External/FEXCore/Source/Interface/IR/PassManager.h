@@ -3,28 +3,85 @@
 #include <FEXCore/IR/IntrusiveIRList.h>
 
 #include <memory>
+#include <string>
 #include <vector>
 
+namespace FEXCore::Core {
+  struct CompileStats;
+}
+
 namespace FEXCore::IR {
 class OpDispatchBuilder;
+class PassManager;
+class RegisterAllocationPass;
 
 class Pass {
 public:
   virtual ~Pass() = default;
   virtual bool Run(OpDispatchBuilder *Disp) = 0;
+
+protected:
+  friend PassManager;
+  PassManager *Manager{};
 };
 
+/**
+ * @brief Owns and runs a pipeline of IR passes
+ *
+ * Passes keep state between runs, so every compiling thread needs its own PassManager
+ */
 class PassManager final {
 public:
   void AddDefaultPasses();
+  void AddBaselinePasses();
   void AddDefaultValidationPasses();
-  void InsertPass(Pass *Pass) {
+  void InsertPass(Pass *Pass, std::string Name) {
+    Pass->Manager = this;
     Passes.emplace_back(Pass);
+    PassNames.emplace_back(std::move(Name));
   }
   bool Run(OpDispatchBuilder *Disp);
 
+  /**
+   * @brief Runs the pipeline in two halves, the IR between them is free of anything register allocation added
+   *
+   * RunBeforeRA followed by RunRA does the same as Run
+   */
+  bool RunBeforeRA(OpDispatchBuilder *Disp);
+  bool RunRA(OpDispatchBuilder *Disp);
+
+  /**
+   * @brief Records the time and IR size change of every pass in to Stats
+   *
+   * nullptr turns it off, counting nodes walks the whole IR around every pass
+   */
+  void SetStats(FEXCore::Core::CompileStats *CompileStats) { Stats = CompileStats; }
+
+  /**
+   * @brief Number of nodes in the code blocks of the IR
+   */
+  static uint64_t CountNodes(OpDispatchBuilder *Disp);
+  static uint64_t CountNodes(IRListView<true> const *IR);
+
+  IR::RegisterAllocationPass *GetRegisterAllocatorPass();
+  bool HasRegisterAllocationPass() const { return RAPass != nullptr; }
+
+  /**
+   * @brief Picks the allocator GetRegisterAllocatorPass creates
+   *
+   * Linear scan is a lot cheaper to run than the graph allocator, at the cost of more spilling
+   */
+  void SetLinearScanRA(bool LinearScan) { LinearScanRA = LinearScan; }
+
 private:
+  bool RunPasses(OpDispatchBuilder *Disp, size_t Begin, size_t End);
+  size_t RAPassIndex() const;
+
   std::vector<std::unique_ptr<Pass>> Passes;
+  std::vector<std::string> PassNames;
+  FEXCore::Core::CompileStats *Stats {};
+  IR::RegisterAllocationPass *RAPass {};
+  bool LinearScanRA {false};
 #ifndef NDEBUG
   std::vector<std::unique_ptr<Pass>> ValidationPasses;
 #endif
@@ -5,12 +5,15 @@ class Pass;
 class RegisterAllocationPass;
 
 FEXCore::IR::Pass* CreateConstProp();
+FEXCore::IR::Pass* CreateAddressModeFolding();
+FEXCore::IR::Pass* CreateGlobalValueNumbering();
 FEXCore::IR::Pass* CreateContextLoadStoreElimination();
 FEXCore::IR::Pass* CreateSyscallOptimization();
 FEXCore::IR::Pass* CreateDeadFlagCalculationEliminination();
 FEXCore::IR::Pass* CreatePassDeadCodeElimination();
 FEXCore::IR::Pass* CreateIRCompaction();
 FEXCore::IR::RegisterAllocationPass* CreateRegisterAllocationPass();
+FEXCore::IR::RegisterAllocationPass* CreateLinearScanRegisterAllocationPass();
 
 namespace Validation {
 FEXCore::IR::Pass* CreateIRValidation();
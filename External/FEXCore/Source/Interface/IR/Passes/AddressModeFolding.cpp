@@ -0,0 +1,224 @@
+#include "Interface/IR/PassManager.h"
+#include "Interface/Core/OpcodeDispatcher.h"
+
+#include <limits>
+
+namespace FEXCore::IR {
+
+// Folds the Add/Mul/Lshl/Constant chains the dispatcher generates for x86 addressing in to the memory ops
+// [Base + Displacement] stays a LoadMem/StoreMem, [Base + Index * Scale + Displacement] becomes a LoadMemIndexed/StoreMemIndexed
+// Only 64bit arithmetic is folded, that is what the backends do with the address register anyway
+class AddressModeFolding final : public FEXCore::IR::Pass {
+public:
+  bool Run(OpDispatchBuilder *Disp) override;
+
+private:
+  struct Address {
+    OrderedNode *Base;
+    OrderedNode *Index;
+    uint8_t Scale;
+    int64_t Displacement;
+  };
+
+  uintptr_t ListBegin;
+  uintptr_t DataBegin;
+
+  IROp_Header *GetOp(OrderedNode *Node) const { return Node->Op(DataBegin); }
+  OrderedNode *GetArg(IROp_Header *IROp, uint8_t Arg) const { return IROp->Args[Arg].GetNode(ListBegin); }
+  void FoldDisplacement(OpDispatchBuilder *Disp, Address *Addr);
+  bool FoldIndex(OpDispatchBuilder *Disp, Address *Addr);
+  Address FoldAddress(OpDispatchBuilder *Disp, OrderedNode *Node, int32_t Displacement);
+};
+
+void AddressModeFolding::FoldDisplacement(OpDispatchBuilder *Disp, Address *Addr) {
+  while (1) {
+    auto IROp = GetOp(Addr->Base);
+    if (IROp->Op != OP_ADD || IROp->Size != 8) {
+      return;
+    }
+
+    uint64_t Constant;
+    uint8_t ConstantArg;
+    if (Disp->IsValueConstant(IROp->Args[1], &Constant)) {
+      ConstantArg = 1;
+    }
+    else if (Disp->IsValueConstant(IROp->Args[0], &Constant)) {
+      ConstantArg = 0;
+    }
+    else {
+      return;
+    }
+
+    // Memory ops only carry a signed 32bit displacement, AArch64 adds in what its ldr/str immediates can't encode
+    int64_t NewDisplacement = Addr->Displacement + static_cast<int64_t>(Constant);
+    if (NewDisplacement < std::numeric_limits<int32_t>::min() ||
+        NewDisplacement > std::numeric_limits<int32_t>::max()) {
+      return;
+    }
+
+    Addr->Displacement = NewDisplacement;
+    Addr->Base = GetArg(IROp, ConstantArg ^ 1);
+  }
+}
+
+bool AddressModeFolding::FoldIndex(OpDispatchBuilder *Disp, Address *Addr) {
+  auto IROp = GetOp(Addr->Base);
+  if (IROp->Op != OP_ADD || IROp->Size != 8) {
+    return false;
+  }
+
+  // Index * Scale can be on either side, the dispatcher puts it first
+  for (uint8_t Arg = 0; Arg < 2; ++Arg) {
+    auto ScaledOp = GetOp(GetArg(IROp, Arg));
+    // Only look at the arguments once the op is known to have two, a constant's value is stored where they would be
+    if ((ScaledOp->Op != OP_MUL && ScaledOp->Op != OP_LSHL) || ScaledOp->Size != 8) {
+      continue;
+    }
+
+    uint64_t Constant;
+    if (!Disp->IsValueConstant(ScaledOp->Args[1], &Constant)) {
+      continue;
+    }
+
+    uint8_t Scale {};
+    if (ScaledOp->Op == OP_MUL && (Constant == 1 || Constant == 2 || Constant == 4 || Constant == 8)) {
+      Scale = Constant;
+    }
+    else if (ScaledOp->Op == OP_LSHL && Constant < 4) {
+      Scale = 1 << Constant;
+    }
+    else {
+      continue;
+    }
+
+    Addr->Index = GetArg(ScaledOp, 0);
+    Addr->Scale = Scale;
+    Addr->Base = GetArg(IROp, Arg ^ 1);
+    return true;
+  }
+
+  Addr->Index = GetArg(IROp, 1);
+  Addr->Scale = 1;
+  Addr->Base = GetArg(IROp, 0);
+  return true;
+}
+
+AddressModeFolding::Address AddressModeFolding::FoldAddress(OpDispatchBuilder *Disp, OrderedNode *Node, int32_t Displacement) {
+  Address Addr {Node, nullptr, 1, Displacement};
+  FoldDisplacement(Disp, &Addr);
+  if (FoldIndex(Disp, &Addr)) {
+    // [Base + Disp + Index * Scale] with the displacement on the base
+    FoldDisplacement(Disp, &Addr);
+  }
+  return Addr;
+}
+
+bool AddressModeFolding::Run(OpDispatchBuilder *Disp) {
+  bool Changed = false;
+  auto CurrentIR = Disp->ViewIR();
+  ListBegin = CurrentIR.GetListData();
+  DataBegin = CurrentIR.GetData();
+
+  auto Begin = CurrentIR.begin();
+  auto Op = Begin();
+
+  OrderedNode *RealNode = Op->GetNode(ListBegin);
+  auto HeaderOp = RealNode->Op(DataBegin)->CW<FEXCore::IR::IROp_IRHeader>();
+  LogMan::Throw::A(HeaderOp->Header.Op == OP_IRHEADER, "First op wasn't IRHeader");
+
+  OrderedNode *BlockNode = HeaderOp->Blocks.GetNode(ListBegin);
+
+  while (1) {
+    auto BlockIROp = BlockNode->Op(DataBegin)->CW<FEXCore::IR::IROp_CodeBlock>();
+    LogMan::Throw::A(BlockIROp->Header.Op == OP_CODEBLOCK, "IR type failed to be a code block");
+
+    // We grab these nodes this way so we can iterate easily
+    auto CodeBegin = CurrentIR.at(BlockIROp->Begin);
+    auto CodeLast = CurrentIR.at(BlockIROp->Last);
+    while (1) {
+      auto CodeOp = CodeBegin();
+      OrderedNode *CodeNode = CodeOp->GetNode(ListBegin);
+      auto IROp = CodeNode->Op(DataBegin);
+
+      if (IROp->Op == OP_LOADMEM || IROp->Op == OP_STOREMEM) {
+        bool IsLoad = IROp->Op == OP_LOADMEM;
+        auto LoadOp = IROp->CW<IR::IROp_LoadMem>();
+        auto StoreOp = IROp->CW<IR::IROp_StoreMem>();
+        int32_t Displacement = IsLoad ? LoadOp->Displacement : StoreOp->Displacement;
+
+        auto Addr = FoldAddress(Disp, GetArg(IROp, 0), Displacement);
+
+        if (!Addr.Index) {
+          if (Addr.Base != GetArg(IROp, 0)) {
+            if (IsLoad) {
+              LoadOp->Displacement = Addr.Displacement;
+            }
+            else {
+              StoreOp->Displacement = Addr.Displacement;
+            }
+            Disp->ReplaceNodeArgument(CodeNode, 0, Addr.Base);
+            Changed = true;
+          }
+        }
+        else if (IsLoad) {
+          // Swap the backing op so every use of the load keeps pointing at the same node
+          auto NewOp = Disp->AllocateOrphanOp<IR::IROp_LoadMemIndexed, OP_LOADMEMINDEXED>();
+          NewOp->Header.Size = IROp->Size;
+          NewOp->Header.ElementSize = IROp->ElementSize;
+          NewOp->Header.HasDest = IROp->HasDest;
+          NewOp->Header.NumArgs = 2;
+          NewOp->Base = Addr.Base->Wrapped(ListBegin);
+          NewOp->Index = Addr.Index->Wrapped(ListBegin);
+          Addr.Base->AddUse();
+          Addr.Index->AddUse();
+          NewOp->Size = LoadOp->Size;
+          NewOp->Align = LoadOp->Align;
+          NewOp->Class = LoadOp->Class;
+          NewOp->Scale = Addr.Scale;
+          NewOp->Displacement = Addr.Displacement;
+          Disp->ReplaceAllUsesWith(CodeNode, &NewOp->Header);
+          Changed = true;
+        }
+        else {
+          OrderedNode *Value = GetArg(IROp, 1);
+          auto NewOp = Disp->AllocateOrphanOp<IR::IROp_StoreMemIndexed, OP_STOREMEMINDEXED>();
+          NewOp->Header.Size = IROp->Size;
+          NewOp->Header.ElementSize = IROp->ElementSize;
+          NewOp->Header.NumArgs = 3;
+          NewOp->Base = Addr.Base->Wrapped(ListBegin);
+          NewOp->Value = Value->Wrapped(ListBegin);
+          NewOp->Index = Addr.Index->Wrapped(ListBegin);
+          Addr.Base->AddUse();
+          Value->AddUse();
+          Addr.Index->AddUse();
+          NewOp->Size = StoreOp->Size;
+          NewOp->Align = StoreOp->Align;
+          NewOp->Class = StoreOp->Class;
+          NewOp->Scale = Addr.Scale;
+          NewOp->Displacement = Addr.Displacement;
+          Disp->ReplaceAllUsesWith(CodeNode, &NewOp->Header);
+          Changed = true;
+        }
+      }
+
+      if (CodeBegin == CodeLast) {
+        break;
+      }
+      ++CodeBegin;
+    }
+
+    if (BlockIROp->Next.ID() == 0) {
+      break;
+    } else {
+      BlockNode = BlockIROp->Next.GetNode(ListBegin);
+    }
+  }
+
+  return Changed;
+}
+
+FEXCore::IR::Pass* CreateAddressModeFolding() {
+  return new AddressModeFolding{};
+}
+
+}
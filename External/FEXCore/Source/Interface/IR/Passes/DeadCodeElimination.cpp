@@ -49,12 +49,16 @@ bool DeadCodeElimination::Run(OpDispatchBuilder *Disp) {
       case OP_STORECONTEXTPAIR:
       case OP_STOREFLAG:
       case OP_STOREMEM:
+      case OP_STOREMEMINDEXED:
+      case OP_MEMCPY:
+      case OP_MEMSET:
       case OP_CAS:
       case OP_PRINT:
         // Keep
         break;
       // IO
       case OP_SYSCALL:
+      case OP_INLINESYSCALL:
         // Keep
         break;
       // Control flow
@@ -0,0 +1,298 @@
+#include "Interface/IR/PassManager.h"
+#include "Interface/Core/OpcodeDispatcher.h"
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace FEXCore::IR {
+
+// Hash based value numbering over the dominator tree
+// An op that computes the same thing as an op in a dominating position gets its uses moved to that op, DCE removes the leftover
+// Ops are zeroed on allocation so the whole op data, arguments included, can be hashed and compared as bytes
+class GlobalValueNumbering final : public FEXCore::IR::Pass {
+public:
+  bool Run(OpDispatchBuilder *Disp) override;
+
+private:
+  struct OpHash {
+    size_t operator()(IROp_Header const *Op) const {
+      // FNV-1a
+      size_t Hash = 14695981039346656037ULL;
+      auto Data = reinterpret_cast<uint8_t const*>(Op);
+      for (size_t i = 0; i < GetSize(Op->Op); ++i) {
+        Hash = (Hash ^ Data[i]) * 1099511628211ULL;
+      }
+      return Hash;
+    }
+  };
+
+  struct OpEqual {
+    bool operator()(IROp_Header const *Lhs, IROp_Header const *Rhs) const {
+      return Lhs->Op == Rhs->Op && memcmp(Lhs, Rhs, GetSize(Lhs->Op)) == 0;
+    }
+  };
+
+  using ValueTable = std::unordered_map<IROp_Header const*, OrderedNode*, OpHash, OpEqual>;
+
+  struct BlockInfo {
+    OrderedNode *Node;
+    std::vector<size_t> Predecessors;
+    std::vector<size_t> Children;
+    size_t IDom;
+  };
+
+  static constexpr size_t NO_IDOM = ~0ULL;
+
+  static bool IsPure(IROps Op);
+  static bool IsMemoryLoad(IROps Op);
+  static bool ClobbersMemory(IROps Op);
+};
+
+bool GlobalValueNumbering::IsPure(IROps Op) {
+  switch (Op) {
+  // Reads guest state that can change between two identical ops
+  case OP_LOADCONTEXT:
+  case OP_LOADCONTEXTPAIR:
+  case OP_LOADCONTEXTINDEXED:
+  case OP_LOADFLAG:
+  case OP_FILLREGISTER:
+  case OP_LOADMEM:
+  case OP_LOADMEMINDEXED:
+  case OP_MEMCMP:
+  case OP_CYCLECOUNTER:
+  case OP_GETHOSTFLAG:
+  // Side effects
+  case OP_SYSCALL:
+  case OP_INLINESYSCALL:
+  case OP_CPUID:
+  case OP_CAS:
+  case OP_CASPAIR:
+  case OP_ATOMICSWAP:
+  case OP_ATOMICFETCHADD:
+  case OP_ATOMICFETCHSUB:
+  case OP_ATOMICFETCHAND:
+  case OP_ATOMICFETCHOR:
+  case OP_ATOMICFETCHXOR:
+  // Value depends on the incoming edge
+  case OP_PHI:
+    return false;
+  default:
+    return true;
+  }
+}
+
+bool GlobalValueNumbering::IsMemoryLoad(IROps Op) {
+  return Op == OP_LOADMEM || Op == OP_LOADMEMINDEXED;
+}
+
+bool GlobalValueNumbering::ClobbersMemory(IROps Op) {
+  switch (Op) {
+  case OP_STOREMEM:
+  case OP_STOREMEMINDEXED:
+  case OP_MEMCPY:
+  case OP_MEMSET:
+  case OP_CAS:
+  case OP_CASPAIR:
+  case OP_ATOMICSWAP:
+  case OP_ATOMICADD:
+  case OP_ATOMICSUB:
+  case OP_ATOMICAND:
+  case OP_ATOMICOR:
+  case OP_ATOMICXOR:
+  case OP_ATOMICFETCHADD:
+  case OP_ATOMICFETCHSUB:
+  case OP_ATOMICFETCHAND:
+  case OP_ATOMICFETCHOR:
+  case OP_ATOMICFETCHXOR:
+  case OP_SYSCALL:
+  case OP_INLINESYSCALL:
+  case OP_GUESTCALLDIRECT:
+  case OP_GUESTCALLINDIRECT:
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool GlobalValueNumbering::Run(OpDispatchBuilder *Disp) {
+  bool Changed = false;
+  auto CurrentIR = Disp->ViewIR();
+  uintptr_t ListBegin = CurrentIR.GetListData();
+  uintptr_t DataBegin = CurrentIR.GetData();
+
+  auto Begin = CurrentIR.begin();
+  auto Op = Begin();
+
+  OrderedNode *RealNode = Op->GetNode(ListBegin);
+  auto HeaderOp = RealNode->Op(DataBegin)->CW<FEXCore::IR::IROp_IRHeader>();
+  LogMan::Throw::A(HeaderOp->Header.Op == OP_IRHEADER, "First op wasn't IRHeader");
+
+  std::vector<BlockInfo> Blocks;
+  std::unordered_map<uint32_t, size_t> BlockIndex;
+
+  OrderedNode *BlockNode = HeaderOp->Blocks.GetNode(ListBegin);
+  while (1) {
+    auto BlockIROp = BlockNode->Op(DataBegin)->CW<FEXCore::IR::IROp_CodeBlock>();
+    LogMan::Throw::A(BlockIROp->Header.Op == OP_CODEBLOCK, "IR type failed to be a code block");
+
+    BlockIndex[BlockNode->Wrapped(ListBegin).ID()] = Blocks.size();
+    Blocks.emplace_back(BlockInfo{BlockNode, {}, {}, NO_IDOM});
+
+    if (BlockIROp->Next.ID() == 0) {
+      break;
+    } else {
+      BlockNode = BlockIROp->Next.GetNode(ListBegin);
+    }
+  }
+
+  // The RA calculates live ranges over the linear node order
+  // A value that is live across a backwards edge would get its register reused inside the loop, so only share values between blocks when every edge goes forward
+  bool HasBackEdge = false;
+  for (size_t i = 0; i < Blocks.size(); ++i) {
+    auto BlockIROp = Blocks[i].Node->Op(DataBegin)->CW<FEXCore::IR::IROp_CodeBlock>();
+    auto CodeBegin = CurrentIR.at(BlockIROp->Begin);
+    auto CodeLast = CurrentIR.at(BlockIROp->Last);
+
+    auto AddEdge = [&](OrderedNodeWrapper Target) {
+      size_t Succ = BlockIndex.at(Target.ID());
+      HasBackEdge |= Succ <= i;
+      Blocks[Succ].Predecessors.emplace_back(i);
+    };
+
+    while (1) {
+      auto IROp = CodeBegin()->GetNode(ListBegin)->Op(DataBegin);
+      if (IROp->Op == OP_JUMP) {
+        AddEdge(IROp->Args[0]);
+      }
+      else if (IROp->Op == OP_CONDJUMP) {
+        AddEdge(IROp->Args[1]);
+        AddEdge(IROp->Args[2]);
+      }
+
+      if (CodeBegin == CodeLast) {
+        break;
+      }
+      ++CodeBegin;
+    }
+  }
+
+  if (!HasBackEdge) {
+    // Without back edges the block order is a topological order, every predecessor already has its dominator when we get to a block
+    auto Intersect = [&](size_t Lhs, size_t Rhs) {
+      while (Lhs != Rhs) {
+        while (Lhs > Rhs) Lhs = Blocks[Lhs].IDom;
+        while (Rhs > Lhs) Rhs = Blocks[Rhs].IDom;
+      }
+      return Lhs;
+    };
+
+    for (size_t i = 1; i < Blocks.size(); ++i) {
+      size_t IDom = NO_IDOM;
+      for (auto Pred : Blocks[i].Predecessors) {
+        // Unreachable predecessors don't constrain anything
+        if (Pred != 0 && Blocks[Pred].IDom == NO_IDOM) continue;
+        IDom = IDom == NO_IDOM ? Pred : Intersect(IDom, Pred);
+      }
+      Blocks[i].IDom = IDom;
+      if (IDom != NO_IDOM) {
+        Blocks[IDom].Children.emplace_back(i);
+      }
+    }
+  }
+
+  // Uses of a replaced node are rewritten as we walk, anything walked before the replacement is caught after
+  std::unordered_map<uint32_t, OrderedNode*> Replacements;
+  ValueTable Values;
+
+  auto RewriteArgs = [&](OrderedNode *CodeNode, IROp_Header *IROp) {
+    if (Replacements.empty()) return;
+    uint8_t NumArgs = IR::GetArgs(IROp->Op);
+    for (uint8_t i = 0; i < NumArgs; ++i) {
+      if (IROp->Args[i].IsInvalid()) continue;
+      auto it = Replacements.find(IROp->Args[i].ID());
+      if (it != Replacements.end()) {
+        Disp->ReplaceNodeArgument(CodeNode, i, it->second);
+      }
+    }
+  };
+
+  std::function<void(size_t)> VisitBlock = [&](size_t Block) {
+    auto BlockIROp = Blocks[Block].Node->Op(DataBegin)->CW<FEXCore::IR::IROp_CodeBlock>();
+    auto CodeBegin = CurrentIR.at(BlockIROp->Begin);
+    auto CodeLast = CurrentIR.at(BlockIROp->Last);
+
+    // Memory can be written by anything between two blocks, loads are only merged inside of one
+    ValueTable Loads;
+    std::vector<IROp_Header const*> Inserted;
+
+    while (1) {
+      auto CodeOp = CodeBegin();
+      OrderedNode *CodeNode = CodeOp->GetNode(ListBegin);
+      auto IROp = CodeNode->Op(DataBegin);
+
+      RewriteArgs(CodeNode, IROp);
+
+      if (ClobbersMemory(IROp->Op)) {
+        Loads.clear();
+      }
+
+      if (IROp->HasDest && (IsPure(IROp->Op) || IsMemoryLoad(IROp->Op))) {
+        auto &Table = IsMemoryLoad(IROp->Op) ? Loads : Values;
+        auto Result = Table.try_emplace(IROp, CodeNode);
+        if (!Result.second) {
+          Replacements[CodeOp->ID()] = Result.first->second;
+          Changed = true;
+        }
+        else if (&Table == &Values) {
+          Inserted.emplace_back(IROp);
+        }
+      }
+
+      if (CodeBegin == CodeLast) {
+        break;
+      }
+      ++CodeBegin;
+    }
+
+    for (auto Child : Blocks[Block].Children) {
+      VisitBlock(Child);
+    }
+
+    // Leaving the dominator subtree, nothing else can see these values
+    for (auto IROp : Inserted) {
+      Values.erase(IROp);
+    }
+  };
+
+  for (size_t i = 0; i < Blocks.size(); ++i) {
+    if (Blocks[i].IDom == NO_IDOM) {
+      VisitBlock(i);
+    }
+  }
+
+  if (!Replacements.empty()) {
+    for (auto &Block : Blocks) {
+      auto BlockIROp = Block.Node->Op(DataBegin)->CW<FEXCore::IR::IROp_CodeBlock>();
+      auto CodeBegin = CurrentIR.at(BlockIROp->Begin);
+      auto CodeLast = CurrentIR.at(BlockIROp->Last);
+      while (1) {
+        OrderedNode *CodeNode = CodeBegin()->GetNode(ListBegin);
+        RewriteArgs(CodeNode, CodeNode->Op(DataBegin));
+
+        if (CodeBegin == CodeLast) {
+          break;
+        }
+        ++CodeBegin;
+      }
+    }
+  }
+
+  return Changed;
+}
+
+FEXCore::IR::Pass* CreateGlobalValueNumbering() {
+  return new GlobalValueNumbering{};
+}
+
+}
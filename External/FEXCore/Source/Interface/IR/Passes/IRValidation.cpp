@@ -42,8 +42,8 @@ bool IRValidation::Run(OpDispatchBuilder *Disp) {
 
   OrderedNode *BlockNode = HeaderOp->Blocks.GetNode(ListBegin);
   IR::RegisterAllocationPass * RAPass{};
-  if (Disp->CTX->HasRegisterAllocationPass()) {
-    RAPass = Disp->CTX->GetRegisterAllocatorPass();
+  if (Manager->HasRegisterAllocationPass()) {
+    RAPass = Manager->GetRegisterAllocatorPass();
   }
 
   while (1) {
@@ -1,27 +1,94 @@
 #include "Interface/IR/PassManager.h"
 #include "Interface/Core/OpcodeDispatcher.h"
+#include <FEXCore/Core/CoreState.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace {
+  // One bit per flag in CPUState::flags
+  using FlagSet = uint64_t;
+  constexpr FlagSet ALL_FLAGS = ~FlagSet{};
+  constexpr size_t FLAGS_OFFSET = offsetof(FEXCore::Core::CPUState, flags[0]);
+  constexpr size_t NUM_FLAGS = sizeof(FEXCore::Core::CPUState::flags);
+  static_assert(NUM_FLAGS <= sizeof(FlagSet) * 8, "Flag set too small for the number of flags");
+
+  struct BlockInfo {
+    FEXCore::IR::OrderedNode *Node;
+    std::vector<size_t> Successors;
+    // Flags read before they are written in this block
+    FlagSet Gen;
+    // Flags written in this block
+    FlagSet Kill;
+    FlagSet LiveIn;
+    FlagSet LiveOut;
+    // Leaves the IR function, anything stored can be seen by whatever runs next
+    bool HasExit;
+  };
+}
 
 namespace FEXCore::IR {
 
 class DeadFlagCalculationEliminination final : public FEXCore::IR::Pass {
 public:
   bool Run(OpDispatchBuilder *Disp) override;
+
+private:
+  std::vector<BlockInfo> Blocks;
+  std::unordered_map<OrderedNodeWrapper::NodeOffsetType, size_t> OffsetToBlock;
+  std::vector<OrderedNode*> BlockNodes;
 };
 
+// Flags read by an op other than through LoadFlag
+static FlagSet GetFlagsRead(FEXCore::IR::IROp_Header const *IROp) {
+  auto ContextRange = [](uint32_t Offset, uint32_t Size) -> FlagSet {
+    if (Offset >= FLAGS_OFFSET + NUM_FLAGS || Offset + Size <= FLAGS_OFFSET) {
+      return 0;
+    }
+    FlagSet Set{};
+    for (uint32_t i = 0; i < NUM_FLAGS; ++i) {
+      if (FLAGS_OFFSET + i >= Offset && FLAGS_OFFSET + i < Offset + Size) {
+        Set |= FlagSet{1} << i;
+      }
+    }
+    return Set;
+  };
+
+  switch (IROp->Op) {
+    case OP_LOADCONTEXT: {
+      auto Op = IROp->C<IR::IROp_LoadContext>();
+      return ContextRange(Op->Offset, IROp->Size);
+    }
+    case OP_LOADCONTEXTPAIR: {
+      auto Op = IROp->C<IR::IROp_LoadContextPair>();
+      return ContextRange(Op->Offset, Op->Size * 2);
+    }
+    // Can read anywhere in the context
+    case OP_LOADCONTEXTINDEXED:
+    // The frontend gets to look at the whole guest state
+    case OP_SYSCALL:
+    case OP_INLINESYSCALL:
+    case OP_BREAK:
+    // Leave the IR function
+    case OP_GUESTCALLDIRECT:
+    case OP_GUESTCALLINDIRECT:
+    case OP_GUESTRETURN:
+      return ALL_FLAGS;
+    default:
+      return 0;
+  }
+}
+
 /**
- * @brief (UNSAFE) This pass removes flag calculations that will otherwise be unused INSIDE of that block
- *
- * Compilers don't really do any form of cross-block flag allocation like they do RA with GPRs.
- * This ends up with them recalculating flags across blocks regardless of if it is actually possible to reuse the flags.
- * This is an additional burden in x86 that most instructions change flags when called, so it is easier to recalculate anyway.
- *
- * This is unsafe since handwritten code can easily break this assumption.
- * This may be more interesting with full function level recompilation since flags definitely won't be used across function boundaries.
+ * @brief Removes flag stores that get overwritten on every path before anything reads them
  *
+ * x86 sets flags on nearly every ALU op, but very few of them are ever read.
+ * This runs a backwards liveness pass over the blocks of the IR function. A StoreFlag is only removed when no path from it
+ * reaches a read of that flag before another store to it.
+ * Flags are considered live when leaving the IR function, since the next block of guest code can't be seen from here.
+ * DCE cleans up the flag calculations afterwards.
  */
 bool DeadFlagCalculationEliminination::Run(OpDispatchBuilder *Disp) {
-  std::array<OrderedNode*, 32> LastValidFlagStores{};
-
   bool Changed = false;
   auto CurrentIR = Disp->ViewIR();
   uintptr_t ListBegin = CurrentIR.GetListData();
@@ -34,12 +101,29 @@ bool DeadFlagCalculationEliminination::Run(OpDispatchBuilder *Disp) {
   auto HeaderOp = RealNode->Op(DataBegin)->CW<FEXCore::IR::IROp_IRHeader>();
   LogMan::Throw::A(HeaderOp->Header.Op == OP_IRHEADER, "First op wasn't IRHeader");
 
-  OrderedNode *BlockNode = HeaderOp->Blocks.GetNode(ListBegin);
+  Blocks.clear();
+  OffsetToBlock.clear();
 
+  // Number the blocks first so jumps can refer to blocks later in the list
+  OrderedNode *BlockNode = HeaderOp->Blocks.GetNode(ListBegin);
   while (1) {
     auto BlockIROp = BlockNode->Op(DataBegin)->CW<FEXCore::IR::IROp_CodeBlock>();
     LogMan::Throw::A(BlockIROp->Header.Op == OP_CODEBLOCK, "IR type failed to be a code block");
 
+    OffsetToBlock[BlockNode->Wrapped(ListBegin).ID()] = Blocks.size();
+    Blocks.emplace_back(BlockInfo{BlockNode});
+
+    if (BlockIROp->Next.ID() == 0) {
+      break;
+    } else {
+      BlockNode = BlockIROp->Next.GetNode(ListBegin);
+    }
+  }
+
+  // Local flag accesses and control flow of every block
+  for (auto &Block : Blocks) {
+    auto BlockIROp = Block.Node->Op(DataBegin)->CW<FEXCore::IR::IROp_CodeBlock>();
+
     // We grab these nodes this way so we can iterate easily
     auto CodeBegin = CurrentIR.at(BlockIROp->Begin);
     auto CodeLast = CurrentIR.at(BlockIROp->Last);
@@ -48,14 +132,34 @@ bool DeadFlagCalculationEliminination::Run(OpDispatchBuilder *Disp) {
       OrderedNode *CodeNode = CodeOp->GetNode(ListBegin);
       auto IROp = CodeNode->Op(DataBegin);
 
-      if (IROp->Op == OP_STOREFLAG) {
-        auto Op = IROp->CW<IR::IROp_StoreFlag>();
-        // Set this node as the last one valid for this flag
-        LastValidFlagStores[Op->Flag] = CodeNode;
-      }
-      else if (IROp->Op == OP_LOADFLAG) {
-        auto Op = IROp->CW<IR::IROp_LoadFlag>();
-        LastValidFlagStores[Op->Flag] = nullptr;
+      switch (IROp->Op) {
+        case OP_STOREFLAG: {
+          auto Op = IROp->C<IR::IROp_StoreFlag>();
+          Block.Kill |= FlagSet{1} << Op->Flag;
+          break;
+        }
+        case OP_LOADFLAG: {
+          auto Op = IROp->C<IR::IROp_LoadFlag>();
+          Block.Gen |= (FlagSet{1} << Op->Flag) & ~Block.Kill;
+          break;
+        }
+        case OP_CONDJUMP: {
+          auto Op = IROp->C<IR::IROp_CondJump>();
+          Block.Successors.emplace_back(OffsetToBlock.at(Op->Header.Args[1].ID()));
+          Block.Successors.emplace_back(OffsetToBlock.at(Op->Header.Args[2].ID()));
+          break;
+        }
+        case OP_JUMP: {
+          auto Op = IROp->C<IR::IROp_Jump>();
+          Block.Successors.emplace_back(OffsetToBlock.at(Op->Header.Args[0].ID()));
+          break;
+        }
+        case OP_EXITFUNCTION:
+          Block.HasExit = true;
+          break;
+        default:
+          Block.Gen |= GetFlagsRead(IROp) & ~Block.Kill;
+          break;
       }
 
       // CodeLast is inclusive. So we still need to dump the CodeLast op as well
@@ -65,21 +169,73 @@ bool DeadFlagCalculationEliminination::Run(OpDispatchBuilder *Disp) {
       ++CodeBegin;
     }
 
-    if (BlockIROp->Next.ID() == 0) {
-      break;
-    } else {
-      BlockNode = BlockIROp->Next.GetNode(ListBegin);
+    // A block that doesn't go anywhere else leaves the function one way or another
+    Block.HasExit |= Block.Successors.empty();
+  }
+
+  // Iterate to a fixed point, walking backwards converges quickest for forward branches
+  bool LivenessChanged = true;
+  while (LivenessChanged) {
+    LivenessChanged = false;
+    for (size_t i = Blocks.size(); i-- > 0;) {
+      auto &Block = Blocks[i];
+      FlagSet LiveOut = Block.HasExit ? ALL_FLAGS : 0;
+      for (auto Successor : Block.Successors) {
+        LiveOut |= Blocks[Successor].LiveIn;
+      }
+
+      FlagSet LiveIn = Block.Gen | (LiveOut & ~Block.Kill);
+      if (LiveIn != Block.LiveIn || LiveOut != Block.LiveOut) {
+        Block.LiveIn = LiveIn;
+        Block.LiveOut = LiveOut;
+        LivenessChanged = true;
+      }
     }
+  }
 
-    // If any flags are stored but not loaded by the end of the block, then erase them
-    for (auto &Flag : LastValidFlagStores) {
-      if (Flag != nullptr) {
-        Disp->Remove(Flag);
-        Changed = true;
+  // Walk every block backwards from what is live on the way out and drop the stores nothing sees
+  for (auto &Block : Blocks) {
+    if (!Block.Kill) {
+      continue;
+    }
+
+    auto BlockIROp = Block.Node->Op(DataBegin)->CW<FEXCore::IR::IROp_CodeBlock>();
+    auto CodeBegin = CurrentIR.at(BlockIROp->Begin);
+    auto CodeLast = CurrentIR.at(BlockIROp->Last);
+
+    BlockNodes.clear();
+    while (1) {
+      BlockNodes.emplace_back(CodeBegin()->GetNode(ListBegin));
+      if (CodeBegin == CodeLast) {
+        break;
       }
+      ++CodeBegin;
     }
 
-    LastValidFlagStores.fill(nullptr);
+    FlagSet Live = Block.LiveOut;
+    for (auto it = BlockNodes.rbegin(); it != BlockNodes.rend(); ++it) {
+      OrderedNode *CodeNode = *it;
+      auto IROp = CodeNode->Op(DataBegin);
+
+      if (IROp->Op == OP_STOREFLAG) {
+        auto Op = IROp->C<IR::IROp_StoreFlag>();
+        FlagSet Flag = FlagSet{1} << Op->Flag;
+        if (Live & Flag) {
+          Live &= ~Flag;
+        }
+        else {
+          Disp->Remove(CodeNode);
+          Changed = true;
+        }
+      }
+      else if (IROp->Op == OP_LOADFLAG) {
+        auto Op = IROp->C<IR::IROp_LoadFlag>();
+        Live |= FlagSet{1} << Op->Flag;
+      }
+      else {
+        Live |= GetFlagsRead(IROp);
+      }
+    }
   }
 
   return Changed;
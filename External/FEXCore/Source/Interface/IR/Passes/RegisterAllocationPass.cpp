@@ -3,6 +3,7 @@
 #include "Interface/IR/Passes.h"
 #include "Interface/Core/OpcodeDispatcher.h"
 
+#include <algorithm>
 #include <iterator>
 
 namespace {
@@ -232,6 +233,11 @@ namespace {
         return Op->Class;
         break;
       }
+      case IR::OP_LOADMEMINDEXED: {
+        auto Op = IROp->C<IR::IROp_LoadMemIndexed>();
+        return Op->Class;
+        break;
+      }
       case IR::OP_FILLREGISTER: {
         auto Op = IROp->C<IR::IROp_FillRegister>();
         return Op->Class;
@@ -332,6 +338,7 @@ namespace FEXCore::IR {
        * Top 32bits is the class, lower 32bits is the register
        */
       uint64_t GetNodeRegister(uint32_t Node) override;
+      bool IsLiveAcross(uint32_t Node, uint32_t At) override;
     private:
 
       std::vector<uint32_t> PhysicalRegisterCount;
@@ -396,6 +403,11 @@ namespace FEXCore::IR {
     return Graph->Nodes[Node].Head.RegAndClass;
   }
 
+  bool ConstrainedRAPass::IsLiveAcross(uint32_t Node, uint32_t At) {
+    // Nodes without a destination keep ~0U as their beginning
+    return LiveRanges[Node].Begin < At && LiveRanges[Node].End > At;
+  }
+
   void ConstrainedRAPass::CalculateLiveRange(FEXCore::IR::IRListView<false> *IR) {
     using namespace FEXCore;
     size_t Nodes = IR->GetSSACount();
@@ -443,7 +455,8 @@ namespace FEXCore::IR {
           case IR::OP_CONSTANT: LiveRanges[Node].RematCost = 1; break;
           case IR::OP_LOADFLAG:
           case IR::OP_LOADCONTEXT: LiveRanges[Node].RematCost = 10; break;
-          case IR::OP_LOADMEM: LiveRanges[Node].RematCost = 100; break;
+          case IR::OP_LOADMEM:
+          case IR::OP_LOADMEMINDEXED: LiveRanges[Node].RematCost = 100; break;
           case IR::OP_FILLREGISTER: LiveRanges[Node].RematCost = DEFAULT_REMAT_COST + 1; break;
           // We want PHI to be very expensive to spill
           case IR::OP_PHI: LiveRanges[Node].RematCost = DEFAULT_REMAT_COST * 10; break;
@@ -1062,7 +1075,386 @@ namespace FEXCore::IR {
     return Changed;
   }
 
+  /**
+   * @brief Linear scan allocator for code that isn't worth building an interference graph for
+   *
+   * Walks the live ranges in program order and hands out the first free physical register.
+   * When a class runs dry, the live value that is used the farthest away gets split. It is stored to a spill slot right after
+   * its definition and every block that uses it later fills it again, so what is left of it gets a second chance at whatever
+   * register is free by then. All the splits from one scan are applied together and the scan restarts until everything fits.
+   */
+  class LinearScanRAPass final : public RegisterAllocationPass {
+    public:
+      LinearScanRAPass();
+      bool Run(OpDispatchBuilder *Disp) override;
+
+      void AllocateRegisterSet(uint32_t RegisterCount, uint32_t ClassCount) override;
+      void AddRegisters(FEXCore::IR::RegisterClassType Class, uint32_t RegisterCount) override;
+      void AddRegisterConflict(FEXCore::IR::RegisterClassType ClassConflict, uint32_t RegConflict, FEXCore::IR::RegisterClassType Class, uint32_t Reg) override;
+      void AllocateRegisterConflicts(FEXCore::IR::RegisterClassType Class, uint32_t NumConflicts) override;
+
+      uint64_t GetNodeRegister(uint32_t Node) override;
+      bool IsLiveAcross(uint32_t Node, uint32_t At) override;
+
+    private:
+      struct ScanClass {
+        uint32_t Count;
+        // Registers of other classes that overlap each register of this one
+        std::vector<std::vector<uint64_t>> Conflicts;
+        // Number of live values holding each register, either directly or through a conflict
+        std::vector<uint32_t> Busy;
+        // Bitmask of the classes that share registers with this one
+        uint64_t Related;
+      };
+
+      struct SplitPoint {
+        FEXCore::IR::OrderedNode *Node;
+        // Uses after this node get filled from the spill slot
+        FEXCore::IR::OrderedNode *At;
+      };
+
+      std::vector<ScanClass> Classes;
+      std::vector<uint64_t> NodeRegisters;
+      std::vector<LiveRange> LiveRanges;
+      std::vector<FEXCore::IR::OrderedNode*> Nodes;
+      std::vector<uint32_t> Active;
+      std::vector<SplitPoint> Splits;
+      std::unique_ptr<FEXCore::IR::Pass> LocalCompaction;
+
+      void CalculateLiveRanges(FEXCore::IR::IRListView<false> *IR);
+      void MarkRegister(uint64_t RegAndClass, int32_t Delta);
+      uint32_t FindFreeRegister(FEXCore::IR::RegisterClassType Class);
+      bool ScanRegisters();
+      void SplitLiveRange(FEXCore::IR::OpDispatchBuilder *Disp, SplitPoint const &Split);
+  };
+
+  LinearScanRAPass::LinearScanRAPass() {
+    LocalCompaction.reset(FEXCore::IR::CreateIRCompaction());
+  }
+
+  void LinearScanRAPass::AllocateRegisterSet(uint32_t RegisterCount, uint32_t ClassCount) {
+    Classes.resize(ClassCount);
+    for (size_t i = 0; i < ClassCount; ++i) {
+      Classes[i].Related = 1ULL << i;
+    }
+  }
+
+  void LinearScanRAPass::AddRegisters(FEXCore::IR::RegisterClassType Class, uint32_t RegisterCount) {
+    Classes[Class].Count = RegisterCount;
+    Classes[Class].Busy.resize(RegisterCount);
+  }
+
+  void LinearScanRAPass::AddRegisterConflict(FEXCore::IR::RegisterClassType ClassConflict, uint32_t RegConflict, FEXCore::IR::RegisterClassType Class, uint32_t Reg) {
+    LogMan::Throw::A(Reg < Classes[Class].Conflicts.size(), "Tried adding reg %d to conflict list only %d in size", Reg, Classes[Class].Conflicts.size());
+    LogMan::Throw::A(RegConflict < Classes[ClassConflict].Conflicts.size(), "Tried adding reg %d to conflict list only %d in size", RegConflict, Classes[ClassConflict].Conflicts.size());
+
+    // Conflict must go both ways
+    Classes[Class].Conflicts[Reg].emplace_back((static_cast<uint64_t>(ClassConflict) << 32) | RegConflict);
+    Classes[ClassConflict].Conflicts[RegConflict].emplace_back((static_cast<uint64_t>(Class) << 32) | Reg);
+    Classes[Class].Related |= 1ULL << ClassConflict;
+    Classes[ClassConflict].Related |= 1ULL << Class;
+  }
+
+  void LinearScanRAPass::AllocateRegisterConflicts(FEXCore::IR::RegisterClassType Class, uint32_t NumConflicts) {
+    Classes[Class].Conflicts.resize(NumConflicts);
+  }
+
+  uint64_t LinearScanRAPass::GetNodeRegister(uint32_t Node) {
+    return NodeRegisters[Node];
+  }
+
+  bool LinearScanRAPass::IsLiveAcross(uint32_t Node, uint32_t At) {
+    return LiveRanges[Node].Begin < At && LiveRanges[Node].End > At;
+  }
+
+  void LinearScanRAPass::CalculateLiveRanges(FEXCore::IR::IRListView<false> *IR) {
+    using namespace FEXCore;
+    uint32_t SSACount = IR->GetSSACount();
+    LiveRanges.assign(SSACount, {~0U, ~0U, 0});
+    NodeRegisters.assign(SSACount, INVALID_REGCLASS);
+    Nodes.assign(SSACount, nullptr);
+
+    uintptr_t ListBegin = IR->GetListData();
+    uintptr_t DataBegin = IR->GetData();
+
+    auto Begin = IR->begin();
+    auto Op = Begin();
+
+    IR::OrderedNode *RealNode = Op->GetNode(ListBegin);
+    auto HeaderOp = RealNode->Op(DataBegin)->CW<FEXCore::IR::IROp_IRHeader>();
+    LogMan::Throw::A(HeaderOp->Header.Op == IR::OP_IRHEADER, "First op wasn't IRHeader");
+
+    IR::OrderedNode *BlockNode = HeaderOp->Blocks.GetNode(ListBegin);
+
+    while (1) {
+      auto BlockIROp = BlockNode->Op(DataBegin)->CW<FEXCore::IR::IROp_CodeBlock>();
+      LogMan::Throw::A(BlockIROp->Header.Op == IR::OP_CODEBLOCK, "IR type failed to be a code block");
+
+      // We grab these nodes this way so we can iterate easily
+      auto CodeBegin = IR->at(BlockIROp->Begin);
+      auto CodeLast = IR->at(BlockIROp->Last);
+      while (1) {
+        auto CodeOp = CodeBegin();
+        IR::OrderedNode *CodeNode = CodeOp->GetNode(ListBegin);
+        auto IROp = CodeNode->Op(DataBegin);
+        uint32_t Node = CodeOp->ID();
+
+        LogMan::Throw::A(IROp->Op != IR::OP_PHI, "Linear scan RA doesn't support PHI nodes");
+
+        Nodes[Node] = CodeNode;
+        if (IROp->HasDest) {
+          LiveRanges[Node].Begin = Node;
+          // Default to ending right where it starts
+          LiveRanges[Node].End = Node;
+          // Only constants are cheaper to rematerialize than to fill
+          LiveRanges[Node].RematCost = IROp->Op == IR::OP_CONSTANT ? 1 : 2;
+          NodeRegisters[Node] = (static_cast<uint64_t>(GetRegClassFromNode(ListBegin, DataBegin, *CodeOp)) << 32) | INVALID_REG;
+        }
+
+        uint8_t NumArgs = IR::GetArgs(IROp->Op);
+        for (uint8_t i = 0; i < NumArgs; ++i) {
+          if (IROp->Args[i].IsInvalid()) continue;
+          uint32_t ArgNode = IROp->Args[i].ID();
+          LogMan::Throw::A(LiveRanges[ArgNode].Begin != ~0U, "%%ssa%d used by %%ssa%d before defined?", ArgNode, Node);
+          LiveRanges[ArgNode].End = Node;
+        }
+
+        // CodeLast is inclusive. So we still need to dump the CodeLast op as well
+        if (CodeBegin == CodeLast) {
+          break;
+        }
+        ++CodeBegin;
+      }
+
+      if (BlockIROp->Next.ID() == 0) {
+        break;
+      } else {
+        BlockNode = BlockIROp->Next.GetNode(ListBegin);
+      }
+    }
+  }
+
+  void LinearScanRAPass::MarkRegister(uint64_t RegAndClass, int32_t Delta) {
+    auto &Class = Classes[RegAndClass >> 32];
+    uint32_t Reg = RegAndClass;
+    Class.Busy[Reg] += Delta;
+
+    if (Reg < Class.Conflicts.size()) {
+      for (auto Conflict : Class.Conflicts[Reg]) {
+        auto &ConflictClass = Classes[Conflict >> 32];
+        if (static_cast<uint32_t>(Conflict) < ConflictClass.Busy.size()) {
+          ConflictClass.Busy[static_cast<uint32_t>(Conflict)] += Delta;
+        }
+      }
+    }
+  }
+
+  uint32_t LinearScanRAPass::FindFreeRegister(FEXCore::IR::RegisterClassType Class) {
+    auto &ScanClass = Classes[Class];
+    for (uint32_t i = 0; i < ScanClass.Count; ++i) {
+      if (!ScanClass.Busy[i]) {
+        return i;
+      }
+    }
+    return INVALID_REG;
+  }
+
+  bool LinearScanRAPass::ScanRegisters() {
+    Active.clear();
+    Splits.clear();
+    for (auto &Class : Classes) {
+      Class.Busy.assign(Class.Busy.size(), 0);
+    }
+
+    for (uint32_t Node = 0; Node < LiveRanges.size(); ++Node) {
+      LiveRange const *NodeLiveRange = &LiveRanges[Node];
+      if (NodeLiveRange->Begin == ~0U) {
+        continue;
+      }
+
+      // Anything that ends here can share its register with the value being defined
+      Active.erase(std::remove_if(Active.begin(), Active.end(), [&](uint32_t ActiveNode) {
+        if (LiveRanges[ActiveNode].End > Node) {
+          return false;
+        }
+        MarkRegister(NodeRegisters[ActiveNode], -1);
+        return true;
+      }), Active.end());
+
+      FEXCore::IR::RegisterClassType Class = FEXCore::IR::RegisterClassType{uint32_t(NodeRegisters[Node] >> 32)};
+      LogMan::Throw::A(Class < Classes.size(), "%%ssa%d doesn't have a register class", Node);
+
+      uint32_t Reg = FindFreeRegister(Class);
+      while (Reg == INVALID_REG) {
+        // The value being defined always needs a register, so split whatever live value is used the farthest away
+        // Constants go first since rematerializing them is free
+        auto Victim = Active.end();
+        for (auto it = Active.begin(); it != Active.end(); ++it) {
+          FEXCore::IR::RegisterClassType ActiveClass = FEXCore::IR::RegisterClassType{uint32_t(NodeRegisters[*it] >> 32)};
+          // Spill slots only hold a single register
+          if (!(Classes[Class].Related & (1ULL << ActiveClass)) ||
+              ActiveClass == FEXCore::IR::GPRPairClass) {
+            continue;
+          }
+
+          if (Victim == Active.end()) {
+            Victim = it;
+            continue;
+          }
+
+          auto const &Candidate = LiveRanges[*it];
+          auto const &Current = LiveRanges[*Victim];
+          if (Candidate.RematCost != Current.RematCost ?
+              Candidate.RematCost < Current.RematCost :
+              Candidate.End > Current.End) {
+            Victim = it;
+          }
+        }
+
+        LogMan::Throw::A(Victim != Active.end(), "Couldn't find a live range to split for %%ssa%d", Node);
+
+        Splits.emplace_back(SplitPoint{Nodes[*Victim], Nodes[Node]});
+        MarkRegister(NodeRegisters[*Victim], -1);
+        Active.erase(Victim);
+
+        Reg = FindFreeRegister(Class);
+      }
+
+      NodeRegisters[Node] = (static_cast<uint64_t>(Class) << 32) | Reg;
+      MarkRegister(NodeRegisters[Node], 1);
+      Active.emplace_back(Node);
+    }
+
+    return Splits.empty();
+  }
+
+  void LinearScanRAPass::SplitLiveRange(FEXCore::IR::OpDispatchBuilder *Disp, SplitPoint const &Split) {
+    using namespace FEXCore;
+
+    uintptr_t ListBegin;
+    uintptr_t DataBegin;
+    {
+      auto IR = Disp->ViewIR();
+      ListBegin = IR.GetListData();
+      DataBegin = IR.GetData();
+    }
+
+    IR::OrderedNode *SplitNode = Split.Node;
+    IR::IROp_Header *SplitIROp = SplitNode->Op(DataBegin);
+    uint32_t SplitID = SplitNode->Wrapped(ListBegin).ID();
+    uint32_t AtID = Split.At->Wrapped(ListBegin).ID();
+    FEXCore::IR::RegisterClassType Class = FEXCore::IR::RegisterClassType{uint32_t(NodeRegisters[SplitID] >> 32)};
+
+    // Fills already have a slot with the value in it, constants don't need one
+    uint32_t Slot = ~0U;
+    if (SplitIROp->Op == IR::OP_FILLREGISTER) {
+      Slot = SplitIROp->C<IR::IROp_FillRegister>()->Slot;
+    }
+    else if (SplitIROp->Op != IR::OP_CONSTANT) {
+      Slot = SpillSlotCount++;
+      Disp->SetWriteCursor(SplitNode);
+      auto SpillOp = Disp->_SpillRegister(SplitNode, Slot, {Class});
+      SpillOp.first->Header.Size = SplitIROp->Size;
+      SpillOp.first->Header.ElementSize = SplitIROp->ElementSize;
+    }
+
+    // The definition dominates every use, so the slot holds the value in any block that uses it
+    // Each block after the split point gets its own fill in front of its first use
+    auto IR = Disp->ViewIR();
+    auto Begin = IR.begin();
+    IR::OrderedNode *RealNode = Begin()->GetNode(ListBegin);
+    auto HeaderOp = RealNode->Op(DataBegin)->CW<FEXCore::IR::IROp_IRHeader>();
+    IR::OrderedNode *BlockNode = HeaderOp->Blocks.GetNode(ListBegin);
+
+    bool PastSplit = false;
+    while (1) {
+      auto BlockIROp = BlockNode->Op(DataBegin)->CW<FEXCore::IR::IROp_CodeBlock>();
+
+      auto CodeBegin = IR.at(BlockIROp->Begin);
+      auto CodeLast = IR.at(BlockIROp->Last);
+      IR::OrderedNode *PrevNode = nullptr;
+      IR::OrderedNode *Filled = nullptr;
+      while (1) {
+        auto CodeOp = CodeBegin();
+        IR::OrderedNode *CodeNode = CodeOp->GetNode(ListBegin);
+        auto IROp = CodeNode->Op(DataBegin);
+
+        if (PastSplit) {
+          uint8_t NumArgs = IR::GetArgs(IROp->Op);
+          for (uint8_t i = 0; i < NumArgs; ++i) {
+            if (IROp->Args[i].IsInvalid() || IROp->Args[i].ID() != SplitID) continue;
+
+            if (!Filled) {
+              LogMan::Throw::A(PrevNode != nullptr, "%%ssa%d used at the start of a block", SplitID);
+              Disp->SetWriteCursor(PrevNode);
+              if (SplitIROp->Op == IR::OP_CONSTANT) {
+                Filled = Disp->_Constant(SplitIROp->C<IR::IROp_Constant>()->Constant);
+              }
+              else {
+                auto FillOp = Disp->_FillRegister(Slot, {Class});
+                FillOp.first->Header.Size = SplitIROp->Size;
+                FillOp.first->Header.ElementSize = SplitIROp->ElementSize;
+                Filled = FillOp;
+              }
+            }
+
+            Disp->ReplaceNodeArgument(CodeNode, i, Filled);
+          }
+        }
+
+        // Uses by the op at the split point keep the old register, the range ends there
+        if (CodeOp->ID() == AtID) {
+          PastSplit = true;
+        }
+
+        // CodeLast is inclusive. So we still need to dump the CodeLast op as well
+        if (CodeBegin == CodeLast) {
+          break;
+        }
+        PrevNode = CodeNode;
+        ++CodeBegin;
+      }
+
+      if (BlockIROp->Next.ID() == 0) {
+        break;
+      } else {
+        BlockNode = BlockIROp->Next.GetNode(ListBegin);
+      }
+    }
+  }
+
+  bool LinearScanRAPass::Run(OpDispatchBuilder *Disp) {
+    bool Changed = false;
+
+    SpillSlotCount = 0;
+
+    while (1) {
+      Changed |= LocalCompaction->Run(Disp);
+      auto IR = Disp->ViewIR();
+      auto LastCursor = Disp->GetWriteCursor();
+      CalculateLiveRanges(&IR);
+
+      HadFullRA = ScanRegisters();
+      if (HadFullRA) {
+        break;
+      }
+
+      // Every split refers to nodes of this scan, the IR gets compacted again before the next one
+      for (auto const &Split : Splits) {
+        SplitLiveRange(Disp, Split);
+      }
+      Disp->SetWriteCursor(LastCursor);
+      Changed = true;
+    }
+
+    return Changed;
+  }
+
   FEXCore::IR::RegisterAllocationPass* CreateRegisterAllocationPass() {
     return new ConstrainedRAPass{};
   }
+
+  FEXCore::IR::RegisterAllocationPass* CreateLinearScanRegisterAllocationPass() {
+    return new LinearScanRAPass{};
+  }
 }
@@ -37,6 +37,13 @@ class RegisterAllocationPass : public FEXCore::IR::Pass {
      * Top 32bits is the class, lower 32bits is the register
      */
     virtual uint64_t GetNodeRegister(uint32_t Node) = 0;
+
+    /**
+     * @brief Returns true if the value of Node is still needed after the op At
+     *
+     * Lets backends keep only the registers that are actually live around a call in to host code
+     */
+    virtual bool IsLiveAcross(uint32_t Node, uint32_t At) = 0;
     /**  @} */
 
   protected:
@@ -1,6 +1,10 @@
 #include "Interface/Context/Context.h"
 #include "Interface/IR/PassManager.h"
 #include "Interface/Core/OpcodeDispatcher.h"
+#include "Interface/HLE/Syscalls.h"
+#include "Interface/HLE/x64/Syscalls.h"
+
+#include <FEXCore/HLE/Linux/ThreadManagement.h>
 
 #include "LogManager.h"
 
@@ -43,15 +47,43 @@ bool SyscallOptimization::Run(OpDispatchBuilder *Disp) {
         uint64_t Constant;
         if (Disp->IsValueConstant(IROp->Args[0], &Constant)) {
           auto SyscallDef = Disp->CTX->SyscallHandler->GetDefinition(Constant);
-          // XXX: Once we have the ability to do real function calls then we can call directly in to the syscall handler
-          if (SyscallDef->NumArgs < FEXCore::HLE::SyscallArguments::MAX_ARGS) {
-            // If the number of args are less than what the IR op supports then we can remove arg usage
-            // We need +1 since we are still passing in syscall number here
-            for (uint8_t Arg = (SyscallDef->NumArgs + 1); Arg < FEXCore::HLE::SyscallArguments::MAX_ARGS; ++Arg) {
-              Disp->ReplaceNodeArgument(CodeNode, Arg, Disp->Invalid());
+          if (Constant == FEXCore::HLE::x64::SYSCALL_GETTID) {
+            // The TID never changes for the lifetime of the thread, read the cached copy instead of leaving the JIT
+            // getpid stays a syscall, the cached PID is only set when the thread starts and a forked child would see its parent's
+            auto NewOp = Disp->AllocateOrphanOp<IR::IROp_LoadThreadManager, OP_LOADTHREADMANAGER>();
+            NewOp->Header.Size = IROp->Size;
+            NewOp->Header.ElementSize = IROp->ElementSize;
+            NewOp->Header.HasDest = IROp->HasDest;
+            NewOp->Header.NumArgs = 0;
+            NewOp->Offset = offsetof(FEXCore::HLE::ThreadManagement, TID);
+            // Drops the syscall's argument uses before the node gets the new op
+            Disp->ReplaceAllUsesWith(CodeNode, &NewOp->Header);
+          }
+          else if (!SyscallDef->UnknownOutputs) {
+            // Syscalls with UnknownOutputs stay generic, only HandleSyscall retries them after an EFAULT
+            // The backend calls the handler directly with the arguments in registers
+            // Only the number goes in the IR, cached IR outlives the handler pointers of the run that made it
+            auto NewOp = Disp->AllocateOrphanOp<IR::IROp_InlineSyscall, OP_INLINESYSCALL>();
+            NewOp->Header.Size = IROp->Size;
+            NewOp->Header.ElementSize = IROp->ElementSize;
+            NewOp->Header.HasDest = IROp->HasDest;
+            NewOp->Header.NumArgs = FEXCore::HLE::SyscallArguments::MAX_ARGS - 1;
+            for (uint8_t Arg = 1; Arg < FEXCore::HLE::SyscallArguments::MAX_ARGS; ++Arg) {
+              // Arguments the handler doesn't take point at the invalid node, which doesn't count uses
+              if (Arg > SyscallDef->NumArgs) {
+                NewOp->Header.Args[Arg - 1] = Disp->Invalid()->Wrapped(ListBegin);
+                continue;
+              }
+
+              OrderedNode *ArgNode = IROp->Args[Arg].GetNode(ListBegin);
+              NewOp->Header.Args[Arg - 1] = ArgNode->Wrapped(ListBegin);
+              ArgNode->AddUse();
             }
-            Changed = true;
+            NewOp->SyscallNumber = Constant;
+            // Drops the syscall's argument uses before the node gets the new op, the new op's uses were added above
+            Disp->ReplaceAllUsesWith(CodeNode, &NewOp->Header);
           }
+          Changed = true;
         }
       }
 
@@ -0,0 +1,38 @@
+#pragma once
+#include <FEXCore/IR/IR.h>
+#include <FEXCore/IR/IntrusiveIRList.h>
+
+namespace FEXCore::IR {
+/**
+ * @brief Returns true if SelectNode can leave its compare in the host flags for NextNode to branch on
+ *
+ * Only a Select of two different constants whose single use is a CondJump directly after it qualifies
+ * Flags are never kept in host flags past that CondJump, nothing else in the block or region can use them
+ *
+ * @param Invert Set when the Select picks zero for the condition being true
+ */
+template<bool Copy>
+bool CanFuseSelectBranch(IRListView<Copy> const *IR, OrderedNode const *SelectNode, OrderedNode const *NextNode, bool *Invert) {
+  uintptr_t ListBegin = IR->GetListData();
+  uintptr_t DataBegin = IR->GetData();
+
+  auto NextOp = NextNode->Op(DataBegin);
+  if (SelectNode->GetUses() != 1 ||
+      NextOp->Op != OP_CONDJUMP ||
+      NextOp->Args[0].GetNode(ListBegin) != SelectNode) {
+    return false;
+  }
+
+  auto Select = SelectNode->Op(DataBegin)->C<IROp_Select>();
+  auto TrueOp = Select->Header.Args[2].GetNode(ListBegin)->Op(DataBegin);
+  auto FalseOp = Select->Header.Args[3].GetNode(ListBegin)->Op(DataBegin);
+  if (TrueOp->Op != OP_CONSTANT || FalseOp->Op != OP_CONSTANT) {
+    return false;
+  }
+
+  bool TrueValue = TrueOp->C<IROp_Constant>()->Constant != 0;
+  bool FalseValue = FalseOp->C<IROp_Constant>()->Constant != 0;
+  *Invert = !TrueValue;
+  return TrueValue != FalseValue;
+}
+}
@@ -0,0 +1,63 @@
+#include "Common/MathUtils.h"
+#include "Interface/Memory/HugePages.h"
+#include "LogManager.h"
+
+#include <atomic>
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+
+namespace FEXCore::Memory {
+  // Explicitly 2MB, the default hugetlb size can be 1GB which the buffers wouldn't be a multiple of
+  constexpr int MAP_HUGE_2MB_FLAGS = MAP_HUGETLB | (21 << MAP_HUGE_SHIFT);
+
+  void AdviseHugePages(void *Ptr, size_t Size) {
+    static std::atomic_bool Warned {};
+    if (madvise(Ptr, Size, MADV_HUGEPAGE) != 0 && !Warned.exchange(true)) {
+      LogMan::Msg::I("Transparent huge pages aren't available (%s), using regular pages", strerror(errno));
+    }
+  }
+
+  CodeBuffer::CodeBuffer(size_t Size, bool HugePages)
+    : CodeMemorySize {Size} {
+    constexpr int Prot = PROT_READ | PROT_WRITE | PROT_EXEC;
+
+    if (HugePages) {
+      CodeMemorySize = AlignUp(Size, HUGE_PAGE_SIZE);
+      void *Ptr = mmap(nullptr, CodeMemorySize, Prot, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGE_2MB_FLAGS, -1, 0);
+      if (Ptr != MAP_FAILED) {
+        CodeMemory = reinterpret_cast<uint8_t*>(Ptr);
+        return;
+      }
+
+      LogMan::Msg::D("hugetlb pool can't hold a 0x%lx byte code buffer, falling back to transparent huge pages", CodeMemorySize);
+
+      // Over allocate so the buffer can start on a huge page boundary, the kernel only uses huge pages for aligned ranges
+      size_t MappingSize = CodeMemorySize + HUGE_PAGE_SIZE;
+      Ptr = mmap(nullptr, MappingSize, Prot, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+      LogMan::Throw::A(Ptr != MAP_FAILED, "Couldn't allocate code buffer");
+
+      uintptr_t Begin = reinterpret_cast<uintptr_t>(Ptr);
+      uintptr_t AlignedBegin = AlignUp(Begin, HUGE_PAGE_SIZE);
+      if (AlignedBegin != Begin) {
+        munmap(Ptr, AlignedBegin - Begin);
+      }
+      uintptr_t AlignedEnd = AlignedBegin + CodeMemorySize;
+      if (AlignedEnd != Begin + MappingSize) {
+        munmap(reinterpret_cast<void*>(AlignedEnd), Begin + MappingSize - AlignedEnd);
+      }
+
+      CodeMemory = reinterpret_cast<uint8_t*>(AlignedBegin);
+      AdviseHugePages(CodeMemory, CodeMemorySize);
+      return;
+    }
+
+    void *Ptr = mmap(nullptr, CodeMemorySize, Prot, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    LogMan::Throw::A(Ptr != MAP_FAILED, "Couldn't allocate code buffer");
+    CodeMemory = reinterpret_cast<uint8_t*>(Ptr);
+  }
+
+  CodeBuffer::~CodeBuffer() {
+    munmap(CodeMemory, CodeMemorySize);
+  }
+}
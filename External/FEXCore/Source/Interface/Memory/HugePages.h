@@ -0,0 +1,36 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+namespace FEXCore::Memory {
+  constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+  /**
+   * @brief Asks for transparent huge pages on [Ptr, Ptr + Size)
+   *
+   * Does nothing when the kernel doesn't have them, only the first failure gets logged
+   */
+  void AdviseHugePages(void *Ptr, size_t Size);
+
+  /**
+   * @brief Read/write/execute memory that generated code gets written in to
+   *
+   * With HugePages it comes from the hugetlb pool, which is reserved up front so running out can't fault later
+   * When the pool can't cover it, it falls back to huge page aligned regular memory with transparent huge pages
+   * Backends inherit from this ahead of their assembler so the memory outlives it
+   */
+  class CodeBuffer {
+  public:
+    CodeBuffer(size_t Size, bool HugePages);
+    ~CodeBuffer();
+
+    CodeBuffer(CodeBuffer const&) = delete;
+    CodeBuffer &operator=(CodeBuffer const&) = delete;
+
+    uint8_t *GetCodeMemory() const { return CodeMemory; }
+
+  private:
+    uint8_t *CodeMemory;
+    size_t CodeMemorySize;
+  };
+}
@@ -1,5 +1,8 @@
 #include "LogManager.h"
+#include "Interface/Memory/HugePages.h"
 #include "Interface/Memory/MemMapper.h"
+#include <algorithm>
+#include <mutex>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -25,6 +28,10 @@ namespace FEXCore::Memory {
       return nullptr;
     }
 
+    if (SHM->HugePages) {
+      FEXCore::Memory::AdviseHugePages(Ptr, Size);
+    }
+
     return Ptr;
   }
 
@@ -43,38 +50,69 @@ namespace FEXCore::Memory {
       return nullptr;
     }
 
-    MappedRegions.emplace_back(MemRegion{Ptr, Offset, Size});
+    if (SHM->HugePages) {
+      FEXCore::Memory::AdviseHugePages(Ptr, Size);
+    }
+
+    std::unique_lock<std::shared_mutex> lk(RegionsMutex);
+    MappedRegions.insert_or_assign(Offset, MemRegion{Ptr, Offset, Size});
 
     return Ptr;
   }
 
   void MemMapper::UnmapRegion(void *Ptr, size_t Size) {
-    auto it = std::find(MappedRegions.begin(), MappedRegions.end(), Ptr);
+    std::unique_lock<std::shared_mutex> lk(RegionsMutex);
+    auto it = std::find_if(MappedRegions.begin(), MappedRegions.end(), [Ptr](auto const &Region) {
+      return Region.second == Ptr;
+    });
     if (it != MappedRegions.end()) {
       munmap(Ptr, Size);
       MappedRegions.erase(it);
     }
   }
 
-  void *MemMapper::GetPointer(uint64_t Offset) {
+  std::vector<MemRegion> MemMapper::GetRegions() {
+    std::shared_lock<std::shared_mutex> lk(RegionsMutex);
+    std::vector<MemRegion> Regions;
+    Regions.reserve(MappedRegions.size());
     for (auto const &Region : MappedRegions) {
-      if (Region.contains(Offset)) {
-        return reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(Region.Ptr) + (Offset - Region.Offset));
-      }
+      Regions.emplace_back(Region.second);
     }
+    return Regions;
+  }
 
-    return nullptr;
+  MemRegion const *MemMapper::FindRegion(uint64_t Offset) const {
+    // Last region starting at or before Offset is the only one that can contain it
+    auto it = MappedRegions.upper_bound(Offset);
+    if (it == MappedRegions.begin()) {
+      return nullptr;
+    }
+    --it;
+
+    return it->second.contains(Offset) ? &it->second : nullptr;
+  }
+
+  void *MemMapper::GetPointer(uint64_t Offset) {
+    std::shared_lock<std::shared_mutex> lk(RegionsMutex);
+    auto Region = FindRegion(Offset);
+    if (!Region) {
+      return nullptr;
+    }
+
+    return reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(Region->Ptr) + (Offset - Region->Offset));
   }
 
 #ifndef NDEBUG
   void *MemMapper::GetPointerSizeCheck(uint64_t Offset, uint64_t Size) {
-    for (auto const &Region : MappedRegions) {
-      if (Region.contains(Offset)) {
-        LogMan::Throw::A((Region.Offset + Region.Size) >= (Offset + Size), "Pointer in region but region isn't large enough. Needs 0x%lx more", Offset - Region.Offset + Size - Region.Size);
-        if ((Region.Offset + Region.Size) >= (Offset + Size)) {
-          return reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(Region.Ptr) + (Offset - Region.Offset));
-        }
-      }
+    std::shared_lock<std::shared_mutex> lk(RegionsMutex);
+    auto Region = FindRegion(Offset);
+    if (!Region) {
+      return nullptr;
+    }
+
+    LogMan::Throw::A((Region->Offset + Region->Size) >= (Offset + Size), "Pointer in region but region isn't large enough. Needs 0x%lx more", Offset - Region->Offset + Size - Region->Size);
+    if ((Region->Offset + Region->Size) >= (Offset + Size)) {
+      return reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(Region->Ptr) + (Offset - Region->Offset));
     }
     return nullptr;
   }
@@ -1,6 +1,8 @@
 #pragma once
 #include "Interface/Memory/SharedMem.h"
 #include <FEXCore/Memory/MemMapper.h>
+#include <map>
+#include <shared_mutex>
 #include <stdint.h>
 #include <vector>
 
@@ -26,6 +28,11 @@ namespace FEXCore::Memory {
 
     void UnmapRegion(void *Ptr, size_t Size);
 
+    /**
+     * @brief Copy of every mapped region in guest address order
+     */
+    std::vector<FEXCore::Memory::MemRegion> GetRegions();
+
     void *GetMemoryBase() { return SHM->Object.Ptr; }
 
     void *GetPointer(uint64_t Offset);
@@ -46,7 +53,13 @@ namespace FEXCore::Memory {
 
   private:
     FEXCore::SHM::InternalSHMObject *SHM;
-    std::vector<FEXCore::Memory::MemRegion> MappedRegions{};
+
+    // Keyed on the guest offset so a lookup is a tree walk instead of a scan
+    // Lookups happen from every thread, mapping changes are rare
+    std::shared_mutex RegionsMutex;
+    std::map<uint64_t, FEXCore::Memory::MemRegion> MappedRegions{};
+
+    FEXCore::Memory::MemRegion const *FindRegion(uint64_t Offset) const;
   };
 }
 
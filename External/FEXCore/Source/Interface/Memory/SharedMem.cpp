@@ -1,4 +1,5 @@
 #include "LogManager.h"
+#include "Interface/Memory/HugePages.h"
 #include "Interface/Memory/SharedMem.h"
 #include <cstddef>
 #include <cstdint>
@@ -19,21 +20,32 @@ namespace FEXCore::SHM {
       return nullptr;
     }
 
+    if (SHM->HugePages) {
+      FEXCore::Memory::AdviseHugePages(Ptr, Size);
+    }
+
     return Ptr;
   }
 
-  SHMObject *AllocateSHMRegion(size_t Size) {
+  SHMObject *AllocateSHMRegion(size_t Size, bool HugePages) {
     InternalSHMObject *SHM = new InternalSHMObject{};
     const std::string SHMName = "FEXCore" + std::to_string(getpid());
+    SHM->HugePages = HugePages;
+
+    // Huge pages on /dev/shm depend on how it was mounted, a memfd follows the shmem_enabled setting which allows advising
+    // Hugetlb backing isn't used, every offset mapped out of the region would need to be huge page aligned
+    SHM->SHMFD = HugePages ? memfd_create(SHMName.c_str(), MFD_CLOEXEC) : -1;
 
-    SHM->SHMFD = shm_open(SHMName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
     if (SHM->SHMFD == -1) {
-      LogMan::Msg::E("Couldn't open SHM");
-      goto err;
-    }
+      SHM->SHMFD = shm_open(SHMName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+      if (SHM->SHMFD == -1) {
+        LogMan::Msg::E("Couldn't open SHM");
+        goto err;
+      }
 
-    // Unlink the SHM file immediately so it doesn't get left around
-    shm_unlink(SHMName.c_str());
+      // Unlink the SHM file immediately so it doesn't get left around
+      shm_unlink(SHMName.c_str());
+    }
 
     // Extend the SHM to the size we requested
     if (ftruncate(SHM->SHMFD, Size) != 0) {
@@ -9,5 +9,6 @@ namespace FEXCore::SHM {
     SHMObject Object;
     int SHMFD;
     size_t Size;
+    bool HugePages;
   };
 }
@@ -0,0 +1,146 @@
+#include "Interface/Memory/VMAAllocator.h"
+#include "LogManager.h"
+
+#include <algorithm>
+
+namespace FEXCore::Memory {
+  VMAAllocator::VMAAllocator(uint64_t Begin, uint64_t End)
+    : Begin {Begin}
+    , ShardSize {((End - Begin) / NUM_SHARDS) & ~0xFFFULL} {
+    LogMan::Throw::A(Begin < End && ShardSize != 0, "VMA window [0x%lx, 0x%lx) can't be split in to page aligned shards", Begin, End);
+
+    // Whatever doesn't fill a whole shard at the top is never handed out
+    this->End = Begin + ShardSize * NUM_SHARDS;
+    LogMan::Throw::A(this->End <= End, "VMA shards overrun the window");
+
+    for (size_t i = 0; i < NUM_SHARDS; ++i) {
+      uint64_t ShardBegin = Begin + ShardSize * i;
+      Shards[i].AddFreeLocked(ShardBegin, ShardBegin + ShardSize);
+    }
+  }
+
+  uint64_t VMAAllocator::Allocate(uint64_t Size, uint64_t Hint) {
+    // Only go to the other shards once ours is full
+    for (size_t i = 0; i < NUM_SHARDS; ++i) {
+      auto &Shard = Shards[(Hint + i) % NUM_SHARDS];
+      std::lock_guard<std::mutex> lk(Shard.Mutex);
+      uint64_t Result = Shard.AllocateLocked(Size);
+      if (Result) {
+        return Result;
+      }
+    }
+
+    return 0;
+  }
+
+  void VMAAllocator::Reserve(uint64_t Base, uint64_t Size) {
+    ForEachShard(Base, Size, [](Shard &Owner, uint64_t Start, uint64_t End) {
+      Owner.ReserveLocked(Start, End);
+    });
+  }
+
+  void VMAAllocator::Free(uint64_t Base, uint64_t Size) {
+    ForEachShard(Base, Size, [](Shard &Owner, uint64_t Start, uint64_t End) {
+      Owner.FreeLocked(Start, End);
+    });
+  }
+
+  template<typename F>
+  void VMAAllocator::ForEachShard(uint64_t Base, uint64_t Size, F Func) {
+    uint64_t Start = std::max(Base, Begin);
+    uint64_t Stop = std::min(Base + Size, End);
+
+    // Split on shard boundaries, a range never spans two shards
+    while (Start < Stop) {
+      size_t Index = (Start - Begin) / ShardSize;
+      uint64_t ShardEnd = std::min(Begin + ShardSize * (Index + 1), Stop);
+
+      auto &Shard = Shards[Index];
+      std::lock_guard<std::mutex> lk(Shard.Mutex);
+      Func(Shard, Start, ShardEnd);
+
+      Start = ShardEnd;
+    }
+  }
+
+  uint64_t VMAAllocator::Shard::AllocateLocked(uint64_t Size) {
+    // Best fit, lowest address among equally sized ranges
+    auto Fit = FreeBySize.lower_bound({Size, 0});
+    if (Fit == FreeBySize.end()) {
+      return 0;
+    }
+
+    uint64_t Start = Fit->second;
+    auto Range = FreeByAddress.find(Start);
+    uint64_t RangeEnd = Range->second;
+    RemoveFreeLocked(Range);
+
+    if (Start + Size != RangeEnd) {
+      AddFreeLocked(Start + Size, RangeEnd);
+    }
+
+    return Start;
+  }
+
+  void VMAAllocator::Shard::AddFreeLocked(uint64_t Start, uint64_t End) {
+    FreeByAddress.emplace(Start, End);
+    FreeBySize.emplace(End - Start, Start);
+  }
+
+  void VMAAllocator::Shard::RemoveFreeLocked(std::map<uint64_t, uint64_t>::iterator Range) {
+    FreeBySize.erase({Range->second - Range->first, Range->first});
+    FreeByAddress.erase(Range);
+  }
+
+  void VMAAllocator::Shard::ReserveLocked(uint64_t Start, uint64_t End) {
+    // First free range that could overlap is the one starting at or before Start
+    auto Range = FreeByAddress.upper_bound(Start);
+    if (Range != FreeByAddress.begin()) {
+      --Range;
+    }
+
+    while (Range != FreeByAddress.end() && Range->first < End) {
+      uint64_t RangeStart = Range->first;
+      uint64_t RangeEnd = Range->second;
+      if (RangeEnd <= Start) {
+        ++Range;
+        continue;
+      }
+
+      RemoveFreeLocked(Range);
+
+      // Whatever is left on either side stays free
+      if (RangeStart < Start) {
+        AddFreeLocked(RangeStart, Start);
+      }
+      if (RangeEnd > End) {
+        AddFreeLocked(End, RangeEnd);
+      }
+
+      Range = FreeByAddress.lower_bound(RangeEnd);
+    }
+  }
+
+  void VMAAllocator::Shard::FreeLocked(uint64_t Start, uint64_t End) {
+    // Anything in the range that is already free gets folded in to the new range
+    ReserveLocked(Start, End);
+
+    // Merge with the neighbours so large allocations can reuse the space
+    auto Next = FreeByAddress.find(End);
+    if (Next != FreeByAddress.end()) {
+      End = Next->second;
+      RemoveFreeLocked(Next);
+    }
+
+    auto Prev = FreeByAddress.lower_bound(Start);
+    if (Prev != FreeByAddress.begin()) {
+      --Prev;
+      if (Prev->second == Start) {
+        Start = Prev->first;
+        RemoveFreeLocked(Prev);
+      }
+    }
+
+    AddFreeLocked(Start, End);
+  }
+}
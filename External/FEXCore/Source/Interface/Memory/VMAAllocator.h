@@ -0,0 +1,70 @@
+#pragma once
+#include <array>
+#include <map>
+#include <mutex>
+#include <set>
+#include <stdint.h>
+#include <utility>
+
+namespace FEXCore::Memory {
+// Hands out guest address space for mmaps that don't ask for a fixed address
+// The window is split in to shards that each keep their own free ranges behind their own lock
+// Threads start looking in the shard their hint picks so concurrent allocators mostly don't contend
+class VMAAllocator {
+public:
+  /**
+   * @brief Hands out offsets in [Begin, End)
+   *
+   * The window is rounded down to a whole number of page aligned shards, nothing past End is ever returned
+   */
+  VMAAllocator(uint64_t Begin, uint64_t End);
+
+  /**
+   * @brief Finds a free range of Size bytes and marks it as used
+   *
+   * @param Hint Picks the shard to try first, the thread ID keeps a thread's mappings together
+   *
+   * @return Start of the range or 0 if there isn't a large enough free range left
+   */
+  uint64_t Allocate(uint64_t Size, uint64_t Hint);
+
+  /**
+   * @brief Marks [Base, Base + Size) as used, the guest mapped something there at a fixed address
+   *
+   * Parts of the range outside of the window are ignored
+   */
+  void Reserve(uint64_t Base, uint64_t Size);
+
+  /**
+   * @brief Makes [Base, Base + Size) available again, doesn't need to line up with what was allocated
+   *
+   * Parts of the range outside of the window are ignored
+   */
+  void Free(uint64_t Base, uint64_t Size);
+
+private:
+  constexpr static size_t NUM_SHARDS = 8;
+
+  struct Shard {
+    std::mutex Mutex;
+    // Start -> End of every free range, ranges never touch
+    std::map<uint64_t, uint64_t> FreeByAddress;
+    // (Size, Start) so the smallest range that fits is a lower_bound away
+    std::set<std::pair<uint64_t, uint64_t>> FreeBySize;
+
+    uint64_t AllocateLocked(uint64_t Size);
+    void AddFreeLocked(uint64_t Start, uint64_t End);
+    void RemoveFreeLocked(std::map<uint64_t, uint64_t>::iterator Range);
+    void ReserveLocked(uint64_t Start, uint64_t End);
+    void FreeLocked(uint64_t Start, uint64_t End);
+  };
+
+  template<typename F>
+  void ForEachShard(uint64_t Base, uint64_t Size, F Func);
+
+  uint64_t Begin;
+  uint64_t End;
+  uint64_t ShardSize;
+  std::array<Shard, NUM_SHARDS> Shards;
+};
+}
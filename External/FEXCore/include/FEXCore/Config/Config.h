@@ -13,6 +13,16 @@ namespace FEXCore::Config {
     CONFIG_GDBSERVER,
     CONFIG_ROOTFSPATH,
     CONFIG_UNIFIED_MEMORY,
+    CONFIG_TIERUP_THRESHOLD,
+    CONFIG_TRANSLATION_CACHE,
+    CONFIG_LAZY_FLAGS,
+    CONFIG_STATIC_REGISTERS,
+    CONFIG_REGISTER_ALLOCATOR,
+    CONFIG_BASELINE_REGISTER_ALLOCATOR,
+    CONFIG_COMPILE_STATS,
+    CONFIG_VDSO,
+    CONFIG_SYSCALL_TRACE,
+    CONFIG_HUGE_PAGES,
   };
 
   enum ConfigCore {
@@ -22,6 +32,11 @@ namespace FEXCore::Config {
     CONFIG_CUSTOM,
   };
 
+  enum ConfigRegisterAllocator {
+    CONFIG_RA_GRAPH,
+    CONFIG_RA_LINEAR_SCAN,
+  };
+
   void SetConfig(FEXCore::Context::Context *CTX, ConfigOption Option, uint64_t Config);
   void SetConfig(FEXCore::Context::Context *CTX, ConfigOption Option, std::string const &Config);
   uint64_t GetConfig(FEXCore::Context::Context *CTX, ConfigOption Option);
@@ -1,6 +1,7 @@
 #pragma once
 #include <stdint.h>
 #include <string>
+#include <utility>
 
 namespace FEXCore {
 
@@ -32,7 +33,8 @@ class LLVMCore;
      * The returned pointer needs to be long lived and be executable in the host environment
      * FEXCore's frontend will store this pointer in to a cache for the current RIP when this was executed
      *
-     * This is a thread specific compilation unit since there is one CPUBackend per guest thread
+     * There is one CPUBackend per guest thread, but if SharesCodeBetweenThreads returns true then
+     * the returned code will be published to and executed by every guest thread
      *
      * If NeedsOpDispatch is returning false then IR and DebugData may be null and the expectation is that the code will still compile
      * FEXCore::Core::ThreadState* is valid at the time of compilation.
@@ -70,9 +72,33 @@ class LLVMCore;
      */
     virtual bool NeedsOpDispatch() = 0;
 
-    virtual bool HasCustomDispatch() const { return false; }
+    /**
+     * @brief Lets FEXCore know if the code this CPUBackend generates can be executed by any guest thread
+     *
+     * Code that only depends on the ThreadState passed in at execution time can live in the Context's shared code cache
+     * Backends that bake thread specific state in to their code must return false and get a thread local cache instead
+     *
+     * @return true if compiled code can be shared between threads
+     */
+    virtual bool SharesCodeBetweenThreads() const { return false; }
 
-    virtual void ExecuteCustomDispatch(FEXCore::Core::ThreadState *Thread) {}
+    /**
+     * @brief Lets FEXCore know if the IR passed to CompileCode has to stay around after it returned
+     *
+     * Backends that only read the IR while compiling return false, FEXCore then drops the IR once the code is published
+     *
+     * @return true if the IR is used after compilation
+     */
+    virtual bool NeedsIRAfterCompile() const { return true; }
+
+    /**
+     * @brief Lets FEXCore know where the code this CPUBackend generates lives
+     *
+     * Blocks in this range get evicted from a shared cache when the CPUBackend is retired, the rest of the cache stays
+     *
+     * @return [Begin, End) of the host code, empty if the code doesn't live in one range
+     */
+    virtual std::pair<uintptr_t, uintptr_t> GetCodeRange() const { return {}; }
 
     virtual void ClearCache() {}
   };
@@ -53,6 +53,13 @@ public:
    */
   virtual void MapMemoryRegion(std::function<void*(uint64_t, uint64_t, bool, bool)> Mapper) {}
 
+  /**
+   * @brief Tells the code loader where the core mapped the guest vDSO, called before SetupStack
+   *
+   * @param Base The guest facing address of the vDSO's ELF header
+   */
+  virtual void SetVDSOBase(uint64_t Base) {}
+
   /**
    * @brief Memory writer function for loading code in to guest memory
    *
@@ -18,6 +18,54 @@ namespace FEXCore::Core {
   };
   static_assert(offsetof(CPUState, xmm) % 16 == 0, "xmm needs to be 128bit aligned!");
 
+  /**
+   * @brief Per-thread tables the JIT uses to resolve indirect branches without going back through the dispatcher
+   *
+   * Targets is a direct mapped cache of guest RIP to host code, indexed by the low bits of the RIP
+   * Returns is a circular stack of where calls are expected to return to, pushed by calls and popped by returns
+   * Entries that don't hold anything point at Miss, which just returns to the dispatcher
+   */
+  struct IndirectBranchCache {
+    constexpr static size_t TARGET_ENTRIES = 1024;
+    constexpr static size_t RETURN_ENTRIES = 64;
+    static_assert((TARGET_ENTRIES & (TARGET_ENTRIES - 1)) == 0, "Targets are indexed with a mask");
+    static_assert((RETURN_ENTRIES & (RETURN_ENTRIES - 1)) == 0, "Returns are indexed with a mask");
+
+    struct TargetEntry {
+      std::atomic<uint64_t> GuestRIP;
+      std::atomic<uintptr_t> HostCode;
+    };
+
+    struct ReturnEntry {
+      uint64_t GuestRIP;
+      uintptr_t const *HostCode; ///< Points at the host code to return to, which gets patched as the return is linked
+    };
+
+    TargetEntry Targets[TARGET_ENTRIES];
+    ReturnEntry Returns[RETURN_ENTRIES];
+    uint64_t ReturnTop;
+    uintptr_t Miss;
+
+    void Reset(uintptr_t MissHandler) {
+      Miss = MissHandler;
+      for (auto &Entry : Targets) {
+        Entry.HostCode.store(Miss, std::memory_order_relaxed);
+        Entry.GuestRIP.store(0, std::memory_order_relaxed);
+      }
+      ResetReturns();
+    }
+
+    void ResetReturns() {
+      for (auto &Entry : Returns) {
+        Entry.GuestRIP = 0;
+        Entry.HostCode = &Miss;
+      }
+      ReturnTop = 0;
+    }
+  };
+  static_assert(sizeof(IndirectBranchCache::TargetEntry) == 16, "JIT indexes Targets with a shift");
+  static_assert(sizeof(IndirectBranchCache::ReturnEntry) == 16, "JIT indexes Returns with a shift");
+
   struct ThreadState {
     CPUState State{};
 
@@ -29,6 +77,8 @@ namespace FEXCore::Core {
     } RunningEvents;
 
     FEXCore::HLE::ThreadManagement ThreadManager;
+
+    IndirectBranchCache IndirectBranches{};
   };
   static_assert(offsetof(ThreadState, State) == 0, "CPUState must be first member in threadstate");
   static_assert(offsetof(ThreadState, State.rip) == 0, "rip must be zero offset in threadstate");
@@ -8,6 +8,7 @@
 
 namespace FEXCore::Core {
   struct RuntimeStats;
+  struct CompileStats;
 }
 
 namespace FEXCore::Context {
@@ -19,12 +20,17 @@ namespace Debug {
 
   uint64_t GetThreadCount(FEXCore::Context::Context *CTX);
   FEXCore::Core::RuntimeStats *GetRuntimeStatsForThread(FEXCore::Context::Context *CTX, uint64_t Thread);
+  /**
+   * @brief Compile time breakdown of a guest thread, empty unless CONFIG_COMPILE_STATS is enabled
+   */
+  FEXCore::Core::CompileStats *GetCompileStatsForThread(FEXCore::Context::Context *CTX, uint64_t Thread);
   FEXCore::Core::CPUState GetCPUState(FEXCore::Context::Context *CTX);
 
   void GetMemoryRegions(FEXCore::Context::Context *CTX, std::vector<FEXCore::Memory::MemRegion> *Regions);
 
   bool GetDebugDataForRIP(FEXCore::Context::Context *CTX, uint64_t RIP, FEXCore::Core::DebugData *Data);
   bool FindHostCodeForRIP(FEXCore::Context::Context *CTX, uint64_t RIP, uint8_t **Code);
+  void GetCachedRIPs(FEXCore::Context::Context *CTX, std::vector<uint64_t> *RIPs);
 	// XXX:
   // bool FindIRForRIP(FEXCore::Context::Context *CTX, uint64_t RIP, FEXCore::IR::IntrusiveIRList **ir);
   // void SetIRForRIP(FEXCore::Context::Context *CTX, uint64_t RIP, FEXCore::IR::IntrusiveIRList *const ir);
@@ -4,8 +4,12 @@
 #include <FEXCore/Core/CPUBackend.h>
 #include <FEXCore/IR/IntrusiveIRList.h>
 #include <FEXCore/Utils/Event.h>
-#include <map>
+#include <atomic>
+#include <memory>
+#include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
 namespace FEXCore {
   class BlockCache;
@@ -14,8 +18,15 @@ namespace FEXCore {
 namespace FEXCore::Context {
   struct Context;
 }
+namespace FEXCore::Frontend {
+  class Decoder;
+}
+namespace FEXCore::HLE {
+  struct SyscallTraceBuffer;
+}
 namespace FEXCore::IR{
   class OpDispatchBuilder;
+  class PassManager;
 }
 
 namespace FEXCore::Core {
@@ -25,6 +36,37 @@ namespace FEXCore::Core {
     std::atomic_uint64_t BlocksCompiled;
   };
 
+  /**
+   * @brief Totals for one stage of block compilation over every time it ran
+   */
+  struct CompileStageStats {
+    uint64_t Runs; ///< Number of times the stage ran
+    uint64_t Nanoseconds; ///< Wall time spent in the stage
+    uint64_t NodesBefore; ///< IR nodes going in to the stage, summed over every run
+    uint64_t NodesAfter; ///< IR nodes coming out of the stage, summed over every run
+    uint64_t Changed; ///< Number of runs that changed the IR
+
+    void AddRun(uint64_t Time, uint64_t Before, uint64_t After, bool DidChange) {
+      ++Runs;
+      Nanoseconds += Time;
+      NodesBefore += Before;
+      NodesAfter += After;
+      Changed += DidChange;
+    }
+  };
+
+  /**
+   * @brief Where a thread's compile time went, only collected with CONFIG_COMPILE_STATS
+   *
+   * Only written by the thread that owns it, readers get a consistent view once the thread is paused
+   */
+  struct CompileStats {
+    CompileStageStats Decode; ///< Frontend decoding of guest instructions
+    CompileStageStats Dispatch; ///< Translating decoded instructions to IR
+    CompileStageStats Codegen; ///< CPUBackend compiling the final IR
+    std::vector<std::pair<std::string, CompileStageStats>> Passes; ///< Every IR pass, in pipeline order
+  };
+
   /**
    * @brief Contains debug data for a block of code for later debugger analysis
    *
@@ -35,7 +77,7 @@ namespace FEXCore::Core {
     uint64_t GuestCodeSize; ///< The size of the guest side code
     uint64_t GuestInstructionCount; ///< Number of guest instructions
     uint64_t TimeSpentInCode; ///< How long this code has spent time running
-    uint64_t RunCount; ///< Number of times this block of code has been run
+    uint64_t RunCount; ///< Number of times this block of code has been run, only counted while Context::CountBlockExecutions is set
   };
 
   struct InternalThreadState {
@@ -47,16 +89,41 @@ namespace FEXCore::Core {
     Event StartRunning;
     Event ThreadWaiting;
 
+    /**
+     * @name Compilation state
+     *
+     * Owned by the thread so that threads can compile blocks concurrently
+     * @{ */
+    std::unique_ptr<FEXCore::Frontend::Decoder> FrontendDecoder;
     std::unique_ptr<FEXCore::IR::OpDispatchBuilder> OpDispatcher;
+    std::unique_ptr<FEXCore::IR::PassManager> PassManager;
+    /**  @} */
 
     std::unique_ptr<FEXCore::CPU::CPUBackend> CPUBackend;
     std::unique_ptr<FEXCore::CPU::CPUBackend> FallbackBackend;
 
-    std::unique_ptr<FEXCore::BlockCache> BlockCache;
+    /**
+     * @brief The block cache this thread dispatches out of
+     *
+     * This is the Context's shared cache unless the CPUBackend generates thread specific code
+     */
+    std::shared_ptr<FEXCore::BlockCache> BlockCache;
+
+    /**
+     * @brief Last shared code cache epoch this thread observed from its dispatcher
+     *
+     * ~0ULL while the thread isn't executing any guest code
+     * Retired code isn't freed until every thread has moved past the epoch it was retired in
+     */
+    std::atomic<uint64_t> CodeCacheEpoch {~0ULL};
 
-    std::map<uint64_t, std::unique_ptr<FEXCore::IR::IRListView<true>>> IRLists;
-    std::map<uint64_t, FEXCore::Core::DebugData> DebugData;
     RuntimeStats Stats{};
+    CompileStats Compilation{};
+
+    /**
+     * @brief Where this thread's syscalls are recorded while syscall tracing is on, owned by the SyscallTracer
+     */
+    FEXCore::HLE::SyscallTraceBuffer *SyscallTrace {};
 
     int StatusCode{};
     FEXCore::Context::ExitReason ExitReason {FEXCore::Context::ExitReason::EXIT_WAITING};
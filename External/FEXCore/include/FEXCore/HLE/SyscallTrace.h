@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+
+namespace FEXCore::HLE {
+  constexpr uint64_t SYSCALL_TRACE_MAGIC = 0x4352'5453'5845'46ULL; // "FEXSTRC"
+  constexpr uint32_t SYSCALL_TRACE_VERSION = 1;
+
+  /**
+   * @brief Start of a syscall trace file, followed by SyscallTraceRecords until the end of the file
+   *
+   * Records of a thread are in the order it made the syscalls, records of different threads are interleaved in chunks
+   */
+  struct SyscallTraceHeader {
+    uint64_t Magic;
+    uint32_t Version;
+    uint32_t RecordSize; ///< sizeof(SyscallTraceRecord) of the writer
+    uint64_t Dropped; ///< Records lost because a thread's buffer was full, filled in once tracing stops
+  };
+
+  /**
+   * @brief One guest syscall
+   */
+  struct SyscallTraceRecord {
+    uint64_t Timestamp; ///< steady_clock nanoseconds when the syscall was entered
+    uint64_t Duration; ///< Nanoseconds spent handling the syscall
+    uint32_t TID; ///< Host thread ID of the guest thread
+    uint32_t Number; ///< x86-64 syscall number
+    uint64_t Arguments[6];
+    uint64_t Result;
+  };
+}
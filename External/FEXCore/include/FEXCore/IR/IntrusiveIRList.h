@@ -2,6 +2,7 @@
 
 #include "FEXCore/IR/IR.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstring>
@@ -55,12 +56,94 @@ class IntrusiveAllocator final {
       memcpy(reinterpret_cast<void*>(Data), reinterpret_cast<void*>(rhs.Data), CurrentOffset);
     }
 
+    void CopyData(void const *Src, size_t Size) {
+      assert(Size <= MemorySize && "Trying to copy more data than the IntrusiveAllocator can hold");
+      CurrentOffset = Size;
+      memcpy(reinterpret_cast<void*>(Data), Src, Size);
+    }
+
   private:
     size_t CurrentOffset {0};
     size_t MemorySize;
     uintptr_t Data;
 };
 
+/**
+ * @brief Bump allocator for the IR copies kept around after compilation
+ *
+ * Copies are carved out of large slabs instead of getting their own malloc
+ * A slab is freed in one go once it stopped taking new copies and every copy in it was destroyed
+ * Not thread safe, the owner has to serialize everything including destroying the copies
+ */
+class IRArena final {
+  public:
+    struct Slab {
+      size_t Size;
+      size_t Offset;
+      size_t LiveAllocations;
+    };
+
+    IRArena() = default;
+    IRArena(IRArena &&) = delete;
+
+    ~IRArena() {
+      if (Current) {
+        assert(Current->LiveAllocations == 0 && "IRArena destroyed with IR still alive");
+        free(Current);
+      }
+    }
+
+    void *Allocate(size_t Size, Slab **Owner) {
+      Size = (Size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+      if (!Current || Current->Offset + Size > Current->Size) {
+        NewGeneration();
+        size_t SlabSize = std::max(SLAB_SIZE, Size + sizeof(Slab));
+        Current = reinterpret_cast<Slab*>(malloc(SlabSize));
+        Current->Size = SlabSize;
+        Current->Offset = sizeof(Slab);
+        Current->LiveAllocations = 0;
+        BackingSize += SlabSize;
+      }
+
+      void *Ptr = reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(Current) + Current->Offset);
+      Current->Offset += Size;
+      ++Current->LiveAllocations;
+      *Owner = Current;
+      return Ptr;
+    }
+
+    void Release(Slab *Owner) {
+      --Owner->LiveAllocations;
+      if (Owner != Current && Owner->LiveAllocations == 0) {
+        FreeSlab(Owner);
+      }
+    }
+
+    /**
+     * @brief Stops allocating from the current slab so it can be freed as soon as its IR is gone
+     */
+    void NewGeneration() {
+      if (Current && Current->LiveAllocations == 0) {
+        FreeSlab(Current);
+      }
+      Current = nullptr;
+    }
+
+    size_t GetBackingSize() const { return BackingSize; }
+
+  private:
+    constexpr static size_t SLAB_SIZE = 1024 * 1024;
+    constexpr static size_t ALIGNMENT = 16;
+
+    void FreeSlab(Slab *Owner) {
+      BackingSize -= Owner->Size;
+      free(Owner);
+    }
+
+    Slab *Current {};
+    size_t BackingSize {};
+};
+
 template<bool Copy>
 class IRListView final {
 public:
@@ -84,9 +167,29 @@ public:
     }
   }
 
+  /**
+   * @brief Copies the IR in to memory from Arena
+   */
+  IRListView(IntrusiveAllocator *Data, IntrusiveAllocator *List, IRArena *Arena)
+    : Arena {Arena} {
+    static_assert(Copy, "Only copies can live in an IRArena");
+    DataSize = Data->Size();
+    ListSize = List->Size();
+
+    IRData = Arena->Allocate(DataSize + ListSize, &ArenaSlab);
+    ListData = reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(IRData) + DataSize);
+    memcpy(IRData, reinterpret_cast<void*>(Data->Begin()), DataSize);
+    memcpy(ListData, reinterpret_cast<void*>(List->Begin()), ListSize);
+  }
+
   ~IRListView() {
     if (Copy) {
-      free (IRData);
+      if (Arena) {
+        Arena->Release(ArenaSlab);
+      }
+      else {
+        free (IRData);
+      }
       // ListData is just offset from IRData
     }
   }
@@ -132,6 +235,8 @@ private:
   void *ListData;
   size_t DataSize;
   size_t ListSize;
+  IRArena *Arena {};
+  IRArena::Slab *ArenaSlab {};
 };
 }
 
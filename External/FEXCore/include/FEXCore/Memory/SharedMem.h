@@ -13,10 +13,11 @@ namespace FEXCore::SHM {
    * @brief Allocate a shared memory region that will be the base of our VM's memory
    *
    * @param Size The size of the SHM region
+   * @param HugePages Ask for transparent huge pages on everything mapped from the region, silently uses regular pages when the host has none
    *
    * @return An object representing our internal SHM state
    */
-  SHMObject *AllocateSHMRegion(size_t Size);
+  SHMObject *AllocateSHMRegion(size_t Size, bool HugePages = false);
 
   /**
    * @brief Destroy the SHM region
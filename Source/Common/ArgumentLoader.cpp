@@ -52,6 +52,44 @@ namespace FEX::ArgLoader {
         .dest("Multiblock")
         .action("store_false")
         .help("Enable Multiblock code compilation");
+     CPUGroup.add_option("--tier-up")
+        .dest("TierUpThreshold")
+        .help("Compile blocks with a fast baseline tier first, recompiling them with full optimizations after this many executions. 0 disables tiering")
+        .set_default(0);
+     CPUGroup.add_option("--translation-cache")
+        .dest("TranslationCache")
+        .action("store_true")
+        .help("Keep compiled IR on disk between runs of the same application");
+     CPUGroup.add_option("--no-translation-cache")
+        .dest("TranslationCache")
+        .action("store_false")
+        .help("Keep compiled IR on disk between runs of the same application");
+     CPUGroup.add_option("--lazy-flags")
+        .dest("LazyFlags")
+        .action("store_true")
+        .help("Defer calculating the flags of ALU ops until they are needed, branching on compare operands directly");
+     CPUGroup.add_option("--no-lazy-flags")
+        .dest("LazyFlags")
+        .action("store_false")
+        .help("Defer calculating the flags of ALU ops until they are needed, branching on compare operands directly");
+     CPUGroup.add_option("--ra")
+        .dest("RegisterAllocator")
+        .help("Register allocator for fully optimized code")
+        .choices({"graph", "linear"})
+        .set_default("graph");
+     CPUGroup.add_option("--baseline-ra")
+        .dest("BaselineRegisterAllocator")
+        .help("Register allocator for the baseline tier of tiered compilation")
+        .choices({"graph", "linear"})
+        .set_default("linear");
+     CPUGroup.add_option("--static-registers")
+        .dest("StaticRegisters")
+        .action("store_true")
+        .help("Keep the most used guest GPRs of each block in host registers, filled on block entry and written back to the context when the block exits");
+     CPUGroup.add_option("--no-static-registers")
+        .dest("StaticRegisters")
+        .action("store_false")
+        .help("Keep the most used guest GPRs of each block in host registers, filled on block entry and written back to the context when the block exits");
     CPUGroup.add_option("-G", "--gdb")
         .dest("GdbServer")
         .action("store_true")
@@ -71,6 +109,16 @@ namespace FEX::ArgLoader {
         .action("store_true")
         .help("Enable unified memory for the emulator");
 
+      EmulationGroup.add_option("--vdso")
+        .dest("VDSO")
+        .action("store_true")
+        .help("Map a vDSO in to the guest so time and getcpu calls skip the syscall instruction");
+
+      EmulationGroup.add_option("--hugepages")
+        .dest("HugePages")
+        .action("store_true")
+        .help("Back guest memory and the code cache with huge pages, falls back to regular pages when the host has none");
+
       Parser.add_option_group(EmulationGroup);
     }
     {
@@ -106,6 +154,15 @@ namespace FEX::ArgLoader {
           .help("Disable logging")
           .action("store_true");
 
+      LoggingGroup.add_option("--compile-stats")
+          .dest("CompileStats")
+          .help("Time every compilation stage and IR pass, printed on exit")
+          .action("store_true");
+
+      LoggingGroup.add_option("--strace")
+          .dest("SyscallTrace")
+          .help("Record every guest syscall with its arguments, result and time taken in to a binary trace file");
+
       Parser.add_option_group(LoggingGroup);
     }
       
@@ -150,6 +207,36 @@ namespace FEX::ArgLoader {
         Config::Add("Multiblock", std::to_string(Multiblock));
       }
 
+      if (Options.is_set_by_user("TierUpThreshold")) {
+        uint32_t TierUpThreshold = Options.get("TierUpThreshold");
+        Config::Add("TierUpThreshold", std::to_string(TierUpThreshold));
+      }
+
+      if (Options.is_set_by_user("TranslationCache")) {
+        bool TranslationCache = Options.get("TranslationCache");
+        Config::Add("TranslationCache", std::to_string(TranslationCache));
+      }
+
+      if (Options.is_set_by_user("LazyFlags")) {
+        bool LazyFlags = Options.get("LazyFlags");
+        Config::Add("LazyFlags", std::to_string(LazyFlags));
+      }
+
+      if (Options.is_set_by_user("RegisterAllocator")) {
+        std::string RegisterAllocator = Options["RegisterAllocator"];
+        Config::Add("RegisterAllocator", RegisterAllocator == "linear" ? "1" : "0");
+      }
+
+      if (Options.is_set_by_user("BaselineRegisterAllocator")) {
+        std::string BaselineRegisterAllocator = Options["BaselineRegisterAllocator"];
+        Config::Add("BaselineRegisterAllocator", BaselineRegisterAllocator == "linear" ? "1" : "0");
+      }
+
+      if (Options.is_set_by_user("StaticRegisters")) {
+        bool StaticRegisters = Options.get("StaticRegisters");
+        Config::Add("StaticRegisters", std::to_string(StaticRegisters));
+      }
+
       if (Options.is_set_by_user("GdbServer")) {
         bool GdbServer = Options.get("GdbServer");
         Config::Add("GdbServer", std::to_string(GdbServer));
@@ -166,6 +253,16 @@ namespace FEX::ArgLoader {
         bool Option = Options.get("UnifiedMemory");
         Config::Add("UnifiedMemory", std::to_string(Option));
       }
+
+      if (Options.is_set_by_user("VDSO")) {
+        bool Option = Options.get("VDSO");
+        Config::Add("VDSO", std::to_string(Option));
+      }
+
+      if (Options.is_set_by_user("HugePages")) {
+        bool Option = Options.get("HugePages");
+        Config::Add("HugePages", std::to_string(Option));
+      }
     }
 
     {
@@ -194,6 +291,16 @@ namespace FEX::ArgLoader {
         bool SilentLog = Options.get("SilentLog");
         Config::Add("SilentLog", std::to_string(SilentLog));
       }
+
+      if (Options.is_set_by_user("CompileStats")) {
+        bool CompileStats = Options.get("CompileStats");
+        Config::Add("CompileStats", std::to_string(CompileStats));
+      }
+
+      if (Options.is_set_by_user("SyscallTrace")) {
+        std::string Option = Options["SyscallTrace"];
+        Config::Add("SyscallTrace", Option);
+      }
     }
 
     RemainingArgs = Parser.args();
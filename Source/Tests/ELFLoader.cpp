@@ -97,10 +97,20 @@ int main(int argc, char **argv, char **const envp) {
   FEX::Config::Value<uint64_t> BlockSizeConfig{"MaxInst", 1};
   FEX::Config::Value<bool> SingleStepConfig{"SingleStep", false};
   FEX::Config::Value<bool> MultiblockConfig{"Multiblock", false};
+  FEX::Config::Value<uint64_t> TierUpThresholdConfig{"TierUpThreshold", 0};
+  FEX::Config::Value<bool> TranslationCacheConfig{"TranslationCache", false};
+  FEX::Config::Value<bool> LazyFlagsConfig{"LazyFlags", false};
+  FEX::Config::Value<bool> StaticRegistersConfig{"StaticRegisters", false};
+  FEX::Config::Value<uint8_t> RegisterAllocatorConfig{"RegisterAllocator", 0};
+  FEX::Config::Value<uint8_t> BaselineRegisterAllocatorConfig{"BaselineRegisterAllocator", 1};
   FEX::Config::Value<bool> GdbServerConfig{"GdbServer", false};
   FEX::Config::Value<bool> UnifiedMemory{"UnifiedMemory", false};
   FEX::Config::Value<std::string> LDPath{"RootFS", ""};
   FEX::Config::Value<bool> SilentLog{"SilentLog", false};
+  FEX::Config::Value<bool> CompileStatsConfig{"CompileStats", false};
+  FEX::Config::Value<bool> VDSOConfig{"VDSO", false};
+  FEX::Config::Value<std::string> SyscallTraceConfig{"SyscallTrace", ""};
+  FEX::Config::Value<bool> HugePagesConfig{"HugePages", false};
 
   ::SilentLog = SilentLog();
 
@@ -112,18 +122,30 @@ int main(int argc, char **argv, char **const envp) {
   FEX::HarnessHelper::ELFCodeLoader Loader{Args[0], LDPath(), Args, ParsedArgs, envp};
 
   FEXCore::Context::InitializeStaticTables();
-  auto SHM = FEXCore::SHM::AllocateSHMRegion(1ULL << 36);
+  auto SHM = FEXCore::SHM::AllocateSHMRegion(1ULL << 36, HugePagesConfig());
   auto CTX = FEXCore::Context::CreateNewContext();
   FEXCore::Context::InitializeContext(CTX);
   FEXCore::Context::SetApplicationFile(CTX, std::filesystem::canonical(Args[0]));
 
   FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_DEFAULTCORE, CoreConfig() > 3 ? FEXCore::Config::CONFIG_CUSTOM : CoreConfig());
   FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_MULTIBLOCK, MultiblockConfig());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_TIERUP_THRESHOLD, TierUpThresholdConfig());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_TRANSLATION_CACHE, TranslationCacheConfig());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_LAZY_FLAGS, LazyFlagsConfig());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_STATIC_REGISTERS, StaticRegistersConfig());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_REGISTER_ALLOCATOR, RegisterAllocatorConfig());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_BASELINE_REGISTER_ALLOCATOR, BaselineRegisterAllocatorConfig());
   FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_SINGLESTEP, SingleStepConfig());
   FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_MAXBLOCKINST, BlockSizeConfig());
   FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_GDBSERVER, GdbServerConfig());
   FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_ROOTFSPATH, LDPath());
   FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_UNIFIED_MEMORY, UnifiedMemory());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_COMPILE_STATS, CompileStatsConfig());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_VDSO, VDSOConfig());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_HUGE_PAGES, HugePagesConfig());
+  if (!SyscallTraceConfig().empty()) {
+    FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_SYSCALL_TRACE, SyscallTraceConfig());
+  }
   FEXCore::Context::SetCustomCPUBackendFactory(CTX, VMFactory::CPUCreationFactory);
   // FEXCore::Context::SetFallbackCPUBackendFactory(CTX, VMFactory::CPUCreationFactoryFallback);
 
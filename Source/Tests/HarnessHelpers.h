@@ -451,6 +451,14 @@ public:
     AuxVariables.emplace_back(auxv_t{0, 0}); // Null ender
   }
 
+  void SetVDSOBase(uint64_t Base) override {
+    for (auto &Aux : AuxVariables) {
+      if (Aux.key == 33) { // AT_SYSINFO_EHDR
+        Aux.val = Base;
+      }
+    }
+  }
+
   uint64_t SetupStack(void *HostPtr, uint64_t GuestPtr) const override {
     uintptr_t StackPointer = reinterpret_cast<uintptr_t>(HostPtr) + StackSize();
     // Set up our initial CPU state
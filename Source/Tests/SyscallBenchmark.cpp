@@ -0,0 +1,84 @@
+// Times the syscalls that programs make the most of, so runs with and without --vdso can be compared
+// Runs natively as well, which gives the number to aim for
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace {
+  // Keeps the compiler from throwing away results
+  volatile uint64_t Sink;
+
+  uint64_t Now() {
+    timespec Time;
+    clock_gettime(CLOCK_MONOTONIC, &Time);
+    return Time.tv_sec * 1000000000ULL + Time.tv_nsec;
+  }
+
+  // libc's syscall() moves the number in from an argument register
+  // Inline so the number is a constant in the block, the way libc's own getpid wrappers do it
+  template<long Number>
+  long RawSyscall() {
+#ifdef __x86_64__
+    long Result;
+    __asm volatile("syscall" : "=a"(Result) : "a"(Number) : "rcx", "r11", "memory");
+    return Result;
+#else
+    return syscall(Number);
+#endif
+  }
+
+  template<typename T>
+  void Run(char const *Name, uint64_t Iterations, T Func) {
+    // Warm up, gets the code compiled before timing it
+    for (uint64_t i = 0; i < 1000; ++i) {
+      Sink = Func();
+    }
+
+    uint64_t Begin = Now();
+    for (uint64_t i = 0; i < Iterations; ++i) {
+      Sink = Func();
+    }
+    uint64_t End = Now();
+
+    printf("%-16s %10.1f ns/call\n", Name, static_cast<double>(End - Begin) / Iterations);
+  }
+}
+
+int main(int argc, char **argv) {
+  uint64_t Iterations = argc > 1 ? strtoull(argv[1], nullptr, 0) : 1000000;
+
+  Run("clock_gettime", Iterations, []() -> uint64_t {
+    timespec Time;
+    clock_gettime(CLOCK_MONOTONIC, &Time);
+    return Time.tv_nsec;
+  });
+
+  Run("gettimeofday", Iterations, []() -> uint64_t {
+    timeval Time;
+    gettimeofday(&Time, nullptr);
+    return Time.tv_usec;
+  });
+
+  Run("time", Iterations, []() -> uint64_t {
+    return time(nullptr);
+  });
+
+  Run("getcpu", Iterations, []() -> uint64_t {
+    return sched_getcpu();
+  });
+
+  Run("gettid", Iterations, []() -> uint64_t {
+    return RawSyscall<SYS_gettid>();
+  });
+
+  Run("getpid", Iterations, []() -> uint64_t {
+    return RawSyscall<SYS_getpid>();
+  });
+
+  return 0;
+}
@@ -60,6 +60,12 @@ int main(int argc, char **argv, char **const envp) {
   FEX::Config::Value<uint64_t> BlockSizeConfig{"MaxInst", 1};
   FEX::Config::Value<bool> SingleStepConfig{"SingleStep", false};
   FEX::Config::Value<bool> MultiblockConfig{"Multiblock", false};
+  FEX::Config::Value<uint64_t> TierUpThresholdConfig{"TierUpThreshold", 0};
+  FEX::Config::Value<bool> LazyFlagsConfig{"LazyFlags", false};
+  FEX::Config::Value<bool> TranslationCacheConfig{"TranslationCache", false};
+  FEX::Config::Value<bool> StaticRegistersConfig{"StaticRegisters", false};
+  FEX::Config::Value<uint8_t> RegisterAllocatorConfig{"RegisterAllocator", 0};
+  FEX::Config::Value<uint8_t> BaselineRegisterAllocatorConfig{"BaselineRegisterAllocator", 1};
 
   auto Args = FEX::ArgLoader::Get();
 
@@ -73,11 +79,19 @@ int main(int argc, char **argv, char **const envp) {
   FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_UNIFIED_MEMORY, 0); // ensure TestHarnessRunner doesn't enable UnifiedMemory.
   FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_DEFAULTCORE, CoreConfig() > 3 ? FEXCore::Config::CONFIG_CUSTOM : CoreConfig());
   FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_MULTIBLOCK, MultiblockConfig());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_TIERUP_THRESHOLD, TierUpThresholdConfig());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_LAZY_FLAGS, LazyFlagsConfig());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_TRANSLATION_CACHE, TranslationCacheConfig());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_STATIC_REGISTERS, StaticRegistersConfig());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_REGISTER_ALLOCATOR, RegisterAllocatorConfig());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_BASELINE_REGISTER_ALLOCATOR, BaselineRegisterAllocatorConfig());
   FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_SINGLESTEP, SingleStepConfig());
   FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_MAXBLOCKINST, BlockSizeConfig());
   FEXCore::Context::SetCustomCPUBackendFactory(CTX, VMFactory::CPUCreationFactory);
 
   FEXCore::Context::AddGuestMemoryRegion(CTX, SHM);
+  // The translation cache is keyed on the test binary
+  FEXCore::Context::SetApplicationFile(CTX, Args[0]);
 
   FEXCore::Context::InitializeContext(CTX);
 
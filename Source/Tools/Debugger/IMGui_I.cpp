@@ -461,7 +461,7 @@ namespace IR {
   bool ShowCPUIRList = true;
 
   struct IRDebugData {
-    FEXCore::Core::DebugData *Debug;
+    FEXCore::Core::DebugData Debug;
     uint64_t RIP;
     std::string RIPString;
     std::string GuestCodeSize;
@@ -557,10 +557,10 @@ namespace IR {
     };
 
     auto SortByCodeSize = [](IRDebugData const &a, IRDebugData const &b) -> bool {
-        return a.Debug->GuestCodeSize < b.Debug->GuestCodeSize;
+        return a.Debug.GuestCodeSize < b.Debug.GuestCodeSize;
     };
     auto SortByInstCount = [](IRDebugData const &a, IRDebugData const &b) -> bool {
-        return a.Debug->GuestInstructionCount < b.Debug->GuestInstructionCount;
+        return a.Debug.GuestInstructionCount < b.Debug.GuestInstructionCount;
     };
 
     if (ImGui::Begin("#CPU IR Entries", &ShowCPUIRList)) {
@@ -673,22 +673,19 @@ namespace IR {
       return;
     }
 
-    FEXCore::Core::ThreadState *State = FEXCore::Context::Debug::GetThreadState(FEX::DebuggerState::GetContext());
-    FEXCore::Core::InternalThreadState *TS = reinterpret_cast<FEXCore::Core::InternalThreadState*>(State);
+    // The IR cache is shared between every thread in the context
+    std::vector<uint64_t> RIPs;
+    FEXCore::Context::Debug::GetCachedRIPs(FEX::DebuggerState::GetContext(), &RIPs);
 
-    auto &IRList = TS->IRLists;
-    auto &DebugData = TS->DebugData;
-
-    for (auto &IR : IRList) {
+    for (auto RIP : RIPs) {
        std::ostringstream out;
-       out << "0x" << std::hex << IR.first;
-       auto Data = DebugData.find(IR.first);
-       IRDebugData DebugData;
-       DebugData.Debug = &Data->second;
-       DebugData.RIP = IR.first;
+       out << "0x" << std::hex << RIP;
+       IRDebugData DebugData{};
+       FEXCore::Context::Debug::GetDebugDataForRIP(FEX::DebuggerState::GetContext(), RIP, &DebugData.Debug);
+       DebugData.RIP = RIP;
        DebugData.RIPString = out.str();
-       DebugData.GuestCodeSize = std::to_string(Data->second.GuestCodeSize);
-       DebugData.GuestInstructionCount = std::to_string(Data->second.GuestInstructionCount);
+       DebugData.GuestCodeSize = std::to_string(DebugData.Debug.GuestCodeSize);
+       DebugData.GuestInstructionCount = std::to_string(DebugData.Debug.GuestInstructionCount);
        IRListTexts.emplace_back(DebugData);
     }
   }
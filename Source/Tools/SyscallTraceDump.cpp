@@ -0,0 +1,94 @@
+// Summarizes a trace written by --strace, syscalls sorted by the total time spent in them
+// -a also prints every record in the order they were made
+#include <FEXCore/HLE/SyscallTrace.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <vector>
+
+namespace {
+  struct SyscallTotals {
+    uint64_t Count;
+    uint64_t Nanoseconds;
+    uint64_t MaxNanoseconds;
+    uint64_t Errors;
+  };
+}
+
+int main(int argc, char **argv) {
+  bool PrintAll = argc > 2 && strcmp(argv[1], "-a") == 0;
+  if (argc < 2 || (argc > 2 && !PrintAll)) {
+    fprintf(stderr, "Usage: %s [-a] <trace file>\n", argv[0]);
+    return 1;
+  }
+
+  char const *Path = argv[argc - 1];
+  FILE *File = fopen(Path, "rb");
+  if (!File) {
+    fprintf(stderr, "Couldn't open %s\n", Path);
+    return 1;
+  }
+
+  FEXCore::HLE::SyscallTraceHeader Header{};
+  if (fread(&Header, sizeof(Header), 1, File) != 1 ||
+      Header.Magic != FEXCore::HLE::SYSCALL_TRACE_MAGIC ||
+      Header.Version != FEXCore::HLE::SYSCALL_TRACE_VERSION ||
+      Header.RecordSize != sizeof(FEXCore::HLE::SyscallTraceRecord)) {
+    fprintf(stderr, "%s isn't a syscall trace this tool understands\n", Path);
+    fclose(File);
+    return 1;
+  }
+
+  std::vector<FEXCore::HLE::SyscallTraceRecord> Records;
+  FEXCore::HLE::SyscallTraceRecord Record;
+  while (fread(&Record, sizeof(Record), 1, File) == 1) {
+    Records.emplace_back(Record);
+  }
+  fclose(File);
+
+  if (PrintAll) {
+    // Threads were written out a chunk at a time
+    std::stable_sort(Records.begin(), Records.end(), [](auto const &A, auto const &B) {
+      return A.Timestamp < B.Timestamp;
+    });
+
+    for (auto const &Record : Records) {
+      printf("%" PRIu64 " [%u] syscall %u(0x%" PRIx64 ", 0x%" PRIx64 ", 0x%" PRIx64 ", 0x%" PRIx64 ", 0x%" PRIx64 ", 0x%" PRIx64 ") = %" PRId64 " <%" PRIu64 "ns>\n",
+        Record.Timestamp, Record.TID, Record.Number,
+        Record.Arguments[0], Record.Arguments[1], Record.Arguments[2],
+        Record.Arguments[3], Record.Arguments[4], Record.Arguments[5],
+        static_cast<int64_t>(Record.Result), Record.Duration);
+    }
+    printf("\n");
+  }
+
+  std::map<uint32_t, SyscallTotals> Totals;
+  uint64_t TotalNanoseconds {};
+  for (auto const &Record : Records) {
+    auto &Total = Totals[Record.Number];
+    ++Total.Count;
+    Total.Nanoseconds += Record.Duration;
+    Total.MaxNanoseconds = std::max(Total.MaxNanoseconds, Record.Duration);
+    // Negative errno
+    Total.Errors += Record.Result >= -4095ULL;
+    TotalNanoseconds += Record.Duration;
+  }
+
+  std::vector<std::pair<uint32_t, SyscallTotals>> Sorted(Totals.begin(), Totals.end());
+  std::sort(Sorted.begin(), Sorted.end(), [](auto const &A, auto const &B) {
+    return A.second.Nanoseconds > B.second.Nanoseconds;
+  });
+
+  printf("%% time     total ns      calls    avg ns    max ns   errors  syscall\n");
+  for (auto const &[Number, Total] : Sorted) {
+    printf("%6.2f %12" PRIu64 " %10" PRIu64 " %9" PRIu64 " %9" PRIu64 " %8" PRIu64 "  %u\n",
+      TotalNanoseconds ? 100.0 * Total.Nanoseconds / TotalNanoseconds : 0.0,
+      Total.Nanoseconds, Total.Count, Total.Nanoseconds / Total.Count, Total.MaxNanoseconds, Total.Errors, Number);
+  }
+  printf("%" PRIu64 " syscalls, %" PRIu64 " dropped\n", static_cast<uint64_t>(Records.size()), Header.Dropped);
+
+  return 0;
+}
@@ -0,0 +1,152 @@
+%ifdef CONFIG
+{
+  "RegData": {
+    "RAX": "0x0000010001000001",
+    "RBX": "0x1111",
+    "RCX": "0x44441111",
+    "RDX": "0x10845890",
+    "R8": "0x1101",
+    "R9": "0x1234567890abcd80",
+    "R10": "0xaaaaaaaaaaaa0000"
+  },
+  "MemoryRegions": {
+    "0x100000000": "4096"
+  }
+}
+%endif
+
+; add at every size, each followed straight away by a different flag consumer
+; RAX holds the setcc results, RBX the jcc results, RCX the cmovcc results
+; RDX the pushf flags, R8 the adc results and R9/R10 add results with garbage above the operands
+mov r15, 0xe0000000
+mov rax, 0
+mov rbx, 0
+mov rcx, 0
+mov rdx, 0
+mov r8, 0
+
+; 8-bit signed overflow, 0x7f + 1
+mov r11, 0x1234567890abcd7f
+add r11b, 1
+seto byte [r15 + 0]
+mov r11, 0x1234567890abcd7f
+add r11b, 1
+setl byte [r15 + 1]
+mov r11, 0x1234567890abcd7f
+add r11b, 1
+setb byte [r15 + 2]
+mov r9, r11
+
+; 16-bit with garbage above the operands, 0xffff + 1 carries out to zero
+mov r11, 0xaaaaaaaaaaaaffff
+mov r12, 0x5555555555550001
+add r11w, r12w
+setbe byte [r15 + 3]
+mov r11, 0xaaaaaaaaaaaaffff
+add r11w, r12w
+sets byte [r15 + 4]
+mov r10, r11
+
+; 32-bit where both carry and signed overflow happen, 0x80000000 + 0x80000000
+mov r11, 0xaaaaaaaa80000000
+mov r12, 0x5555555580000000
+add r11d, r12d
+setz byte [r15 + 5]
+mov r11, 0xaaaaaaaa80000000
+add r11d, r12d
+setnle byte [r15 + 6]
+
+; 64-bit unsigned carry without signed overflow, -1 + 2
+mov r11, -1
+mov r12, 2
+add r11, r12
+setnbe byte [r15 + 7]
+mov rax, [r15]
+
+; jcc
+mov r11, 0x1234567890abcd7f
+add r11b, 1
+jno .jcc_8_done
+or rbx, 0x1
+.jcc_8_done:
+
+mov r11, 0xaaaaaaaaaaaaffff
+mov r12, 0x5555555555550001
+add r11w, r12w
+jnb .jcc_16_done
+or rbx, 0x10
+.jcc_16_done:
+
+mov r11, 0xaaaaaaaa80000000
+mov r12, 0x5555555580000000
+add r11d, r12d
+jno .jcc_32_done
+or rbx, 0x100
+.jcc_32_done:
+
+mov r11, -1
+mov r12, 2
+add r11, r12
+js .jcc_64_done
+or rbx, 0x1000
+.jcc_64_done:
+
+; cmovcc, taken and not taken
+mov r13, 0x1111
+mov r11, 0xaaaaaaaaaaaaffff
+mov r12, 0x5555555555550001
+add r11w, r12w
+cmovz rcx, r13
+
+mov r13, 0x2222
+mov r11, -1
+mov r12, 2
+add r11, r12
+cmovl rcx, r13
+
+mov r13, 0x4444
+mov r14, 0
+mov r11, 0x7fffffffffffffff
+mov r12, 1
+add r11, r12
+cmovo r14, r13
+shl r14, 16
+or rcx, r14
+
+; pushf, only the flags add defines
+mov r11, 0x1234567890abcd7f
+add r11b, 1
+pushf
+pop r14
+and r14, 0x8d5
+mov rdx, r14
+
+mov r11, 0xaaaaaaaa80000000
+mov r12, 0x5555555580000000
+add r11d, r12d
+pushf
+pop r14
+and r14, 0x8d5
+shl r14, 12
+or rdx, r14
+
+mov r11, 0x000000000000000f
+add r11, 0x11
+pushf
+pop r14
+and r14, 0x8d5
+shl r14, 24
+or rdx, r14
+
+; adc picks up the carry
+mov r11, 0xaaaaaaaaaaaaffff
+mov r12, 0x5555555555550001
+add r11w, r12w
+adc r8, 0x100
+
+mov r11, 0x7fffffffffffffff
+mov r12, 1
+add r11, r12
+adc r8, 0x1000
+
+hlt
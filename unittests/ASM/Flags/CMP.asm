@@ -0,0 +1,144 @@
+%ifdef CONFIG
+{
+  "RegData": {
+    "RAX": "0x0100010101000101",
+    "RBX": "0x1111",
+    "RCX": "0x44441111",
+    "RDX": "0x85044810",
+    "R8": "0x1101"
+  },
+  "MemoryRegions": {
+    "0x100000000": "4096"
+  }
+}
+%endif
+
+; cmp at every size, each followed straight away by a different flag consumer
+; RAX holds the setcc results, RBX the jcc results, RCX the cmovcc results
+; RDX the pushf flags and R8 the adc results
+mov r15, 0xe0000000
+mov rax, 0
+mov rbx, 0
+mov rcx, 0
+mov rdx, 0
+mov r8, 0
+
+; 8-bit signed overflow, 0x80 - 1
+mov r11, 0x1234567890abcd80
+cmp r11b, 1
+seto byte [r15 + 0]
+cmp r11b, 1
+setl byte [r15 + 1]
+cmp r11b, 1
+setb byte [r15 + 2]
+
+; 16-bit with garbage above the operands, 1 - 2 borrows
+mov r11, 0xffffffffffff0001
+mov r12, 0x0000000000000002
+cmp r11w, r12w
+setbe byte [r15 + 3]
+cmp r11w, r12w
+sets byte [r15 + 4]
+
+; 32-bit equal with different upper halves
+mov r11, 0xaaaaaaaa12345678
+mov r12, 0x5555555512345678
+cmp r11d, r12d
+setz byte [r15 + 5]
+cmp r11d, r12d
+setnle byte [r15 + 6]
+
+; 64-bit where signed and unsigned orderings disagree, -1 against 1
+mov r11, -1
+mov r12, 1
+cmp r11, r12
+setnbe byte [r15 + 7]
+mov rax, [r15]
+
+; jcc
+mov r11, 0x1234567890abcd80
+cmp r11b, 1
+jno .jcc_8_done
+or rbx, 0x1
+.jcc_8_done:
+
+mov r11, 0xffffffffffff0001
+mov r12, 0x0000000000000002
+cmp r11w, r12w
+jnb .jcc_16_done
+or rbx, 0x10
+.jcc_16_done:
+
+mov r11, 0xaaaaaaaa12345678
+mov r12, 0x5555555512345678
+cmp r11d, r12d
+jnz .jcc_32_done
+or rbx, 0x100
+.jcc_32_done:
+
+mov r11, -1
+mov r12, 1
+cmp r11, r12
+jnl .jcc_64_done
+or rbx, 0x1000
+.jcc_64_done:
+
+; cmovcc, taken and not taken
+mov r13, 0x1111
+mov r11, 0xffffffffffff0001
+mov r12, 0x0000000000000002
+cmp r11w, r12w
+cmovb rcx, r13
+
+mov r13, 0x2222
+mov r11, -1
+mov r12, 1
+cmp r11, r12
+cmovg rcx, r13
+
+mov r13, 0x4444
+mov r14, 0
+mov r11, 0x8000000000000000
+mov r12, 1
+cmp r11, r12
+cmovo r14, r13
+shl r14, 16
+or rcx, r14
+
+; pushf, only the flags cmp defines
+mov r11, 0x1234567890abcd80
+cmp r11b, 1
+pushf
+pop r14
+and r14, 0x8d5
+mov rdx, r14
+
+mov r11, 0xaaaaaaaa12345678
+mov r12, 0x5555555512345678
+cmp r11d, r12d
+pushf
+pop r14
+and r14, 0x8d5
+shl r14, 12
+or rdx, r14
+
+mov r11, 0x000000000000000f
+cmp r11, 0x10
+pushf
+pop r14
+and r14, 0x8d5
+shl r14, 24
+or rdx, r14
+
+; adc picks up the borrow
+mov r11, 0xffffffffffff0001
+mov r12, 0x0000000000000002
+cmp r11w, r12w
+adc r8, 0x100
+
+mov r11, -1
+mov r12, 1
+cmp r11, r12
+adc r8, 0x1000
+
+hlt
@@ -0,0 +1,131 @@
+%ifdef CONFIG
+{
+  "RegData": {
+    "RAX": "0x10101010101",
+    "RBX": "0x1010",
+    "RDX": "0x44000080",
+    "R8": "0x89005",
+    "R9": "0x1000"
+  },
+  "MemoryRegions": {
+    "0x100000000": "4096"
+  }
+}
+%endif
+
+; Flags that are set in one block and read in another
+; RAX gets the setcc results from straight line successors, RBX the ones from joins
+; R9 the adc chain carried around a loop, RDX the flags read at the top of a loop
+; R8 the flags that survived a loop which doesn't write them
+mov r15, 0xe0000000
+mov rax, 0
+mov rbx, 0
+mov rdx, 0
+
+; Set in one block, read after an unconditional jump
+mov r11, 0x8000000000000000
+add r11, r11
+jmp .jmp_target
+mov r11, 1
+add r11, r11
+.jmp_target:
+setc byte [r15 + 0]
+setz byte [r15 + 1]
+seto byte [r15 + 2]
+
+; The branch only consumes ZF, the successors read the rest
+mov r11, 0x7fffffff
+add r11d, 1
+jz .branch_done
+seto byte [r15 + 3]
+sets byte [r15 + 4]
+.branch_done:
+setp byte [r15 + 5]
+mov rax, [r15]
+
+; Only one side of a diamond writes the flags, the join reads whatever reached it
+; jrcxz picks the side so nothing in between touches the flags
+mov qword [r15], 0
+mov r12, 2
+.diamond:
+mov rcx, r12
+and rcx, 1
+mov r11, 1
+cmp r11, 2
+jrcxz .diamond_skip
+mov r11, 3
+cmp r11, 2
+.diamond_skip:
+setb r13b
+movzx r13, r13b
+shl rbx, 4
+or rbx, r13
+dec r12
+jns .diamond
+
+; An earlier write that is overwritten in the successor must not leak through
+mov r11, -1
+add r11, 1
+jmp .overwrite
+.overwrite:
+mov r11, 1
+cmp r11, 0
+setc r13b
+shl rbx, 4
+or bl, r13b
+
+; adc carries CF around the back edge, dec leaves it alone
+; R9 gets the carry out above the three low bytes of the sum
+mov qword [r15 + 0], -1
+mov qword [r15 + 8], -1
+mov qword [r15 + 16], -1
+mov qword [r15 + 32], 1
+mov qword [r15 + 40], 0
+mov qword [r15 + 48], 0
+mov r11, 0
+mov r12, 3
+clc
+.adc_loop:
+mov r13, [r15 + r11 * 8]
+adc [r15 + 32 + r11 * 8], r13
+lea r11, [r11 + 1]
+dec r12
+jnz .adc_loop
+mov r9, 0
+adc r9, 0
+shl r9, 4
+or r9, [r15 + 32]
+shl r9, 4
+or r9, [r15 + 40]
+shl r9, 4
+or r9, [r15 + 48]
+
+; Flags written at the bottom of the loop are read at the top of the next iteration
+; loop doesn't touch the flags
+mov rcx, 3
+mov r11, 0x20
+cmp r11, r11
+.head_loop:
+pushf
+pop r13
+and r13, 0x8d5
+shl rdx, 12
+or rdx, r13
+shl r11, 1
+test r11b, r11b
+loop .head_loop
+
+; Flags set before a loop that leaves them alone survive to the exit
+mov r11, 0x7f
+add r11b, 1
+mov r12, 0
+mov rcx, 5
+.flag_free_loop:
+lea r12, [r12 + 1]
+loop .flag_free_loop
+pushf
+pop r8
+and r8, 0x8d5
+shl r8, 8
+or r8, r12
+hlt
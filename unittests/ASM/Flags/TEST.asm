@@ -0,0 +1,146 @@
+%ifdef CONFIG
+{
+  "RegData": {
+    "RAX": "0x0101000101000100",
+    "RBX": "0x1111",
+    "RCX": "0x44441111",
+    "RDX": "0x44000080",
+    "R8": "0x100"
+  },
+  "MemoryRegions": {
+    "0x100000000": "4096"
+  }
+}
+%endif
+
+; test at every size, each followed straight away by a different flag consumer
+; test always clears CF and OF, so the carry and overflow consumers check they really are clear
+; RAX holds the setcc results, RBX the jcc results, RCX the cmovcc results
+; RDX the pushf flags and R8 the adc results
+mov r15, 0xe0000000
+mov rax, 0
+mov rbx, 0
+mov rcx, 0
+mov rdx, 0
+mov r8, 0
+
+; Sets carry and overflow beforehand so stale flags show up
+mov r11, 0x7fffffffffffffff
+add r11, r11
+
+; 8-bit sign bit
+mov r11, 0x1234567890abcd80
+test r11b, 0xff
+seto byte [r15 + 0]
+test r11b, 0xff
+setl byte [r15 + 1]
+test r11b, 0xff
+setb byte [r15 + 2]
+
+; 16-bit where only the garbage above the operands overlaps
+mov r11, 0xffffffffffff00f0
+mov r12, 0xffffffffffff0f0f
+test r11w, r12w
+setbe byte [r15 + 3]
+test r11w, r12w
+setp byte [r15 + 4]
+
+; 32-bit with an odd number of bits in the low byte of the result
+mov r11, 0xaaaaaaaa00000007
+mov r12, 0x55555555ffffffff
+test r11d, r12d
+setz byte [r15 + 5]
+test r11d, r12d
+setnle byte [r15 + 6]
+
+; 64-bit sign bit
+mov r11, 0x8000000000000001
+mov r12, 0x8000000000000000
+test r11, r12
+setnbe byte [r15 + 7]
+mov rax, [r15]
+
+; jcc
+mov r11, 0x1234567890abcd80
+test r11b, 0xff
+jns .jcc_8_done
+or rbx, 0x1
+.jcc_8_done:
+
+mov r11, 0xffffffffffff00f0
+mov r12, 0xffffffffffff0f0f
+test r11w, r12w
+jnz .jcc_16_done
+or rbx, 0x10
+.jcc_16_done:
+
+mov r11, 0xaaaaaaaa00000007
+mov r12, 0x55555555ffffffff
+test r11d, r12d
+jp .jcc_32_done
+or rbx, 0x100
+.jcc_32_done:
+
+mov r11, 0x8000000000000001
+mov r12, 0x8000000000000000
+test r11, r12
+jnl .jcc_64_done
+or rbx, 0x1000
+.jcc_64_done:
+
+; cmovcc, taken and not taken
+mov r13, 0x1111
+mov r11, 0xffffffffffff00f0
+mov r12, 0xffffffffffff0f0f
+test r11w, r12w
+cmovz rcx, r13
+
+mov r13, 0x2222
+mov r11, 0x8000000000000001
+mov r12, 0x8000000000000000
+test r11, r12
+cmovb rcx, r13
+
+mov r13, 0x4444
+mov r14, 0
+mov r11, 0x8000000000000001
+mov r12, 0x8000000000000000
+test r11, r12
+cmovle r14, r13
+shl r14, 16
+or rcx, r14
+
+; pushf, AF is undefined after test so it gets masked out
+mov r11, 0x1234567890abcd80
+test r11b, 0xff
+pushf
+pop r14
+and r14, 0x8c5
+mov rdx, r14
+
+mov r11, 0xaaaaaaaa00000007
+mov r12, 0x55555555ffffffff
+test r11d, r12d
+pushf
+pop r14
+and r14, 0x8c5
+shl r14, 12
+or rdx, r14
+
+mov r11, 0xffffffffffff00f0
+mov r12, 0xffffffffffff0f0f
+test r11w, r12w
+pushf
+pop r14
+and r14, 0x8c5
+shl r14, 24
+or rdx, r14
+
+; adc sees the cleared carry
+mov r11, -1
+add r11, 1
+mov r11, 0x8000000000000001
+test r11, r11
+adc r8, 0x100
+
+hlt
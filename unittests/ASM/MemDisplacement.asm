@@ -0,0 +1,126 @@
+%ifdef CONFIG
+{
+  "RegData": {
+    "RAX": "0x8786858483828180",
+    "RBX": "0xf9cfcd9500aac13f",
+    "RCX": "0xd0cfcecdcccbcac9",
+    "RDX": "0x8f8e8d8c8b8a8988",
+    "RDI": "0xe7e6e5e4e3e2e1e0",
+    "RBP": "0xf7f6f5f4f3f2f1f0",
+    "R8": "0x1716151413121110",
+    "R9": "0x2726252423222120",
+    "R10": "0x3a39383736353433",
+    "R11": "0x44434241",
+    "R12": "0x5251",
+    "R13": "0x60",
+    "R14": "0x7877767574737271"
+  },
+  "MemoryRegions": {
+    "0x100000000": "4096"
+  }
+}
+%endif
+
+; Loads and stores through displacements the AArch64 ldr/str immediates can't encode
+; Scaled offsets only go up to 4095 * access size and have to be a multiple of it, unscaled ones are [-256, 255]
+mov r15, 0xe0080000
+
+; Bytes 0 to 255 repeating over [r15 - 0x400, r15 + 0x400)
+mov rdi, 0xe007fc00
+mov eax, 0
+mov ecx, 0x800
+fill:
+mov [rdi], al
+add al, 1
+add rdi, 1
+sub ecx, 1
+jnz fill
+
+; Large positive
+mov rbx, 0xe006dcd0
+mov r8, qword [rbx + 0x12340]
+
+; Large negative
+mov rbx, 0xe0092368
+mov r9, qword [rbx - 0x12348]
+
+; Misaligned, too large to be unscaled
+mov rbx, 0xe007ff30
+mov r10, qword [rbx + 0x103]
+
+; 32bit, past the scaled range and misaligned
+mov rbx, 0xe007c040
+mov r11d, dword [rbx + 0x4001]
+
+; 16bit, negative and misaligned
+mov rbx, 0xe0081052
+movzx r12, word [rbx - 0x1001]
+
+; 8bit, one past the scaled range
+mov rbx, 0xe007f060
+movzx r13, byte [rbx + 0x1000]
+
+; Largest scaled offset
+mov rbx, 0xe0077ff8
+mov rbp, qword [rbx + 0x7ff8]
+
+; Smallest unscaled offset, kept in memory until the hash is done
+mov rbx, 0xe00800e0
+mov rdi, qword [rbx - 0x100]
+mov qword [r15 - 0x2f0], rdi
+
+; Misaligned, largest unscaled offset
+mov rbx, 0xe007feca
+mov rcx, qword [rbx + 0xff]
+
+; Indexed, large and misaligned
+mov rsi, 3
+mov rbx, 0xe0060058
+mov r14, qword [rbx + rsi * 8 + 0x20001]
+
+; 128bit, a multiple of 8 but not 16
+mov rbx, 0xe0070078
+movups xmm0, [rbx + 0x10008]
+movups [r15 - 0x300], xmm0
+mov rax, qword [r15 - 0x300]
+mov rdx, qword [r15 - 0x2f8]
+
+; Stores, checked with a hash of [r15 + 0x200, r15 + 0x300)
+; 64bit, misaligned past the scaled range
+mov rbx, 0xe0078208
+mov qword [rbx + 0x7ff9], r8
+
+; 32bit, large negative
+mov rbx, 0xe0088216
+mov dword [rbx - 0x8003], r9d
+
+; 16bit, one past the scaled range
+mov rbx, 0xe007e224
+mov word [rbx + 0x2001], r10w
+
+; 8bit, one below the unscaled range
+mov rbx, 0xe0080338
+mov byte [rbx - 0x101], r11b
+
+; 128bit, a multiple of 8 but not 16
+mov rbx, 0xe0070250
+movups [rbx + 0xfff8], xmm0
+
+; Indexed, large negative
+mov rsi, 5
+mov rbx, 0xe00b028f
+mov dword [rbx + rsi * 4 - 0x30000], r12d
+
+mov rdi, 0xe0080200
+mov rbx, 0
+mov esi, 32
+hash:
+xor rbx, [rdi]
+imul rbx, rbx, 0x2545f491
+add rdi, 8
+sub esi, 1
+jnz hash
+
+mov rdi, qword [r15 - 0x2f0]
+
+hlt
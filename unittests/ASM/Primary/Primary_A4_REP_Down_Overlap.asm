@@ -0,0 +1,61 @@
+%ifdef CONFIG
+{
+  "RegData": {
+    "RAX": "0x5A5A5A5A",
+    "RBX": "0x0E0D0C0B0A090807",
+    "R8": "0xDFFFFFFF",
+    "R9": "0xE0000000",
+    "R10": "0x1F1E1F1E1F1E1F1E",
+    "R11": "0xE0000016",
+    "R12": "0xE0000014",
+    "R13": "0x5A5A5A5A5A5A5A5A",
+    "R14": "0xE000000C",
+    "R15": "0x0605040302010000"
+  },
+  "MemoryRegions": {
+    "0x100000000": "4096"
+  }
+}
+%endif
+
+; DF=1 copies walk down from the last element, overlap behaves like memmove one way and smears the other
+mov rdx, 0xe0000000
+
+mov rax, 0x0706050403020100
+mov [rdx + 8 * 0], rax
+mov rax, 0x0f0e0d0c0b0a0908
+mov [rdx + 8 * 1], rax
+mov rax, 0x1716151413121110
+mov [rdx + 8 * 2], rax
+mov rax, 0x1f1e1d1c1b1a1918
+mov [rdx + 8 * 3], rax
+
+; Destination past the source, every byte moves up intact
+lea rsi, [rdx + 8 * 0 + 14]
+lea rdi, [rdx + 8 * 0 + 15]
+std
+mov rcx, 15
+rep movsb
+mov r15, [rdx + 8 * 0]
+mov rbx, [rdx + 8 * 1]
+mov r8, rsi
+mov r9, rdi
+
+; Destination behind the source, the last word gets repeated
+lea rsi, [rdx + 8 * 3 + 6]
+lea rdi, [rdx + 8 * 3 + 4]
+mov rcx, 4
+rep movsw
+mov r10, [rdx + 8 * 3]
+mov r11, rsi
+mov r12, rdi
+
+; stos walks down too
+mov rax, 0x5a5a5a5a
+lea rdi, [rdx + 8 * 2 + 4]
+mov rcx, 2
+rep stosd
+cld
+mov r13, [rdx + 8 * 2]
+mov r14, rdi
+hlt
@@ -0,0 +1,61 @@
+%ifdef CONFIG
+{
+  "RegData": {
+    "RAX": "0xFFFFFFFFFFFFFFFF",
+    "RBX": "0xFFFFFFFFFFFFFFFF",
+    "R8": "0xE000000F",
+    "R9": "0xE0000010",
+    "R10": "0x1B1A191817161514",
+    "R11": "0x1F1E1D1C",
+    "R12": "0x1716151417161514",
+    "R13": "0x1716151417161514",
+    "R14": "0x0"
+  },
+  "MemoryRegions": {
+    "0x100000000": "4096"
+  }
+}
+%endif
+
+; Overlapping copies go one element at a time, not like memmove
+mov rdx, 0xe0000000
+
+mov rax, 0x07060504030201ff
+mov [rdx + 8 * 0], rax
+mov rax, 0x0f0e0d0c0b0a0908
+mov [rdx + 8 * 1], rax
+mov rax, 0x1716151413121110
+mov [rdx + 8 * 2], rax
+mov rax, 0x1f1e1d1c1b1a1918
+mov [rdx + 8 * 3], rax
+mov rax, 0
+mov [rdx + 8 * 4], rax
+
+; Destination one byte past the source smears the first byte
+lea rsi, [rdx + 8 * 0]
+lea rdi, [rdx + 8 * 0 + 1]
+cld
+mov rcx, 15
+rep movsb
+mov rax, [rdx + 8 * 0]
+mov rbx, [rdx + 8 * 1]
+mov r8, rsi
+mov r9, rdi
+
+; Destination behind the source shifts everything down
+lea rsi, [rdx + 8 * 2 + 4]
+lea rdi, [rdx + 8 * 2]
+mov rcx, 2
+rep movsq
+mov r10, [rdx + 8 * 2]
+mov r11, [rdx + 8 * 3]
+
+; Destination one dword past the source repeats the first dword
+lea rsi, [rdx + 8 * 2]
+lea rdi, [rdx + 8 * 2 + 4]
+mov rcx, 3
+rep movsd
+mov r12, [rdx + 8 * 2]
+mov r13, [rdx + 8 * 3]
+mov r14, rcx
+hlt
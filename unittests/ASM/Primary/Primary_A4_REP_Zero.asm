@@ -0,0 +1,53 @@
+%ifdef CONFIG
+{
+  "RegData": {
+    "RAX": "0x4142434445464748",
+    "RBX": "0x5152535455565758",
+    "R8": "0xE0000000",
+    "R9": "0xE0000008",
+    "R10": "0xE0000008",
+    "R11": "0x95",
+    "R12": "0xE0000000",
+    "R13": "0xE0000008"
+  },
+  "MemoryRegions": {
+    "0x100000000": "4096"
+  }
+}
+%endif
+
+; A count of zero touches neither memory, RSI/RDI nor the flags
+mov rdx, 0xe0000000
+
+mov rax, 0x4142434445464748
+mov [rdx + 8 * 0], rax
+mov rax, 0x5152535455565758
+mov [rdx + 8 * 1], rax
+
+lea rsi, [rdx + 8 * 0]
+lea rdi, [rdx + 8 * 1]
+cld
+mov rcx, 0
+rep movsb
+mov r8, rsi
+mov r9, rdi
+
+mov rax, 0
+std
+rep stosq
+cld
+mov r10, rdi
+
+; Flags from the cmp survive the compare that never runs
+mov rax, 1
+cmp rax, 2
+repe cmpsq
+pushf
+pop r11
+and r11, 0x8d5
+mov r12, rsi
+mov r13, rdi
+
+mov rax, [rdx + 8 * 0]
+mov rbx, [rdx + 8 * 1]
+hlt
@@ -0,0 +1,109 @@
+%ifdef CONFIG
+{
+  "RegData": {
+    "R8": "0x881000F0001",
+    "R9": "0x400000010",
+    "R10": "0x4400070002",
+    "R11": "0x4400000010",
+    "R12": "0x400010000"
+  },
+  "MemoryRegions": {
+    "0x100000000": "4096"
+  }
+}
+%endif
+
+; REPE/REPNE CMPS stopping on the first and on the last element
+; Each case leaves (flags & 0x8d5) << 32 | RCX << 16 | (RSI - buffer) in a register
+mov rdx, 0xe0000000
+
+; Two identical 16 byte strings at +0 and +16
+mov rax, 0x0706050403020100
+mov [rdx + 8 * 0], rax
+mov [rdx + 8 * 2], rax
+mov rax, 0x0f0e0d0c0b0a0908
+mov [rdx + 8 * 1], rax
+mov [rdx + 8 * 3], rax
+
+; REPE, first byte differs, source smaller
+mov byte [rdx + 16], 0x80
+lea rsi, [rdx + 0]
+lea rdi, [rdx + 16]
+cld
+mov rcx, 16
+repe cmpsb
+pushf
+pop r8
+and r8, 0x8d5
+shl r8, 32
+shl rcx, 16
+or r8, rcx
+sub rsi, rdx
+or r8, rsi
+mov byte [rdx + 16], 0x00
+
+; REPE, last byte differs, source larger
+mov byte [rdx + 31], 0x00
+lea rsi, [rdx + 0]
+lea rdi, [rdx + 16]
+mov rcx, 16
+repe cmpsb
+pushf
+pop r9
+and r9, 0x8d5
+shl r9, 32
+shl rcx, 16
+or r9, rcx
+sub rsi, rdx
+or r9, rsi
+mov byte [rdx + 31], 0x0f
+
+; REPNE, first word matches
+mov word [rdx + 2], 0xffff
+lea rsi, [rdx + 0]
+lea rdi, [rdx + 16]
+mov rcx, 8
+repne cmpsw
+pushf
+pop r10
+and r10, 0x8d5
+shl r10, 32
+shl rcx, 16
+or r10, rcx
+sub rsi, rdx
+or r10, rsi
+
+; REPNE, only the last word matches
+mov rax, 0x7f7f7f7f7f7f7f7f
+mov [rdx + 8 * 0], rax
+mov rax, 0x0f0e7f7f7f7f7f7f
+mov [rdx + 8 * 1], rax
+lea rsi, [rdx + 0]
+lea rdi, [rdx + 16]
+mov rcx, 8
+repne cmpsw
+pushf
+pop r11
+and r11, 0x8d5
+shl r11, 32
+shl rcx, 16
+or r11, rcx
+sub rsi, rdx
+or r11, rsi
+
+; DF=1, REPE stops on the first element it looks at, which is the highest one
+lea rsi, [rdx + 8 * 1]
+lea rdi, [rdx + 8 * 3]
+std
+mov rcx, 2
+repe cmpsq
+cld
+pushf
+pop r12
+and r12, 0x8d5
+shl r12, 32
+shl rcx, 16
+or r12, rcx
+sub rsi, rdx
+or r12, rsi
+hlt
@@ -0,0 +1,98 @@
+%ifdef CONFIG
+{
+  "RegData": {
+    "RAX": "0x113e73ace3979d95",
+    "RBX": "0x9e419a4a553c3294",
+    "RCX": "0x2230f69713bbafc7",
+    "RDX": "0xce5ad076a3572fd0",
+    "RSI": "0x5225c3f727195097",
+    "RDI": "0x50c16f236d626b1",
+    "RBP": "0xc3ac1008c5d3b3e6",
+    "R8": "0x163cc005639bf2f4",
+    "R9": "0xa9c2bb21cacce606",
+    "R10": "0x79eb847f212645ef",
+    "R11": "0x5cc2729f26bc4e69",
+    "R12": "0xf73ced67201b537e",
+    "R13": "0xf1de261fff3598d2",
+    "R14": "0xc252164cb0441968",
+    "R15": "0xc386e5cd39ce3d0e"
+  },
+  "MemoryRegions": {
+    "0x100000000": "4096"
+  }
+}
+%endif
+
+; Every GPR stays live through the mixing below, more values than there are host registers so the RA has to spill
+; Loaded from memory so nothing can be constant folded
+mov rdi, 0xe0000000
+mov rax, 0x123456789abcdef
+mov ecx, 16
+fill:
+imul rax, rax, 0x5851f42d
+add rax, 0x14057b7
+mov [rdi], rax
+add rdi, 8
+sub ecx, 1
+jnz fill
+
+mov rsi, 0xe0000000
+mov rax, qword [rsi + 8 * 0]
+mov rbx, qword [rsi + 8 * 1]
+mov rcx, qword [rsi + 8 * 2]
+mov rdx, qword [rsi + 8 * 3]
+mov rbp, qword [rsi + 8 * 4]
+mov rdi, qword [rsi + 8 * 5]
+mov r8,  qword [rsi + 8 * 6]
+mov r9,  qword [rsi + 8 * 7]
+mov r10, qword [rsi + 8 * 8]
+mov r11, qword [rsi + 8 * 9]
+mov r12, qword [rsi + 8 * 10]
+mov r13, qword [rsi + 8 * 11]
+mov r14, qword [rsi + 8 * 12]
+mov r15, qword [rsi + 8 * 13]
+mov rsi, qword [rsi + 8 * 14]
+
+lea rax, [rax + rbx * 2]
+xor rbx, rcx
+sub rcx, rdx
+rol rdx, 13
+add rbp, rsi
+xor rsi, rdi
+lea rdi, [rdi + r8 * 4]
+sub r8, r9
+xor r9, r10
+add r10, r11
+rol r11, 7
+xor r12, r13
+add r13, r14
+sub r14, r15
+xor r15, rax
+add rax, r12
+imul rbx, rbp
+xor rcx, r15
+add rdx, r11
+sub rsi, r9
+
+lea rax, [rax + rbx * 2]
+xor rbx, rcx
+sub rcx, rdx
+rol rdx, 13
+add rbp, rsi
+xor rsi, rdi
+lea rdi, [rdi + r8 * 4]
+sub r8, r9
+xor r9, r10
+add r10, r11
+rol r11, 7
+xor r12, r13
+add r13, r14
+sub r14, r15
+xor r15, rax
+add rax, r12
+imul rbx, rbp
+xor rcx, r15
+add rdx, r11
+sub rsi, r9
+
+hlt
@@ -0,0 +1,63 @@
+%ifdef CONFIG
+{
+  "RegData": {
+    "RAX": "0x0",
+    "RBX": "0x4142434445464748",
+    "RDX": "0x1",
+    "R12": "0x0"
+  },
+  "MemoryRegions": {
+    "0x100000000": "4096"
+  }
+}
+%endif
+
+; mmap(nullptr, 0x2000, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)
+mov rax, 9
+mov rdi, 0
+mov rsi, 0x2000
+mov rdx, 3
+mov r10, 0x22
+mov r8, -1
+mov r9, 0
+syscall
+mov r14, rax
+
+; Has to come from the mmap window in guest memory, not wherever the host kernel likes
+mov rdx, 0
+mov r13, 0x100000000
+cmp r14, r13
+jb .out_of_window
+mov r13, 0x400000000
+cmp r14, r13
+jae .out_of_window
+mov rdx, 1
+.out_of_window:
+
+; Usable by the guest
+mov rbx, 0x4142434445464748
+mov [r14 + 0x1000], rbx
+mov rbx, 0
+mov rbx, [r14 + 0x1000]
+
+; munmap(r14, 0x2000)
+mov r15, rdx
+mov rax, 11
+mov rdi, r14
+mov rsi, 0x2000
+syscall
+mov r12, rax
+
+; Freed ranges get handed out again
+mov rax, 9
+mov rdi, 0
+mov rsi, 0x2000
+mov rdx, 3
+mov r10, 0x22
+mov r8, -1
+mov r9, 0
+syscall
+sub rax, r14
+mov rdx, r15
+
+hlt